@@ -0,0 +1,1532 @@
+/**
+ * @file calibration_bench.c
+ * @brief Benchmark e replay da calibração no host com traces gravados
+ * @version 1.0.0
+ *
+ * Implementa os drivers (read_*, encoders, EEPROM, log) sobre um trace e
+ * um relógio virtual: get_time_ms() devolve o relógio do replay e
+ * delay_ms() apenas o avança, então a sequência roda muito mais rápido
+ * que o tempo real. Cada leitura devolve a amostra mais recente do trace
+ * com timestamp <= relógio (amostragem e retenção, como um driver que
+ * guarda a última conversão); varreduras do LiDAR só são entregues uma vez.
+ *
+ * Relatório: por fase, latência virtual, chamadas de calibration_update(),
+ * ciclos de CPU e amostras consumidas; o início e o fim de cada fase,
+ * conferindo que uma fase só começa após as de que depende; ao final, a
+ * estimativa de cada campo com valor verdadeiro no trace e o erro, e a RAM
+ * por subsistema (calibration_footprint_table()). Sai com 1 se a calibração
+ * falhar, uma dependência for violada ou algum erro passar da tolerância,
+ * para servir de gate de regressão.
+ *
+ * Com -DCALIB_FIXED_POINT=1 a calibração roda no build em ponto fixo e o
+ * bench ainda confere os kernels e as estatísticas em Q16.16 contra a
+ * aritmética exata (double) sobre as amostras do trace, falhando se algum
+ * erro passar dos limites de calibration_fixed.h.
+ *
+ * Depois de uma passada válida com odometria, o trace é repetido com uma
+ * falha injetada (bias do acelerômetro deslocado e pulsos/metro fora do
+ * intervalo): a validação tem que rejeitar a sequência e o snapshot
+ * publicado e o kernel global têm que continuar iguais aos da passada
+ * anterior. Com -DCALIB_WITH_CAMERA=0 a máscara do trace é a do SKU e o
+ * caso exercita o caminho da calibração completa.
+ *
+ * Formato do trace (CSV, '#' comenta; cada stream em ordem de tempo,
+ * timestamps rebaseados para começar em 0):
+ *   imu,t_ms,ax,ay,az,gx,gy,gz
+ *   mag,t_ms,mx,my,mz
+ *   lidar,t_ms,distance
+ *   scan,t_ms,distance,angle          (pontos com o mesmo t_ms = uma varredura)
+ *   battery,t_ms,voltage,current,percentage
+ *   temp,t_ms,temperature
+ *   move,duration_ms,left_pulses,right_pulses   (um por move_forward_distance())
+ *   truth,campo,valor[,tolerância]              (campo float de SensorCalibration_t)
+ *
+ * Sem trace, gera um cenário sintético com verdade conhecida (-s semente).
+ *
+ * Com -DCALIB_PARALLEL_THREADS=1 as fases rodam nos workers do firmware e
+ * o relógio anda em passo único: delay_ms() de um worker dorme até o laço
+ * principal avançar o relógio, e o laço só avança quando todos os workers
+ * vivos estão dormindo. Os drivers são serializados por uma trava.
+ *
+ * Build (host, a partir de docs/):
+ *   cc -std=c99 -O2 -Ibench/host -I. *.c bench/calibration_bench.c -lm -o calibration_bench
+ *   (acrescentar -DCALIB_FIXED_POINT=1 para o build em ponto fixo, ou
+ *   -DCALIB_PARALLEL_THREADS=1 ... -lpthread para as fases em threads)
+ * Uso:
+ *   calibration_bench [-v] [-p] [-a] [-t tick_ms] [-m máscara] [-s semente] [-w saída.csv] [trace.csv]
+ *   -p ativa a execução paralela das fases (set_calibration_parallel()) e
+ *      repete o trace em sequência para reportar o tempo economizado
+ *   -a ativa a amostragem adaptativa (set_calibration_adaptive()) e repete
+ *      o trace com contagens fixas para comparar as amostras por fase (com
+ *      -p, fases simultâneas contam na primeira em execução)
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <float.h>
+#include <time.h>
+#include "sensor_calibration.h"
+#include "calibration_apply.h"
+#include "calibration_stats.h"
+#include "calibration_fixed.h"
+#include "calibration_footprint.h"
+#include "calibration_context.h"
+#include "eeprom.h"
+#include "logger.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_CYCLES() ((uint64_t)__rdtsc())
+#define BENCH_CYCLES_UNIT "cycles"
+#elif defined(__aarch64__)
+static inline uint64_t read_virtual_counter(void) {
+  uint64_t value;
+  __asm__ volatile("mrs %0, cntvct_el0" : "=r"(value));
+  return value;
+}
+#define BENCH_CYCLES() read_virtual_counter()
+#define BENCH_CYCLES_UNIT "ticks"
+#else
+#define BENCH_CYCLES() host_time_ns()
+#define BENCH_CYCLES_UNIT "ns"
+#endif
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define BENCH_EEPROM_SIZE 0x4000
+#define BENCH_STALE_MS 500             // Sem amostra nova por este tempo: sensor parado
+#define BENCH_TIMEOUT_MS 600000        // Limite do replay (tempo virtual)
+#define BENCH_SYNTH_DURATION_MS 60000
+#define BENCH_SYNTH_SCAN_POINTS 360
+#define BENCH_MAX_TRUTH 32
+#define BENCH_LINE_MAX 256
+#define BENCH_PI 3.14159265f
+#define BENCH_MAX_WORKERS 16
+#define BENCH_STALL_MS 200             // Espera real máxima no passo único (ex.: worker em join)
+#define BENCH_FAULT_ACCEL 0.5f         // Passada com falha: bias novo do IMU, ainda no intervalo
+#define BENCH_FAULT_PULSE_GAIN 3u      // ... e pulsos/metro acima do intervalo da validação
+
+typedef enum {
+  STREAM_IMU = 0,
+  STREAM_MAG,
+  STREAM_LIDAR,
+  STREAM_SCAN,
+  STREAM_BATTERY,
+  STREAM_TEMP,
+  STREAM_MOVE,
+  STREAM_COUNT
+} BenchStreamId_t;
+
+static const char *const stream_names[STREAM_COUNT] = {
+  "imu", "mag", "lidar", "scan", "battery", "temp", "move"
+};
+
+// Fases no relatório: uma por sensor (INIT/RUNNING) e o fechamento
+#define BENCH_PHASE_FINALIZE CALIB_SENSOR_COUNT
+#define BENCH_PHASES (CALIB_SENSOR_COUNT + 1)
+
+static const char *const phase_names[BENCH_PHASES] = {
+  "imu", "mag", "odom", "lidar", "camera", "battery", "temp", "finalize"
+};
+
+/**
+ * @struct BenchStream_t
+ * @brief Registros de um sensor em ordem de tempo
+ */
+typedef struct {
+  uint8_t *records;
+  uint32_t *times;
+  size_t elem_size;
+  size_t count, capacity;
+  size_t cursor;       ///< Primeiro registro com tempo ainda não alcançado
+  size_t delivered;    ///< Registros já entregues (índice do último + 1)
+} BenchStream_t;
+
+typedef struct {
+  size_t first;        ///< Índice do primeiro ponto em scan_points
+  size_t count;
+} BenchScan_t;
+
+typedef struct {
+  uint32_t duration_ms;
+  uint32_t left_pulses;
+  uint32_t right_pulses;
+} BenchMove_t;
+
+typedef struct {
+  const char *name;
+  size_t offset;
+} BenchField_t;
+
+typedef struct {
+  int field;
+  float value;
+  float tolerance;     ///< < 0: sem tolerância (só reportar)
+} BenchTruth_t;
+
+/**
+ * @struct BenchWorker_t
+ * @brief Worker de fase visto pelo relógio em passo único
+ */
+typedef struct {
+  bool live;
+  bool parked;         ///< Dormindo em delay_ms()
+  uint32_t wake;       ///< Relógio em que acorda
+} BenchWorker_t;
+
+/**
+ * @struct BenchPhaseStats_t
+ * @brief Custo acumulado de uma fase
+ */
+typedef struct {
+  uint32_t virtual_ms;            ///< Tempo virtual gasto na fase (inclui delay_ms())
+  uint32_t calls;                 ///< Chamadas de calibration_update()
+  uint64_t cycles;
+  uint32_t fresh[STREAM_COUNT];   ///< Amostras novas consumidas
+  uint32_t reads[STREAM_COUNT];   ///< Leituras (inclui amostras repetidas)
+} BenchPhaseStats_t;
+
+#define FIELD(name) { #name, offsetof(SensorCalibration_t, name) }
+
+static const BenchField_t fields[] = {
+  FIELD(imu_bias_x), FIELD(imu_bias_y), FIELD(imu_bias_z),
+  FIELD(imu_scale_x), FIELD(imu_scale_y), FIELD(imu_scale_z),
+  FIELD(mag_offset_x), FIELD(mag_offset_y), FIELD(mag_offset_z),
+  FIELD(mag_scale_x), FIELD(mag_scale_y), FIELD(mag_scale_z),
+  FIELD(pulses_per_meter_left), FIELD(pulses_per_meter_right),
+  FIELD(lidar_offset_distance), FIELD(lidar_angle_offset),
+  FIELD(camera_focal_length), FIELD(camera_principal_point_x),
+  FIELD(camera_principal_point_y), FIELD(camera_distortion_k1),
+  FIELD(camera_distortion_k2),
+  FIELD(battery_voltage_offset), FIELD(battery_voltage_scale),
+  FIELD(temp_offset),
+};
+
+#define FIELD_COUNT (sizeof(fields) / sizeof(fields[0]))
+
+// ============================================================================
+// VARIÁVEIS GLOBAIS
+// ============================================================================
+
+static BenchStream_t streams[STREAM_COUNT];
+static LiDARData_t *scan_points;
+static size_t scan_point_count, scan_point_capacity;
+static BenchTruth_t truth[BENCH_MAX_TRUTH];
+static size_t truth_count;
+
+static uint32_t vclock;
+static uint32_t trace_origin;                  // Relógio no início da passada atual do trace
+static bool fault_injected;                    // Segunda passada: leituras que reprovam a validação
+static bool verbose;
+static bool parallel_phases;                   // -p: set_calibration_parallel(true)
+static bool adaptive_sampling;                 // -a: set_calibration_adaptive(true)
+static int phase = BENCH_PHASE_FINALIZE;        // Fase que recebe o custo das leituras
+static BenchPhaseStats_t stats[BENCH_PHASES];
+
+static uint8_t eeprom[BENCH_EEPROM_SIZE];
+static uint32_t eeprom_bytes_written, eeprom_writes;
+static uint32_t left_count, right_count;
+static uint32_t stale_failures;
+
+#if CALIB_PARALLEL_THREADS
+static pthread_mutex_t bench_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t clock_advanced = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t worker_parked = PTHREAD_COND_INITIALIZER;
+static pthread_key_t worker_key;
+static pthread_t main_thread;
+static BenchWorker_t workers[BENCH_MAX_WORKERS];
+#endif
+
+// ============================================================================
+// UTILITÁRIOS INTERNOS
+// ============================================================================
+
+static uint64_t host_time_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void *checked_realloc(void *ptr, size_t size) {
+  void *p = realloc(ptr, size);
+  if (p == NULL) {
+    fprintf(stderr, "out of memory\n");
+    exit(2);
+  }
+  return p;
+}
+
+#if CALIB_PARALLEL_THREADS
+/**
+ * @brief Prazo real para pthread_cond_timedwait()
+ */
+static struct timespec stall_deadline(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  ts.tv_nsec += (long)(BENCH_STALL_MS % 1000) * 1000000L;
+  ts.tv_sec += BENCH_STALL_MS / 1000 + ts.tv_nsec / 1000000000L;
+  ts.tv_nsec %= 1000000000L;
+  return ts;
+}
+
+/**
+ * @brief Fim de um worker (destrutor da chave da thread)
+ */
+static void worker_exit(void *arg) {
+  BenchWorker_t *w = (BenchWorker_t *)arg;
+
+  pthread_mutex_lock(&bench_lock);
+  w->live = false;
+  pthread_cond_broadcast(&worker_parked);
+  pthread_mutex_unlock(&bench_lock);
+}
+
+/**
+ * @brief Worker da thread atual (registrado na primeira chamada; NULL no laço principal)
+ */
+static BenchWorker_t *current_worker(void) {
+  BenchWorker_t *w = pthread_getspecific(worker_key);
+
+  if (w != NULL || pthread_equal(pthread_self(), main_thread)) {
+    return w;
+  }
+  for (size_t i = 0; i < BENCH_MAX_WORKERS; i++) {
+    if (!workers[i].live) {
+      w = &workers[i];
+      w->live = true;
+      w->parked = false;
+      pthread_setspecific(worker_key, w);
+      return w;
+    }
+  }
+  fprintf(stderr, "too many calibration workers\n");
+  exit(2);
+}
+
+/**
+ * @brief true se todos os workers vivos dormem até depois do relógio
+ */
+static bool workers_parked(void) {
+  for (size_t i = 0; i < BENCH_MAX_WORKERS; i++) {
+    if (workers[i].live && !(workers[i].parked && (int32_t)(workers[i].wake - vclock) > 0)) {
+      return false;
+    }
+  }
+  return true;
+}
+#endif
+
+/**
+ * @brief Entrar em um driver (serializa os workers e os registra)
+ */
+static void bench_enter(void) {
+#if CALIB_PARALLEL_THREADS
+  pthread_mutex_lock(&bench_lock);
+  (void)current_worker();
+#endif
+}
+
+static void bench_leave(void) {
+#if CALIB_PARALLEL_THREADS
+  pthread_mutex_unlock(&bench_lock);
+#endif
+}
+
+/**
+ * @brief Avançar o relógio virtual (laço principal)
+ *
+ * Em passo único, espera os workers dormirem; um worker que não volta em
+ * BENCH_STALL_MS de tempo real não segura o relógio.
+ */
+static void clock_advance(uint32_t ms) {
+  bench_enter();
+#if CALIB_PARALLEL_THREADS
+  struct timespec deadline = stall_deadline();
+  while (!workers_parked() &&
+         pthread_cond_timedwait(&worker_parked, &bench_lock, &deadline) == 0) {
+  }
+#endif
+  vclock += ms;
+#if CALIB_PARALLEL_THREADS
+  pthread_cond_broadcast(&clock_advanced);
+#endif
+  bench_leave();
+}
+
+static void stream_init(BenchStream_t *s, size_t elem_size) {
+  memset(s, 0, sizeof(*s));
+  s->elem_size = elem_size;
+}
+
+static void stream_push(BenchStream_t *s, uint32_t time_ms, const void *record) {
+  if (s->count == s->capacity) {
+    s->capacity = s->capacity ? s->capacity * 2 : 256;
+    s->records = checked_realloc(s->records, s->capacity * s->elem_size);
+    s->times = checked_realloc(s->times, s->capacity * sizeof(uint32_t));
+  }
+  memcpy(s->records + s->count * s->elem_size, record, s->elem_size);
+  s->times[s->count++] = time_ms;
+}
+
+/**
+ * @brief Amostra mais recente com tempo <= relógio (NULL se não houver)
+ * @param fresh_only Entregar cada registro no máximo uma vez
+ */
+static const void *stream_read_locked(BenchStreamId_t id, bool fresh_only) {
+  BenchStream_t *s = &streams[id];
+  uint32_t now = vclock - trace_origin;
+
+  while (s->cursor < s->count && s->times[s->cursor] <= now) {
+    s->cursor++;
+  }
+  if (s->cursor == 0) {
+    return NULL;
+  }
+
+  size_t latest = s->cursor - 1;
+  bool fresh = latest + 1 > s->delivered;
+  if (fresh_only && !fresh) {
+    return NULL;
+  }
+  if (!fresh && now - s->times[latest] > BENCH_STALE_MS) {
+    stale_failures++;
+    return NULL;  // Trace acabou: o sensor "parou"
+  }
+
+  stats[phase].reads[id]++;
+  if (fresh) {
+    stats[phase].fresh[id]++;
+    s->delivered = latest + 1;
+  }
+  return s->records + latest * s->elem_size;
+}
+
+/**
+ * @brief stream_read_locked() a partir de um driver (registros do trace são imutáveis)
+ */
+static const void *stream_read(BenchStreamId_t id, bool fresh_only) {
+  bench_enter();
+  const void *record = stream_read_locked(id, fresh_only);
+  bench_leave();
+  return record;
+}
+
+static int phase_of_state(CalibrationState_t state) {
+  if (state >= CALIB_IMU_INIT && state <= CALIB_TEMP_RUNNING) {
+    return (state - CALIB_IMU_INIT) / 2;
+  }
+  return BENCH_PHASE_FINALIZE;
+}
+
+static int find_field(const char *name) {
+  for (size_t i = 0; i < FIELD_COUNT; i++) {
+    if (strcmp(fields[i].name, name) == 0) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+static float field_value(const SensorCalibration_t *calib, int field) {
+  float value;
+  memcpy(&value, (const uint8_t *)calib + fields[field].offset, sizeof(value));
+  return value;
+}
+
+static void add_truth(const char *name, float value, float tolerance) {
+  int field = find_field(name);
+
+  if (field < 0 || truth_count == BENCH_MAX_TRUTH) {
+    fprintf(stderr, "ignoring truth for '%s'\n", name);
+    return;
+  }
+  truth[truth_count].field = field;
+  truth[truth_count].value = value;
+  truth[truth_count].tolerance = tolerance;
+  truth_count++;
+}
+
+/**
+ * @brief Acrescentar um ponto de varredura (mesmo t_ms do anterior = mesma varredura)
+ */
+static void add_scan_point(uint32_t time_ms, float distance, float angle) {
+  BenchStream_t *s = &streams[STREAM_SCAN];
+
+  if (scan_point_count == scan_point_capacity) {
+    scan_point_capacity = scan_point_capacity ? scan_point_capacity * 2 : 4096;
+    scan_points = checked_realloc(scan_points, scan_point_capacity * sizeof(LiDARData_t));
+  }
+  scan_points[scan_point_count].distance = distance;
+  scan_points[scan_point_count].angle = angle;
+  scan_points[scan_point_count].timestamp = time_ms;
+
+  if (s->count == 0 || s->times[s->count - 1] != time_ms) {
+    BenchScan_t scan = { scan_point_count, 0 };
+    stream_push(s, time_ms, &scan);
+  }
+  ((BenchScan_t *)s->records)[s->count - 1].count++;
+  scan_point_count++;
+}
+
+// ============================================================================
+// TRACE
+// ============================================================================
+
+/**
+ * @brief Carregar um trace CSV
+ */
+static bool load_trace(const char *path) {
+  FILE *f = fopen(path, "r");
+  char line[BENCH_LINE_MAX];
+  unsigned line_no = 0;
+
+  if (f == NULL) {
+    perror(path);
+    return false;
+  }
+
+  while (fgets(line, sizeof(line), f) != NULL) {
+    char kind[16], name[64];
+    unsigned long t, a, b, c;
+    float v[6];
+    int n;
+
+    line_no++;
+    if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') {
+      continue;
+    }
+
+    if (sscanf(line, "%15[^,],", kind) != 1) {
+      fprintf(stderr, "%s:%u: malformed line\n", path, line_no);
+      continue;
+    }
+
+    if (strcmp(kind, "imu") == 0 &&
+        sscanf(line, "imu,%lu,%f,%f,%f,%f,%f,%f", &t, &v[0], &v[1], &v[2],
+               &v[3], &v[4], &v[5]) == 7) {
+      IMUData_t d = { v[0], v[1], v[2], v[3], v[4], v[5], (uint32_t)t };
+      stream_push(&streams[STREAM_IMU], (uint32_t)t, &d);
+    } else if (strcmp(kind, "mag") == 0 &&
+               sscanf(line, "mag,%lu,%f,%f,%f", &t, &v[0], &v[1], &v[2]) == 4) {
+      MagData_t d = { v[0], v[1], v[2], (uint32_t)t };
+      stream_push(&streams[STREAM_MAG], (uint32_t)t, &d);
+    } else if (strcmp(kind, "lidar") == 0 &&
+               sscanf(line, "lidar,%lu,%f", &t, &v[0]) == 2) {
+      LiDARData_t d = { v[0], 0.0f, (uint32_t)t };
+      stream_push(&streams[STREAM_LIDAR], (uint32_t)t, &d);
+    } else if (strcmp(kind, "scan") == 0 &&
+               sscanf(line, "scan,%lu,%f,%f", &t, &v[0], &v[1]) == 3) {
+      add_scan_point((uint32_t)t, v[0], v[1]);
+    } else if (strcmp(kind, "battery") == 0 &&
+               sscanf(line, "battery,%lu,%f,%f,%f", &t, &v[0], &v[1], &v[2]) == 4) {
+      BatteryData_t d = { v[0], v[1], v[2], (uint32_t)t };
+      stream_push(&streams[STREAM_BATTERY], (uint32_t)t, &d);
+    } else if (strcmp(kind, "temp") == 0 &&
+               sscanf(line, "temp,%lu,%f", &t, &v[0]) == 2) {
+      TemperatureData_t d = { .temperature = v[0], .timestamp = (uint32_t)t };
+      stream_push(&streams[STREAM_TEMP], (uint32_t)t, &d);
+    } else if (strcmp(kind, "move") == 0 &&
+               sscanf(line, "move,%lu,%lu,%lu", &a, &b, &c) == 3) {
+      BenchMove_t m = { (uint32_t)a, (uint32_t)b, (uint32_t)c };
+      stream_push(&streams[STREAM_MOVE], 0, &m);
+    } else if (strcmp(kind, "truth") == 0 &&
+               (n = sscanf(line, "truth,%63[^,],%f,%f", name, &v[0], &v[1])) >= 2) {
+      add_truth(name, v[0], n == 3 ? v[1] : -1.0f);
+    } else {
+      fprintf(stderr, "%s:%u: unknown or malformed record\n", path, line_no);
+    }
+  }
+
+  fclose(f);
+  return true;
+}
+
+/**
+ * @brief Rebasear os timestamps para que o primeiro registro seja t = 0
+ */
+static void rebase_trace(void) {
+  uint32_t origin = UINT32_MAX;
+
+  for (int id = 0; id < STREAM_COUNT; id++) {
+    if (id != STREAM_MOVE && streams[id].count > 0 && streams[id].times[0] < origin) {
+      origin = streams[id].times[0];
+    }
+  }
+  if (origin == UINT32_MAX || origin == 0) {
+    return;
+  }
+
+  for (int id = 0; id < STREAM_COUNT; id++) {
+    if (id == STREAM_MOVE) {
+      continue;
+    }
+    for (size_t i = 0; i < streams[id].count; i++) {
+      streams[id].times[i] -= origin;
+    }
+  }
+  for (size_t i = 0; i < scan_point_count; i++) {
+    scan_points[i].timestamp -= origin;
+  }
+}
+
+/**
+ * @brief Gravar o trace carregado (ou sintético) em CSV
+ */
+static bool write_trace(const char *path) {
+  FILE *f = fopen(path, "w");
+
+  if (f == NULL) {
+    perror(path);
+    return false;
+  }
+
+  fprintf(f, "# calibration_bench trace\n");
+  for (size_t i = 0; i < streams[STREAM_IMU].count; i++) {
+    const IMUData_t *d = (const IMUData_t *)streams[STREAM_IMU].records + i;
+    fprintf(f, "imu,%lu,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g\n", (unsigned long)d->timestamp,
+            d->ax, d->ay, d->az, d->gx, d->gy, d->gz);
+  }
+  for (size_t i = 0; i < streams[STREAM_MAG].count; i++) {
+    const MagData_t *d = (const MagData_t *)streams[STREAM_MAG].records + i;
+    fprintf(f, "mag,%lu,%.6g,%.6g,%.6g\n", (unsigned long)d->timestamp, d->mx, d->my, d->mz);
+  }
+  for (size_t i = 0; i < streams[STREAM_LIDAR].count; i++) {
+    const LiDARData_t *d = (const LiDARData_t *)streams[STREAM_LIDAR].records + i;
+    fprintf(f, "lidar,%lu,%.6g\n", (unsigned long)d->timestamp, d->distance);
+  }
+  for (size_t i = 0; i < scan_point_count; i++) {
+    fprintf(f, "scan,%lu,%.6g,%.6g\n", (unsigned long)scan_points[i].timestamp,
+            scan_points[i].distance, scan_points[i].angle);
+  }
+  for (size_t i = 0; i < streams[STREAM_BATTERY].count; i++) {
+    const BatteryData_t *d = (const BatteryData_t *)streams[STREAM_BATTERY].records + i;
+    fprintf(f, "battery,%lu,%.6g,%.6g,%.6g\n", (unsigned long)d->timestamp,
+            d->voltage, d->current, d->percentage);
+  }
+  for (size_t i = 0; i < streams[STREAM_TEMP].count; i++) {
+    const TemperatureData_t *d = (const TemperatureData_t *)streams[STREAM_TEMP].records + i;
+    fprintf(f, "temp,%lu,%.6g\n", (unsigned long)d->timestamp, d->temperature);
+  }
+  for (size_t i = 0; i < streams[STREAM_MOVE].count; i++) {
+    const BenchMove_t *m = (const BenchMove_t *)streams[STREAM_MOVE].records + i;
+    fprintf(f, "move,%lu,%lu,%lu\n", (unsigned long)m->duration_ms,
+            (unsigned long)m->left_pulses, (unsigned long)m->right_pulses);
+  }
+  for (size_t i = 0; i < truth_count; i++) {
+    fprintf(f, "truth,%s,%.6g", fields[truth[i].field].name, truth[i].value);
+    if (truth[i].tolerance >= 0.0f) {
+      fprintf(f, ",%.6g", truth[i].tolerance);
+    }
+    fputc('\n', f);
+  }
+
+  return fclose(f) == 0;
+}
+
+// ============================================================================
+// CENÁRIO SINTÉTICO
+// ============================================================================
+
+static uint32_t rng_state;
+
+static float uniform(void) {
+  // xorshift32: reprodutível entre plataformas, ao contrário de rand()
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return ((rng_state >> 8) + 0.5f) / 16777216.0f;
+}
+
+static float gaussian(void) {
+  float u = uniform();
+  float v = uniform();
+  return sqrtf(-2.0f * logf(u)) * cosf(2.0f * BENCH_PI * v);
+}
+
+/**
+ * @brief Gerar um cenário com verdade conhecida
+ *
+ * Robô parado e nivelado para o IMU; magnetômetro girando em azimute e
+ * elevação com hard-iron e ganhos por eixo; parede a 1 m à frente com
+ * offsets de distância e ângulo do LiDAR; encoders com pulsos/metro
+ * diferentes por roda.
+ */
+static void synthesize_trace(uint32_t seed) {
+  const float mag_offset[3] = { 0.1f, -0.2f, 0.05f };
+  const float mag_gain[3] = { 0.5f, 0.45f, 0.55f };
+  const float lidar_d = 0.02f, lidar_a = 0.03f;
+  float inv_gain_product = 1.0f;
+
+  rng_state = seed ? seed : 1;
+
+  for (uint32_t t = 0; t < BENCH_SYNTH_DURATION_MS; t += 5) {
+    IMUData_t d = { 0.05f + 0.01f * gaussian(), -0.02f + 0.01f * gaussian(),
+                    9.91f + 0.01f * gaussian(), 0.001f + 0.0005f * gaussian(),
+                    -0.002f + 0.0005f * gaussian(), 0.003f + 0.0005f * gaussian(), t };
+    stream_push(&streams[STREAM_IMU], t, &d);
+  }
+
+  for (uint32_t t = 0; t < BENCH_SYNTH_DURATION_MS; t += 20) {
+    float az = t / 30000.0f * 2.0f * BENCH_PI * 3.0f;
+    float el = 1.2f * sinf(t / 900.0f);
+    MagData_t d = { mag_offset[0] + mag_gain[0] * cosf(az) * cosf(el) + 0.001f * gaussian(),
+                    mag_offset[1] + mag_gain[1] * sinf(az) * cosf(el) + 0.001f * gaussian(),
+                    mag_offset[2] + mag_gain[2] * sinf(el) + 0.001f * gaussian(), t };
+    stream_push(&streams[STREAM_MAG], t, &d);
+  }
+
+  for (uint32_t t = 0; t < BENCH_SYNTH_DURATION_MS; t += 20) {
+    LiDARData_t d = { 1.0f - lidar_d + 0.003f * gaussian(), 0.0f, t };
+    stream_push(&streams[STREAM_LIDAR], t, &d);
+  }
+
+  for (uint32_t t = 0; t < BENCH_SYNTH_DURATION_MS; t += 100) {
+    for (int i = 0; i < BENCH_SYNTH_SCAN_POINTS; i++) {
+      float angle = i * 2.0f * BENCH_PI / BENCH_SYNTH_SCAN_POINTS;
+      if (angle >= BENCH_PI) {
+        angle -= 2.0f * BENCH_PI;
+      }
+      float true_angle = angle + lidar_a;
+      float range = (fabsf(true_angle) < 0.9f) ? 1.0f / cosf(true_angle) : 3.0f;
+      add_scan_point(t, range - lidar_d + 0.005f * gaussian(), angle);
+    }
+  }
+
+  for (uint32_t t = 0; t < BENCH_SYNTH_DURATION_MS; t += 100) {
+    BatteryData_t b = { 11.8f + 0.02f * gaussian(), 1.0f, 80.0f, t };
+    TemperatureData_t tc = { .temperature = 26.0f + 0.1f * gaussian(), .timestamp = t };
+    stream_push(&streams[STREAM_BATTERY], t, &b);
+    stream_push(&streams[STREAM_TEMP], t, &tc);
+  }
+
+  // Um percurso de ODOM_TEST_DISTANCE_MM (1 m)
+  BenchMove_t move = { 3000, 1050, 1020 };
+  stream_push(&streams[STREAM_MOVE], 0, &move);
+
+  for (int i = 0; i < 3; i++) {
+    inv_gain_product /= mag_gain[i];
+  }
+  float det_scale = cbrtf(inv_gain_product);
+
+  add_truth("imu_bias_x", 0.05f, 0.005f);
+  add_truth("imu_bias_y", -0.02f, 0.005f);
+  add_truth("imu_bias_z", 0.10f, 0.005f);
+  add_truth("mag_offset_x", mag_offset[0], 0.01f);
+  add_truth("mag_offset_y", mag_offset[1], 0.01f);
+  add_truth("mag_offset_z", mag_offset[2], 0.01f);
+  add_truth("mag_scale_x", 1.0f / mag_gain[0] / det_scale, 0.02f);
+  add_truth("mag_scale_y", 1.0f / mag_gain[1] / det_scale, 0.02f);
+  add_truth("mag_scale_z", 1.0f / mag_gain[2] / det_scale, 0.02f);
+  add_truth("pulses_per_meter_left", 1050.0f, 1.0f);
+  add_truth("pulses_per_meter_right", 1020.0f, 1.0f);
+  add_truth("lidar_offset_distance", lidar_d, 0.005f);
+  add_truth("lidar_angle_offset", lidar_a, 0.005f);
+  add_truth("battery_voltage_offset", 0.2f, 0.02f);
+  add_truth("temp_offset", -1.0f, 0.1f);
+}
+
+// ============================================================================
+// DRIVERS DO HOST
+// ============================================================================
+
+bool read_imu_raw(IMUData_t *imu_data) {
+  const IMUData_t *d = stream_read(STREAM_IMU, false);
+  if (d == NULL) {
+    return false;
+  }
+  *imu_data = *d;
+  if (fault_injected) {
+    imu_data->ax += BENCH_FAULT_ACCEL;
+  }
+  return true;
+}
+
+bool read_magnetometer_raw(MagData_t *mag_data) {
+  const MagData_t *d = stream_read(STREAM_MAG, false);
+  if (d == NULL) {
+    return false;
+  }
+  *mag_data = *d;
+  return true;
+}
+
+bool read_battery_data(BatteryData_t *battery_data) {
+  const BatteryData_t *d = stream_read(STREAM_BATTERY, false);
+  if (d == NULL) {
+    return false;
+  }
+  *battery_data = *d;
+  return true;
+}
+
+bool read_temperature_data(TemperatureData_t *temp_data) {
+  const TemperatureData_t *d = stream_read(STREAM_TEMP, false);
+  if (d == NULL) {
+    return false;
+  }
+  *temp_data = *d;
+  return true;
+}
+
+float read_lidar_distance(void) {
+  const LiDARData_t *d = stream_read(STREAM_LIDAR, false);
+  return (d != NULL) ? d->distance : -1.0f;
+}
+
+bool read_lidar_scan(const LiDARData_t **points, size_t *count) {
+  const BenchScan_t *scan = stream_read(STREAM_SCAN, true);
+  if (scan == NULL) {
+    return false;
+  }
+  *points = scan_points + scan->first;
+  *count = scan->count;
+  return true;
+}
+
+bool read_camera_frame(CameraFrame_t *frame) {
+  (void)frame;
+  return false;  // Traces não carregam quadros: a fase da câmera fica fora da máscara
+}
+
+void release_camera_frame(const CameraFrame_t *frame) {
+  (void)frame;
+}
+
+bool move_forward_distance(uint32_t distance_mm) {
+  BenchStream_t *s = &streams[STREAM_MOVE];
+  bool moved = false;
+  (void)distance_mm;
+
+  bench_enter();
+  if (s->delivered < s->count) {
+    const BenchMove_t *m = (const BenchMove_t *)s->records + s->delivered++;
+    stats[phase].reads[STREAM_MOVE]++;
+    stats[phase].fresh[STREAM_MOVE]++;
+    uint32_t gain = fault_injected ? BENCH_FAULT_PULSE_GAIN : 1u;
+    left_count += m->left_pulses * gain;
+    right_count += m->right_pulses * gain;
+    vclock += m->duration_ms;
+    moved = true;
+  }
+  bench_leave();
+  return moved;
+}
+
+void reset_encoder_counters(void) {
+  bench_enter();
+  left_count = 0;
+  right_count = 0;
+  bench_leave();
+}
+
+uint32_t get_left_encoder_count(void) {
+  bench_enter();
+  uint32_t count = left_count;
+  bench_leave();
+  return count;
+}
+
+uint32_t get_right_encoder_count(void) {
+  bench_enter();
+  uint32_t count = right_count;
+  bench_leave();
+  return count;
+}
+
+uint32_t get_time_ms(void) {
+  bench_enter();
+  uint32_t now = vclock;
+  bench_leave();
+  return now;
+}
+
+void delay_ms(uint32_t ms) {
+  bench_enter();
+#if CALIB_PARALLEL_THREADS
+  BenchWorker_t *w = current_worker();
+  if (w != NULL) {
+    struct timespec deadline = stall_deadline();
+
+    // Dorme até o laço principal passar de wake (ou até o laço parar em um join)
+    w->wake = vclock + ms;
+    w->parked = true;
+    pthread_cond_broadcast(&worker_parked);
+    while ((int32_t)(vclock - w->wake) < 0 &&
+           pthread_cond_timedwait(&clock_advanced, &bench_lock, &deadline) == 0) {
+    }
+    w->parked = false;
+    bench_leave();
+    return;
+  }
+#endif
+  vclock += ms;
+  bench_leave();
+}
+
+void eeprom_write(uint32_t addr, const uint8_t *data, size_t len) {
+  bench_enter();
+  if (addr + len <= sizeof(eeprom)) {
+    memcpy(eeprom + addr, data, len);
+  }
+  eeprom_bytes_written += (uint32_t)len;
+  eeprom_writes++;
+  bench_leave();
+}
+
+void eeprom_read(uint32_t addr, uint8_t *data, size_t len) {
+  bench_enter();
+  if (addr + len <= sizeof(eeprom)) {
+    memcpy(data, eeprom + addr, len);
+  } else {
+    memset(data, 0xFF, len);
+  }
+  bench_leave();
+}
+
+static void log_line(const char *level, const char *fmt, va_list ap) {
+  bench_enter();
+  if (verbose) {
+    fprintf(stderr, "[%8lu] %s ", (unsigned long)vclock, level);
+    vfprintf(stderr, fmt, ap);
+    fputc('\n', stderr);
+  }
+  bench_leave();
+}
+
+void log_info(const char *fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  log_line("I", fmt, ap);
+  va_end(ap);
+}
+
+void log_warning(const char *fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  log_line("W", fmt, ap);
+  va_end(ap);
+}
+
+void log_error(const char *fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  log_line("E", fmt, ap);
+  va_end(ap);
+}
+
+// ============================================================================
+// REPLAY E RELATÓRIO
+// ============================================================================
+
+/**
+ * @brief Máscara padrão: sensores com dados no trace (câmera nunca)
+ */
+static uint32_t mask_from_trace(void) {
+  uint32_t mask = 0;
+
+  if (streams[STREAM_IMU].count > 0) {
+    mask |= CALIB_SENSOR_BIT(CALIB_SENSOR_IMU);
+  }
+  if (streams[STREAM_MAG].count > 0) {
+    mask |= CALIB_SENSOR_BIT(CALIB_SENSOR_MAG);
+  }
+  if (streams[STREAM_MOVE].count > 0) {
+    mask |= CALIB_SENSOR_BIT(CALIB_SENSOR_ODOM);
+  }
+  if (streams[STREAM_SCAN].count > 0 || streams[STREAM_LIDAR].count > 0) {
+    mask |= CALIB_SENSOR_BIT(CALIB_SENSOR_LIDAR);
+  }
+  if (streams[STREAM_BATTERY].count > 0) {
+    mask |= CALIB_SENSOR_BIT(CALIB_SENSOR_BATTERY);
+  }
+  if (streams[STREAM_TEMP].count > 0) {
+    mask |= CALIB_SENSOR_BIT(CALIB_SENSOR_TEMP);
+  }
+  return mask;
+}
+
+/**
+ * @brief Recomeçar o trace no relógio atual (o relógio do firmware não volta)
+ */
+static void rewind_trace(void) {
+  trace_origin = vclock;
+  for (int id = 0; id < STREAM_COUNT; id++) {
+    streams[id].cursor = 0;
+    streams[id].delivered = 0;
+  }
+}
+
+/**
+ * @brief Rodar uma sequência até voltar a CALIB_IDLE
+ * @return false se estourar BENCH_TIMEOUT_MS
+ */
+static bool run_sequence(uint32_t mask, uint32_t tick_ms) {
+  bool started = false;
+
+  request_calibration_mask(mask);
+
+  // Com workers, o relógio e phase só são acessados sob a trava dos drivers
+  while (get_time_ms() - trace_origin < BENCH_TIMEOUT_MS) {
+    CalibrationState_t state = get_calibration_state();
+    if (state == CALIB_IDLE && started) {
+      return true;
+    }
+    started |= state != CALIB_IDLE;
+
+    bench_enter();
+    phase = phase_of_state(state);
+    bench_leave();
+    BenchPhaseStats_t *p = &stats[phase_of_state(state)];
+    uint32_t tick_start = get_time_ms();
+
+    uint64_t start = BENCH_CYCLES();
+    calibration_update();
+    p->cycles += BENCH_CYCLES() - start;
+    p->calls++;
+
+    clock_advance(tick_ms);
+    p->virtual_ms += get_time_ms() - tick_start;
+  }
+  return false;
+}
+
+/**
+ * @brief Inicializar o firmware e rodar a sequência sobre o trace
+ */
+static bool replay(uint32_t mask, uint32_t tick_ms) {
+  calibration_init();
+  if (parallel_phases) {
+    set_calibration_parallel(true);
+  }
+  if (adaptive_sampling) {
+    set_calibration_adaptive(true);
+  }
+  return run_sequence(mask, tick_ms);
+}
+
+/**
+ * @brief Repetir a sequência com leituras que reprovam a validação
+ *
+ * O IMU ganha um bias novo (ainda válido) e o odômetro passa do
+ * intervalo aceito: a sequência termina em CALIB_ERROR, e o snapshot
+ * publicado e o kernel global devem continuar com a calibração anterior,
+ * sem nenhum valor da passada reprovada.
+ * @return Número de falhas
+ */
+static int rollback_check(uint32_t mask, uint32_t tick_ms) {
+  static CalibrationApplyKernel_t kernel_before, kernel_after;
+  SensorCalibration_t before, after;
+  SensorCalibrationExt_t ext_before, ext_after;
+  int failures = 0;
+
+  get_calibration_snapshot(&before, &ext_before);
+  calibration_apply_read(&kernel_before);
+  uint32_t rejected = get_calibration_metrics()->validation_failures;
+
+  rewind_trace();
+  fault_injected = true;
+  bool finished = run_sequence(mask, tick_ms);
+  fault_injected = false;
+
+  get_calibration_snapshot(&after, &ext_after);
+  calibration_apply_read(&kernel_after);
+
+  printf("\n%-24s %12s %12s\n", "rollback (rejected run)", "before", "after");
+  for (size_t i = 0; i < FIELD_COUNT; i++) {
+    float a = field_value(&before, (int)i);
+    float b = field_value(&after, (int)i);
+    if (memcmp(&a, &b, sizeof(a)) != 0) {
+      printf("%-24s %12.5g %12.5g  FAIL\n", fields[i].name, a, b);
+      failures++;
+    }
+  }
+  if (memcmp(&ext_before, &ext_after, sizeof(ext_before)) != 0) {
+    printf("%-24s %12s %12s  FAIL\n", "extensions", "", "changed");
+    failures++;
+  }
+  if (memcmp(&kernel_before, &kernel_after, sizeof(kernel_before)) != 0) {
+    printf("%-24s %12s %12s  FAIL\n", "global apply kernel", "", "changed");
+    failures++;
+  }
+  if (!finished || get_calibration_metrics()->validation_failures == rejected) {
+    printf("%-24s %12s %12s  FAIL\n", "validation", "", finished ? "passed" : "timeout");
+    failures++;
+  }
+  if (failures == 0) {
+    printf("%-24s %12s %12s\n", "published calibration", "kept", "kept");
+  }
+  return failures;
+}
+
+static void print_report(double host_ms) {
+  printf("%-9s %9s %8s %14s %12s  samples (new/reads)\n",
+         "phase", "virt_ms", "calls", BENCH_CYCLES_UNIT, "per_call");
+
+  for (int i = 0; i < BENCH_PHASES; i++) {
+    const BenchPhaseStats_t *p = &stats[i];
+    if (p->calls == 0) {
+      continue;
+    }
+    printf("%-9s %9lu %8lu %14llu %12llu ", phase_names[i],
+           (unsigned long)p->virtual_ms, (unsigned long)p->calls,
+           (unsigned long long)p->cycles,
+           (unsigned long long)(p->calls ? p->cycles / p->calls : 0));
+    for (int id = 0; id < STREAM_COUNT; id++) {
+      if (p->reads[id] > 0) {
+        printf(" %s %lu/%lu", stream_names[id], (unsigned long)p->fresh[id],
+               (unsigned long)p->reads[id]);
+      }
+    }
+    putchar('\n');
+  }
+
+  printf("\nvirtual %lu ms in %.1f ms host (%.0fx), eeprom %lu bytes in %lu writes",
+         (unsigned long)vclock, host_ms, host_ms > 0.0 ? vclock / host_ms : 0.0,
+         (unsigned long)eeprom_bytes_written, (unsigned long)eeprom_writes);
+  if (stale_failures > 0) {
+    printf(", %lu reads past end of trace", (unsigned long)stale_failures);
+  }
+  putchar('\n');
+
+  const CalibrationMetrics_t *m = get_calibration_metrics();
+  printf("firmware metrics: validations %lu (%lu rejected), eeprom %lu records "
+         "(%lu..%lu, ema %lu cycles), read failures",
+         (unsigned long)m->validations, (unsigned long)m->validation_failures,
+         (unsigned long)m->eeprom_writes, (unsigned long)m->eeprom_write.min,
+         (unsigned long)m->eeprom_write.max, (unsigned long)m->eeprom_write.ema);
+  for (int i = 0; i < CALIB_SENSOR_COUNT; i++) {
+    printf(" %lu", (unsigned long)m->read_failures[i]);
+  }
+  putchar('\n');
+}
+
+/**
+ * @brief Imprimir o início e o fim de cada fase e conferir as dependências
+ *
+ * Espelha os depends da tabela de fases do firmware: o odômetro espera o
+ * IMU e o LiDAR espera a temperatura, também com execução paralela.
+ * @return Número de fases iniciadas antes do fim de uma dependência
+ */
+static int print_schedule(uint32_t mask) {
+  static const struct {
+    CalibrationSensor_t phase;
+    CalibrationSensor_t after;
+  } depends[] = {
+    { CALIB_SENSOR_ODOM, CALIB_SENSOR_IMU },
+    { CALIB_SENSOR_LIDAR, CALIB_SENSOR_TEMP },
+  };
+  const CalibrationMetrics_t *m = get_calibration_metrics();
+  int failures = 0;
+
+  mask &= CALIB_SENSOR_MASK_SKU;
+  printf("\n%-9s %9s %9s\n", "schedule", "start_ms", "end_ms");
+  for (int i = 0; i < CALIB_SENSOR_COUNT; i++) {
+    if (mask & CALIB_SENSOR_BIT(i)) {
+      printf("%-9s %9lu %9lu\n", phase_names[i], (unsigned long)(m->phase_start_ms[i] - trace_origin),
+             (unsigned long)(m->phase_end_ms[i] - trace_origin));
+    }
+  }
+  for (size_t i = 0; i < sizeof(depends) / sizeof(depends[0]); i++) {
+    uint32_t both = CALIB_SENSOR_BIT(depends[i].phase) | CALIB_SENSOR_BIT(depends[i].after);
+    if ((mask & both) != both) {
+      continue;
+    }
+    bool ok = m->phase_start_ms[depends[i].phase] >= m->phase_end_ms[depends[i].after];
+    printf("%s after %s%s\n", phase_names[depends[i].phase], phase_names[depends[i].after],
+           ok ? "" : "  FAIL");
+    failures += ok ? 0 : 1;
+  }
+  return failures;
+}
+
+/**
+ * @brief Comparar a calibração com a verdade do trace
+ * @return Número de campos fora da tolerância
+ */
+static int print_errors(const SensorCalibration_t *calib) {
+  int failures = 0;
+
+  if (truth_count == 0) {
+    return 0;
+  }
+
+  printf("\n%-24s %12s %12s %12s %10s\n", "field", "truth", "estimate", "error", "tolerance");
+  for (size_t i = 0; i < truth_count; i++) {
+    float estimate = field_value(calib, truth[i].field);
+    float error = estimate - truth[i].value;
+    bool ok = truth[i].tolerance < 0.0f || fabsf(error) <= truth[i].tolerance;
+
+    printf("%-24s %12.5g %12.5g %12.5g ", fields[truth[i].field].name, truth[i].value,
+           estimate, error);
+    if (truth[i].tolerance >= 0.0f) {
+      printf("%10.4g%s", truth[i].tolerance, ok ? "" : "  FAIL");
+    }
+    putchar('\n');
+    failures += ok ? 0 : 1;
+  }
+  return failures;
+}
+
+/**
+ * @brief Todos os sensores da máscara terminaram com calibração válida
+ *
+ * O status global só fica válido com todos os sensores calibrados, o que
+ * nunca acontece sem a câmera; por isso o resultado usa os metadados.
+ */
+static bool masked_sensors_valid(uint32_t mask) {
+  for (int i = 0; i < CALIB_SENSOR_COUNT; i++) {
+    if ((mask & CALIB_SENSOR_BIT(i)) &&
+        get_sensor_calibration_meta((CalibrationSensor_t)i)->status != CALIB_VALID) {
+      return false;
+    }
+  }
+  return mask != 0;
+}
+
+#if CALIB_FIXED_POINT
+/**
+ * @brief Aplicar o kernel publicado a um stream em Q16.16
+ * @return Maior erro em LSB contra a forma afim em double, ou -1 se uma
+ *         lane preservada mudar
+ */
+static double fixed_apply_error(BenchStreamId_t id, const CalibrationAffineBlock_t *block) {
+  const BenchStream_t *s = &streams[id];
+  const size_t words = s->count * block->words_per_record;
+  const size_t block_words = (size_t)block->words_per_record * block->records_per_block;
+  int32_t *q = checked_realloc(NULL, words * sizeof(int32_t) + 1);
+  int32_t *y = checked_realloc(NULL, words * sizeof(int32_t) + 1);
+  double worst = 0.0;
+
+  for (size_t i = 0; i < words; i++) {
+    float x;
+    memcpy(&x, s->records + i * 4, 4);
+    if (block->keep[i % block_words]) {
+      memcpy(&q[i], &x, 4);
+    } else {
+      q[i] = calib_q16_from_float(x);
+    }
+  }
+
+  calibration_apply_block_q16(block, q, y, s->count);
+
+  for (size_t i = 0; i < words; i++) {
+    int lane = (int)(i % block_words);
+    if (block->keep[lane]) {
+      if (y[i] != q[i]) {
+        worst = -1.0;
+        break;
+      }
+      continue;
+    }
+    double exact = (double)block->gain[lane] * q[i] + 65536.0 * block->offset[lane];
+    worst = fmax(worst, fabs(y[i] - exact));
+  }
+
+  free(q);
+  free(y);
+  return worst;
+}
+
+/**
+ * @brief Conferir o build em ponto fixo contra a aritmética exata
+ *
+ * Kernels: cada stream do trace é corrigido em Q16.16 pelo kernel
+ * publicado. Estatísticas: cada eixo do IMU é acumulado inteiro e em duas
+ * metades combinadas (merge), contra média/variância em double das mesmas
+ * amostras em Q16.16.
+ * @return Número de limites violados
+ */
+static int fixed_point_check(void) {
+  static CalibrationApplyKernel_t kernel;
+  const struct {
+    BenchStreamId_t id;
+    const CalibrationAffineBlock_t *block;
+  } targets[] = {
+    { STREAM_IMU, &kernel.imu }, { STREAM_MAG, &kernel.mag },
+    { STREAM_LIDAR, &kernel.lidar }, { STREAM_BATTERY, &kernel.battery },
+    { STREAM_TEMP, &kernel.temp },
+  };
+  int failures = 0;
+
+  calibration_apply_read(&kernel);
+  printf("\n%-18s %15s %14s\n", "fixed point", "max error", "bound");
+  for (size_t t = 0; t < sizeof(targets) / sizeof(targets[0]); t++) {
+    if (streams[targets[t].id].count == 0) {
+      continue;
+    }
+    double error = fixed_apply_error(targets[t].id, targets[t].block);
+    bool ok = error >= 0.0 && error <= CALIB_FIXED_APPLY_BOUND_LSB;
+    printf("apply %-12s %11.3f LSB %10d LSB%s\n", stream_names[targets[t].id], error,
+           CALIB_FIXED_APPLY_BOUND_LSB, ok ? "" : "  FAIL");
+    failures += ok ? 0 : 1;
+  }
+
+  const BenchStream_t *imu = &streams[STREAM_IMU];
+  double mean_error = 0.0, mean_bound = 0.0, var_error = 0.0, var_bound = 0.0;
+  bool merge_ok = true;
+
+  for (int axis = 0; axis < 6; axis++) {
+    CalibrationStats_t whole, first, second;
+    double sum = 0.0, sum2 = 0.0;
+    calib_q16_t origin = 0;
+
+    calibration_stats_reset(&whole);
+    calibration_stats_reset(&first);
+    calibration_stats_reset(&second);
+    for (size_t i = 0; i < imu->count; i++) {
+      const IMUData_t *d = (const IMUData_t *)(imu->records + i * imu->elem_size);
+      const float *v = &d->ax;
+      calib_q16_t q = calib_q16_from_float(v[axis]);
+
+      calibration_stats_push_q16(&whole, q);
+      calibration_stats_push_q16(i < imu->count / 2 ? &first : &second, q);
+      origin = (i == 0) ? q : origin;
+      sum += q;
+      sum2 += (double)q * q;
+    }
+    if (imu->count < 2) {
+      break;
+    }
+
+    double n = (double)imu->count;
+    double mean = sum / n;
+    double var = (sum2 / n - mean * mean) / 65536.0 / 65536.0;
+    double mean_limit = CALIB_FIXED_MEAN_BOUND_LSB + fabs(mean) * FLT_EPSILON;
+    double var_limit = fabs(mean - origin) / 65536.0 / 131072.0 + ldexp(1.0, -32) +
+                       var * FLT_EPSILON;
+
+    double e = fabs(calibration_stats_mean(&whole) * 65536.0 - mean);
+    if (e / mean_limit > mean_error / fmax(mean_bound, DBL_MIN)) {
+      mean_error = e;
+      mean_bound = mean_limit;
+    }
+    e = fabs(calibration_stats_variance(&whole) - var);
+    if (e / var_limit > var_error / fmax(var_bound, DBL_MIN)) {
+      var_error = e;
+      var_bound = var_limit;
+    }
+
+    calibration_stats_merge(&first, &second);
+    merge_ok &= calibration_stats_mean(&first) == calibration_stats_mean(&whole) &&
+                calibration_stats_variance(&first) == calibration_stats_variance(&whole);
+  }
+
+  if (imu->count >= 2) {
+    bool mean_ok = mean_error <= mean_bound;
+    bool var_ok = var_error <= var_bound;
+    printf("%-18s %11.3f LSB %10.3f LSB%s\n", "stats mean (imu)", mean_error, mean_bound,
+           mean_ok ? "" : "  FAIL");
+    printf("%-18s %15.3g %14.3g%s\n", "stats variance", var_error, var_bound,
+           var_ok ? "" : "  FAIL");
+    printf("%-18s %15s%s\n", "stats merge", merge_ok ? "exact" : "differs", merge_ok ? "" : "  FAIL");
+    failures += (mean_ok ? 0 : 1) + (var_ok ? 0 : 1) + (merge_ok ? 0 : 1);
+  }
+  return failures;
+}
+#endif
+
+/**
+ * @brief Imprimir a RAM por subsistema do build (ver calibration_footprint.h)
+ *
+ * Os tamanhos são os do host: ponteiros e alinhamento mudam no alvo.
+ */
+static void print_footprint(void) {
+  size_t count;
+  const CalibrationFootprintEntry_t *entries = calibration_footprint_table(&count);
+
+  printf("\n%-26s %8s  %s\n", "ram footprint", "bytes", CALIB_PHASE_ARENA ? "(phase arena)" : "");
+  for (size_t i = 0; i < count; i++) {
+    printf("%-26s %8lu  %s\n", entries[i].name, (unsigned long)entries[i].bytes,
+           entries[i].scope == CALIB_FOOTPRINT_STATIC ? "static" : "");
+  }
+  printf("%-26s %8lu\n%-26s %8lu\n", "per instance",
+         (unsigned long)calibration_footprint_total(CALIB_FOOTPRINT_INSTANCE), "static",
+         (unsigned long)calibration_footprint_total(CALIB_FOOTPRINT_STATIC));
+}
+
+/**
+ * @brief Repetir a sequência sem execução paralela e comparar a duração
+ *
+ * A passada sequencial parte da calibração da paralela; as fases têm
+ * contagens fixas, então a diferença de tempo virtual é a do escalonamento.
+ * @param parallel_ms Duração virtual da passada paralela
+ * @return Número de falhas
+ */
+static int sequential_check(uint32_t mask, uint32_t tick_ms, uint32_t parallel_ms) {
+  rewind_trace();
+  set_calibration_parallel(false);
+  bool finished = run_sequence(mask, tick_ms);
+  uint32_t sequential_ms = get_time_ms() - trace_origin;
+  bool valid = finished && masked_sensors_valid(mask);
+  set_calibration_parallel(true);
+
+  printf("\n%-24s %12s %12s\n", "parallel phases", "virt_ms", "result");
+  printf("%-24s %12lu %12s\n", "parallel", (unsigned long)parallel_ms, "VALID");
+  printf("%-24s %12lu %12s%s\n", "sequential", (unsigned long)sequential_ms,
+         !finished ? "TIMEOUT" : (valid ? "VALID" : "INVALID"), valid ? "" : "  FAIL");
+  printf("%-24s %12ld %11.1f%%\n", "saved", (long)sequential_ms - (long)parallel_ms,
+         sequential_ms > 0 ? 100.0 * ((double)sequential_ms - parallel_ms) / sequential_ms : 0.0);
+  return valid ? 0 : 1;
+}
+
+/**
+ * @brief Amostras novas consumidas por uma fase, em todos os streams
+ */
+static uint32_t phase_samples(const BenchPhaseStats_t *p) {
+  uint32_t total = 0;
+
+  for (int id = 0; id < STREAM_COUNT; id++) {
+    total += p->fresh[id];
+  }
+  return total;
+}
+
+/**
+ * @brief Repetir a sequência com contagens fixas e comparar as amostras
+ *
+ * As estimativas da passada adaptativa já foram conferidas contra a
+ * verdade do trace; stats[] passa a ter só a passada fixa.
+ * @param adaptive Custos da passada adaptativa, por fase
+ * @return Número de falhas
+ */
+static int adaptive_check(uint32_t mask, uint32_t tick_ms, const BenchPhaseStats_t *adaptive) {
+  memset(stats, 0, sizeof(stats));
+  rewind_trace();
+  set_calibration_adaptive(false);
+  bool finished = run_sequence(mask, tick_ms);
+  bool valid = finished && masked_sensors_valid(mask);
+  set_calibration_adaptive(true);
+
+  printf("\n%-9s %9s %9s %9s %9s\n", "adaptive", "samples", "fixed", "virt_ms", "fixed");
+  for (int i = 0; i < BENCH_PHASE_FINALIZE; i++) {
+    uint32_t samples = phase_samples(&adaptive[i]);
+    uint32_t fixed_samples = phase_samples(&stats[i]);
+    if (samples == 0 && fixed_samples == 0) {
+      continue;
+    }
+    printf("%-9s %9lu %9lu %9lu %9lu\n", phase_names[i], (unsigned long)samples,
+           (unsigned long)fixed_samples, (unsigned long)adaptive[i].virtual_ms,
+           (unsigned long)stats[i].virtual_ms);
+  }
+  if (!valid) {
+    printf("fixed-count run %s  FAIL\n", finished ? "INVALID" : "TIMEOUT");
+  }
+  return valid ? 0 : 1;
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr, "usage: %s [-v] [-p] [-a] [-t tick_ms] [-m mask] [-s seed] [-w out.csv] [trace.csv]\n",
+          argv0);
+}
+
+int main(int argc, char **argv) {
+  const char *trace_path = NULL;
+  const char *write_path = NULL;
+  uint32_t tick_ms = 1;
+  uint32_t seed = 1;
+  uint32_t mask = 0;
+  bool mask_given = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-v") == 0) {
+      verbose = true;
+    } else if (strcmp(argv[i], "-p") == 0) {
+      parallel_phases = true;
+    } else if (strcmp(argv[i], "-a") == 0) {
+      adaptive_sampling = true;
+    } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+      tick_ms = (uint32_t)strtoul(argv[++i], NULL, 0);
+    } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+      mask = (uint32_t)strtoul(argv[++i], NULL, 0);
+      mask_given = true;
+    } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+      seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+    } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+      write_path = argv[++i];
+    } else if (argv[i][0] != '-' && trace_path == NULL) {
+      trace_path = argv[i];
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (tick_ms == 0) {
+    tick_ms = 1;
+  }
+#if CALIB_PARALLEL_THREADS
+  main_thread = pthread_self();
+  pthread_key_create(&worker_key, worker_exit);
+#endif
+
+  stream_init(&streams[STREAM_IMU], sizeof(IMUData_t));
+  stream_init(&streams[STREAM_MAG], sizeof(MagData_t));
+  stream_init(&streams[STREAM_LIDAR], sizeof(LiDARData_t));
+  stream_init(&streams[STREAM_SCAN], sizeof(BenchScan_t));
+  stream_init(&streams[STREAM_BATTERY], sizeof(BatteryData_t));
+  stream_init(&streams[STREAM_TEMP], sizeof(TemperatureData_t));
+  stream_init(&streams[STREAM_MOVE], sizeof(BenchMove_t));
+
+  if (trace_path != NULL) {
+    if (!load_trace(trace_path)) {
+      return 2;
+    }
+    rebase_trace();
+  } else {
+    synthesize_trace(seed);
+  }
+
+  if (write_path != NULL && !write_trace(write_path)) {
+    return 2;
+  }
+
+  if (!mask_given) {
+    mask = mask_from_trace();
+  }
+  memset(eeprom, 0xFF, sizeof(eeprom));
+
+  uint64_t host_start = host_time_ns();
+  bool finished = replay(mask, tick_ms);
+  double host_ms = (host_time_ns() - host_start) / 1e6;
+  uint32_t run_ms = get_time_ms() - trace_origin;
+  if (parallel_phases && !is_calibration_parallel()) {
+    fprintf(stderr, "parallel calibration unavailable in this build (CALIB_PHASE_ARENA)\n");
+    return 2;
+  }
+
+  static BenchPhaseStats_t run_stats[BENCH_PHASES];
+  memcpy(run_stats, stats, sizeof(run_stats));
+
+  const SensorCalibration_t *calib = get_calibration_data();
+  print_report(host_ms);
+  int failures = print_schedule(mask);
+  failures += print_errors(calib);
+  print_footprint();
+  if (finished && (mask & CALIB_SENSOR_BIT(CALIB_SENSOR_ODOM)) && masked_sensors_valid(mask)) {
+    failures += rollback_check(mask, tick_ms);
+  }
+  if (adaptive_sampling && finished && masked_sensors_valid(mask)) {
+    failures += adaptive_check(mask, tick_ms, run_stats);
+  }
+  if (parallel_phases && finished && masked_sensors_valid(mask)) {
+    failures += sequential_check(mask, tick_ms, run_ms);
+  }
+#if CALIB_FIXED_POINT
+  failures += fixed_point_check();
+#endif
+
+  bool valid = finished && masked_sensors_valid(mask);
+  printf("\nresult: %s (mask 0x%02lx)\n",
+         !finished ? "TIMEOUT" : (valid ? "VALID" : "INVALID"), (unsigned long)mask);
+
+  return (valid && failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,15 @@
+/**
+ * @file eeprom.h
+ * @brief EEPROM do host para o benchmark (memória, ver calibration_bench.c)
+ */
+
+#ifndef EEPROM_H
+#define EEPROM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+void eeprom_write(uint32_t addr, const uint8_t *data, size_t len);
+void eeprom_read(uint32_t addr, uint8_t *data, size_t len);
+
+#endif // EEPROM_H
@@ -0,0 +1,13 @@
+/**
+ * @file logger.h
+ * @brief Log do host para o benchmark (stderr com -v, ver calibration_bench.c)
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+void log_info(const char *fmt, ...);
+void log_warning(const char *fmt, ...);
+void log_error(const char *fmt, ...);
+
+#endif // LOGGER_H
@@ -0,0 +1,246 @@
+/**
+ * @file calibration_align.c
+ * @brief Alinhamento temporal de streams: rings SPSC e interpolação em µs
+ * @version 1.0.0
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include "calibration_align.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define CALIB_STATIC_ASSERT(cond, name) typedef char name[(cond) ? 1 : -1]
+
+CALIB_STATIC_ASSERT(CALIB_ALIGN_CHANNELS <= 8, align_channel_masks_are_8_bits);
+CALIB_STATIC_ASSERT(sizeof(float) == sizeof(uint32_t), align_floats_are_words);
+
+#define ALIGN_PI 3.14159265f
+
+// Ordena a escrita da amostra antes da publicação do índice
+#if defined(__GNUC__)
+#define ALIGN_BARRIER() __sync_synchronize()
+#else
+#define ALIGN_BARRIER()
+#endif
+
+// ============================================================================
+// UTILITÁRIOS INTERNOS
+// ============================================================================
+
+/**
+ * @brief Amostra k posições depois de tail
+ */
+static const CalibrationAlignSample_t *sample_at(const CalibrationAlignRing_t *ring,
+                                                 uint32_t tail, uint32_t k) {
+  return &ring->samples[(tail + k) & ring->mask];
+}
+
+/**
+ * @brief Ângulo em (-π, π]
+ */
+static float wrap_angle(float a) {
+  while (a > ALIGN_PI) {
+    a -= 2.0f * ALIGN_PI;
+  }
+  while (a <= -ALIGN_PI) {
+    a += 2.0f * ALIGN_PI;
+  }
+  return a;
+}
+
+/**
+ * @brief Interpolar as palavras de a e b na fração frac do intervalo
+ */
+static void interpolate(const CalibrationAlignRing_t *ring, const CalibrationAlignSample_t *a,
+                        const CalibrationAlignSample_t *b, float frac, uint32_t *words) {
+  for (int i = 0; i < ring->channels; i++) {
+    uint8_t bit = (uint8_t)(1u << i);
+
+    if (ring->hold_mask & bit) {
+      words[i] = a->word[i];
+    } else if (ring->counter_mask & bit) {
+      float delta = (float)(int32_t)(b->word[i] - a->word[i]) * frac;
+      words[i] = a->word[i] + (uint32_t)(int32_t)floorf(delta + 0.5f);
+    } else {
+      float va = calibration_align_float(a->word[i]);
+      float delta = calibration_align_float(b->word[i]) - va;
+      if (ring->angle_mask & bit) {
+        words[i] = calibration_align_word(wrap_angle(va + frac * wrap_angle(delta)));
+      } else {
+        words[i] = calibration_align_word(va + frac * delta);
+      }
+    }
+  }
+}
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Inicializar um ring vazio
+ */
+void calibration_align_init(CalibrationAlignRing_t *ring, CalibrationAlignSample_t *storage,
+                            uint32_t capacity, uint8_t channels, uint8_t angle_mask,
+                            uint8_t counter_mask, uint8_t hold_mask) {
+  ring->samples = storage;
+  ring->mask = capacity - 1;
+  ring->head = 0;
+  ring->tail = 0;
+  ring->dropped = 0;
+  ring->channels = (channels <= CALIB_ALIGN_CHANNELS) ? channels : CALIB_ALIGN_CHANNELS;
+  ring->angle_mask = angle_mask;
+  ring->counter_mask = counter_mask;
+  ring->hold_mask = hold_mask;
+}
+
+/**
+ * @brief Inserir uma amostra (produtor)
+ *
+ * Só o produtor escreve head e as amostras; a amostra mais nova nunca é
+ * descartada pelo consumidor (release mantém o extremo inferior), então
+ * a comparação de ordem lê um registro estável.
+ */
+bool calibration_align_push(CalibrationAlignRing_t *ring, uint64_t t_us, const uint32_t *words) {
+  uint32_t head = ring->head;
+
+  if (head - ring->tail > ring->mask ||
+      (head != 0 && t_us < ring->samples[(head - 1) & ring->mask].t_us)) {
+    ring->dropped++;
+    return false;
+  }
+
+  CalibrationAlignSample_t *s = &ring->samples[head & ring->mask];
+  s->t_us = t_us;
+  memcpy(s->word, words, ring->channels * sizeof(uint32_t));
+
+  ALIGN_BARRIER();
+  ring->head = head + 1;
+  return true;
+}
+
+/**
+ * @brief Número de amostras pendentes
+ */
+size_t calibration_align_count(const CalibrationAlignRing_t *ring) {
+  return (size_t)(ring->head - ring->tail);
+}
+
+/**
+ * @brief Copiar a k-ésima amostra pendente
+ */
+bool calibration_align_get(const CalibrationAlignRing_t *ring, size_t k,
+                           CalibrationAlignSample_t *sample) {
+  uint32_t tail = ring->tail;
+
+  if (k >= (size_t)(ring->head - tail)) {
+    return false;
+  }
+  ALIGN_BARRIER();
+  *sample = *sample_at(ring, tail, (uint32_t)k);
+  return true;
+}
+
+/**
+ * @brief Descartar a amostra mais antiga
+ */
+void calibration_align_pop(CalibrationAlignRing_t *ring) {
+  uint32_t tail = ring->tail;
+
+  if (tail != ring->head) {
+    ALIGN_BARRIER();
+    ring->tail = tail + 1;
+  }
+}
+
+/**
+ * @brief Descartar as amostras que não servem a consultas em t_us ou depois
+ */
+uint32_t calibration_align_release(CalibrationAlignRing_t *ring, uint64_t t_us) {
+  uint32_t start = ring->tail;
+  uint32_t head = ring->head;
+  uint32_t tail = start;
+
+  ALIGN_BARRIER();
+  while (head - tail >= 2 && sample_at(ring, tail, 1)->t_us <= t_us) {
+    tail++;
+  }
+  ALIGN_BARRIER();
+  ring->tail = tail;
+  return tail - start;
+}
+
+/**
+ * @brief Valores do stream num instante
+ *
+ * Busca binária pela última amostra com timestamp <= t_us.
+ */
+CalibrationAlignResult_t calibration_align_at(const CalibrationAlignRing_t *ring, uint64_t t_us,
+                                              uint32_t max_gap_us, uint32_t *words) {
+  uint32_t tail = ring->tail;
+  uint32_t count = ring->head - tail;
+
+  if (count == 0) {
+    return CALIB_ALIGN_PENDING;
+  }
+  ALIGN_BARRIER();
+
+  if (t_us < sample_at(ring, tail, 0)->t_us) {
+    return CALIB_ALIGN_MISSED;
+  }
+  if (t_us > sample_at(ring, tail, count - 1)->t_us) {
+    return CALIB_ALIGN_PENDING;
+  }
+
+  uint32_t lo = 0;
+  uint32_t hi = count - 1;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo + 1) / 2;
+    if (sample_at(ring, tail, mid)->t_us <= t_us) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+
+  const CalibrationAlignSample_t *a = sample_at(ring, tail, lo);
+  if (a->t_us == t_us) {
+    memcpy(words, a->word, ring->channels * sizeof(uint32_t));
+    return CALIB_ALIGN_OK;
+  }
+
+  const CalibrationAlignSample_t *b = sample_at(ring, tail, lo + 1);
+  uint64_t span = b->t_us - a->t_us;
+  if (span > max_gap_us) {
+    return CALIB_ALIGN_MISSED;
+  }
+
+  interpolate(ring, a, b, (float)(uint32_t)(t_us - a->t_us) / (float)(uint32_t)span, words);
+  return CALIB_ALIGN_OK;
+}
+
+/**
+ * @brief Guardar um float numa palavra
+ */
+uint32_t calibration_align_word(float value) {
+  uint32_t word;
+
+  memcpy(&word, &value, sizeof(word));
+  return word;
+}
+
+/**
+ * @brief Ler um float de uma palavra
+ */
+float calibration_align_float(uint32_t word) {
+  float value;
+
+  memcpy(&value, &word, sizeof(value));
+  return value;
+}
@@ -0,0 +1,170 @@
+/**
+ * @file calibration_align.h
+ * @brief Alinhamento temporal de streams: rings SPSC e interpolação em µs
+ * @version 1.0.0
+ *
+ * Cada stream (encoders, pose, ...) é um ring sem lock com um produtor
+ * (ISR ou thread do driver) e um consumidor (a thread de
+ * calibration_update()). As amostras são palavras de 32 bits, como nos
+ * kernels de calibration_apply.h, com um timestamp em µs; cada palavra é
+ * interpolada conforme o seu tipo:
+ *
+ * - float (padrão): linear;
+ * - ângulo (angle_mask): float pelo menor arco, em (-π, π];
+ * - contador (counter_mask): uint32 em aritmética modular, arredondado;
+ * - retenção (hold_mask): copiada da amostra anterior (ex.: timestamp ms).
+ *
+ * Os timestamps são a base de tempo em µs da instância
+ * (get_calibration_time_us()), em 64 bits: não dão a volta durante a
+ * vida do robô, e as comparações são diretas.
+ *
+ * Consultas (calibration_align_at) fazem busca binária entre as amostras
+ * pendentes; calibration_align_release() descarta as que nenhuma
+ * consulta futura vai usar. Só o consumidor consulta ou descarta.
+ */
+
+#ifndef CALIBRATION_ALIGN_H
+#define CALIBRATION_ALIGN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#ifndef CALIB_ALIGN_CHANNELS
+#define CALIB_ALIGN_CHANNELS 4   ///< Palavras por amostra (pose: x, y, θ, timestamp)
+#endif
+
+// ============================================================================
+// ENUMERAÇÕES
+// ============================================================================
+
+/**
+ * @enum CalibrationAlignResult_t
+ * @brief Resultado de uma consulta
+ */
+typedef enum {
+  CALIB_ALIGN_OK = 0,       ///< Instante entre duas amostras (ou sobre uma)
+  CALIB_ALIGN_PENDING = 1,  ///< Instante depois da amostra mais nova: tentar de novo
+  CALIB_ALIGN_MISSED = 2    ///< Antes da mais antiga, ou intervalo maior que max_gap_us
+} CalibrationAlignResult_t;
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+/**
+ * @struct CalibrationAlignSample_t
+ * @brief Amostra de um stream
+ */
+typedef struct {
+  uint64_t t_us;                          ///< Timestamp (µs)
+  uint32_t word[CALIB_ALIGN_CHANNELS];    ///< Valores (float pelo padrão de bits, ou uint32)
+} CalibrationAlignSample_t;
+
+/**
+ * @struct CalibrationAlignRing_t
+ * @brief Ring SPSC de amostras em ordem de tempo (armazenamento externo)
+ */
+typedef struct {
+  CalibrationAlignSample_t *samples;  ///< Armazenamento (capacity amostras)
+  uint32_t mask;                      ///< capacity - 1 (potência de 2)
+  volatile uint32_t head;             ///< Amostras escritas (produtor)
+  volatile uint32_t tail;             ///< Amostras descartadas (consumidor)
+  volatile uint32_t dropped;          ///< Rejeitadas: ring cheio ou fora de ordem
+  uint8_t channels;                   ///< Palavras usadas por amostra
+  uint8_t angle_mask;                 ///< Bit i: palavra i é ângulo (rad)
+  uint8_t counter_mask;               ///< Bit i: palavra i é contador uint32
+  uint8_t hold_mask;                  ///< Bit i: palavra i não é interpolada
+} CalibrationAlignRing_t;
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Inicializar um ring vazio
+ * @param ring Ring
+ * @param storage Armazenamento de capacity amostras
+ * @param capacity Capacidade (potência de 2)
+ * @param channels Palavras por amostra (até CALIB_ALIGN_CHANNELS)
+ * @param angle_mask Palavras angulares
+ * @param counter_mask Palavras que são contadores
+ * @param hold_mask Palavras retidas da amostra anterior
+ */
+void calibration_align_init(CalibrationAlignRing_t *ring, CalibrationAlignSample_t *storage,
+                            uint32_t capacity, uint8_t channels, uint8_t angle_mask,
+                            uint8_t counter_mask, uint8_t hold_mask);
+
+/**
+ * @brief Inserir uma amostra (produtor, custo fixo)
+ * @param ring Ring
+ * @param t_us Timestamp (µs); não pode ser anterior ao da amostra mais nova
+ * @param words channels palavras
+ * @return false se o ring estiver cheio ou a amostra fora de ordem (descartada)
+ */
+bool calibration_align_push(CalibrationAlignRing_t *ring, uint64_t t_us, const uint32_t *words);
+
+/**
+ * @brief Número de amostras pendentes
+ * @param ring Ring
+ * @return Amostras entre tail e head
+ */
+size_t calibration_align_count(const CalibrationAlignRing_t *ring);
+
+/**
+ * @brief Copiar a k-ésima amostra pendente (0 = mais antiga)
+ * @param ring Ring
+ * @param k Índice
+ * @param sample Destino
+ * @return false se k >= calibration_align_count()
+ */
+bool calibration_align_get(const CalibrationAlignRing_t *ring, size_t k,
+                           CalibrationAlignSample_t *sample);
+
+/**
+ * @brief Descartar a amostra mais antiga
+ * @param ring Ring
+ */
+void calibration_align_pop(CalibrationAlignRing_t *ring);
+
+/**
+ * @brief Descartar as amostras que não servem a consultas em t_us ou depois
+ *
+ * Mantém a última amostra com timestamp <= t_us (extremo inferior da
+ * próxima interpolação).
+ * @param ring Ring
+ * @param t_us Instante (µs)
+ * @return Amostras descartadas
+ */
+uint32_t calibration_align_release(CalibrationAlignRing_t *ring, uint64_t t_us);
+
+/**
+ * @brief Valores do stream num instante
+ * @param ring Ring
+ * @param t_us Instante (µs)
+ * @param max_gap_us Maior intervalo entre as duas amostras interpoladas
+ * @param words Destino (channels palavras; só escrito com CALIB_ALIGN_OK)
+ * @return CALIB_ALIGN_OK, CALIB_ALIGN_PENDING ou CALIB_ALIGN_MISSED
+ */
+CalibrationAlignResult_t calibration_align_at(const CalibrationAlignRing_t *ring, uint64_t t_us,
+                                              uint32_t max_gap_us, uint32_t *words);
+
+/**
+ * @brief Guardar um float numa palavra
+ * @param value Valor
+ * @return Padrão de bits IEEE 754
+ */
+uint32_t calibration_align_word(float value);
+
+/**
+ * @brief Ler um float de uma palavra
+ * @param word Padrão de bits IEEE 754
+ * @return Valor
+ */
+float calibration_align_float(uint32_t word);
+
+#endif // CALIBRATION_ALIGN_H
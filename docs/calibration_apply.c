@@ -0,0 +1,692 @@
+/**
+ * @file calibration_apply.c
+ * @brief Aplicação da calibração em lote sobre amostras dos sensores
+ * @version 1.0.0
+ *
+ * Os registros de sensores (IMUData_t, MagData_t, ...) são sequências de
+ * palavras de 32 bits. Cada sensor tem um bloco de mmc(palavras, 4)
+ * palavras com gain/offset por lane, de modo que um bloco corresponde a
+ * um número inteiro de registros e de vetores SIMD de 4 lanes.
+ *
+ * O kernel padrão de apply_*_batch() é publicado como a calibração em
+ * calibration_snapshot.c: duas cópias e uma sequência, e cada lote copia
+ * o bloco do seu sensor de uma única publicação antes de processar.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "calibration_apply.h"
+
+// O build em ponto fixo é para placas sem FPU: sem caminho SIMD em float
+#if CALIB_FIXED_POINT
+#elif !defined(CALIB_APPLY_FORCE_SCALAR) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define CALIB_APPLY_NEON 1
+#elif !defined(CALIB_APPLY_FORCE_SCALAR) && (defined(__SSE2__) || defined(_M_X64))
+#include <emmintrin.h>
+#define CALIB_APPLY_SSE 1
+#endif
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define CALIB_STATIC_ASSERT(cond, name) typedef char name[(cond) ? 1 : -1]
+
+// Os kernels dependem de registros sem padding
+CALIB_STATIC_ASSERT(sizeof(IMUData_t) == 7 * 4, imu_data_is_7_words);
+CALIB_STATIC_ASSERT(sizeof(MagData_t) == 4 * 4, mag_data_is_4_words);
+CALIB_STATIC_ASSERT(sizeof(LiDARData_t) == 3 * 4, lidar_data_is_3_words);
+CALIB_STATIC_ASSERT(sizeof(BatteryData_t) == 4 * 4, battery_data_is_4_words);
+
+// TemperatureData_t: temperature, timestamp, channel[], channel_count
+#define TEMP_WORDS (CALIB_TEMP_CHANNELS + 2)
+#define TEMP_BLOCK_WORDS \
+  ((TEMP_WORDS % 4 == 0) ? TEMP_WORDS : (TEMP_WORDS % 2 == 0) ? 2 * TEMP_WORDS : 4 * TEMP_WORDS)
+
+CALIB_STATIC_ASSERT(sizeof(TemperatureData_t) == TEMP_WORDS * 4, temp_data_is_channels_plus_2_words);
+CALIB_STATIC_ASSERT(TEMP_BLOCK_WORDS <= CALIB_APPLY_BLOCK_WORDS, temp_channels_fit_simd_block);
+
+#define LANE_KEEP 0xFFFFFFFFu
+
+// Kernel de passagem: todas as lanes copiadas (equivale à calibração padrão)
+CALIB_STATIC_ASSERT(CALIB_APPLY_BLOCK_WORDS == 7 * 4, passthrough_keep_covers_block);
+
+#define KEEP_4 LANE_KEEP, LANE_KEEP, LANE_KEEP, LANE_KEEP
+#define PASSTHROUGH_BLOCK(words, records) \
+  { .keep = { KEEP_4, KEEP_4, KEEP_4, KEEP_4, KEEP_4, KEEP_4, KEEP_4 }, \
+    .words_per_record = (words), .records_per_block = (records) }
+#define PASSTHROUGH_KERNEL \
+  { .imu = PASSTHROUGH_BLOCK(7, 4), .mag = PASSTHROUGH_BLOCK(4, 1), \
+    .lidar = PASSTHROUGH_BLOCK(3, 4), .battery = PASSTHROUGH_BLOCK(4, 1), \
+    .temp = PASSTHROUGH_BLOCK(TEMP_WORDS, TEMP_BLOCK_WORDS / TEMP_WORDS) }
+
+// Mesma barreira de calibration_snapshot.c
+#define LATCH_BARRIER() __sync_synchronize()
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+/**
+ * @struct KernelLatch_t
+ * @brief Kernel padrão em duas cópias (seqlock em latch, ver calibration_snapshot.h)
+ *
+ * Leitores usam copy[sequence & 1]; o escritor só grava a outra.
+ */
+typedef struct {
+  volatile uint32_t sequence;
+  CalibrationApplyKernel_t copy[2];
+} KernelLatch_t;
+
+/**
+ * @struct MagKernel_t
+ * @brief Correção do magnetômetro lida de uma única publicação
+ */
+typedef struct {
+  CalibrationAffineBlock_t block;  ///< Modelo min/max
+  float matrix[3][3];              ///< Soft-iron completa
+  float center[3];                 ///< Hard-iron
+  bool use_matrix;                 ///< true: usar matrix/center
+} MagKernel_t;
+
+// ============================================================================
+// VARIÁVEIS GLOBAIS
+// ============================================================================
+
+static KernelLatch_t default_kernel = {
+  .sequence = 0,
+  .copy = { PASSTHROUGH_KERNEL, PASSTHROUGH_KERNEL },
+};
+
+// ============================================================================
+// PREPARAÇÃO DOS COEFICIENTES
+// ============================================================================
+
+/**
+ * @brief Inicializar bloco com lanes identidade
+ */
+static void block_init(CalibrationAffineBlock_t *block, uint8_t words_per_record) {
+  uint8_t records = 1;
+
+  // Menor número de registros cujo total de palavras é múltiplo de 4
+  while ((records * words_per_record) % 4 != 0) {
+    records++;
+  }
+
+  memset(block, 0, sizeof(*block));
+  block->words_per_record = words_per_record;
+  block->records_per_block = records;
+
+  for (int i = 0; i < CALIB_APPLY_BLOCK_WORDS; i++) {
+    block->gain[i] = 1.0f;
+  }
+}
+
+/**
+ * @brief Gravar gain/offset de uma lane (e a forma em ponto fixo)
+ */
+static void block_store_lane(CalibrationAffineBlock_t *block, int lane, float gain, float offset) {
+  block->gain[lane] = gain;
+  block->offset[lane] = offset;
+#if CALIB_FIXED_POINT
+  block->gain_q31[lane] = calib_q31_from_float(gain - 1.0f);
+  block->offset_q16[lane] = calib_q16_from_float(offset);
+#endif
+}
+
+/**
+ * @brief Definir lane de um campo em todos os registros do bloco
+ */
+static void block_set_lane(CalibrationAffineBlock_t *block, uint8_t word,
+                           float gain, float offset) {
+  for (int r = 0; r < block->records_per_block; r++) {
+    int lane = r * block->words_per_record + word;
+    block_store_lane(block, lane, gain, offset);
+    block->keep[lane] = 0;
+  }
+}
+
+/**
+ * @brief Marcar lane como cópia direta (ex.: timestamp)
+ */
+static void block_keep_lane(CalibrationAffineBlock_t *block, uint8_t word) {
+  for (int r = 0; r < block->records_per_block; r++) {
+    int lane = r * block->words_per_record + word;
+    // gain = offset = 0 para que a lane mascarada resulte em +0.0
+    block_store_lane(block, lane, 0.0f, 0.0f);
+    block->keep[lane] = LANE_KEEP;
+  }
+}
+
+/**
+ * @brief Pré-calcular coeficientes fundidos a partir da calibração
+ *
+ * IMU/Magnetômetro: (raw - bias) * scale = scale * raw + (-scale * bias)
+ * LiDAR/Bateria:    raw * scale + offset
+ */
+void calibration_apply_prepare(CalibrationApplyKernel_t *kernel,
+                               const SensorCalibration_t *calib) {
+  // IMU: ax, ay, az, gx, gy, gz, timestamp
+  block_init(&kernel->imu, 7);
+  block_set_lane(&kernel->imu, 0, calib->imu_scale_x, -calib->imu_scale_x * calib->imu_bias_x);
+  block_set_lane(&kernel->imu, 1, calib->imu_scale_y, -calib->imu_scale_y * calib->imu_bias_y);
+  block_set_lane(&kernel->imu, 2, calib->imu_scale_z, -calib->imu_scale_z * calib->imu_bias_z);
+  block_set_lane(&kernel->imu, 3, 1.0f, 0.0f);
+  block_set_lane(&kernel->imu, 4, 1.0f, 0.0f);
+  block_set_lane(&kernel->imu, 5, 1.0f, 0.0f);
+  block_keep_lane(&kernel->imu, 6);
+
+  // Magnetômetro: mx, my, mz, timestamp
+  block_init(&kernel->mag, 4);
+  block_set_lane(&kernel->mag, 0, calib->mag_scale_x, -calib->mag_scale_x * calib->mag_offset_x);
+  block_set_lane(&kernel->mag, 1, calib->mag_scale_y, -calib->mag_scale_y * calib->mag_offset_y);
+  block_set_lane(&kernel->mag, 2, calib->mag_scale_z, -calib->mag_scale_z * calib->mag_offset_z);
+  block_keep_lane(&kernel->mag, 3);
+
+  // LiDAR: distance, angle, timestamp
+  block_init(&kernel->lidar, 3);
+  block_set_lane(&kernel->lidar, 0, 1.0f, calib->lidar_offset_distance);
+  block_set_lane(&kernel->lidar, 1, 1.0f, calib->lidar_angle_offset);
+  block_keep_lane(&kernel->lidar, 2);
+
+  // Bateria: voltage, current, percentage, timestamp
+  block_init(&kernel->battery, 4);
+  block_set_lane(&kernel->battery, 0, calib->battery_voltage_scale,
+                 calib->battery_voltage_offset);
+  block_keep_lane(&kernel->battery, 1);
+  block_keep_lane(&kernel->battery, 2);
+  block_keep_lane(&kernel->battery, 3);
+
+  // Temperatura: canais identidade até calibration_apply_prepare_thermal()
+  block_init(&kernel->temp, TEMP_WORDS);
+  block_keep_lane(&kernel->temp, 1);
+  block_keep_lane(&kernel->temp, TEMP_WORDS - 1);
+
+  // Modelo min/max por padrão; a matriz vem de calibration_apply_prepare_ext()
+  kernel->mag_use_matrix = false;
+
+  kernel->calibration_count = calib->calibration_count;
+}
+
+/**
+ * @brief Sobrepor ao kernel a correção do magnetômetro das extensões
+ */
+void calibration_apply_prepare_ext(CalibrationApplyKernel_t *kernel,
+                                   const SensorCalibrationExt_t *ext) {
+  for (int i = 0; i < 3; i++) {
+    block_set_lane(&kernel->imu, (uint8_t)(3 + i), 1.0f, -ext->gyro_bias[i]);
+  }
+  
+  kernel->mag_use_matrix = (ext->mag_model == MAG_MODEL_ELLIPSOID);
+  memcpy(kernel->mag_matrix, ext->mag_soft_iron, sizeof(kernel->mag_matrix));
+  memcpy(kernel->mag_center, ext->mag_hard_iron, sizeof(kernel->mag_center));
+}
+
+/**
+ * @brief Sobrepor ao kernel a correção dos canais de temperatura
+ *
+ * Canal 0 na palavra 0 (temperature); canal i > 0 na palavra i + 1.
+ */
+void calibration_apply_prepare_thermal(CalibrationApplyKernel_t *kernel,
+                                       const CalibrationThermal_t *model) {
+  block_set_lane(&kernel->temp, 0, model->slope[0], model->offset[0]);
+  for (int i = 1; i < CALIB_TEMP_CHANNELS; i++) {
+    block_set_lane(&kernel->temp, (uint8_t)(i + 1), model->slope[i], model->offset[i]);
+  }
+}
+
+/**
+ * @brief Substituir o offset de distância do LiDAR de um kernel
+ */
+void calibration_apply_prepare_lidar_offset(CalibrationApplyKernel_t *kernel, float offset) {
+  block_set_lane(&kernel->lidar, 0, 1.0f, offset);
+}
+
+/**
+ * @brief Substituir o bias do giroscópio de um kernel
+ */
+void calibration_apply_prepare_gyro_bias(CalibrationApplyKernel_t *kernel, const float bias[3]) {
+  for (int i = 0; i < 3; i++) {
+    block_set_lane(&kernel->imu, (uint8_t)(3 + i), 1.0f, -bias[i]);
+  }
+}
+
+// ============================================================================
+// KERNEL PADRÃO
+// ============================================================================
+
+/**
+ * @brief Abrir uma publicação: leitores passam a copy[1]
+ *
+ * As duas cópias são iguais entre publicações, então copy[0] pode ser
+ * alterada no lugar.
+ * @return Cópia a gravar
+ */
+static CalibrationApplyKernel_t *latch_write_begin(void) {
+  default_kernel.sequence = default_kernel.sequence + 1;
+  LATCH_BARRIER();
+  return &default_kernel.copy[0];
+}
+
+/**
+ * @brief Fechar a publicação: leitores voltam a copy[0], que é espelhada em copy[1]
+ */
+static void latch_write_end(void) {
+  LATCH_BARRIER();
+  default_kernel.sequence = default_kernel.sequence + 1;
+  LATCH_BARRIER();
+  default_kernel.copy[1] = default_kernel.copy[0];
+  LATCH_BARRIER();
+}
+
+/**
+ * @brief Iniciar uma leitura
+ * @param copy Cópia que o escritor não está gravando
+ * @return Sequência a conferir em latch_read_retry()
+ */
+static uint32_t latch_read_begin(const CalibrationApplyKernel_t **copy) {
+  uint32_t seq = default_kernel.sequence;
+
+  LATCH_BARRIER();
+  *copy = &default_kernel.copy[seq & 1u];
+  return seq;
+}
+
+/**
+ * @brief true se uma publicação inteira aconteceu durante a leitura
+ */
+static bool latch_read_retry(uint32_t seq) {
+  LATCH_BARRIER();
+  return default_kernel.sequence != seq;
+}
+
+/**
+ * @brief Copiar um bloco do kernel padrão
+ */
+static void latch_read_block(size_t offset, CalibrationAffineBlock_t *block) {
+  const CalibrationApplyKernel_t *copy;
+  uint32_t seq;
+
+  do {
+    seq = latch_read_begin(&copy);
+    memcpy(block, (const uint8_t *)copy + offset, sizeof(*block));
+  } while (latch_read_retry(seq));
+}
+
+/**
+ * @brief Copiar a correção do magnetômetro do kernel padrão
+ */
+static void latch_read_mag(MagKernel_t *mag) {
+  const CalibrationApplyKernel_t *copy;
+  uint32_t seq;
+
+  do {
+    seq = latch_read_begin(&copy);
+    mag->block = copy->mag;
+    memcpy(mag->matrix, copy->mag_matrix, sizeof(mag->matrix));
+    memcpy(mag->center, copy->mag_center, sizeof(mag->center));
+    mag->use_matrix = copy->mag_use_matrix;
+  } while (latch_read_retry(seq));
+}
+
+/**
+ * @brief Atualizar o kernel padrão
+ */
+void calibration_apply_set(const SensorCalibration_t *calib) {
+  calibration_apply_prepare(latch_write_begin(), calib);
+  latch_write_end();
+}
+
+/**
+ * @brief Atualizar as extensões do kernel padrão
+ */
+void calibration_apply_set_ext(const SensorCalibrationExt_t *ext) {
+  calibration_apply_prepare_ext(latch_write_begin(), ext);
+  latch_write_end();
+}
+
+/**
+ * @brief Atualizar apenas o bias do giroscópio do kernel padrão
+ */
+void calibration_apply_set_gyro_bias(const float bias[3]) {
+  calibration_apply_prepare_gyro_bias(latch_write_begin(), bias);
+  latch_write_end();
+}
+
+/**
+ * @brief Publicar um kernel já preparado como kernel padrão
+ */
+void calibration_apply_set_kernel(const CalibrationApplyKernel_t *kernel) {
+  *latch_write_begin() = *kernel;
+  latch_write_end();
+}
+
+/**
+ * @brief Copiar o kernel padrão
+ */
+uint32_t calibration_apply_read(CalibrationApplyKernel_t *kernel) {
+  const CalibrationApplyKernel_t *copy;
+  uint32_t seq;
+
+  do {
+    seq = latch_read_begin(&copy);
+    memcpy(kernel, copy, sizeof(*kernel));
+  } while (latch_read_retry(seq));
+
+  return seq / 2u;
+}
+
+// ============================================================================
+// KERNELS
+// ============================================================================
+
+/**
+ * @brief Processar palavras com lane inicial 0 (caminho escalar)
+ */
+static void apply_words_scalar(const CalibrationAffineBlock_t *block,
+                               const uint8_t *src, uint8_t *dst,
+                               size_t words) {
+  const size_t block_words = (size_t)block->words_per_record * block->records_per_block;
+  size_t lane = 0;
+
+  for (size_t i = 0; i < words; i++) {
+    uint32_t bits;
+    memcpy(&bits, src + i * 4, 4);
+
+    if (!block->keep[lane]) {
+      float x;
+      memcpy(&x, &bits, 4);
+#if CALIB_FIXED_POINT
+      x = calib_q16_to_float(calib_q16_affine(calib_q16_from_float(x), block->gain_q31[lane],
+                                              block->offset_q16[lane]));
+#else
+      x = block->gain[lane] * x + block->offset[lane];
+#endif
+      memcpy(&bits, &x, 4);
+    }
+
+    memcpy(dst + i * 4, &bits, 4);
+
+    if (++lane == block_words) {
+      lane = 0;
+    }
+  }
+}
+
+#if defined(CALIB_APPLY_SSE)
+/**
+ * @brief Processar blocos completos com SSE
+ *
+ * A lane de entrada é mascarada antes da multiplicação para que
+ * timestamps (inteiros, frequentemente denormais como float) nunca
+ * passem pela unidade de ponto flutuante.
+ */
+static void apply_blocks_simd(const CalibrationAffineBlock_t *block,
+                              const uint8_t *src, uint8_t *dst,
+                              size_t blocks) {
+  const int vectors = (block->words_per_record * block->records_per_block) / 4;
+
+  for (size_t b = 0; b < blocks; b++) {
+    for (int v = 0; v < vectors; v++) {
+      __m128 x = _mm_loadu_ps((const float *)src + 4 * v);
+      __m128 k = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)&block->keep[4 * v]));
+      __m128 g = _mm_loadu_ps(&block->gain[4 * v]);
+      __m128 o = _mm_loadu_ps(&block->offset[4 * v]);
+
+      __m128 y = _mm_add_ps(_mm_mul_ps(_mm_andnot_ps(k, x), g), o);
+      y = _mm_or_ps(y, _mm_and_ps(k, x));
+
+      _mm_storeu_ps((float *)dst + 4 * v, y);
+    }
+    src += (size_t)vectors * 16;
+    dst += (size_t)vectors * 16;
+  }
+}
+#elif defined(CALIB_APPLY_NEON)
+/**
+ * @brief Processar blocos completos com NEON
+ */
+static void apply_blocks_simd(const CalibrationAffineBlock_t *block,
+                              const uint8_t *src, uint8_t *dst,
+                              size_t blocks) {
+  const int vectors = (block->words_per_record * block->records_per_block) / 4;
+
+  for (size_t b = 0; b < blocks; b++) {
+    for (int v = 0; v < vectors; v++) {
+      uint32x4_t xb = vld1q_u32((const uint32_t *)src + 4 * v);
+      uint32x4_t k = vld1q_u32(&block->keep[4 * v]);
+      float32x4_t g = vld1q_f32(&block->gain[4 * v]);
+      float32x4_t o = vld1q_f32(&block->offset[4 * v]);
+
+      float32x4_t xa = vreinterpretq_f32_u32(vbicq_u32(xb, k));
+      float32x4_t y = vmlaq_f32(o, xa, g);
+      y = vbslq_f32(k, vreinterpretq_f32_u32(xb), y);
+
+      vst1q_f32((float *)dst + 4 * v, y);
+    }
+    src += (size_t)vectors * 16;
+    dst += (size_t)vectors * 16;
+  }
+}
+#endif
+
+/**
+ * @brief Aplicar um bloco afim sobre registros arbitrários
+ */
+void calibration_apply_block(const CalibrationAffineBlock_t *block,
+                             const void *in, void *out, size_t n) {
+  const uint8_t *src = (const uint8_t *)in;
+  uint8_t *dst = (uint8_t *)out;
+  size_t tail_records = n;
+
+#if defined(CALIB_APPLY_SSE) || defined(CALIB_APPLY_NEON)
+  size_t blocks = n / block->records_per_block;
+  size_t block_bytes = (size_t)block->words_per_record * block->records_per_block * 4;
+
+  apply_blocks_simd(block, src, dst, blocks);
+  src += blocks * block_bytes;
+  dst += blocks * block_bytes;
+  tail_records = n - blocks * block->records_per_block;
+#endif
+
+  apply_words_scalar(block, src, dst, tail_records * block->words_per_record);
+}
+
+#if CALIB_FIXED_POINT
+/**
+ * @brief Aplicar um bloco afim sobre registros em Q16.16
+ */
+void calibration_apply_block_q16(const CalibrationAffineBlock_t *block,
+                                 const int32_t *in, int32_t *out, size_t n) {
+  const size_t block_words = (size_t)block->words_per_record * block->records_per_block;
+  const size_t words = n * block->words_per_record;
+  size_t lane = 0;
+
+  for (size_t i = 0; i < words; i++) {
+    out[i] = block->keep[lane] ? in[i]
+                               : calib_q16_affine(in[i], block->gain_q31[lane],
+                                                  block->offset_q16[lane]);
+    if (++lane == block_words) {
+      lane = 0;
+    }
+  }
+}
+#endif
+
+/**
+ * @brief out[i] = gain * in[i] + offset sobre um array contíguo
+ */
+static void apply_array(const CalibrationAffineBlock_t *block, int lane,
+                        const float *in, float *out, size_t n) {
+#if CALIB_FIXED_POINT
+  for (size_t i = 0; i < n; i++) {
+    out[i] = calib_q16_to_float(calib_q16_affine(calib_q16_from_float(in[i]),
+                                                 block->gain_q31[lane], block->offset_q16[lane]));
+  }
+#else
+  const float gain = block->gain[lane];
+  const float offset = block->offset[lane];
+  size_t i = 0;
+
+#if defined(CALIB_APPLY_SSE)
+  __m128 g = _mm_set1_ps(gain);
+  __m128 o = _mm_set1_ps(offset);
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(in + i), g), o));
+  }
+#elif defined(CALIB_APPLY_NEON)
+  float32x4_t g = vdupq_n_f32(gain);
+  float32x4_t o = vdupq_n_f32(offset);
+  for (; i + 4 <= n; i += 4) {
+    vst1q_f32(out + i, vmlaq_f32(o, vld1q_f32(in + i), g));
+  }
+#endif
+
+  for (; i < n; i++) {
+    out[i] = gain * in[i] + offset;
+  }
+#endif
+}
+
+/**
+ * @brief Correção soft-iron completa: out = W · (in - c)
+ *
+ * Os três eixos de saída dependem dos três de entrada, então não há
+ * forma afim por lane; o laço por amostra é escalar no layout AoS
+ * e vetorizável pelo compilador no layout SoA.
+ */
+static void apply_mag_matrix(const MagKernel_t *mag,
+                             const float *in_x, const float *in_y, const float *in_z,
+                             float *out_x, float *out_y, float *out_z,
+                             size_t n, size_t stride) {
+  const float (*w)[3] = mag->matrix;
+  const float *c = mag->center;
+
+  for (size_t i = 0; i < n; i++) {
+    size_t k = i * stride;
+    float x = in_x[k] - c[0];
+    float y = in_y[k] - c[1];
+    float z = in_z[k] - c[2];
+
+    out_x[k] = w[0][0] * x + w[0][1] * y + w[0][2] * z;
+    out_y[k] = w[1][0] * x + w[1][1] * y + w[1][2] * z;
+    out_z[k] = w[2][0] * x + w[2][1] * y + w[2][2] * z;
+  }
+}
+
+/**
+ * @brief Copiar timestamps quando a saída não é in-place
+ */
+static void copy_timestamps(const uint32_t *in, uint32_t *out, size_t n) {
+  if (in != out) {
+    memmove(out, in, n * sizeof(uint32_t));
+  }
+}
+
+// ============================================================================
+// INTERFACE PÚBLICA
+// ============================================================================
+
+/**
+ * @brief Aplicar calibração do IMU em lote
+ */
+void apply_imu_calibration_batch(const IMUData_t *in, IMUData_t *out, size_t n) {
+  CalibrationAffineBlock_t imu;
+
+  latch_read_block(offsetof(CalibrationApplyKernel_t, imu), &imu);
+  calibration_apply_block(&imu, in, out, n);
+}
+
+/**
+ * @brief Aplicar calibração do Magnetômetro em lote
+ */
+void apply_mag_calibration_batch(const MagData_t *in, MagData_t *out, size_t n) {
+  MagKernel_t mag;
+
+  latch_read_mag(&mag);
+  if (!mag.use_matrix) {
+    calibration_apply_block(&mag.block, in, out, n);
+    return;
+  }
+
+  // Passo de 4 floats por registro (mx, my, mz, timestamp)
+  apply_mag_matrix(&mag, &in->mx, &in->my, &in->mz,
+                   &out->mx, &out->my, &out->mz, n, 4);
+  for (size_t i = 0; i < n && in != out; i++) {
+    out[i].timestamp = in[i].timestamp;
+  }
+}
+
+/**
+ * @brief Aplicar calibração do LiDAR em lote
+ */
+void apply_lidar_calibration_batch(const LiDARData_t *in, LiDARData_t *out,
+                                   size_t n) {
+  CalibrationAffineBlock_t lidar;
+
+  latch_read_block(offsetof(CalibrationApplyKernel_t, lidar), &lidar);
+  calibration_apply_block(&lidar, in, out, n);
+}
+
+/**
+ * @brief Aplicar calibração da Bateria em lote
+ */
+void apply_battery_calibration_batch(const BatteryData_t *in,
+                                     BatteryData_t *out, size_t n) {
+  CalibrationAffineBlock_t battery;
+
+  latch_read_block(offsetof(CalibrationApplyKernel_t, battery), &battery);
+  calibration_apply_block(&battery, in, out, n);
+}
+
+/**
+ * @brief Aplicar a correção por canal de temperatura em lote
+ */
+void apply_temperature_calibration_batch(const TemperatureData_t *in,
+                                         TemperatureData_t *out, size_t n) {
+  CalibrationAffineBlock_t temp;
+
+  latch_read_block(offsetof(CalibrationApplyKernel_t, temp), &temp);
+  calibration_apply_block(&temp, in, out, n);
+}
+
+/**
+ * @brief Aplicar calibração do IMU sobre arrays SoA
+ */
+void apply_imu_calibration_soa(const IMUSoAView_t *in, const IMUSoAView_t *out,
+                               size_t n) {
+  CalibrationAffineBlock_t block;
+  const CalibrationAffineBlock_t *imu = &block;
+
+  latch_read_block(offsetof(CalibrationApplyKernel_t, imu), &block);
+
+  // Lanes 0..5 do primeiro registro do bloco: ax, ay, az, gx, gy, gz
+  apply_array(imu, 0, in->ax, out->ax, n);
+  apply_array(imu, 1, in->ay, out->ay, n);
+  apply_array(imu, 2, in->az, out->az, n);
+  apply_array(imu, 3, in->gx, out->gx, n);
+  apply_array(imu, 4, in->gy, out->gy, n);
+  apply_array(imu, 5, in->gz, out->gz, n);
+  copy_timestamps(in->ts, out->ts, n);
+}
+
+/**
+ * @brief Aplicar calibração do Magnetômetro sobre arrays SoA
+ */
+void apply_mag_calibration_soa(const MagSoAView_t *in, const MagSoAView_t *out,
+                               size_t n) {
+  MagKernel_t mag;
+
+  latch_read_mag(&mag);
+  if (mag.use_matrix) {
+    apply_mag_matrix(&mag, in->mx, in->my, in->mz,
+                     out->mx, out->my, out->mz, n, 1);
+  } else {
+    apply_array(&mag.block, 0, in->mx, out->mx, n);
+    apply_array(&mag.block, 1, in->my, out->my, n);
+    apply_array(&mag.block, 2, in->mz, out->mz, n);
+  }
+  copy_timestamps(in->ts, out->ts, n);
+}
@@ -0,0 +1,243 @@
+/**
+ * @file calibration_apply.h
+ * @brief Aplicação da calibração em lote sobre amostras dos sensores
+ * @version 1.0.0
+ *
+ * A correção de cada sensor é reduzida à forma afim fundida
+ * out = gain * raw + offset, pré-calculada uma vez por mudança de
+ * calibração (calibration_apply_prepare). Os kernels em lote usam
+ * NEON ou SSE quando disponíveis, com fallback escalar.
+ *
+ * Definir CALIB_APPLY_FORCE_SCALAR desativa os caminhos SIMD.
+ *
+ * O kernel padrão (calibration_apply_set*()) tem um único escritor, a
+ * thread de calibration_update(); apply_*_batch() pode rodar em outra
+ * thread ou ISR e nunca vê uma publicação pela metade. Antes da primeira
+ * publicação ele copia as amostras sem alteração.
+ *
+ * Com CALIB_FIXED_POINT (calibration_fixed.h) os blocos guardam também os
+ * coeficientes em Q1.31/Q16.16 e os kernels usam só aritmética inteira:
+ * as funções em float convertem cada palavra na entrada e na saída, e
+ * calibration_apply_block_q16() processa registros já em Q16.16, com o
+ * mesmo layout de palavras. A correção soft-iron completa
+ * (mag_use_matrix) continua em float.
+ */
+
+#ifndef CALIBRATION_APPLY_H
+#define CALIBRATION_APPLY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sensor_calibration.h"
+#include "calibration_buffer.h"
+#include "calibration_thermal.h"
+#include "calibration_fixed.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+/// Palavras de 32 bits por bloco SIMD (mmc(7, 4) = 28 para IMUData_t)
+#define CALIB_APPLY_BLOCK_WORDS 28
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+/**
+ * @struct CalibrationAffineBlock_t
+ * @brief Padrão gain/offset de um bloco de registros consecutivos
+ *
+ * Cada registro é visto como uma sequência de palavras de 32 bits; lanes
+ * marcadas em keep (ex.: timestamp) são copiadas sem alteração.
+ */
+typedef struct {
+  float gain[CALIB_APPLY_BLOCK_WORDS];     ///< Ganho por lane
+  float offset[CALIB_APPLY_BLOCK_WORDS];   ///< Offset por lane
+  uint32_t keep[CALIB_APPLY_BLOCK_WORDS];  ///< 0xFFFFFFFF = copiar lane
+#if CALIB_FIXED_POINT
+  calib_q31_t gain_q31[CALIB_APPLY_BLOCK_WORDS];    ///< gain - 1 por lane, Q1.31
+  calib_q16_t offset_q16[CALIB_APPLY_BLOCK_WORDS];  ///< Offset por lane, Q16.16
+#endif
+  uint8_t words_per_record;                ///< Palavras por registro
+  uint8_t records_per_block;               ///< Registros por bloco SIMD
+} CalibrationAffineBlock_t;
+
+/**
+ * @struct CalibrationApplyKernel_t
+ * @brief Coeficientes fundidos de todos os sensores
+ */
+typedef struct {
+  CalibrationAffineBlock_t imu;      ///< ax..gz (timestamp preservado)
+  CalibrationAffineBlock_t mag;      ///< mx..mz (timestamp preservado)
+  CalibrationAffineBlock_t lidar;    ///< distance, angle
+  CalibrationAffineBlock_t battery;  ///< voltage (current/percentage preservados)
+  CalibrationAffineBlock_t temp;     ///< Canais (timestamp/channel_count preservados)
+  float mag_matrix[3][3];            ///< Soft-iron completa (modelo elipsoide)
+  float mag_center[3];               ///< Hard-iron (modelo elipsoide)
+  bool mag_use_matrix;               ///< true: usar mag_matrix em vez de mag
+  uint16_t calibration_count;        ///< calibration_count de origem
+} CalibrationApplyKernel_t;
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Pré-calcular coeficientes fundidos a partir da calibração
+ * @param kernel Kernel de destino
+ * @param calib Calibração de origem
+ */
+void calibration_apply_prepare(CalibrationApplyKernel_t *kernel,
+                               const SensorCalibration_t *calib);
+
+/**
+ * @brief Sobrepor ao kernel a correção do magnetômetro das extensões
+ * @param kernel Kernel já preparado com calibration_apply_prepare()
+ * @param ext Extensões de calibração
+ */
+void calibration_apply_prepare_ext(CalibrationApplyKernel_t *kernel,
+                                   const SensorCalibrationExt_t *ext);
+
+/**
+ * @brief Substituir o bias do giroscópio de um kernel
+ * @param kernel Kernel já preparado com calibration_apply_prepare()
+ * @param bias Bias X, Y, Z (rad/s)
+ */
+void calibration_apply_prepare_gyro_bias(CalibrationApplyKernel_t *kernel, const float bias[3]);
+
+/**
+ * @brief Sobrepor ao kernel a correção dos canais de temperatura
+ * @param kernel Kernel já preparado com calibration_apply_prepare()
+ * @param model Modelo térmico
+ */
+void calibration_apply_prepare_thermal(CalibrationApplyKernel_t *kernel,
+                                       const CalibrationThermal_t *model);
+
+/**
+ * @brief Substituir o offset de distância do LiDAR de um kernel
+ * (compensação de temperatura em tempo de execução)
+ * @param kernel Kernel já preparado com calibration_apply_prepare()
+ * @param offset Offset de distância (m)
+ */
+void calibration_apply_prepare_lidar_offset(CalibrationApplyKernel_t *kernel, float offset);
+
+/**
+ * @brief Atualizar as extensões do kernel padrão
+ * @param ext Extensões de calibração
+ */
+void calibration_apply_set_ext(const SensorCalibrationExt_t *ext);
+
+/**
+ * @brief Atualizar apenas o bias do giroscópio do kernel padrão
+ * (compensação de temperatura em tempo de execução)
+ * @param bias Bias X, Y, Z (rad/s)
+ */
+void calibration_apply_set_gyro_bias(const float bias[3]);
+
+/**
+ * @brief Atualizar o kernel padrão usado pelas funções apply_*_batch()
+ * @param calib Calibração de origem
+ */
+void calibration_apply_set(const SensorCalibration_t *calib);
+
+/**
+ * @brief Publicar um kernel já preparado como kernel padrão
+ * @param kernel Kernel de origem (copiado)
+ */
+void calibration_apply_set_kernel(const CalibrationApplyKernel_t *kernel);
+
+/**
+ * @brief Copiar o kernel padrão (qualquer thread ou ISR)
+ * @param kernel Destino
+ * @return Número de publicações desde o boot
+ */
+uint32_t calibration_apply_read(CalibrationApplyKernel_t *kernel);
+
+/**
+ * @brief Aplicar calibração do IMU em lote (in e out podem coincidir)
+ * @param in Amostras brutas
+ * @param out Amostras corrigidas
+ * @param n Número de amostras
+ */
+void apply_imu_calibration_batch(const IMUData_t *in, IMUData_t *out, size_t n);
+
+/**
+ * @brief Aplicar calibração do Magnetômetro em lote
+ * @param in Amostras brutas
+ * @param out Amostras corrigidas
+ * @param n Número de amostras
+ */
+void apply_mag_calibration_batch(const MagData_t *in, MagData_t *out, size_t n);
+
+/**
+ * @brief Aplicar calibração do LiDAR em lote
+ * @param in Amostras brutas
+ * @param out Amostras corrigidas
+ * @param n Número de amostras
+ */
+void apply_lidar_calibration_batch(const LiDARData_t *in, LiDARData_t *out,
+                                   size_t n);
+
+/**
+ * @brief Aplicar calibração da Bateria em lote
+ * @param in Amostras brutas
+ * @param out Amostras corrigidas
+ * @param n Número de amostras
+ */
+void apply_battery_calibration_batch(const BatteryData_t *in,
+                                     BatteryData_t *out, size_t n);
+
+/**
+ * @brief Aplicar a correção por canal de temperatura em lote
+ * @param in Leituras brutas
+ * @param out Leituras corrigidas
+ * @param n Número de leituras
+ */
+void apply_temperature_calibration_batch(const TemperatureData_t *in,
+                                         TemperatureData_t *out, size_t n);
+
+/**
+ * @brief Aplicar calibração do IMU sobre arrays SoA (in e out podem coincidir)
+ * @param in Visão SoA de entrada (ex.: obtida com imu_ring_peek())
+ * @param out Visão SoA de saída
+ * @param n Número de amostras
+ */
+void apply_imu_calibration_soa(const IMUSoAView_t *in, const IMUSoAView_t *out,
+                               size_t n);
+
+/**
+ * @brief Aplicar calibração do Magnetômetro sobre arrays SoA
+ * @param in Visão SoA de entrada (ex.: obtida com mag_ring_peek())
+ * @param out Visão SoA de saída
+ * @param n Número de amostras
+ */
+void apply_mag_calibration_soa(const MagSoAView_t *in, const MagSoAView_t *out,
+                               size_t n);
+
+/**
+ * @brief Aplicar um bloco afim sobre registros arbitrários
+ * @param block Padrão gain/offset/keep
+ * @param in Registros de entrada
+ * @param out Registros de saída
+ * @param n Número de registros
+ */
+void calibration_apply_block(const CalibrationAffineBlock_t *block,
+                             const void *in, void *out, size_t n);
+
+#if CALIB_FIXED_POINT
+/**
+ * @brief Aplicar um bloco afim sobre registros em Q16.16 (só inteiros)
+ *
+ * Lanes de keep (timestamps, contadores) são copiadas sem alteração.
+ * Erro máximo contra a forma afim exata: CALIB_FIXED_APPLY_BOUND_LSB.
+ * @param block Padrão gain/offset/keep (ex.: imu de calibration_apply_read())
+ * @param in Registros de entrada, words_per_record palavras cada
+ * @param out Registros de saída (pode coincidir com in)
+ * @param n Número de registros
+ */
+void calibration_apply_block_q16(const CalibrationAffineBlock_t *block,
+                                 const int32_t *in, int32_t *out, size_t n);
+#endif
+
+#endif // CALIBRATION_APPLY_H
@@ -0,0 +1,310 @@
+/**
+ * @file calibration_battery.c
+ * @brief Estado de carga da bateria: curva OCV x SoC aprendida online
+ * @version 1.0.0
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include "calibration_battery.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define CALIB_BATTERY_MAGIC 0xCAFEB001    // Incrementar a cada mudança de layout
+#define CALIB_SOC_RESISTANCE_MAX 1.0f     // R acima disso é ruído do degrau (ohm)
+
+static const uint16_t default_curve_mv[CALIB_SOC_POINTS] = { CALIB_SOC_DEFAULT_CURVE_MV };
+
+// ============================================================================
+// UTILITÁRIOS INTERNOS
+// ============================================================================
+
+/**
+ * @brief Saturar em 0..1
+ */
+static float clamp_unit(float x) {
+  if (x < 0.0f) {
+    return 0.0f;
+  }
+  return (x > 1.0f) ? 1.0f : x;
+}
+
+/**
+ * @brief Ajustar um ponto da curva (média corrente) mantendo-a não decrescente
+ */
+static void curve_point_learn(CalibrationBatteryModel_t *model, int point, float residual,
+                              float weight) {
+  if (model->ocv_count[point] < CALIB_SOC_LUT_MAX_WEIGHT) {
+    model->ocv_count[point]++;
+  }
+
+  float value = model->ocv[point] + weight / (float)model->ocv_count[point] * residual;
+  model->ocv[point] = value;
+
+  for (int i = point + 1; i < CALIB_SOC_POINTS && model->ocv[i] < value; i++) {
+    model->ocv[i] = value;
+  }
+  for (int i = point - 1; i >= 0 && model->ocv[i] > value; i--) {
+    model->ocv[i] = value;
+  }
+}
+
+/**
+ * @brief Incorporar uma OCV observada num SoC
+ *
+ * O resíduo em relação à curva interpolada é dividido entre os dois
+ * pontos vizinhos, na proporção da interpolação (peso relativo weight).
+ */
+static void curve_learn(CalibrationBatteryModel_t *model, float soc, float ocv, float weight) {
+  float pos = soc * (CALIB_SOC_POINTS - 1);
+  int lower = (int)pos;
+
+  if (lower >= CALIB_SOC_POINTS - 1) {
+    lower = CALIB_SOC_POINTS - 2;
+  }
+
+  float t = pos - (float)lower;
+  float residual = ocv - calibration_soc_ocv(model, soc);
+  if (t < 1.0f) {
+    curve_point_learn(model, lower, residual, weight * (1.0f - t));
+  }
+  if (t > 0.0f) {
+    curve_point_learn(model, lower + 1, residual, weight * t);
+  }
+}
+
+/**
+ * @brief SoC de uma OCV na curva nominal (CALIB_SOC_DEFAULT_CURVE_MV)
+ */
+static float nominal_soc(float ocv) {
+  static CalibrationBatteryModel_t nominal;
+
+  if (nominal.magic == 0) {
+    calibration_battery_model_default(&nominal);
+  }
+  return calibration_soc_from_ocv(&nominal, ocv);
+}
+
+/**
+ * @brief Estimar a capacidade num repouso relaxado
+ *
+ * A referência é a curva nominal, não a aprendida: esta é ajustada pela
+ * própria contagem e não observa o erro da capacidade. Uma vez por repouso.
+ */
+static bool capacity_learn(CalibrationSocEstimator_t *est, CalibrationBatteryModel_t *model) {
+  float depth = 1.0f - nominal_soc(est->ocv);
+
+  if (est->capacity_sampled || depth < CALIB_SOC_CAPACITY_DEPTH) {
+    return false;
+  }
+  est->capacity_sampled = true;
+
+  float capacity = est->drawn_ah / depth;
+  if (capacity < 0.5f * model->capacity_ah || capacity > 2.0f * model->capacity_ah) {
+    return false;
+  }
+
+  model->capacity_ah += CALIB_SOC_CAPACITY_GAIN * (capacity - model->capacity_ah);
+  if (model->capacity_updates < UINT16_MAX) {
+    model->capacity_updates++;
+  }
+  return true;
+}
+
+/**
+ * @brief Guardar a amostra como referência da próxima
+ */
+static void sample_keep(CalibrationSocEstimator_t *est, float voltage, float current,
+                        uint32_t timestamp) {
+  est->last_voltage = voltage;
+  est->last_current = current;
+  est->last_time = timestamp;
+}
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Preencher o modelo com a curva e os parâmetros nominais
+ */
+void calibration_battery_model_default(CalibrationBatteryModel_t *model) {
+  memset(model, 0, sizeof(*model));
+  model->magic = CALIB_BATTERY_MAGIC;
+  for (int i = 0; i < CALIB_SOC_POINTS; i++) {
+    model->ocv[i] = default_curve_mv[i] * 0.001f;
+  }
+  model->capacity_ah = CALIB_SOC_CAPACITY_AH;
+  model->resistance = CALIB_SOC_RESISTANCE;
+}
+
+/**
+ * @brief Verificar a consistência de um modelo carregado
+ */
+bool calibration_battery_model_valid(const CalibrationBatteryModel_t *model) {
+  if (model->magic != CALIB_BATTERY_MAGIC ||
+      !(model->capacity_ah > 0.1f && model->capacity_ah < 1000.0f) ||
+      !(model->resistance >= 0.0f && model->resistance < CALIB_SOC_RESISTANCE_MAX)) {
+    return false;
+  }
+
+  for (int i = 1; i < CALIB_SOC_POINTS; i++) {
+    if (!(model->ocv[i] >= model->ocv[i - 1])) {
+      return false;
+    }
+  }
+  return model->ocv[CALIB_SOC_POINTS - 1] > model->ocv[0];
+}
+
+/**
+ * @brief Reiniciar o estimador
+ */
+void calibration_soc_reset(CalibrationSocEstimator_t *est) {
+  memset(est, 0, sizeof(*est));
+}
+
+/**
+ * @brief Incorporar uma amostra de tensão e corrente
+ *
+ * A primeira amostra inicializa o SoC pela OCV. Intervalos maiores que
+ * CALIB_SOC_MAX_GAP_S não são integrados e suspendem o aprendizado até a
+ * próxima carga completa (a carga do intervalo é desconhecida).
+ */
+bool calibration_soc_update(CalibrationSocEstimator_t *est, CalibrationBatteryModel_t *model,
+                            float voltage, float current, uint32_t timestamp) {
+  float i = CALIB_SOC_CURRENT_SIGN * current;
+  bool changed = false;
+
+  if (!est->initialized) {
+    est->ocv = voltage + i * model->resistance;
+    est->soc = calibration_soc_from_ocv(model, est->ocv);
+    est->initialized = true;
+    sample_keep(est, voltage, i, timestamp);
+    return false;
+  }
+
+  float dt = (float)(timestamp - est->last_time) * 0.001f;
+  if (dt <= 0.0f) {
+    return false;
+  }
+  if (dt > CALIB_SOC_MAX_GAP_S) {
+    est->anchored = false;
+    est->resting = false;
+    sample_keep(est, voltage, i, timestamp);
+    return false;
+  }
+
+  // Resistência interna: degrau de corrente entre amostras consecutivas
+  float di = i - est->last_current;
+  if (fabsf(di) >= CALIB_SOC_IR_STEP) {
+    float r = -(voltage - est->last_voltage) / di;
+    if (r > 0.0f && r < CALIB_SOC_RESISTANCE_MAX) {
+      model->resistance += CALIB_SOC_IR_GAIN * (r - model->resistance);
+      if (model->resistance_updates < UINT16_MAX) {
+        model->resistance_updates++;
+      }
+      changed = true;
+    }
+  }
+
+  // Contagem de coulombs (trapézio)
+  float drawn = 0.5f * (i + est->last_current) * dt / 3600.0f;
+  est->drawn_ah += drawn;
+  est->soc = clamp_unit(est->soc - drawn / model->capacity_ah);
+
+  if (i > 0.0f) {
+    est->discharge_avg += fminf(dt / CALIB_SOC_LOAD_TAU_S, 1.0f) * (i - est->discharge_avg);
+  }
+
+  est->ocv = voltage + i * model->resistance;
+  float soc_v = calibration_soc_from_ocv(model, est->ocv);
+
+  if (fabsf(i) < CALIB_SOC_REST_CURRENT) {
+    if (!est->resting) {
+      est->resting = true;
+      est->capacity_sampled = false;
+      est->rest_start = timestamp;
+    }
+  } else {
+    est->resting = false;
+  }
+  bool relaxed = est->resting && (timestamp - est->rest_start) >= CALIB_SOC_REST_MS;
+
+  if (i < CALIB_SOC_REST_CURRENT && -i < CALIB_SOC_FULL_CURRENT &&
+      voltage >= model->ocv[CALIB_SOC_POINTS - 1] - CALIB_SOC_FULL_MARGIN) {
+    // Fim da carga: referência absoluta
+    est->soc = 1.0f;
+    est->drawn_ah = 0.0f;
+    est->anchored = true;
+  } else if (est->anchored && i > -CALIB_SOC_REST_CURRENT) {
+    if (relaxed) {
+      changed |= capacity_learn(est, model);
+    }
+    curve_learn(model, est->soc, est->ocv, relaxed ? 1.0f : CALIB_SOC_LOAD_WEIGHT);
+    changed = true;
+  } else if (relaxed) {
+    est->soc = soc_v;
+  }
+
+  // Sob carga a OCV corrige a deriva da contagem, devagar
+  if (!relaxed) {
+    est->soc += fminf(dt / CALIB_SOC_VOLTAGE_TAU_S, 1.0f) * (soc_v - est->soc);
+  }
+
+  sample_keep(est, voltage, i, timestamp);
+  return changed;
+}
+
+/**
+ * @brief SoC correspondente a uma OCV
+ */
+float calibration_soc_from_ocv(const CalibrationBatteryModel_t *model, float ocv) {
+  if (ocv <= model->ocv[0]) {
+    return 0.0f;
+  }
+  if (ocv >= model->ocv[CALIB_SOC_POINTS - 1]) {
+    return 1.0f;
+  }
+
+  int lo = 0;
+  int hi = CALIB_SOC_POINTS - 1;
+  while (hi - lo > 1) {
+    int mid = (lo + hi) / 2;
+    if (model->ocv[mid] <= ocv) {
+      lo = mid;
+    } else {
+      hi = mid;
+    }
+  }
+
+  float span = model->ocv[hi] - model->ocv[lo];
+  float t = (span > 0.0f) ? (ocv - model->ocv[lo]) / span : 0.0f;
+  return ((float)lo + t) / (CALIB_SOC_POINTS - 1);
+}
+
+/**
+ * @brief OCV correspondente a um SoC
+ */
+float calibration_soc_ocv(const CalibrationBatteryModel_t *model, float soc) {
+  float pos = clamp_unit(soc) * (CALIB_SOC_POINTS - 1);
+  int point = (int)pos;
+
+  if (point >= CALIB_SOC_POINTS - 1) {
+    return model->ocv[CALIB_SOC_POINTS - 1];
+  }
+  return model->ocv[point] + (pos - (float)point) * (model->ocv[point + 1] - model->ocv[point]);
+}
+
+/**
+ * @brief Autonomia na corrente média de descarga recente
+ */
+uint32_t calibration_soc_runtime(const CalibrationSocEstimator_t *est,
+                                 const CalibrationBatteryModel_t *model) {
+  float load = fmaxf(est->discharge_avg, CALIB_SOC_MIN_LOAD);
+
+  return (uint32_t)(est->soc * model->capacity_ah * 3600.0f / load);
+}
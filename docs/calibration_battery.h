@@ -0,0 +1,222 @@
+/**
+ * @file calibration_battery.h
+ * @brief Estado de carga da bateria: curva OCV x SoC aprendida online
+ * @version 1.0.0
+ *
+ * BatteryData_t.percentage vem cru do driver e oscila com a carga. Aqui o
+ * estado de carga (SoC) combina três fontes:
+ *
+ * - contagem de coulombs: a corrente integrada entre amostras move o SoC
+ *   (curto prazo, sem ruído, mas deriva com o erro da capacidade);
+ * - tensão de circuito aberto: OCV = V + I·R (queda na resistência
+ *   interna R compensada) consultada na curva OCV x SoC; em repouso
+ *   (corrente baixa por CALIB_SOC_REST_MS) a OCV é confiável e corrige o
+ *   SoC, sob carga ela só o puxa devagar (CALIB_SOC_VOLTAGE_TAU_S);
+ * - carga completa: fim da carga (tensão no topo, corrente caindo) fixa
+ *   SoC = 100% e zera a carga retirada.
+ *
+ * Desde a última carga completa a contagem de coulombs é a referência, e
+ * a curva é aprendida com ela: o resíduo entre a OCV observada e a curva
+ * interpolada no SoC atual é dividido entre os dois pontos vizinhos
+ * (CALIB_SOC_POINTS, a cada 100/(CALIB_SOC_POINTS-1) %), numa média
+ * corrente com peso cheio em repouso e reduzido sob carga, e a curva é
+ * mantida não decrescente. Durante a carga a curva não aprende (a
+ * polarização da carga não é modelada). R vem dos degraus de corrente
+ * (-ΔV/ΔI).
+ *
+ * A capacidade só é observável contra uma referência independente da
+ * contagem, já que a curva aprendida se ajusta a ela: a profundidade de
+ * um repouso profundo é lida na curva nominal (CALIB_SOC_DEFAULT_CURVE_MV).
+ *
+ * Convenção: corrente positiva na descarga (CALIB_SOC_CURRENT_SIGN = -1
+ * para drivers com o sinal invertido). Todas as consultas têm custo fixo:
+ * o SoC é mantido pela atualização e a inversão da curva é uma busca
+ * binária sobre CALIB_SOC_POINTS pontos.
+ */
+
+#ifndef CALIBRATION_BATTERY_H
+#define CALIBRATION_BATTERY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sensor_calibration.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define CALIB_SOC_POINTS 21                ///< Pontos da curva (0..100% a cada 5%)
+
+#ifndef CALIB_SOC_CURRENT_SIGN
+#define CALIB_SOC_CURRENT_SIGN 1.0f        ///< Sinal que torna a descarga positiva
+#endif
+
+#ifndef CALIB_SOC_CAPACITY_AH
+#define CALIB_SOC_CAPACITY_AH 10.0f        ///< Capacidade nominal (Ah)
+#endif
+
+#ifndef CALIB_SOC_RESISTANCE
+#define CALIB_SOC_RESISTANCE 0.05f         ///< Resistência interna inicial (ohm)
+#endif
+
+/// Curva OCV x SoC inicial (mV, 0% a 100%): pack 3S de íon-lítio
+#ifndef CALIB_SOC_DEFAULT_CURVE_MV
+#define CALIB_SOC_DEFAULT_CURVE_MV \
+  9000, 9900, 10350, 10590, 10740, 10830, 10920, 10980, 11040, 11100, 11160, \
+  11250, 11340, 11430, 11550, 11670, 11790, 11940, 12120, 12300, 12600
+#endif
+
+#ifndef CALIB_SOC_REST_CURRENT
+#define CALIB_SOC_REST_CURRENT 0.2f        ///< Corrente de repouso (A)
+#endif
+
+#ifndef CALIB_SOC_REST_MS
+#define CALIB_SOC_REST_MS 600000           ///< Repouso até a OCV relaxar (10 min)
+#endif
+
+#ifndef CALIB_SOC_FULL_CURRENT
+#define CALIB_SOC_FULL_CURRENT 0.5f        ///< Corrente de carga no fim da carga (A)
+#endif
+
+#ifndef CALIB_SOC_FULL_MARGIN
+#define CALIB_SOC_FULL_MARGIN 0.05f        ///< Tensão abaixo do topo da curva aceita como cheia (V)
+#endif
+
+#ifndef CALIB_SOC_VOLTAGE_TAU_S
+#define CALIB_SOC_VOLTAGE_TAU_S 1800.0f    ///< Constante de tempo da correção pela OCV sob carga (s)
+#endif
+
+#ifndef CALIB_SOC_LOAD_TAU_S
+#define CALIB_SOC_LOAD_TAU_S 300.0f        ///< Média da corrente de descarga para a autonomia (s)
+#endif
+
+#ifndef CALIB_SOC_MAX_GAP_S
+#define CALIB_SOC_MAX_GAP_S 10.0f          ///< Intervalo maior que isso não é integrado
+#endif
+
+#ifndef CALIB_SOC_IR_STEP
+#define CALIB_SOC_IR_STEP 1.0f             ///< Degrau de corrente que mede R (A)
+#endif
+
+#ifndef CALIB_SOC_IR_GAIN
+#define CALIB_SOC_IR_GAIN 0.1f             ///< Ganho da média exponencial de R
+#endif
+
+#ifndef CALIB_SOC_LUT_MAX_WEIGHT
+#define CALIB_SOC_LUT_MAX_WEIGHT 64        ///< Peso máximo da média de um ponto da curva
+#endif
+
+#ifndef CALIB_SOC_LOAD_WEIGHT
+#define CALIB_SOC_LOAD_WEIGHT 0.05f        ///< Peso relativo de uma OCV medida sob carga
+#endif
+
+#ifndef CALIB_SOC_CAPACITY_DEPTH
+#define CALIB_SOC_CAPACITY_DEPTH 0.3f      ///< Descarga mínima para estimar a capacidade
+#endif
+
+#ifndef CALIB_SOC_CAPACITY_GAIN
+#define CALIB_SOC_CAPACITY_GAIN 0.2f       ///< Ganho da média exponencial da capacidade
+#endif
+
+#ifndef CALIB_SOC_MIN_LOAD
+#define CALIB_SOC_MIN_LOAD 0.1f            ///< Corrente mínima no cálculo da autonomia (A)
+#endif
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+/**
+ * @struct CalibrationBatteryModel_t
+ * @brief Modelo aprendido da bateria (persistido)
+ */
+typedef struct {
+  uint32_t magic;
+  float ocv[CALIB_SOC_POINTS];         ///< OCV em cada ponto de SoC (V, não decrescente)
+  uint8_t ocv_count[CALIB_SOC_POINTS]; ///< Observações por ponto (até CALIB_SOC_LUT_MAX_WEIGHT)
+  float capacity_ah;                   ///< Capacidade útil (Ah)
+  float resistance;                    ///< Resistência interna (ohm)
+  uint16_t capacity_updates;           ///< Estimativas de capacidade incorporadas
+  uint16_t resistance_updates;         ///< Degraus de corrente incorporados
+} CalibrationBatteryModel_t;
+
+/**
+ * @struct CalibrationSocEstimator_t
+ * @brief Estado do estimador de carga (RAM)
+ */
+typedef struct {
+  float soc;              ///< Estado de carga (0..1)
+  float ocv;              ///< Última OCV estimada (V)
+  float discharge_avg;    ///< Média exponencial da corrente de descarga (A)
+  float drawn_ah;         ///< Carga retirada desde a última carga completa (Ah)
+  float last_voltage;     ///< Amostra anterior (V)
+  float last_current;     ///< Amostra anterior (A, positiva na descarga)
+  uint32_t last_time;     ///< Timestamp da amostra anterior (ms)
+  uint32_t rest_start;    ///< Início do repouso atual (ms)
+  bool initialized;
+  bool resting;
+  bool capacity_sampled;  ///< Capacidade já estimada neste repouso
+  bool anchored;          ///< Houve carga completa desde a inicialização
+} CalibrationSocEstimator_t;
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Preencher o modelo com a curva e os parâmetros nominais
+ * @param model Modelo
+ */
+void calibration_battery_model_default(CalibrationBatteryModel_t *model);
+
+/**
+ * @brief Verificar a consistência de um modelo carregado
+ * @param model Modelo
+ * @return false se a curva for decrescente ou os parâmetros implausíveis
+ */
+bool calibration_battery_model_valid(const CalibrationBatteryModel_t *model);
+
+/**
+ * @brief Reiniciar o estimador (próxima amostra inicializa pela OCV)
+ * @param est Estimador
+ */
+void calibration_soc_reset(CalibrationSocEstimator_t *est);
+
+/**
+ * @brief Incorporar uma amostra de tensão e corrente
+ * @param est Estimador
+ * @param model Modelo (aprendido no lugar)
+ * @param voltage Tensão calibrada (V)
+ * @param current Corrente do driver (A)
+ * @param timestamp Timestamp da amostra (ms)
+ * @return true se o modelo mudou (gravar depois)
+ */
+bool calibration_soc_update(CalibrationSocEstimator_t *est, CalibrationBatteryModel_t *model,
+                            float voltage, float current, uint32_t timestamp);
+
+/**
+ * @brief SoC correspondente a uma OCV (busca binária na curva)
+ * @param model Modelo
+ * @param ocv Tensão de circuito aberto (V)
+ * @return SoC (0..1, saturado nas pontas)
+ */
+float calibration_soc_from_ocv(const CalibrationBatteryModel_t *model, float ocv);
+
+/**
+ * @brief OCV correspondente a um SoC (índice direto na curva)
+ * @param model Modelo
+ * @param soc SoC (0..1)
+ * @return OCV (V)
+ */
+float calibration_soc_ocv(const CalibrationBatteryModel_t *model, float soc);
+
+/**
+ * @brief Autonomia na corrente média de descarga recente
+ * @param est Estimador
+ * @param model Modelo
+ * @return Segundos até SoC = 0
+ */
+uint32_t calibration_soc_runtime(const CalibrationSocEstimator_t *est,
+                                 const CalibrationBatteryModel_t *model);
+
+#endif // CALIBRATION_BATTERY_H
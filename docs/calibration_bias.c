@@ -0,0 +1,155 @@
+/**
+ * @file calibration_bias.c
+ * @brief Estimação contínua do bias do IMU (detecção de velocidade zero)
+ * @version 1.0.0
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include "calibration_bias.h"
+
+// ============================================================================
+// UTILITÁRIOS INTERNOS
+// ============================================================================
+
+/**
+ * @brief Norma da diferença entre dois vetores 3D
+ */
+static float diff_norm(const float a[3], const float b[3]) {
+  float dx = a[0] - b[0];
+  float dy = a[1] - b[1];
+  float dz = a[2] - b[2];
+  return sqrtf(dx * dx + dy * dy + dz * dz);
+}
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Zerar estimador (mantém a referência)
+ */
+void calibration_bias_reset(CalibrationBiasEstimator_t *est) {
+  float acc_ref[3], gyro_ref[3];
+
+  memcpy(acc_ref, est->acc_ref, sizeof(acc_ref));
+  memcpy(gyro_ref, est->gyro_ref, sizeof(gyro_ref));
+  memset(est, 0, sizeof(*est));
+  memcpy(est->acc_ref, acc_ref, sizeof(acc_ref));
+  memcpy(est->gyro_ref, gyro_ref, sizeof(gyro_ref));
+}
+
+/**
+ * @brief Definir o bias de referência e descartar a evidência acumulada
+ */
+void calibration_bias_set_reference(CalibrationBiasEstimator_t *est,
+                                    const float acc_ref[3], const float gyro_ref[3]) {
+  memcpy(est->acc_ref, acc_ref, sizeof(est->acc_ref));
+  memcpy(est->gyro_ref, gyro_ref, sizeof(est->gyro_ref));
+  calibration_bias_reset(est);
+}
+
+/**
+ * @brief Processar uma amostra bruta do IMU
+ *
+ * Até CALIB_BIAS_MIN_EVIDENCE amostras, o peso é 1/n (média acumulada,
+ * sem viés de inicialização); depois, CALIB_BIAS_EMA_ALPHA.
+ */
+bool calibration_bias_update(CalibrationBiasEstimator_t *est, const IMUData_t *sample) {
+  est->samples++;
+
+  float acc_norm = sqrtf(sample->ax * sample->ax + sample->ay * sample->ay +
+                         sample->az * sample->az);
+  float gyro_sq = sample->gx * sample->gx + sample->gy * sample->gy +
+                  sample->gz * sample->gz;
+
+  bool still = fabsf(acc_norm - CALIB_GRAVITY) < CALIB_ZV_ACC_THRESHOLD &&
+               gyro_sq < CALIB_ZV_GYRO_THRESHOLD * CALIB_ZV_GYRO_THRESHOLD;
+
+  if (!still) {
+    est->still_run = 0;
+    return false;
+  }
+  if (est->still_run < CALIB_ZV_HOLD_SAMPLES) {
+    est->still_run++;
+    return false;
+  }
+
+  if (est->still_samples < CALIB_BIAS_MIN_EVIDENCE) {
+    est->still_samples++;
+  }
+  float alpha = 1.0f / (float)est->still_samples;
+  if (alpha < CALIB_BIAS_EMA_ALPHA) {
+    alpha = CALIB_BIAS_EMA_ALPHA;
+  }
+
+  // Resíduo em repouso: a - (0, 0, g) = bias do acelerômetro
+  const float acc[3] = { sample->ax, sample->ay, sample->az - CALIB_GRAVITY };
+  const float gyro[3] = { sample->gx, sample->gy, sample->gz };
+
+  for (int i = 0; i < 3; i++) {
+    float delta = acc[i] - est->acc_bias[i];
+    est->acc_bias[i] += alpha * delta;
+    est->acc_noise[i] += alpha * (delta * (acc[i] - est->acc_bias[i]) - est->acc_noise[i]);
+    est->gyro_bias[i] += alpha * (gyro[i] - est->gyro_bias[i]);
+  }
+
+  if (est->still_samples >= CALIB_BIAS_MIN_EVIDENCE) {
+    float acc_drift = diff_norm(est->acc_bias, est->acc_ref);
+    float gyro_drift = diff_norm(est->gyro_bias, est->gyro_ref);
+    if (acc_drift > est->max_acc_drift) {
+      est->max_acc_drift = acc_drift;
+    }
+    if (gyro_drift > est->max_gyro_drift) {
+      est->max_gyro_drift = gyro_drift;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Descartar uma amostra com movimento detectado por outra fonte
+ */
+void calibration_bias_reject(CalibrationBiasEstimator_t *est) {
+  est->samples++;
+  est->still_run = 0;
+}
+
+/**
+ * @brief Atualizar só a referência do giroscópio
+ */
+void calibration_bias_set_gyro_reference(CalibrationBiasEstimator_t *est,
+                                         const float gyro_ref[3]) {
+  memcpy(est->gyro_ref, gyro_ref, sizeof(est->gyro_ref));
+}
+
+/**
+ * @brief Verificar se o robô está em repouso agora
+ */
+bool calibration_bias_is_still(const CalibrationBiasEstimator_t *est) {
+  return est->still_run >= CALIB_ZV_HOLD_SAMPLES;
+}
+
+/**
+ * @brief Verificar se há repouso suficiente para julgar o desvio
+ */
+bool calibration_bias_has_evidence(const CalibrationBiasEstimator_t *est) {
+  return est->still_samples >= CALIB_BIAS_MIN_EVIDENCE;
+}
+
+/**
+ * @brief Desvio atual do bias do acelerômetro
+ */
+float calibration_bias_acc_drift(const CalibrationBiasEstimator_t *est) {
+  return diff_norm(est->acc_bias, est->acc_ref);
+}
+
+/**
+ * @brief Desvio atual do bias do giroscópio
+ */
+float calibration_bias_gyro_drift(const CalibrationBiasEstimator_t *est) {
+  return diff_norm(est->gyro_bias, est->gyro_ref);
+}
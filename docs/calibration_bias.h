@@ -0,0 +1,140 @@
+/**
+ * @file calibration_bias.h
+ * @brief Estimação contínua do bias do IMU (detecção de velocidade zero)
+ * @version 1.0.0
+ *
+ * Cada amostra passa por um detector de repouso (|‖a‖ - g| e ‖ω‖ abaixo
+ * dos limiares por CALIB_ZV_HOLD_SAMPLES amostras seguidas). Em repouso,
+ * o giroscópio mede diretamente o bias e o acelerômetro mede
+ * bias + (0, 0, g), no mesmo modelo de calibrate_imu() (robô nivelado).
+ * As estimativas são médias exponenciais; o custo por amostra é fixo
+ * (sem laços nem buffers), adequado ao caminho de 1 kHz.
+ */
+
+#ifndef CALIBRATION_BIAS_H
+#define CALIBRATION_BIAS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sensor_calibration.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define CALIB_GRAVITY 9.81f              ///< m/s²
+
+#ifndef CALIB_ZV_ACC_THRESHOLD
+#define CALIB_ZV_ACC_THRESHOLD 0.3f      ///< |‖a‖ - g| máximo em repouso (m/s²)
+#endif
+
+#ifndef CALIB_ZV_GYRO_THRESHOLD
+#define CALIB_ZV_GYRO_THRESHOLD 0.05f    ///< ‖ω‖ máximo em repouso (rad/s)
+#endif
+
+#ifndef CALIB_ZV_HOLD_SAMPLES
+#define CALIB_ZV_HOLD_SAMPLES 50         ///< Amostras seguidas para declarar repouso
+#endif
+
+#ifndef CALIB_BIAS_EMA_ALPHA
+#define CALIB_BIAS_EMA_ALPHA (1.0f / 2048.0f)  ///< Constante da média exponencial
+#endif
+
+#ifndef CALIB_BIAS_MIN_EVIDENCE
+#define CALIB_BIAS_MIN_EVIDENCE 2000     ///< Amostras em repouso antes de julgar desvio
+#endif
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+/**
+ * @struct CalibrationBiasEstimator_t
+ * @brief Estado do estimador de bias
+ */
+typedef struct {
+  float acc_bias[3];       ///< Bias do acelerômetro estimado (m/s²)
+  float gyro_bias[3];      ///< Bias do giroscópio estimado (rad/s)
+  float acc_noise[3];      ///< Variância exponencial do resíduo em repouso
+  float acc_ref[3];        ///< Bias de referência (calibração atual)
+  float gyro_ref[3];       ///< Bias de referência do giroscópio
+  float max_acc_drift;     ///< Maior desvio ‖acc_bias - acc_ref‖ observado
+  float max_gyro_drift;    ///< Maior desvio ‖gyro_bias - gyro_ref‖ observado
+  uint32_t samples;        ///< Amostras recebidas
+  uint32_t still_samples;  ///< Amostras usadas na estimativa (saturado)
+  uint32_t still_run;      ///< Amostras em repouso consecutivas
+} CalibrationBiasEstimator_t;
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Zerar estimador (mantém a referência)
+ * @param est Estimador
+ */
+void calibration_bias_reset(CalibrationBiasEstimator_t *est);
+
+/**
+ * @brief Definir o bias de referência e descartar a evidência acumulada
+ * @param est Estimador
+ * @param acc_ref Bias do acelerômetro da calibração atual
+ * @param gyro_ref Bias do giroscópio da calibração atual
+ */
+void calibration_bias_set_reference(CalibrationBiasEstimator_t *est,
+                                    const float acc_ref[3], const float gyro_ref[3]);
+
+/**
+ * @brief Processar uma amostra bruta do IMU (custo fixo)
+ * @param est Estimador
+ * @param sample Amostra bruta
+ * @return true se a amostra foi usada (robô em repouso)
+ */
+bool calibration_bias_update(CalibrationBiasEstimator_t *est, const IMUData_t *sample);
+
+/**
+ * @brief Descartar uma amostra com movimento detectado por outra fonte
+ *
+ * Ex.: rodas girando em velocidade constante, sem aceleração nem rotação
+ * visíveis no IMU. Reinicia a contagem de repouso.
+ * @param est Estimador
+ */
+void calibration_bias_reject(CalibrationBiasEstimator_t *est);
+
+/**
+ * @brief Atualizar só a referência do giroscópio (mantém a evidência)
+ * @param est Estimador
+ * @param gyro_ref Bias de referência (ex.: compensado em temperatura)
+ */
+void calibration_bias_set_gyro_reference(CalibrationBiasEstimator_t *est,
+                                         const float gyro_ref[3]);
+
+/**
+ * @brief Verificar se o robô está em repouso agora
+ * @param est Estimador
+ * @return true se a última amostra foi usada na estimativa
+ */
+bool calibration_bias_is_still(const CalibrationBiasEstimator_t *est);
+
+/**
+ * @brief Verificar se há repouso suficiente para julgar o desvio
+ * @param est Estimador
+ * @return true se still_samples >= CALIB_BIAS_MIN_EVIDENCE
+ */
+bool calibration_bias_has_evidence(const CalibrationBiasEstimator_t *est);
+
+/**
+ * @brief Desvio atual do bias do acelerômetro em relação à referência
+ * @param est Estimador
+ * @return ‖acc_bias - acc_ref‖ (m/s²)
+ */
+float calibration_bias_acc_drift(const CalibrationBiasEstimator_t *est);
+
+/**
+ * @brief Desvio atual do bias do giroscópio em relação à referência
+ * @param est Estimador
+ * @return ‖gyro_bias - gyro_ref‖ (rad/s)
+ */
+float calibration_bias_gyro_drift(const CalibrationBiasEstimator_t *est);
+
+#endif // CALIBRATION_BIAS_H
@@ -0,0 +1,287 @@
+/**
+ * @file calibration_buffer.c
+ * @brief Buffers circulares em layout SoA para IMU e Magnetômetro
+ * @version 1.0.0
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "calibration_buffer.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define CALIB_STATIC_ASSERT(cond, name) typedef char name[(cond) ? 1 : -1]
+
+CALIB_STATIC_ASSERT((CALIB_IMU_RING_CAPACITY & (CALIB_IMU_RING_CAPACITY - 1)) == 0,
+                    imu_ring_capacity_is_power_of_two);
+CALIB_STATIC_ASSERT((CALIB_MAG_RING_CAPACITY & (CALIB_MAG_RING_CAPACITY - 1)) == 0,
+                    mag_ring_capacity_is_power_of_two);
+
+#define IMU_RING_MASK (CALIB_IMU_RING_CAPACITY - 1)
+#define MAG_RING_MASK (CALIB_MAG_RING_CAPACITY - 1)
+
+// ============================================================================
+// BUFFER IMU
+// ============================================================================
+
+/**
+ * @brief Inicializar buffer do IMU
+ */
+void imu_ring_init(IMURing_t *ring) {
+  ring->head = 0;
+  ring->tail = 0;
+}
+
+/**
+ * @brief Número de amostras disponíveis para leitura
+ */
+size_t imu_ring_count(const IMURing_t *ring) {
+  return (size_t)(ring->head - ring->tail);
+}
+
+/**
+ * @brief Inserir amostra (AoS) no buffer
+ */
+bool imu_ring_push(IMURing_t *ring, const IMUData_t *sample) {
+  if (imu_ring_count(ring) >= CALIB_IMU_RING_CAPACITY) {
+    return false;
+  }
+
+  uint32_t i = ring->head & IMU_RING_MASK;
+  ring->ax[i] = sample->ax;
+  ring->ay[i] = sample->ay;
+  ring->az[i] = sample->az;
+  ring->gx[i] = sample->gx;
+  ring->gy[i] = sample->gy;
+  ring->gz[i] = sample->gz;
+  ring->ts[i] = sample->timestamp;
+  ring->head++;
+
+  return true;
+}
+
+/**
+ * @brief Ler uma amostra via read_imu_raw() e inseri-la no buffer
+ */
+bool imu_ring_push_from_driver(IMURing_t *ring) {
+  IMUData_t sample;
+
+  if (!read_imu_raw(&sample)) {
+    return false;
+  }
+
+  return imu_ring_push(ring, &sample);
+}
+
+/**
+ * @brief Obter o maior trecho contíguo pendente como visão SoA
+ */
+size_t imu_ring_peek(IMURing_t *ring, IMUSoAView_t *view) {
+  uint32_t start = ring->tail & IMU_RING_MASK;
+  size_t count = imu_ring_count(ring);
+  size_t until_wrap = CALIB_IMU_RING_CAPACITY - start;
+
+  view->ax = &ring->ax[start];
+  view->ay = &ring->ay[start];
+  view->az = &ring->az[start];
+  view->gx = &ring->gx[start];
+  view->gy = &ring->gy[start];
+  view->gz = &ring->gz[start];
+  view->ts = &ring->ts[start];
+
+  return count < until_wrap ? count : until_wrap;
+}
+
+/**
+ * @brief Descartar amostras já processadas
+ */
+void imu_ring_consume(IMURing_t *ring, size_t n) {
+  size_t count = imu_ring_count(ring);
+  ring->tail += (uint32_t)(n < count ? n : count);
+}
+
+/**
+ * @brief Ler até max amostras em formato AoS
+ */
+size_t imu_ring_read(IMURing_t *ring, IMUData_t *out, size_t max) {
+  size_t total = 0;
+
+  // No máximo dois trechos contíguos (antes e depois do wraparound)
+  while (total < max) {
+    IMUSoAView_t view;
+    size_t n = imu_ring_peek(ring, &view);
+
+    if (n == 0) {
+      break;
+    }
+    if (n > max - total) {
+      n = max - total;
+    }
+
+    imu_soa_to_aos(&view, n, &out[total]);
+    imu_ring_consume(ring, n);
+    total += n;
+  }
+
+  return total;
+}
+
+// ============================================================================
+// BUFFER MAGNETÔMETRO
+// ============================================================================
+
+/**
+ * @brief Inicializar buffer do Magnetômetro
+ */
+void mag_ring_init(MagRing_t *ring) {
+  ring->head = 0;
+  ring->tail = 0;
+}
+
+/**
+ * @brief Número de amostras disponíveis para leitura
+ */
+size_t mag_ring_count(const MagRing_t *ring) {
+  return (size_t)(ring->head - ring->tail);
+}
+
+/**
+ * @brief Inserir amostra (AoS) no buffer
+ */
+bool mag_ring_push(MagRing_t *ring, const MagData_t *sample) {
+  if (mag_ring_count(ring) >= CALIB_MAG_RING_CAPACITY) {
+    return false;
+  }
+
+  uint32_t i = ring->head & MAG_RING_MASK;
+  ring->mx[i] = sample->mx;
+  ring->my[i] = sample->my;
+  ring->mz[i] = sample->mz;
+  ring->ts[i] = sample->timestamp;
+  ring->head++;
+
+  return true;
+}
+
+/**
+ * @brief Ler uma amostra via read_magnetometer_raw() e inseri-la no buffer
+ */
+bool mag_ring_push_from_driver(MagRing_t *ring) {
+  MagData_t sample;
+
+  if (!read_magnetometer_raw(&sample)) {
+    return false;
+  }
+
+  return mag_ring_push(ring, &sample);
+}
+
+/**
+ * @brief Obter o maior trecho contíguo pendente como visão SoA
+ */
+size_t mag_ring_peek(MagRing_t *ring, MagSoAView_t *view) {
+  uint32_t start = ring->tail & MAG_RING_MASK;
+  size_t count = mag_ring_count(ring);
+  size_t until_wrap = CALIB_MAG_RING_CAPACITY - start;
+
+  view->mx = &ring->mx[start];
+  view->my = &ring->my[start];
+  view->mz = &ring->mz[start];
+  view->ts = &ring->ts[start];
+
+  return count < until_wrap ? count : until_wrap;
+}
+
+/**
+ * @brief Descartar amostras já processadas
+ */
+void mag_ring_consume(MagRing_t *ring, size_t n) {
+  size_t count = mag_ring_count(ring);
+  ring->tail += (uint32_t)(n < count ? n : count);
+}
+
+/**
+ * @brief Ler até max amostras em formato AoS
+ */
+size_t mag_ring_read(MagRing_t *ring, MagData_t *out, size_t max) {
+  size_t total = 0;
+
+  while (total < max) {
+    MagSoAView_t view;
+    size_t n = mag_ring_peek(ring, &view);
+
+    if (n == 0) {
+      break;
+    }
+    if (n > max - total) {
+      n = max - total;
+    }
+
+    mag_soa_to_aos(&view, n, &out[total]);
+    mag_ring_consume(ring, n);
+    total += n;
+  }
+
+  return total;
+}
+
+// ============================================================================
+// CONVERSÃO AoS <-> SoA
+// ============================================================================
+
+/**
+ * @brief Converter amostras AoS do IMU para SoA
+ */
+void imu_aos_to_soa(const IMUData_t *in, size_t n, const IMUSoAView_t *out) {
+  for (size_t i = 0; i < n; i++) {
+    out->ax[i] = in[i].ax;
+    out->ay[i] = in[i].ay;
+    out->az[i] = in[i].az;
+    out->gx[i] = in[i].gx;
+    out->gy[i] = in[i].gy;
+    out->gz[i] = in[i].gz;
+    out->ts[i] = in[i].timestamp;
+  }
+}
+
+/**
+ * @brief Converter amostras SoA do IMU para AoS
+ */
+void imu_soa_to_aos(const IMUSoAView_t *in, size_t n, IMUData_t *out) {
+  for (size_t i = 0; i < n; i++) {
+    out[i].ax = in->ax[i];
+    out[i].ay = in->ay[i];
+    out[i].az = in->az[i];
+    out[i].gx = in->gx[i];
+    out[i].gy = in->gy[i];
+    out[i].gz = in->gz[i];
+    out[i].timestamp = in->ts[i];
+  }
+}
+
+/**
+ * @brief Converter amostras AoS do Magnetômetro para SoA
+ */
+void mag_aos_to_soa(const MagData_t *in, size_t n, const MagSoAView_t *out) {
+  for (size_t i = 0; i < n; i++) {
+    out->mx[i] = in[i].mx;
+    out->my[i] = in[i].my;
+    out->mz[i] = in[i].mz;
+    out->ts[i] = in[i].timestamp;
+  }
+}
+
+/**
+ * @brief Converter amostras SoA do Magnetômetro para AoS
+ */
+void mag_soa_to_aos(const MagSoAView_t *in, size_t n, MagData_t *out) {
+  for (size_t i = 0; i < n; i++) {
+    out[i].mx = in->mx[i];
+    out[i].my = in->my[i];
+    out[i].mz = in->mz[i];
+    out[i].timestamp = in->ts[i];
+  }
+}
@@ -0,0 +1,233 @@
+/**
+ * @file calibration_buffer.h
+ * @brief Buffers circulares em layout SoA (structure-of-arrays) para IMU e Magnetômetro
+ * @version 1.0.0
+ *
+ * Cada eixo é armazenado em um array contíguo (ax[], ay[], ..., ts[]),
+ * permitindo que estatísticas e kernels de correção percorram os dados
+ * com passo unitário. A capacidade é definida em tempo de compilação e
+ * deve ser potência de 2.
+ */
+
+#ifndef CALIBRATION_BUFFER_H
+#define CALIBRATION_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "calibration_footprint.h"
+#include "sensor_calibration.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#ifndef CALIB_IMU_RING_CAPACITY
+#define CALIB_IMU_RING_CAPACITY 256   ///< Amostras do IMU (potência de 2)
+#endif
+
+#ifndef CALIB_MAG_RING_CAPACITY
+#define CALIB_MAG_RING_CAPACITY 64    ///< Amostras do Magnetômetro (potência de 2)
+#endif
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+/**
+ * @struct IMUSoAView_t
+ * @brief Visão SoA sobre arrays externos (sem cópia)
+ */
+typedef struct {
+  float *ax, *ay, *az;  ///< Aceleração (m/s²)
+  float *gx, *gy, *gz;  ///< Velocidade angular (rad/s)
+  uint32_t *ts;         ///< Timestamp (ms)
+} IMUSoAView_t;
+
+/**
+ * @struct MagSoAView_t
+ * @brief Visão SoA sobre arrays externos (sem cópia)
+ */
+typedef struct {
+  float *mx, *my, *mz;  ///< Campo magnético (Gauss)
+  uint32_t *ts;         ///< Timestamp (ms)
+} MagSoAView_t;
+
+/**
+ * @struct IMURing_t
+ * @brief Buffer circular SoA de amostras do IMU
+ */
+typedef struct {
+  float ax[CALIB_IMU_RING_CAPACITY];
+  float ay[CALIB_IMU_RING_CAPACITY];
+  float az[CALIB_IMU_RING_CAPACITY];
+  float gx[CALIB_IMU_RING_CAPACITY];
+  float gy[CALIB_IMU_RING_CAPACITY];
+  float gz[CALIB_IMU_RING_CAPACITY];
+  uint32_t ts[CALIB_IMU_RING_CAPACITY];
+  uint32_t head;  ///< Total de amostras escritas
+  uint32_t tail;  ///< Total de amostras consumidas
+} IMURing_t;
+
+/**
+ * @struct MagRing_t
+ * @brief Buffer circular SoA de amostras do Magnetômetro
+ */
+typedef struct {
+  float mx[CALIB_MAG_RING_CAPACITY];
+  float my[CALIB_MAG_RING_CAPACITY];
+  float mz[CALIB_MAG_RING_CAPACITY];
+  uint32_t ts[CALIB_MAG_RING_CAPACITY];
+  uint32_t head;  ///< Total de amostras escritas
+  uint32_t tail;  ///< Total de amostras consumidas
+} MagRing_t;
+
+// ============================================================================
+// BUFFER IMU
+// ============================================================================
+
+/**
+ * @brief Inicializar buffer do IMU
+ * @param ring Buffer
+ */
+void imu_ring_init(IMURing_t *ring);
+
+/**
+ * @brief Número de amostras disponíveis para leitura
+ * @param ring Buffer
+ * @return Amostras pendentes
+ */
+size_t imu_ring_count(const IMURing_t *ring);
+
+/**
+ * @brief Inserir amostra (AoS) no buffer
+ * @param ring Buffer
+ * @param sample Amostra
+ * @return false se o buffer estiver cheio (amostra descartada)
+ */
+bool imu_ring_push(IMURing_t *ring, const IMUData_t *sample);
+
+/**
+ * @brief Ler uma amostra via read_imu_raw() e inseri-la no buffer
+ * @param ring Buffer
+ * @return false se a leitura falhar ou o buffer estiver cheio
+ */
+bool imu_ring_push_from_driver(IMURing_t *ring);
+
+/**
+ * @brief Obter o maior trecho contíguo pendente como visão SoA (sem cópia)
+ * @param ring Buffer
+ * @param view Visão preenchida com ponteiros para o buffer
+ * @return Número de amostras na visão (0 se vazio)
+ */
+size_t imu_ring_peek(IMURing_t *ring, IMUSoAView_t *view);
+
+/**
+ * @brief Descartar amostras já processadas via imu_ring_peek()
+ * @param ring Buffer
+ * @param n Número de amostras
+ */
+void imu_ring_consume(IMURing_t *ring, size_t n);
+
+/**
+ * @brief Ler até max amostras em formato AoS
+ * @param ring Buffer
+ * @param out Destino
+ * @param max Capacidade de out
+ * @return Amostras lidas
+ */
+size_t imu_ring_read(IMURing_t *ring, IMUData_t *out, size_t max);
+
+// ============================================================================
+// BUFFER MAGNETÔMETRO
+// ============================================================================
+
+/**
+ * @brief Inicializar buffer do Magnetômetro
+ * @param ring Buffer
+ */
+void mag_ring_init(MagRing_t *ring);
+
+/**
+ * @brief Número de amostras disponíveis para leitura
+ * @param ring Buffer
+ * @return Amostras pendentes
+ */
+size_t mag_ring_count(const MagRing_t *ring);
+
+/**
+ * @brief Inserir amostra (AoS) no buffer
+ * @param ring Buffer
+ * @param sample Amostra
+ * @return false se o buffer estiver cheio (amostra descartada)
+ */
+bool mag_ring_push(MagRing_t *ring, const MagData_t *sample);
+
+/**
+ * @brief Ler uma amostra via read_magnetometer_raw() e inseri-la no buffer
+ * @param ring Buffer
+ * @return false se a leitura falhar ou o buffer estiver cheio
+ */
+bool mag_ring_push_from_driver(MagRing_t *ring);
+
+/**
+ * @brief Obter o maior trecho contíguo pendente como visão SoA (sem cópia)
+ * @param ring Buffer
+ * @param view Visão preenchida com ponteiros para o buffer
+ * @return Número de amostras na visão (0 se vazio)
+ */
+size_t mag_ring_peek(MagRing_t *ring, MagSoAView_t *view);
+
+/**
+ * @brief Descartar amostras já processadas via mag_ring_peek()
+ * @param ring Buffer
+ * @param n Número de amostras
+ */
+void mag_ring_consume(MagRing_t *ring, size_t n);
+
+/**
+ * @brief Ler até max amostras em formato AoS
+ * @param ring Buffer
+ * @param out Destino
+ * @param max Capacidade de out
+ * @return Amostras lidas
+ */
+size_t mag_ring_read(MagRing_t *ring, MagData_t *out, size_t max);
+
+// ============================================================================
+// CONVERSÃO AoS <-> SoA
+// ============================================================================
+
+/**
+ * @brief Converter amostras AoS do IMU para SoA
+ * @param in Amostras AoS
+ * @param n Número de amostras
+ * @param out Visão SoA de destino (arrays com pelo menos n elementos)
+ */
+void imu_aos_to_soa(const IMUData_t *in, size_t n, const IMUSoAView_t *out);
+
+/**
+ * @brief Converter amostras SoA do IMU para AoS
+ * @param in Visão SoA de origem
+ * @param n Número de amostras
+ * @param out Amostras AoS
+ */
+void imu_soa_to_aos(const IMUSoAView_t *in, size_t n, IMUData_t *out);
+
+/**
+ * @brief Converter amostras AoS do Magnetômetro para SoA
+ * @param in Amostras AoS
+ * @param n Número de amostras
+ * @param out Visão SoA de destino (arrays com pelo menos n elementos)
+ */
+void mag_aos_to_soa(const MagData_t *in, size_t n, const MagSoAView_t *out);
+
+/**
+ * @brief Converter amostras SoA do Magnetômetro para AoS
+ * @param in Visão SoA de origem
+ * @param n Número de amostras
+ * @param out Amostras AoS
+ */
+void mag_soa_to_aos(const MagSoAView_t *in, size_t n, MagData_t *out);
+
+#endif // CALIBRATION_BUFFER_H
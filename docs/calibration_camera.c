@@ -0,0 +1,1121 @@
+/**
+ * @file calibration_camera.c
+ * @brief Calibração intrínseca da câmera com tabuleiro de xadrez
+ * @version 1.0.0
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "calibration_camera.h"
+
+#if !defined(CALIB_CAMERA_FORCE_SCALAR) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define CALIB_CAMERA_NEON 1
+#elif !defined(CALIB_CAMERA_FORCE_SCALAR) && (defined(__SSE2__) || defined(_M_X64))
+#include <emmintrin.h>
+#define CALIB_CAMERA_SSE 1
+#endif
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define CALIB_STATIC_ASSERT(cond, name) typedef char name[(cond) ? 1 : -1]
+
+CALIB_STATIC_ASSERT(CALIB_CAMERA_BINS <= 64, camera_bins_fit_mask);
+CALIB_STATIC_ASSERT(CALIB_CAMERA_MAX_FRAMES <= 255, camera_view_count_fits_u8);
+CALIB_STATIC_ASSERT(CALIB_CAMERA_MAX_WIDTH <= INT16_MAX, camera_candidates_fit_i16);
+
+// Detecção
+#define RING_RADIUS 3                    // Raio do anel de 8 amostras (pixels)
+#define MERGE_DIST2 (2 * RING_RADIUS * 2 * RING_RADIUS)  // Máximos mais próximos são um canto
+#define HULL_MIN_TURN_SIN 0.25f          // Vértices do envoltório mais retos são bordas
+#define SNAP_FRACTION 0.4f               // Raio de busca / espaçamento local previsto
+#define SUBPIX_RADIUS 4                  // Janela do refinamento subpixel
+#define SUBPIX_ITERATIONS 3
+#define SUBPIX_EPS 0.05f                 // Deslocamento que encerra o refinamento (pixels)
+
+// Seleção de vistas
+#define TILT_MIN 0.06f                   // |Δ lados opostos| / soma para contar como inclinada
+#define REPLACE_SCORE_GAIN 1.1f          // Nitidez relativa para substituir a vista de um bin
+
+// Levenberg–Marquardt
+#define LM_INTRINSICS 5
+#define LM_POSE 6
+#define LM_LAMBDA_INIT 1e-3
+#define LM_LAMBDA_MIN 1e-9
+#define LM_LAMBDA_MAX 1e10
+#define LM_TOLERANCE 1e-7                // Redução relativa do custo que encerra o ajuste
+#define LM_MAX_ITERATIONS 100
+#define MIN_VIEWS 3
+
+static const int8_t ring_dx[8] = { 3, 2, 0, -2, -3, -2, 0, 2 };
+static const int8_t ring_dy[8] = { 0, 2, 3, 2, 0, -2, -3, -2 };
+
+
+// ============================================================================
+// ÁLGEBRA
+// ============================================================================
+
+/**
+ * @brief Fatoração de Cholesky no lugar (triângulo inferior, linha a linha)
+ * @return false se a matriz não for definida positiva
+ */
+static bool cholesky_factor(double *a, int n) {
+  for (int j = 0; j < n; j++) {
+    double d = a[j * n + j];
+    for (int k = 0; k < j; k++) {
+      d -= a[j * n + k] * a[j * n + k];
+    }
+    if (!(d > 0.0)) {
+      return false;
+    }
+    d = sqrt(d);
+    a[j * n + j] = d;
+    for (int i = j + 1; i < n; i++) {
+      double s = a[i * n + j];
+      for (int k = 0; k < j; k++) {
+        s -= a[i * n + k] * a[j * n + k];
+      }
+      a[i * n + j] = s / d;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Resolver L·Lᵀ·X = B no lugar (B: n x nrhs, linha a linha)
+ */
+static void cholesky_solve(const double *l, int n, double *b, int nrhs) {
+  for (int c = 0; c < nrhs; c++) {
+    for (int i = 0; i < n; i++) {
+      double s = b[i * nrhs + c];
+      for (int k = 0; k < i; k++) {
+        s -= l[i * n + k] * b[k * nrhs + c];
+      }
+      b[i * nrhs + c] = s / l[i * n + i];
+    }
+    for (int i = n - 1; i >= 0; i--) {
+      double s = b[i * nrhs + c];
+      for (int k = i + 1; k < n; k++) {
+        s -= l[k * n + i] * b[k * nrhs + c];
+      }
+      b[i * nrhs + c] = s / l[i * n + i];
+    }
+  }
+}
+
+/**
+ * @brief C = A · B (3x3)
+ */
+static void mat3_mul(const double a[9], const double b[9], double c[9]) {
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      c[i * 3 + j] = a[i * 3] * b[j] + a[i * 3 + 1] * b[3 + j] + a[i * 3 + 2] * b[6 + j];
+    }
+  }
+}
+
+/**
+ * @brief Transformação de normalização de Hartley (centro na origem, distância média √2)
+ */
+static void normalization(const float (*pts)[2], int n, double t[9]) {
+  double mx = 0.0, my = 0.0, dist = 0.0;
+
+  for (int i = 0; i < n; i++) {
+    mx += pts[i][0];
+    my += pts[i][1];
+  }
+  mx /= n;
+  my /= n;
+  for (int i = 0; i < n; i++) {
+    dist += sqrt((pts[i][0] - mx) * (pts[i][0] - mx) + (pts[i][1] - my) * (pts[i][1] - my));
+  }
+  double s = (dist > 0.0) ? sqrt(2.0) * n / dist : 1.0;
+
+  t[0] = s;   t[1] = 0.0; t[2] = -s * mx;
+  t[3] = 0.0; t[4] = s;   t[5] = -s * my;
+  t[6] = 0.0; t[7] = 0.0; t[8] = 1.0;
+}
+
+/**
+ * @brief Homografia src → dst por mínimos quadrados (DLT normalizada, h33 = 1)
+ */
+static bool fit_homography(const float (*src)[2], const float (*dst)[2], int n, double h[9]) {
+  double ts[9], td[9];
+  double ata[64] = { 0 };
+  double atb[8] = { 0 };
+
+  normalization(src, n, ts);
+  normalization(dst, n, td);
+
+  for (int i = 0; i < n; i++) {
+    double x = ts[0] * src[i][0] + ts[2];
+    double y = ts[4] * src[i][1] + ts[5];
+    double u = td[0] * dst[i][0] + td[2];
+    double v = td[4] * dst[i][1] + td[5];
+    const double rows[2][8] = {
+      { x, y, 1.0, 0.0, 0.0, 0.0, -u * x, -u * y },
+      { 0.0, 0.0, 0.0, x, y, 1.0, -v * x, -v * y },
+    };
+    const double rhs[2] = { u, v };
+
+    for (int r = 0; r < 2; r++) {
+      for (int a = 0; a < 8; a++) {
+        atb[a] += rows[r][a] * rhs[r];
+        for (int b = 0; b <= a; b++) {
+          ata[a * 8 + b] += rows[r][a] * rows[r][b];
+        }
+      }
+    }
+  }
+  for (int a = 0; a < 8; a++) {
+    for (int b = a + 1; b < 8; b++) {
+      ata[a * 8 + b] = ata[b * 8 + a];
+    }
+  }
+
+  if (!cholesky_factor(ata, 8)) {
+    return false;
+  }
+  cholesky_solve(ata, 8, atb, 1);
+
+  // H = Td⁻¹ · Hn · Ts
+  double hn[9] = { atb[0], atb[1], atb[2], atb[3], atb[4], atb[5], atb[6], atb[7], 1.0 };
+  double td_inv[9] = { 1.0 / td[0], 0.0, -td[2] / td[0],
+                       0.0, 1.0 / td[4], -td[5] / td[4],
+                       0.0, 0.0, 1.0 };
+  double tmp[9];
+  mat3_mul(hn, ts, tmp);
+  mat3_mul(td_inv, tmp, h);
+  return true;
+}
+
+/**
+ * @brief Aplicar homografia a um ponto
+ */
+static void homography_apply(const double h[9], float x, float y, float out[2]) {
+  double w = h[6] * x + h[7] * y + h[8];
+  out[0] = (float)((h[0] * x + h[1] * y + h[2]) / w);
+  out[1] = (float)((h[3] * x + h[4] * y + h[5]) / w);
+}
+
+// ============================================================================
+// RESPOSTA DE CANTO
+// ============================================================================
+
+/**
+ * @brief Resposta de canto X num pixel (anel de 8 amostras)
+ *
+ * p0..p7 a 45° em torno do pixel. Num canto X pares opostos têm a mesma
+ * cor (|p0 - p4| ≈ 0) e pares a 90° têm cores opostas; numa borda reta
+ * ocorre o inverso. Resposta = soma - diferença, em [-1020, 1020].
+ */
+static int16_t ring_response_scalar(const uint8_t *p, const ptrdiff_t off[8]) {
+  int q[8];
+
+  for (int k = 0; k < 8; k++) {
+    q[k] = p[off[k]];
+  }
+  int sum = abs(q[0] + q[4] - q[2] - q[6]) + abs(q[1] + q[5] - q[3] - q[7]);
+  int diff = abs(q[0] - q[4]) + abs(q[1] - q[5]) + abs(q[2] - q[6]) + abs(q[3] - q[7]);
+  return (int16_t)(sum - diff);
+}
+
+#if defined(CALIB_CAMERA_SSE)
+static __m128i abs_epi16(__m128i x) {
+  return _mm_max_epi16(x, _mm_sub_epi16(_mm_setzero_si128(), x));
+}
+
+/**
+ * @brief Resposta de 8 pixels (lanes int16) a partir das 8 amostras do anel
+ */
+static __m128i ring_response_sse(const __m128i q[8]) {
+  __m128i s0 = _mm_sub_epi16(_mm_add_epi16(q[0], q[4]), _mm_add_epi16(q[2], q[6]));
+  __m128i s1 = _mm_sub_epi16(_mm_add_epi16(q[1], q[5]), _mm_add_epi16(q[3], q[7]));
+  __m128i sum = _mm_add_epi16(abs_epi16(s0), abs_epi16(s1));
+  __m128i diff = _mm_add_epi16(_mm_add_epi16(abs_epi16(_mm_sub_epi16(q[0], q[4])),
+                                             abs_epi16(_mm_sub_epi16(q[1], q[5]))),
+                               _mm_add_epi16(abs_epi16(_mm_sub_epi16(q[2], q[6])),
+                                             abs_epi16(_mm_sub_epi16(q[3], q[7]))));
+  return _mm_sub_epi16(sum, diff);
+}
+#elif defined(CALIB_CAMERA_NEON)
+/**
+ * @brief Resposta de 8 pixels (lanes int16) a partir das 8 amostras do anel
+ */
+static int16x8_t ring_response_neon(const int16x8_t q[8]) {
+  int16x8_t s0 = vsubq_s16(vaddq_s16(q[0], q[4]), vaddq_s16(q[2], q[6]));
+  int16x8_t s1 = vsubq_s16(vaddq_s16(q[1], q[5]), vaddq_s16(q[3], q[7]));
+  int16x8_t sum = vaddq_s16(vabsq_s16(s0), vabsq_s16(s1));
+  int16x8_t diff = vaddq_s16(vaddq_s16(vabdq_s16(q[0], q[4]), vabdq_s16(q[1], q[5])),
+                             vaddq_s16(vabdq_s16(q[2], q[6]), vabdq_s16(q[3], q[7])));
+  return vsubq_s16(sum, diff);
+}
+#endif
+
+/**
+ * @brief Resposta de uma linha inteira (bordas sem anel completo = 0)
+ */
+static void response_row(const uint8_t *row, const ptrdiff_t off[8], int16_t *out, int width) {
+  int x = RING_RADIUS;
+  const int end = width - RING_RADIUS;
+
+  memset(out, 0, sizeof(int16_t) * (size_t)width);
+
+#if defined(CALIB_CAMERA_SSE)
+  const __m128i zero = _mm_setzero_si128();
+  for (; x + 16 <= end; x += 16) {
+    __m128i lo[8], hi[8];
+    for (int k = 0; k < 8; k++) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(row + x + off[k]));
+      lo[k] = _mm_unpacklo_epi8(v, zero);
+      hi[k] = _mm_unpackhi_epi8(v, zero);
+    }
+    _mm_storeu_si128((__m128i *)(out + x), ring_response_sse(lo));
+    _mm_storeu_si128((__m128i *)(out + x + 8), ring_response_sse(hi));
+  }
+#elif defined(CALIB_CAMERA_NEON)
+  for (; x + 16 <= end; x += 16) {
+    int16x8_t lo[8], hi[8];
+    for (int k = 0; k < 8; k++) {
+      uint8x16_t v = vld1q_u8(row + x + off[k]);
+      lo[k] = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(v)));
+      hi[k] = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(v)));
+    }
+    vst1q_s16(out + x, ring_response_neon(lo));
+    vst1q_s16(out + x + 8, ring_response_neon(hi));
+  }
+#endif
+
+  for (; x < end; x++) {
+    out[x] = ring_response_scalar(row + x, off);
+  }
+}
+
+// ============================================================================
+// CANDIDATOS
+// ============================================================================
+
+/**
+ * @brief Registrar um máximo local (funde máximos próximos, mantém os mais fortes)
+ */
+static void candidate_add(CameraDetectScratch_t *scratch, int x, int y, int16_t response) {
+  CameraCornerCandidate_t *candidates = scratch->candidates;
+  int weakest = 0;
+
+  for (int i = 0; i < scratch->candidate_count; i++) {
+    float dx = candidates[i].x - (float)x;
+    float dy = candidates[i].y - (float)y;
+    if (dx * dx + dy * dy <= (float)MERGE_DIST2) {
+      if (response > candidates[i].response) {
+        candidates[i].x = (int16_t)x;
+        candidates[i].y = (int16_t)y;
+        candidates[i].response = response;
+      }
+      return;
+    }
+    if (candidates[i].response < candidates[weakest].response) {
+      weakest = i;
+    }
+  }
+
+  if (scratch->candidate_count < CALIB_CAMERA_MAX_CANDIDATES) {
+    weakest = scratch->candidate_count++;
+  } else if (response <= candidates[weakest].response) {
+    return;
+  }
+  candidates[weakest].x = (int16_t)x;
+  candidates[weakest].y = (int16_t)y;
+  candidates[weakest].response = response;
+}
+
+/**
+ * @brief Varrer o quadro: resposta por linha + supressão de não-máximos 3x3
+ *
+ * Só três linhas de resposta ficam em memória; a linha y-1 é avaliada
+ * assim que a linha y fica pronta.
+ */
+static void detect_candidates(CameraDetectScratch_t *scratch, const CameraFrame_t *frame) {
+  ptrdiff_t off[8];
+  const int width = frame->width;
+
+  for (int k = 0; k < 8; k++) {
+    off[k] = (ptrdiff_t)ring_dy[k] * (ptrdiff_t)frame->stride + ring_dx[k];
+  }
+  scratch->candidate_count = 0;
+
+  for (int y = RING_RADIUS; y < frame->height - RING_RADIUS; y++) {
+    response_row(frame->pixels + (size_t)y * frame->stride, off, scratch->response_rows[y % 3],
+                 width);
+    if (y < RING_RADIUS + 2) {
+      continue;
+    }
+
+    const int16_t *up = scratch->response_rows[(y - 2) % 3];
+    const int16_t *mid = scratch->response_rows[(y - 1) % 3];
+    const int16_t *down = scratch->response_rows[y % 3];
+
+    for (int x = RING_RADIUS + 1; x < width - RING_RADIUS - 1; x++) {
+      int16_t c = mid[x];
+      if (c < CALIB_CAMERA_RESPONSE_MIN) {
+        continue;
+      }
+      // Estrito para cima/esquerda, não estrito para baixo/direita: platôs geram um único máximo
+      if (c > up[x - 1] && c > up[x] && c > up[x + 1] && c > mid[x - 1] &&
+          c >= mid[x + 1] && c >= down[x - 1] && c >= down[x] && c >= down[x + 1]) {
+        candidate_add(scratch, x, y - 1, c);
+      }
+    }
+  }
+}
+
+static int compare_response_desc(const void *a, const void *b) {
+  const CameraCornerCandidate_t *ca = (const CameraCornerCandidate_t *)a;
+  const CameraCornerCandidate_t *cb = (const CameraCornerCandidate_t *)b;
+  return (int)cb->response - (int)ca->response;
+}
+
+static int compare_position(const void *a, const void *b) {
+  const CameraCornerCandidate_t *ca = (const CameraCornerCandidate_t *)a;
+  const CameraCornerCandidate_t *cb = (const CameraCornerCandidate_t *)b;
+  if (ca->x != cb->x) {
+    return (ca->x < cb->x) ? -1 : 1;
+  }
+  return (ca->y < cb->y) ? -1 : (ca->y > cb->y);
+}
+
+// ============================================================================
+// MONTAGEM DA GRADE
+// ============================================================================
+
+static float cross2(const CameraCornerCandidate_t *o, const CameraCornerCandidate_t *a,
+                    const CameraCornerCandidate_t *b) {
+  return (float)(a->x - o->x) * (float)(b->y - o->y) - (float)(a->y - o->y) * (float)(b->x - o->x);
+}
+
+/**
+ * @brief Envoltório convexo (cadeia monótona de Andrew), sentido de cross2 > 0
+ * @param candidates Candidatos, já ordenados por posição
+ * @param n Número de candidatos
+ * @param hull Índices dos vértices (capacidade n + 1)
+ * @return Número de vértices
+ */
+static int convex_hull(const CameraCornerCandidate_t *candidates, int n, int *hull) {
+  int k = 0;
+
+  for (int i = 0; i < n; i++) {
+    while (k >= 2 && cross2(&candidates[hull[k - 2]], &candidates[hull[k - 1]], &candidates[i]) <= 0.0f) {
+      k--;
+    }
+    hull[k++] = i;
+  }
+  for (int i = n - 2, lower = k + 1; i >= 0; i--) {
+    while (k >= lower && cross2(&candidates[hull[k - 2]], &candidates[hull[k - 1]], &candidates[i]) <= 0.0f) {
+      k--;
+    }
+    hull[k++] = i;
+  }
+  return k - 1;  // O último repete o primeiro
+}
+
+/**
+ * @brief Remover vértices quase retos até restarem os cantos externos
+ *
+ * Cantos da borda do tabuleiro (distorção, perspectiva) entram no
+ * envoltório com curvatura pequena; os quatro cantos externos dobram ~90°.
+ */
+static int prune_hull(const CameraCornerCandidate_t *candidates, int *hull, int h) {
+  while (h > 4) {
+    int flattest = -1;
+    float flattest_sin = HULL_MIN_TURN_SIN;
+
+    for (int i = 0; i < h; i++) {
+      const CameraCornerCandidate_t *prev = &candidates[hull[(i + h - 1) % h]];
+      const CameraCornerCandidate_t *cur = &candidates[hull[i]];
+      const CameraCornerCandidate_t *next = &candidates[hull[(i + 1) % h]];
+      float e1x = cur->x - prev->x, e1y = cur->y - prev->y;
+      float e2x = next->x - cur->x, e2y = next->y - cur->y;
+      float norm = sqrtf((e1x * e1x + e1y * e1y) * (e2x * e2x + e2y * e2y));
+      float turn = (norm > 0.0f) ? fabsf(e1x * e2y - e1y * e2x) / norm : 0.0f;
+
+      if (turn < flattest_sin) {
+        flattest_sin = turn;
+        flattest = i;
+      }
+    }
+    if (flattest < 0) {
+      break;
+    }
+    memmove(&hull[flattest], &hull[flattest + 1], sizeof(int) * (size_t)(h - flattest - 1));
+    h--;
+  }
+  return h;
+}
+
+/**
+ * @brief Refinamento subpixel: ponto q onde gᵀ·(p - q) = 0 para todos os
+ * gradientes g da janela (bordas que passam pelo canto)
+ */
+static bool refine_corner(const CameraFrame_t *frame, float *px, float *py) {
+  for (int iter = 0; iter < SUBPIX_ITERATIONS; iter++) {
+    int cx = (int)lrintf(*px);
+    int cy = (int)lrintf(*py);
+
+    if (cx - SUBPIX_RADIUS - 1 < 0 || cy - SUBPIX_RADIUS - 1 < 0 ||
+        cx + SUBPIX_RADIUS + 1 >= frame->width || cy + SUBPIX_RADIUS + 1 >= frame->height) {
+      return false;
+    }
+
+    float gxx = 0.0f, gxy = 0.0f, gyy = 0.0f, bx = 0.0f, by = 0.0f;
+    for (int y = cy - SUBPIX_RADIUS; y <= cy + SUBPIX_RADIUS; y++) {
+      const uint8_t *row = frame->pixels + (size_t)y * frame->stride;
+      for (int x = cx - SUBPIX_RADIUS; x <= cx + SUBPIX_RADIUS; x++) {
+        float gx = 0.5f * ((float)row[x + 1] - (float)row[x - 1]);
+        float gy = 0.5f * ((float)row[x + frame->stride] - (float)row[x - (ptrdiff_t)frame->stride]);
+        float a = gx * gx, b = gx * gy, c = gy * gy;
+        gxx += a;
+        gxy += b;
+        gyy += c;
+        bx += a * (float)x + b * (float)y;
+        by += b * (float)x + c * (float)y;
+      }
+    }
+
+    float det = gxx * gyy - gxy * gxy;
+    if (!(det > 1e-6f * (gxx + gyy) * (gxx + gyy))) {
+      return false;
+    }
+    float qx = (gyy * bx - gxy * by) / det;
+    float qy = (gxx * by - gxy * bx) / det;
+
+    if (fabsf(qx - (float)cx) > SUBPIX_RADIUS || fabsf(qy - (float)cy) > SUBPIX_RADIUS) {
+      return false;
+    }
+    float shift = fabsf(qx - *px) + fabsf(qy - *py);
+    *px = qx;
+    *py = qy;
+    if (shift < SUBPIX_EPS) {
+      break;
+    }
+  }
+  return true;
+}
+
+// ============================================================================
+// MODELO DE PROJEÇÃO
+// ============================================================================
+
+/**
+ * @brief Projetar o canto (X, Y, 0) do tabuleiro
+ * @param jp Derivadas em (f, cx, cy, k1, k2), pode ser NULL
+ * @param jq Derivadas em (ω, δt) com R' = exp(ω)·R, t' = t + δt, pode ser NULL
+ * @return false se o ponto estiver atrás da câmera
+ */
+static bool project(const CameraIntrinsics_t *in, const float r[9], const float t[3],
+                    float bx, float by, float uv[2], double jp[2][LM_INTRINSICS],
+                    double jq[2][LM_POSE]) {
+  float qx = r[0] * bx + r[1] * by;
+  float qy = r[3] * bx + r[4] * by;
+  float qz = r[6] * bx + r[7] * by;
+  float z = qz + t[2];
+
+  if (!(z > 1e-3f)) {
+    return false;
+  }
+
+  float iz = 1.0f / z;
+  float x = (qx + t[0]) * iz;
+  float y = (qy + t[1]) * iz;
+  float r2 = x * x + y * y;
+  float d = 1.0f + in->k1 * r2 + in->k2 * r2 * r2;
+  float f = in->focal_length;
+
+  uv[0] = f * x * d + in->cx;
+  uv[1] = f * y * d + in->cy;
+
+  if (jp != NULL) {
+    jp[0][0] = x * d; jp[0][1] = 1.0; jp[0][2] = 0.0; jp[0][3] = f * x * r2; jp[0][4] = f * x * r2 * r2;
+    jp[1][0] = y * d; jp[1][1] = 0.0; jp[1][2] = 1.0; jp[1][3] = f * y * r2; jp[1][4] = f * y * r2 * r2;
+  }
+
+  if (jq != NULL) {
+    float dd = 2.0f * (in->k1 + 2.0f * in->k2 * r2);
+    float du[2] = { f * (d + x * x * dd), f * x * y * dd };  // ∂u/∂(x, y)
+    float dv[2] = { f * x * y * dd, f * (d + y * y * dd) };  // ∂v/∂(x, y)
+    const float *dxy[2] = { du, dv };
+
+    for (int k = 0; k < 2; k++) {
+      // M = ∂(u|v)/∂Xc;  ∂Xc/∂ω = -[q]×,  ∂Xc/∂δt = I
+      float m0 = dxy[k][0] * iz;
+      float m1 = dxy[k][1] * iz;
+      float m2 = -(dxy[k][0] * x + dxy[k][1] * y) * iz;
+      jq[k][0] = -m1 * qz + m2 * qy;
+      jq[k][1] = m0 * qz - m2 * qx;
+      jq[k][2] = -m0 * qy + m1 * qx;
+      jq[k][3] = m0;
+      jq[k][4] = m1;
+      jq[k][5] = m2;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Canto observado de uma vista (pixels)
+ */
+static void view_corner(const CameraView_t *view, int p, float obs[2]) {
+  const float scale = 1.0f / (float)(1 << CALIB_CAMERA_SUBPIXEL_BITS);
+  obs[0] = view->corners[p][0] * scale;
+  obs[1] = view->corners[p][1] * scale;
+}
+
+/**
+ * @brief Custo de uma vista (soma dos resíduos²), infinito se algum ponto não projetar
+ */
+static double view_cost(const CameraIntrinsics_t *in, const CameraView_t *view,
+                        const float r[9], const float t[3]) {
+  double cost = 0.0;
+
+  for (int p = 0; p < CALIB_CAMERA_BOARD_POINTS; p++) {
+    float uv[2], obs[2];
+    if (!project(in, r, t, (float)(p % CALIB_CAMERA_BOARD_COLS),
+                 (float)(p / CALIB_CAMERA_BOARD_COLS), uv, NULL, NULL)) {
+      return HUGE_VAL;
+    }
+    view_corner(view, p, obs);
+    cost += (double)(uv[0] - obs[0]) * (uv[0] - obs[0]) + (double)(uv[1] - obs[1]) * (uv[1] - obs[1]);
+  }
+  return cost;
+}
+
+/**
+ * @brief Blocos das equações normais de uma vista
+ * @param a Jpᵀ·Jp acumulado (5x5)
+ * @param ga Jpᵀ·e acumulado (5)
+ * @param c Jqᵀ·Jq da vista (6x6)
+ * @param b Jpᵀ·Jq da vista (5x6)
+ * @param gq Jqᵀ·e da vista (6)
+ */
+static void view_normal_equations(const CameraIntrinsics_t *in, const CameraView_t *view,
+                                  double a[LM_INTRINSICS * LM_INTRINSICS], double ga[LM_INTRINSICS],
+                                  double c[LM_POSE * LM_POSE], double b[LM_INTRINSICS * LM_POSE],
+                                  double gq[LM_POSE]) {
+  memset(c, 0, sizeof(double) * LM_POSE * LM_POSE);
+  memset(b, 0, sizeof(double) * LM_INTRINSICS * LM_POSE);
+  memset(gq, 0, sizeof(double) * LM_POSE);
+
+  for (int p = 0; p < CALIB_CAMERA_BOARD_POINTS; p++) {
+    float uv[2], obs[2];
+    double jp[2][LM_INTRINSICS], jq[2][LM_POSE];
+
+    if (!project(in, view->rotation, view->translation, (float)(p % CALIB_CAMERA_BOARD_COLS),
+                 (float)(p / CALIB_CAMERA_BOARD_COLS), uv, jp, jq)) {
+      continue;
+    }
+    view_corner(view, p, obs);
+    const double e[2] = { uv[0] - obs[0], uv[1] - obs[1] };
+
+    for (int k = 0; k < 2; k++) {
+      for (int i = 0; i < LM_INTRINSICS; i++) {
+        ga[i] += jp[k][i] * e[k];
+        for (int j = 0; j < LM_INTRINSICS; j++) {
+          a[i * LM_INTRINSICS + j] += jp[k][i] * jp[k][j];
+        }
+        for (int j = 0; j < LM_POSE; j++) {
+          b[i * LM_POSE + j] += jp[k][i] * jq[k][j];
+        }
+      }
+      for (int i = 0; i < LM_POSE; i++) {
+        gq[i] += jq[k][i] * e[k];
+        for (int j = 0; j < LM_POSE; j++) {
+          c[i * LM_POSE + j] += jq[k][i] * jq[k][j];
+        }
+      }
+    }
+  }
+}
+
+/**
+ * @brief R' = exp([ω]×)·R (Rodrigues)
+ */
+static void rotate_pose(const float r[9], const double w[3], float out[9]) {
+  double theta = sqrt(w[0] * w[0] + w[1] * w[1] + w[2] * w[2]);
+  double e[9];
+
+  if (theta < 1e-12) {
+    memcpy(out, r, sizeof(float) * 9);
+    return;
+  }
+  double kx = w[0] / theta, ky = w[1] / theta, kz = w[2] / theta;
+  double s = sin(theta), c = cos(theta), v = 1.0 - c;
+
+  e[0] = c + kx * kx * v;      e[1] = kx * ky * v - kz * s; e[2] = kx * kz * v + ky * s;
+  e[3] = ky * kx * v + kz * s; e[4] = c + ky * ky * v;      e[5] = ky * kz * v - kx * s;
+  e[6] = kz * kx * v - ky * s; e[7] = kz * ky * v + kx * s; e[8] = c + kz * kz * v;
+
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      out[i * 3 + j] = (float)(e[i * 3] * r[j] + e[i * 3 + 1] * r[3 + j] + e[i * 3 + 2] * r[6 + j]);
+    }
+  }
+}
+
+/**
+ * @brief Pose inicial da vista a partir da homografia: K⁻¹·H = λ·[r1 r2 t]
+ */
+static void pose_from_homography(const double h[9], const CameraIntrinsics_t *in,
+                                 CameraView_t *view) {
+  double m[3][3];  // Colunas de K⁻¹·H
+
+  for (int j = 0; j < 3; j++) {
+    m[j][0] = (h[j] - in->cx * h[6 + j]) / in->focal_length;
+    m[j][1] = (h[3 + j] - in->cy * h[6 + j]) / in->focal_length;
+    m[j][2] = h[6 + j];
+  }
+
+  double scale = 1.0 / sqrt(m[0][0] * m[0][0] + m[0][1] * m[0][1] + m[0][2] * m[0][2]);
+  if (m[2][2] * scale < 0.0) {
+    scale = -scale;  // Tabuleiro à frente da câmera
+  }
+
+  // Ortonormalizar r1, r2 simetricamente (bissetriz preservada)
+  double a[3], b[3], sum[3], dif[3], r1[3], r2[3], r3[3];
+  double na = 0.0, nb = 0.0, ns = 0.0, nd = 0.0;
+  for (int i = 0; i < 3; i++) {
+    a[i] = m[0][i];
+    b[i] = m[1][i];
+    na += a[i] * a[i];
+    nb += b[i] * b[i];
+  }
+  for (int i = 0; i < 3; i++) {
+    a[i] /= sqrt(na);
+    b[i] /= sqrt(nb);
+    sum[i] = a[i] + b[i];
+    dif[i] = a[i] - b[i];
+    ns += sum[i] * sum[i];
+    nd += dif[i] * dif[i];
+  }
+  for (int i = 0; i < 3; i++) {
+    double s = (scale < 0.0) ? -1.0 : 1.0;
+    r1[i] = s * (sum[i] / sqrt(ns) + dif[i] / sqrt(nd)) / sqrt(2.0);
+    r2[i] = s * (sum[i] / sqrt(ns) - dif[i] / sqrt(nd)) / sqrt(2.0);
+  }
+  r3[0] = r1[1] * r2[2] - r1[2] * r2[1];
+  r3[1] = r1[2] * r2[0] - r1[0] * r2[2];
+  r3[2] = r1[0] * r2[1] - r1[1] * r2[0];
+
+  for (int i = 0; i < 3; i++) {
+    view->rotation[i * 3 + 0] = (float)r1[i];
+    view->rotation[i * 3 + 1] = (float)r2[i];
+    view->rotation[i * 3 + 2] = (float)r3[i];
+    view->translation[i] = (float)(scale * m[2][i]);
+  }
+}
+
+/**
+ * @brief Homografia tabuleiro → imagem de uma vista guardada
+ */
+static bool view_homography(const CameraView_t *view, double h[9]) {
+  float board[CALIB_CAMERA_BOARD_POINTS][2];
+  float image[CALIB_CAMERA_BOARD_POINTS][2];
+
+  for (int p = 0; p < CALIB_CAMERA_BOARD_POINTS; p++) {
+    board[p][0] = (float)(p % CALIB_CAMERA_BOARD_COLS);
+    board[p][1] = (float)(p / CALIB_CAMERA_BOARD_COLS);
+    view_corner(view, p, image[p]);
+  }
+  return fit_homography((const float (*)[2])board, (const float (*)[2])image,
+                        CALIB_CAMERA_BOARD_POINTS, h);
+}
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Zerar o calibrador
+ */
+void calibration_camera_reset(CameraCalibrator_t *cal) {
+  memset(cal, 0, sizeof(*cal));
+}
+
+/**
+ * @brief Detectar o tabuleiro num quadro
+ *
+ * Os candidatos mais fracos que metade da resposta mediana dos N mais
+ * fortes são descartados; o envoltório dos restantes deve reduzir-se aos
+ * quatro cantos externos, cuja homografia prevê cada canto interno.
+ */
+bool calibration_camera_detect(CameraDetectScratch_t *scratch, const CameraFrame_t *frame,
+                               float corners[CALIB_CAMERA_BOARD_POINTS][2], float *score) {
+  CameraCornerCandidate_t *candidates = scratch->candidates;
+  const int cols = CALIB_CAMERA_BOARD_COLS;
+  const int rows = CALIB_CAMERA_BOARD_ROWS;
+  int hull[CALIB_CAMERA_MAX_CANDIDATES + 1];
+
+  if (frame->width > CALIB_CAMERA_MAX_WIDTH || frame->width < 4 * RING_RADIUS ||
+      frame->height < 4 * RING_RADIUS || frame->height > INT16_MAX) {
+    return false;
+  }
+
+  detect_candidates(scratch, frame);
+  if (scratch->candidate_count < CALIB_CAMERA_BOARD_POINTS) {
+    return false;
+  }
+
+  qsort(candidates, (size_t)scratch->candidate_count, sizeof(CameraCornerCandidate_t),
+        compare_response_desc);
+  int n = scratch->candidate_count;
+  int16_t floor_response = candidates[CALIB_CAMERA_BOARD_POINTS / 2].response / 2;
+  while (n > CALIB_CAMERA_BOARD_POINTS && candidates[n - 1].response < floor_response) {
+    n--;
+  }
+  qsort(candidates, (size_t)n, sizeof(CameraCornerCandidate_t), compare_position);
+
+  int h = prune_hull(candidates, hull, convex_hull(candidates, n, hull));
+  if (h != 4) {
+    return false;
+  }
+
+  // Rotular os cantos externos no mesmo sentido da grade; lado longo = colunas
+  float quad[4][2], outer[4][2];
+  int k = 0;
+  float len[4];
+  for (int i = 0; i < 4; i++) {
+    const CameraCornerCandidate_t *a = &candidates[hull[i]];
+    const CameraCornerCandidate_t *b = &candidates[hull[(i + 1) % 4]];
+    len[i] = sqrtf((b->x - a->x) * (b->x - a->x) + (b->y - a->y) * (b->y - a->y));
+  }
+  k = ((len[0] + len[2] >= len[1] + len[3]) == (cols >= rows)) ? 0 : 1;
+  if (candidates[hull[k + 2]].x + candidates[hull[k + 2]].y <
+      candidates[hull[k]].x + candidates[hull[k]].y) {
+    k += 2;
+  }
+  for (int i = 0; i < 4; i++) {
+    quad[i][0] = candidates[hull[(k + i) % 4]].x;
+    quad[i][1] = candidates[hull[(k + i) % 4]].y;
+  }
+  outer[0][0] = 0.0f;               outer[0][1] = 0.0f;
+  outer[1][0] = (float)(cols - 1);  outer[1][1] = 0.0f;
+  outer[2][0] = (float)(cols - 1);  outer[2][1] = (float)(rows - 1);
+  outer[3][0] = 0.0f;               outer[3][1] = (float)(rows - 1);
+
+  double hom[9];
+  if (!fit_homography((const float (*)[2])outer, (const float (*)[2])quad, 4, hom)) {
+    return false;
+  }
+
+  // Associar cada canto previsto ao candidato mais próximo
+  bool used[CALIB_CAMERA_MAX_CANDIDATES] = { false };
+  float total = 0.0f;
+  for (int p = 0; p < CALIB_CAMERA_BOARD_POINTS; p++) {
+    float i = (float)(p % cols), j = (float)(p / cols);
+    float pred[2], right[2], down[2];
+
+    homography_apply(hom, i, j, pred);
+    homography_apply(hom, i + 1.0f, j, right);
+    homography_apply(hom, i, j + 1.0f, down);
+    float sx = (right[0] - pred[0]) * (right[0] - pred[0]) + (right[1] - pred[1]) * (right[1] - pred[1]);
+    float sy = (down[0] - pred[0]) * (down[0] - pred[0]) + (down[1] - pred[1]) * (down[1] - pred[1]);
+    float best = SNAP_FRACTION * SNAP_FRACTION * (sx < sy ? sx : sy);
+    int match = -1;
+
+    for (int c = 0; c < n; c++) {
+      float dx = candidates[c].x - pred[0];
+      float dy = candidates[c].y - pred[1];
+      float d2 = dx * dx + dy * dy;
+      if (!used[c] && d2 < best) {
+        best = d2;
+        match = c;
+      }
+    }
+    if (match < 0) {
+      return false;
+    }
+
+    used[match] = true;
+    corners[p][0] = candidates[match].x;
+    corners[p][1] = candidates[match].y;
+    total += candidates[match].response;
+    if (!refine_corner(frame, &corners[p][0], &corners[p][1])) {
+      return false;
+    }
+  }
+
+  *score = total / (float)CALIB_CAMERA_BOARD_POINTS;
+  return true;
+}
+
+/**
+ * @brief Processar um quadro e decidir se a vista é guardada
+ *
+ * Bin = célula 3x3 do centro do tabuleiro x classe de inclinação
+ * (frontal, ±x, ±y pela diferença entre lados opostos). Bins novos são
+ * sempre aceitos; um bin ocupado só troca de vista por uma mais nítida.
+ */
+bool calibration_camera_add_frame(CameraCalibrator_t *cal, const CameraFrame_t *frame) {
+  float corners[CALIB_CAMERA_BOARD_POINTS][2];
+  float score;
+
+  cal->frames_seen++;
+  cal->frames_since_new++;
+
+  if ((cal->view_count > 0 && (frame->width != cal->width || frame->height != cal->height)) ||
+      !calibration_camera_detect(&cal->work.scratch, frame, corners, &score)) {
+    cal->frames_rejected++;
+    return false;
+  }
+  cal->width = frame->width;
+  cal->height = frame->height;
+
+  const float *c00 = corners[0];
+  const float *c10 = corners[CALIB_CAMERA_BOARD_COLS - 1];
+  const float *c11 = corners[CALIB_CAMERA_BOARD_POINTS - 1];
+  const float *c01 = corners[CALIB_CAMERA_BOARD_POINTS - CALIB_CAMERA_BOARD_COLS];
+  float top = hypotf(c10[0] - c00[0], c10[1] - c00[1]);
+  float bottom = hypotf(c11[0] - c01[0], c11[1] - c01[1]);
+  float left = hypotf(c01[0] - c00[0], c01[1] - c00[1]);
+  float right = hypotf(c11[0] - c10[0], c11[1] - c10[1]);
+  float tx = (right - left) / (right + left);
+  float ty = (bottom - top) / (bottom + top);
+
+  int tilt = 0;
+  if (fabsf(tx) >= TILT_MIN || fabsf(ty) >= TILT_MIN) {
+    tilt = (fabsf(tx) >= fabsf(ty)) ? (tx > 0.0f ? 1 : 2) : (ty > 0.0f ? 3 : 4);
+  }
+  float mx = 0.25f * (c00[0] + c10[0] + c11[0] + c01[0]);
+  float my = 0.25f * (c00[1] + c10[1] + c11[1] + c01[1]);
+  int cell_x = (int)(3.0f * mx / (float)frame->width);
+  int cell_y = (int)(3.0f * my / (float)frame->height);
+  cell_x = cell_x < 0 ? 0 : (cell_x > 2 ? 2 : cell_x);
+  cell_y = cell_y < 0 ? 0 : (cell_y > 2 ? 2 : cell_y);
+  uint8_t bin = (uint8_t)((cell_y * 3 + cell_x) * CALIB_CAMERA_TILT_CLASSES + tilt);
+
+  CameraView_t *view = NULL;
+  if (cal->bins_used & (1ULL << bin)) {
+    for (int v = 0; v < cal->view_count; v++) {
+      if (cal->views[v].bin == bin && score > cal->views[v].score * REPLACE_SCORE_GAIN) {
+        view = &cal->views[v];
+      }
+    }
+  } else if (cal->view_count < CALIB_CAMERA_MAX_FRAMES) {
+    view = &cal->views[cal->view_count++];
+    cal->bins_used |= 1ULL << bin;
+    cal->frames_since_new = 0;
+  }
+  if (view == NULL) {
+    return false;
+  }
+
+  const float scale = (float)(1 << CALIB_CAMERA_SUBPIXEL_BITS);
+  for (int p = 0; p < CALIB_CAMERA_BOARD_POINTS; p++) {
+    for (int a = 0; a < 2; a++) {
+      float q = corners[p][a] * scale;
+      view->corners[p][a] = (uint16_t)(q < 0.0f ? 0 : (q > 65535.0f ? 65535 : lrintf(q)));
+    }
+  }
+  view->score = score;
+  view->bin = bin;
+  return true;
+}
+
+/**
+ * @brief Inicializar o ajuste
+ *
+ * Com ponto principal no centro e sem skew, B = K⁻ᵀK⁻¹ = diag(w, w, 1),
+ * w = 1/f². As restrições de Zhang (h1ᵀBh2 = 0, h1ᵀBh1 = h2ᵀBh2) são
+ * lineares em w: a_i·w + b_i = 0, resolvidas por mínimos quadrados.
+ */
+bool calibration_camera_solve_begin(CameraCalibrator_t *cal, const CameraIntrinsics_t *prior) {
+  double homographies[CALIB_CAMERA_MAX_FRAMES][9];
+  double sab = 0.0, saa = 0.0;
+  CameraIntrinsics_t *in = &cal->intrinsics;
+
+  if (cal->view_count < MIN_VIEWS) {
+    return false;
+  }
+
+  in->cx = 0.5f * (float)(cal->width - 1);
+  in->cy = 0.5f * (float)(cal->height - 1);
+  in->k1 = 0.0f;
+  in->k2 = 0.0f;
+
+  for (int v = 0; v < cal->view_count; v++) {
+    double *h = homographies[v];
+    if (!view_homography(&cal->views[v], h)) {
+      return false;
+    }
+
+    double g[9], norm = 0.0;
+    for (int j = 0; j < 3; j++) {
+      g[j] = h[j] - in->cx * h[6 + j];
+      g[3 + j] = h[3 + j] - in->cy * h[6 + j];
+      g[6 + j] = h[6 + j];
+    }
+    for (int i = 0; i < 9; i++) {
+      norm += g[i] * g[i];
+    }
+    for (int i = 0; i < 9; i++) {
+      g[i] /= sqrt(norm);
+    }
+
+    double a1 = g[0] * g[1] + g[3] * g[4];
+    double b1 = g[6] * g[7];
+    double a2 = g[0] * g[0] + g[3] * g[3] - g[1] * g[1] - g[4] * g[4];
+    double b2 = g[6] * g[6] - g[7] * g[7];
+    sab += a1 * b1 + a2 * b2;
+    saa += a1 * a1 + a2 * a2;
+  }
+
+  double w = (saa > 0.0) ? -sab / saa : 0.0;
+  double f = (w > 0.0) ? 1.0 / sqrt(w) : 0.0;
+  if (!(f > 0.2 * cal->width && f < 5.0 * cal->width)) {
+    f = prior->focal_length;  // Vistas quase frontais: f não observável na inicialização
+  }
+  in->focal_length = (float)f;
+
+  cal->cost = 0.0;
+  for (int v = 0; v < cal->view_count; v++) {
+    pose_from_homography(homographies[v], in, &cal->views[v]);
+    cal->cost += view_cost(in, &cal->views[v], cal->views[v].rotation, cal->views[v].translation);
+  }
+
+  cal->lambda = LM_LAMBDA_INIT;
+  cal->iterations = 0;
+  return isfinite(cal->cost);
+}
+
+/**
+ * @brief Uma iteração de Levenberg–Marquardt (complemento de Schur)
+ *
+ * [A B; Bᵀ C]·[Δp; Δq] = -[ga; gq] com C bloco-diagonal (6x6 por vista):
+ * (A - Σ B·C⁻¹·Bᵀ)·Δp = -ga + Σ B·C⁻¹·gq e Δq = C⁻¹·(-gq - Bᵀ·Δp).
+ * Os blocos de cada vista são recalculados na substituição de volta em
+ * vez de guardados: memória O(1) por vista além da pose.
+ */
+CalibrationStepResult_t calibration_camera_solve_step(CameraCalibrator_t *cal) {
+  double a[LM_INTRINSICS * LM_INTRINSICS] = { 0 };
+  double ga[LM_INTRINSICS] = { 0 };
+  double schur[LM_INTRINSICS * LM_INTRINSICS] = { 0 };
+  double rhs[LM_INTRINSICS] = { 0 };
+  double c[LM_POSE * LM_POSE], b[LM_INTRINSICS * LM_POSE], gq[LM_POSE];
+  double y[LM_POSE * (LM_INTRINSICS + 1)];
+  const double damping = 1.0 + cal->lambda;
+
+  // Passo 1: sistema reduzido
+  for (int v = 0; v < cal->view_count; v++) {
+    view_normal_equations(&cal->intrinsics, &cal->views[v], a, ga, c, b, gq);
+    for (int i = 0; i < LM_POSE; i++) {
+      c[i * LM_POSE + i] = c[i * LM_POSE + i] * damping + 1e-9;
+    }
+    if (!cholesky_factor(c, LM_POSE)) {
+      return CALIB_STEP_FAILED;
+    }
+    for (int i = 0; i < LM_POSE; i++) {
+      for (int j = 0; j < LM_INTRINSICS; j++) {
+        y[i * (LM_INTRINSICS + 1) + j] = b[j * LM_POSE + i];
+      }
+      y[i * (LM_INTRINSICS + 1) + LM_INTRINSICS] = gq[i];
+    }
+    cholesky_solve(c, LM_POSE, y, LM_INTRINSICS + 1);
+    for (int i = 0; i < LM_INTRINSICS; i++) {
+      for (int k = 0; k < LM_POSE; k++) {
+        double bik = b[i * LM_POSE + k];
+        rhs[i] += bik * y[k * (LM_INTRINSICS + 1) + LM_INTRINSICS];
+        for (int j = 0; j < LM_INTRINSICS; j++) {
+          schur[i * LM_INTRINSICS + j] -= bik * y[k * (LM_INTRINSICS + 1) + j];
+        }
+      }
+    }
+  }
+
+  double dp[LM_INTRINSICS];
+  for (int i = 0; i < LM_INTRINSICS; i++) {
+    for (int j = 0; j < LM_INTRINSICS; j++) {
+      schur[i * LM_INTRINSICS + j] += a[i * LM_INTRINSICS + j] * (i == j ? damping : 1.0);
+    }
+    schur[i * LM_INTRINSICS + i] += 1e-9;
+    dp[i] = rhs[i] - ga[i];
+  }
+
+  CameraIntrinsics_t next = cal->intrinsics;
+  bool solved = cholesky_factor(schur, LM_INTRINSICS);
+  double next_cost = HUGE_VAL;
+
+  if (solved) {
+    cholesky_solve(schur, LM_INTRINSICS, dp, 1);
+    next.focal_length += (float)dp[0];
+    next.cx += (float)dp[1];
+    next.cy += (float)dp[2];
+    next.k1 += (float)dp[3];
+    next.k2 += (float)dp[4];
+
+    // Passo 2: poses candidatas e seu custo
+    next_cost = 0.0;
+    for (int v = 0; v < cal->view_count; v++) {
+      const CameraView_t *view = &cal->views[v];
+      double dq[LM_POSE];
+      double unused_a[LM_INTRINSICS * LM_INTRINSICS], unused_ga[LM_INTRINSICS];
+
+      view_normal_equations(&cal->intrinsics, view, unused_a, unused_ga, c, b, gq);
+      for (int i = 0; i < LM_POSE; i++) {
+        c[i * LM_POSE + i] = c[i * LM_POSE + i] * damping + 1e-9;
+        dq[i] = -gq[i];
+        for (int j = 0; j < LM_INTRINSICS; j++) {
+          dq[i] -= b[j * LM_POSE + i] * dp[j];
+        }
+      }
+      if (!cholesky_factor(c, LM_POSE)) {
+        return CALIB_STEP_FAILED;
+      }
+      cholesky_solve(c, LM_POSE, dq, 1);
+
+      rotate_pose(view->rotation, dq, cal->work.trial.rotation[v]);
+      for (int i = 0; i < 3; i++) {
+        cal->work.trial.translation[v][i] = view->translation[i] + (float)dq[3 + i];
+      }
+      next_cost += view_cost(&next, view, cal->work.trial.rotation[v], cal->work.trial.translation[v]);
+    }
+  }
+
+  cal->iterations++;
+
+  if (solved && next_cost < cal->cost) {
+    double reduction = (cal->cost - next_cost) / cal->cost;
+
+    cal->intrinsics = next;
+    for (int v = 0; v < cal->view_count; v++) {
+      memcpy(cal->views[v].rotation, cal->work.trial.rotation[v], sizeof(cal->work.trial.rotation[v]));
+      memcpy(cal->views[v].translation, cal->work.trial.translation[v], sizeof(cal->work.trial.translation[v]));
+    }
+    cal->cost = next_cost;
+    cal->lambda = (cal->lambda * 0.1 > LM_LAMBDA_MIN) ? cal->lambda * 0.1 : LM_LAMBDA_MIN;
+
+    if (reduction < LM_TOLERANCE) {
+      return CALIB_STEP_DONE;
+    }
+  } else {
+    cal->lambda *= 10.0;
+    if (cal->lambda > LM_LAMBDA_MAX) {
+      return CALIB_STEP_DONE;  // Nenhum passo reduz o custo: mínimo local
+    }
+  }
+
+  if (!isfinite(cal->cost)) {
+    return CALIB_STEP_FAILED;
+  }
+  return (cal->iterations >= LM_MAX_ITERATIONS) ? CALIB_STEP_DONE : CALIB_STEP_PENDING;
+}
+
+/**
+ * @brief Erro de reprojeção RMS da estimativa atual
+ */
+float calibration_camera_rms(const CameraCalibrator_t *cal) {
+  uint32_t points = (uint32_t)cal->view_count * CALIB_CAMERA_BOARD_POINTS;
+  return (points > 0) ? (float)sqrt(cal->cost / points) : 0.0f;
+}
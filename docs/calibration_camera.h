@@ -0,0 +1,188 @@
+/**
+ * @file calibration_camera.h
+ * @brief Calibração intrínseca da câmera com tabuleiro de xadrez
+ * @version 1.0.0
+ *
+ * Pipeline:
+ * 1. Detecção: resposta de canto X em anel de 8 pontos (SIMD quando
+ *    disponível) lida direto do buffer do driver, supressão de não-máximos
+ *    em três linhas, montagem da grade pelo envoltório convexo + homografia
+ *    e refinamento subpixel por ortogonalidade de gradientes.
+ * 2. Seleção: cada vista cai num bin de cobertura (posição 3x3 no quadro x
+ *    inclinação); só vistas em bins novos, ou mais nítidas que a do bin,
+ *    são guardadas, até CALIB_CAMERA_MAX_FRAMES.
+ * 3. Ajuste: inicialização de Zhang (f com ponto principal no centro) e
+ *    Levenberg–Marquardt sobre f, cx, cy, k1, k2 e as poses, resolvido pelo
+ *    complemento de Schur (sistema 5x5 + blocos 6x6 por vista). Cada
+ *    chamada de calibration_camera_solve_step() faz uma iteração.
+ *
+ * Modelo: x = X/Z, y = Y/Z, r² = x² + y², d = 1 + k1·r² + k2·r⁴,
+ * u = f·x·d + cx, v = f·y·d + cy. Os cantos internos do tabuleiro ficam em
+ * (i, j, 0), em unidades de quadrado (a escala não afeta os intrínsecos).
+ */
+
+#ifndef CALIBRATION_CAMERA_H
+#define CALIBRATION_CAMERA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sensor_calibration.h"
+#include "calibration_footprint.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#ifndef CALIB_CAMERA_BOARD_COLS
+#define CALIB_CAMERA_BOARD_COLS 9        ///< Cantos internos por linha
+#endif
+
+#ifndef CALIB_CAMERA_BOARD_ROWS
+#define CALIB_CAMERA_BOARD_ROWS 6        ///< Cantos internos por coluna
+#endif
+
+#define CALIB_CAMERA_BOARD_POINTS (CALIB_CAMERA_BOARD_COLS * CALIB_CAMERA_BOARD_ROWS)
+
+#ifndef CALIB_CAMERA_MAX_FRAMES
+#define CALIB_CAMERA_MAX_FRAMES 15       ///< Vistas guardadas para o ajuste
+#endif
+
+#ifndef CALIB_CAMERA_MAX_WIDTH
+#define CALIB_CAMERA_MAX_WIDTH 640       ///< Largura máxima do quadro (buffers de linha)
+#endif
+
+#ifndef CALIB_CAMERA_RESPONSE_MIN
+#define CALIB_CAMERA_RESPONSE_MIN 64     ///< Resposta mínima de um canto candidato
+#endif
+
+#define CALIB_CAMERA_MAX_CANDIDATES (4 * CALIB_CAMERA_BOARD_POINTS)  ///< Máximos locais por quadro
+#define CALIB_CAMERA_SUBPIXEL_BITS 4     ///< Cantos guardados em 1/16 pixel (uint16)
+#define CALIB_CAMERA_TILT_CLASSES 5      ///< Frontal, ±x, ±y
+#define CALIB_CAMERA_BINS (9 * CALIB_CAMERA_TILT_CLASSES)
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+/**
+ * @struct CameraIntrinsics_t
+ * @brief Parâmetros intrínsecos estimados
+ */
+typedef struct {
+  float focal_length;  ///< f (pixels)
+  float cx, cy;        ///< Ponto principal (pixels)
+  float k1, k2;        ///< Distorção radial
+} CameraIntrinsics_t;
+
+/**
+ * @struct CameraView_t
+ * @brief Vista guardada do tabuleiro
+ */
+typedef struct {
+  uint16_t corners[CALIB_CAMERA_BOARD_POINTS][2];  ///< (u, v) em 1/16 pixel, ordem da grade
+  float score;                                     ///< Resposta média dos cantos (nitidez)
+  float rotation[9];                               ///< Pose: R (linha a linha)
+  float translation[3];                            ///< Pose: t (unidades de quadrado)
+  uint8_t bin;                                     ///< Bin de cobertura
+} CameraView_t;
+
+/**
+ * @struct CameraCornerCandidate_t
+ * @brief Máximo local da resposta de canto
+ */
+typedef struct {
+  int16_t x, y;  ///< Pixel do máximo
+  int16_t response;
+} CameraCornerCandidate_t;
+
+/**
+ * @struct CameraDetectScratch_t
+ * @brief Memória de trabalho de uma detecção (uma por detecção simultânea)
+ */
+typedef struct {
+  int16_t response_rows[3][CALIB_CAMERA_MAX_WIDTH];                 ///< Três linhas de resposta
+  CameraCornerCandidate_t candidates[CALIB_CAMERA_MAX_CANDIDATES];
+  int candidate_count;
+} CameraDetectScratch_t;
+
+/**
+ * @struct CameraCalibrator_t
+ * @brief Estado da calibração (vistas + Levenberg–Marquardt)
+ */
+typedef struct {
+  CameraView_t views[CALIB_CAMERA_MAX_FRAMES];
+  uint8_t view_count;
+  uint16_t width, height;        ///< Geometria do primeiro quadro aceito
+  uint64_t bins_used;            ///< Bit por bin de cobertura ocupado
+  uint32_t frames_seen;          ///< Quadros processados
+  uint32_t frames_rejected;      ///< Quadros sem tabuleiro completo
+  uint32_t frames_since_new;     ///< Quadros desde a última vista em bin novo
+
+  CameraIntrinsics_t intrinsics; ///< Estimativa atual
+  double cost;                   ///< Soma dos resíduos² na estimativa atual
+  double lambda;                 ///< Amortecimento do LM
+  uint16_t iterations;
+
+  // Coleta e ajuste nunca rodam no mesmo passo: a detecção e as poses
+  // candidatas do LM dividem a memória
+  union {
+    CameraDetectScratch_t scratch;                      ///< Detecção de add_frame()
+    struct {
+      float rotation[CALIB_CAMERA_MAX_FRAMES][9];       ///< Poses candidatas de uma iteração
+      float translation[CALIB_CAMERA_MAX_FRAMES][3];
+    } trial;
+  } work;
+} CameraCalibrator_t;
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Zerar o calibrador
+ * @param cal Calibrador
+ */
+void calibration_camera_reset(CameraCalibrator_t *cal);
+
+/**
+ * @brief Detectar o tabuleiro num quadro (lido no lugar, sem cópia)
+ * @param scratch Memória de trabalho
+ * @param frame Quadro
+ * @param corners Cantos na ordem da grade (pixels)
+ * @param score Resposta média dos cantos
+ * @return true se todos os cantos internos foram encontrados
+ */
+bool calibration_camera_detect(CameraDetectScratch_t *scratch, const CameraFrame_t *frame,
+                               float corners[CALIB_CAMERA_BOARD_POINTS][2], float *score);
+
+/**
+ * @brief Processar um quadro: detectar e decidir se a vista é guardada
+ * @param cal Calibrador
+ * @param frame Quadro
+ * @return true se a vista foi guardada (bin novo ou mais nítida)
+ */
+bool calibration_camera_add_frame(CameraCalibrator_t *cal, const CameraFrame_t *frame);
+
+/**
+ * @brief Inicializar o ajuste (Zhang + poses) com as vistas guardadas
+ * @param cal Calibrador
+ * @param prior Intrínsecos anteriores (f usado se as vistas não o determinarem)
+ * @return false se houver menos de 3 vistas ou a inicialização falhar
+ */
+bool calibration_camera_solve_begin(CameraCalibrator_t *cal, const CameraIntrinsics_t *prior);
+
+/**
+ * @brief Executar uma iteração de Levenberg–Marquardt
+ * @param cal Calibrador
+ * @return CALIB_STEP_DONE ao convergir, CALIB_STEP_FAILED se divergir
+ */
+CalibrationStepResult_t calibration_camera_solve_step(CameraCalibrator_t *cal);
+
+/**
+ * @brief Erro de reprojeção RMS da estimativa atual
+ * @param cal Calibrador
+ * @return RMS (pixels)
+ */
+float calibration_camera_rms(const CameraCalibrator_t *cal);
+
+#endif // CALIBRATION_CAMERA_H
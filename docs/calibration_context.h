@@ -0,0 +1,537 @@
+/**
+ * @file calibration_context.h
+ * @brief Instâncias independentes do sistema de calibração
+ * @version 1.0.0
+ *
+ * Todo o estado da calibração (dados, máquina de estados, fases,
+ * estimadores online, instrumentação e cursores da EEPROM) fica num
+ * CalibrationContext_t, e todo acesso ao hardware passa pelos callbacks
+ * de CalibrationDrivers_t. Cada IMU/LiDAR de um robô, ou cada robô de um
+ * simulador de frota, é uma instância; instâncias diferentes podem ser
+ * atualizadas em paralelo, em threads distintas, sem sincronização.
+ * Uma mesma instância não é reentrante.
+ *
+ * A API global de sensor_calibration.h opera sobre uma instância padrão
+ * cujos drivers são read_imu_raw(), get_time_ms(), eeprom_read() etc.
+ * Com CALIB_DEFAULT_INSTANCE=0 ela não é compilada e sensor_calibration.c
+ * deixa de referenciar esses símbolos (os auxiliares *_push_from_driver()
+ * de calibration_buffer.h e o log diferido continuam usando os globais).
+ *
+ * A estrutura é pública apenas para permitir alocação estática (sem
+ * malloc); os campos não devem ser acessados diretamente. Cada
+ * instância ocupa sizeof(CalibrationContext_t), dominado pelo
+ * calibrador da câmera (detalhado por calibration_footprint_table()).
+ *
+ * Observações:
+ * - o log diferido (CALIB_LOG_DEFERRED) tem um único ring e um único
+ *   produtor: instâncias atualizadas em threads diferentes exigem o
+ *   logger direto;
+ * - apply_*_calibration_batch() usam o kernel da instância padrão; para
+ *   outras instâncias, aplicar os blocos de
+ *   get_calibration_apply_kernel_ctx() com calibration_apply_block().
+ */
+
+#ifndef CALIBRATION_CONTEXT_H
+#define CALIBRATION_CONTEXT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "calibration_footprint.h"
+#include "sensor_calibration.h"
+#include "calibration_apply.h"
+#include "calibration_stats.h"
+#include "calibration_ellipsoid.h"
+#include "calibration_store.h"
+#include "calibration_bias.h"
+#include "calibration_lidar.h"
+#include "calibration_camera.h"
+#include "calibration_undistort.h"
+#include "calibration_odometry.h"
+#include "calibration_snapshot.h"
+#include "calibration_wire.h"
+#include "calibration_prior.h"
+#include "calibration_battery.h"
+#include "calibration_align.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#ifndef CALIB_LIDAR_SCAN
+#define CALIB_LIDAR_SCAN 1         ///< 0: driver sem read_lidar_scan(), leituras pontuais
+#endif
+
+#ifndef CALIB_SENSOR_FIFO
+#define CALIB_SENSOR_FIFO 0        ///< 1: instância padrão lê IMU/magnetômetro em rajadas
+#endif
+
+#ifndef CALIB_FIFO_BURST
+#define CALIB_FIFO_BURST 32        ///< Amostras por leitura em rajada
+#endif
+
+#ifndef CALIB_FIFO_POLL_MS
+#define CALIB_FIFO_POLL_MS 20      ///< Leitura da FIFO sem sinalização da ISR
+#endif
+
+#ifndef CALIB_TIME_US
+#define CALIB_TIME_US 0            ///< 1: instância padrão usa get_time_us() como base em µs
+#endif
+
+#ifndef CALIB_ALIGN_ENCODER_CAPACITY
+#define CALIB_ALIGN_ENCODER_CAPACITY 64  ///< Amostras de encoder pendentes (potência de 2)
+#endif
+
+#ifndef CALIB_ALIGN_POSE_CAPACITY
+#define CALIB_ALIGN_POSE_CAPACITY 16     ///< Poses pendentes (potência de 2)
+#endif
+
+#ifndef CALIB_ALIGN_LATENCY_US
+#define CALIB_ALIGN_LATENCY_US 300000    ///< Espera máxima de uma pose pelos encoders (µs)
+#endif
+
+#ifndef CALIB_WIRE_SYNC
+#define CALIB_WIRE_SYNC 1          ///< 0: sem get_calibration_wire() (economiza 2 cópias)
+#endif
+
+#ifndef CALIB_ROBOT_MODEL_ID
+#define CALIB_ROBOT_MODEL_ID 0     ///< Modelo do robô para o prior de frota (0: aceita qualquer)
+#endif
+
+#ifndef CALIB_PARALLEL_THREADS
+#define CALIB_PARALLEL_THREADS 0   ///< 1: fases paralelas em pthreads (host Linux)
+#endif
+
+#if CALIB_PARALLEL_THREADS
+#include <pthread.h>
+#endif
+
+#if CALIB_PHASE_ARENA && CALIB_PARALLEL_THREADS
+#error "CALIB_PHASE_ARENA runs one phase at a time; disable CALIB_PARALLEL_THREADS"
+#endif
+
+// Sensores presentes no SKU: 0 remove a fase, seu estado e seus wrappers
+// do firmware. A calibração salva mantém todos os campos (formato estável).
+#ifndef CALIB_WITH_IMU
+#define CALIB_WITH_IMU 1
+#endif
+#ifndef CALIB_WITH_MAG
+#define CALIB_WITH_MAG 1
+#endif
+#ifndef CALIB_WITH_ODOM
+#define CALIB_WITH_ODOM 1
+#endif
+#ifndef CALIB_WITH_LIDAR
+#define CALIB_WITH_LIDAR 1
+#endif
+#ifndef CALIB_WITH_CAMERA
+#define CALIB_WITH_CAMERA 1
+#endif
+#ifndef CALIB_WITH_BATTERY
+#define CALIB_WITH_BATTERY 1
+#endif
+#ifndef CALIB_WITH_TEMP
+#define CALIB_WITH_TEMP 1
+#endif
+
+/// Sensores calibráveis neste SKU (CALIB_SENSOR_BIT)
+#define CALIB_SENSOR_MASK_SKU \
+  ((CALIB_WITH_IMU     ? CALIB_SENSOR_BIT(CALIB_SENSOR_IMU)     : 0) | \
+   (CALIB_WITH_MAG     ? CALIB_SENSOR_BIT(CALIB_SENSOR_MAG)     : 0) | \
+   (CALIB_WITH_ODOM    ? CALIB_SENSOR_BIT(CALIB_SENSOR_ODOM)    : 0) | \
+   (CALIB_WITH_LIDAR   ? CALIB_SENSOR_BIT(CALIB_SENSOR_LIDAR)   : 0) | \
+   (CALIB_WITH_CAMERA  ? CALIB_SENSOR_BIT(CALIB_SENSOR_CAMERA)  : 0) | \
+   (CALIB_WITH_BATTERY ? CALIB_SENSOR_BIT(CALIB_SENSOR_BATTERY) : 0) | \
+   (CALIB_WITH_TEMP    ? CALIB_SENSOR_BIT(CALIB_SENSOR_TEMP)    : 0))
+
+/// Uma fase por sensor presente no SKU
+#define CALIB_PHASE_COUNT \
+  (CALIB_WITH_IMU + CALIB_WITH_MAG + CALIB_WITH_ODOM + CALIB_WITH_LIDAR + \
+   CALIB_WITH_CAMERA + CALIB_WITH_BATTERY + CALIB_WITH_TEMP)
+
+// Cobertura de direções do magnetômetro (12 azimutes x 6 faixas de z,
+// faixas de mesma área na esfera)
+#define CALIB_MAG_COVERAGE_AZ_BINS 12
+#define CALIB_MAG_COVERAGE_EL_BINS 6
+#define CALIB_MAG_COVERAGE_BINS (CALIB_MAG_COVERAGE_AZ_BINS * CALIB_MAG_COVERAGE_EL_BINS)
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+/**
+ * @struct CalibrationDrivers_t
+ * @brief Drivers de uma instância (mesma semântica das funções auxiliares
+ * de sensor_calibration.h, com user como primeiro argumento)
+ *
+ * Todos os callbacks são obrigatórios, exceto os de FIFO e os de sensores
+ * fora do SKU (CALIB_WITH_* = 0); read_lidar_scan
+ * só é usado com CALIB_LIDAR_SCAN=1 e read_lidar_distance só com
+ * CALIB_LIDAR_SCAN=0. Com read_imu_fifo/read_magnetometer_fifo não nulos,
+ * as fases e o monitoramento consomem rajadas em vez de amostras.
+ * Sem get_time_us, a base em µs é get_time_ms() estendida (resolução de
+ * 1 ms).
+ */
+typedef struct {
+  void *user;  ///< Repassado a cada callback (ex.: estado do robô simulado)
+  bool (*read_imu_raw)(void *user, IMUData_t *imu_data);
+  bool (*read_magnetometer_raw)(void *user, MagData_t *mag_data);
+  bool (*read_imu_fifo)(void *user, IMUData_t *buf, size_t max, size_t *got);
+  bool (*read_magnetometer_fifo)(void *user, MagData_t *buf, size_t max, size_t *got);
+  bool (*read_battery_data)(void *user, BatteryData_t *battery_data);
+  bool (*read_temperature_data)(void *user, TemperatureData_t *temp_data);
+  float (*read_lidar_distance)(void *user);
+  bool (*read_lidar_scan)(void *user, const LiDARData_t **points, size_t *count);
+  bool (*read_camera_frame)(void *user, CameraFrame_t *frame);
+  void (*release_camera_frame)(void *user, const CameraFrame_t *frame);
+  bool (*move_forward_distance)(void *user, uint32_t distance_mm);
+  void (*reset_encoder_counters)(void *user);
+  uint32_t (*get_left_encoder_count)(void *user);
+  uint32_t (*get_right_encoder_count)(void *user);
+  uint32_t (*get_time_ms)(void *user);
+  uint64_t (*get_time_us)(void *user);  ///< Opcional: mesmo relógio de get_time_ms, em µs
+  void (*delay_ms)(void *user, uint32_t ms);
+  CalibrationEepromRead_t eeprom_read;
+  CalibrationEepromWrite_t eeprom_write;
+} CalibrationDrivers_t;
+
+/**
+ * @brief Controle de leitura de uma FIFO de sensor
+ */
+typedef struct {
+  volatile uint32_t notified;  ///< Incrementado pela ISR (watermark ou fim do DMA)
+  uint32_t seen;               ///< notified na última leitura
+  uint32_t next_poll;          ///< Próxima leitura sem sinalização
+} CalibrationFifoPoll_t;
+
+/**
+ * @brief Acumuladores da fase do IMU
+ */
+typedef struct {
+  uint32_t start_time;        ///< Amostras da FIFO anteriores são descartadas
+  uint32_t next_sample_time;
+  CalibrationStats_t acc_x, acc_y, acc_z;
+  CalibrationStats_t gyro_x, gyro_y, gyro_z;
+} ImuPhase_t;
+
+/**
+ * @brief Acumuladores da fase do magnetômetro
+ */
+typedef struct {
+  uint32_t start_time;
+  uint32_t end_time;
+  uint32_t next_sample_time;
+  CalibrationStats_t mag_x, mag_y, mag_z;
+  EllipsoidFit_t fit;
+  EllipsoidSolution_t last_solution;
+  uint8_t stable_checks;
+  bool has_solution;
+  uint32_t coverage[(CALIB_MAG_COVERAGE_BINS + 31) / 32];  ///< Bitmap de bins visitados
+  uint16_t coverage_bins;                                  ///< Bins visitados
+  uint32_t last_new_bin_sample;                            ///< Amostra do último bin novo
+} MagPhase_t;
+
+/**
+ * @brief Estado da fase do odômetro
+ */
+typedef struct {
+  uint32_t settle_time;  ///< Fim da espera após reset dos encoders
+  uint32_t start_left;   ///< Contagens antes do movimento
+  uint32_t start_right;
+} OdomPhase_t;
+
+/**
+ * @brief Acumulador da fase do LiDAR por leituras pontuais
+ */
+typedef struct {
+  uint32_t next_sample_time;
+  CalibrationStats_t distance;
+} LidarPhase_t;
+
+typedef enum {
+  CAMERA_STAGE_COLLECT = 0,  ///< Capturando e selecionando vistas
+  CAMERA_STAGE_SOLVE = 1     ///< Iterações de Levenberg–Marquardt
+} CameraStage_t;
+
+/**
+ * @brief Estado da fase da câmera
+ */
+typedef struct {
+  CameraStage_t stage;
+  CameraCalibrator_t calibrator;
+} CameraPhase_t;
+
+/**
+ * @brief Acumulador da fase da bateria
+ */
+typedef struct {
+  uint32_t next_sample_time;
+  CalibrationStats_t voltage;
+} BatteryPhase_t;
+
+/**
+ * @brief Acumulador da fase de temperatura
+ */
+typedef struct {
+  uint32_t next_sample_time;
+  CalibrationStats_t channel[CALIB_TEMP_CHANNELS];
+  float offset[CALIB_TEMP_CHANNELS];  ///< Resultado, aplicado em CALIB_COMPLETE
+  uint8_t channel_count;              ///< Menor número de canais entre as leituras
+} TempPhase_t;
+
+typedef enum {
+  PHASE_PENDING = 0,
+  PHASE_RUNNING = 1,
+  PHASE_DONE = 2
+} PhaseStatus_t;
+
+/**
+ * @brief Estado de execução de uma fase
+ */
+typedef struct {
+  PhaseStatus_t status;
+  uint32_t start_time;
+#if CALIB_PARALLEL_THREADS
+  pthread_t thread;
+  CalibrationContext_t *ctx;  ///< Instância do worker
+  pthread_mutex_t lock;       ///< Protege os campos abaixo (vive entre start e join)
+  pthread_cond_t begun_cond;  ///< Sinalizada quando begin() termina
+  bool begun;                 ///< begin() concluído no worker
+  int result;                 ///< CalibrationStepResult_t publicado pelo worker
+  bool cancel;                ///< Pedido de cancelamento (timeout)
+#endif
+} PhaseRuntime_t;
+
+/**
+ * @struct CalibrationContext
+ * @brief Estado completo de uma instância
+ */
+struct CalibrationContext {
+  CalibrationDrivers_t drivers;
+  CalibrationStore_t store;                    ///< Cursores da EEPROM da instância
+
+  // Calibração e sequência
+  SensorCalibration_t calib;                   ///< Cópia de trabalho (thread de controle)
+  SensorCalibrationExt_t calib_ext;
+  CalibrationSnapshot_t published;             ///< Última calibração confirmada
+#if CALIB_WIRE_SYNC
+  CalibrationWireSync_t wire;                   ///< Sincronização com o app (thread de comunicação)
+#endif
+  CalibrationApplyKernel_t kernel;             ///< Coeficientes fundidos de calib/calib_ext
+  CalibrationPrior_t prior;                    ///< Prior de frota (RAM, reenviado pelo app)
+  CalibrationThermal_t thermal;                ///< Canais de temperatura e deriva do LiDAR
+  float ambient_temperature;                   ///< Referência da fase de temperatura (°C)
+  CalibrationState_t calib_state;
+  bool calibration_requested;
+  bool adaptive_sampling;
+  bool parallel_calibration;
+  uint32_t calibration_mask;                   ///< Sensores da sequência atual
+  uint32_t failed_sensors;                     ///< Sensores que falharam
+  SensorCalibration_t calib_backup;            ///< Calibração antes da sequência
+  SensorCalibrationExt_t calib_ext_backup;
+
+  // Monitoramento contínuo
+  CalibrationBiasEstimator_t bias_estimator;   ///< Bias online do IMU
+  uint32_t last_imu_feed_time;                 ///< Última amostra externa
+  bool imu_fed_externally;
+  uint32_t drift_next_sample;
+  uint32_t drift_next_check;
+  uint32_t gyro_next_update;
+  bool gyro_lut_dirty;                         ///< Tabela alterada desde o último save
+  uint32_t gyro_lut_saved_time;
+  CalibrationOdomEstimator_t odom_estimator;   ///< Odômetro online (RLS)
+  bool odom_dirty;                             ///< Odômetro alterado desde o último save
+  uint32_t odom_saved_time;
+  // Streams de encoders e pose (calibration_push_*) alinhados em µs
+  CalibrationAlignRing_t encoder_ring;         ///< Contagens esquerda/direita
+  CalibrationAlignRing_t pose_ring;            ///< x, y, θ e timestamp em ms
+  CalibrationAlignSample_t encoder_samples[CALIB_ALIGN_ENCODER_CAPACITY];
+  CalibrationAlignSample_t pose_samples[CALIB_ALIGN_POSE_CAPACITY];
+  uint32_t encoder_scanned;                    ///< Amostras pendentes já vistas por wheels_scan
+  uint32_t wheels_last[2];                     ///< Contagens da última amostra vista
+  uint64_t wheels_motion_us;                   ///< Última mudança de contagem (µs)
+  bool wheels_streamed;                        ///< Há encoders no ring
+  uint64_t time_us_base;                       ///< get_time_ms() estendida: voltas * 2^32 ms
+  uint32_t time_last_ms;
+  volatile uint32_t time_sequence;             ///< Seqlock do par acima (ímpar: gravando)
+#if CALIB_WITH_BATTERY
+  CalibrationBatteryModel_t battery_model;     ///< Curva OCV x SoC, R e capacidade aprendidas
+  CalibrationSocEstimator_t soc;               ///< Estado de carga
+  uint32_t soc_next_sample;
+  bool battery_model_dirty;                    ///< Modelo alterado desde o último save
+  uint32_t battery_model_saved_time;
+#endif
+  CalibrationMetrics_t metrics;                ///< Instrumentação
+  CalibrationUndistortMap_t undistort_map;     ///< Regerada quando os intrínsecos mudam
+
+  // Amostras lidas dos drivers
+  IMUData_t imu_data;
+  MagData_t mag_data;
+  BatteryData_t battery_data;
+  TemperatureData_t temp_data;
+  TemperatureData_t temp_calibrated;           ///< temp_data corrigida por canal
+  bool temp_valid;                             ///< temp_calibrated já lida
+  // Rajada da FIFO: as fases do IMU e do magnetômetro nunca rodam juntas e
+  // o monitoramento só roda fora delas
+  union {
+    IMUData_t imu[CALIB_FIFO_BURST];
+    MagData_t mag[CALIB_FIFO_BURST];
+  } burst;
+  CalibrationFifoPoll_t imu_fifo;
+  CalibrationFifoPoll_t mag_fifo;
+
+  // Fases: com CALIB_PHASE_ARENA, uma fase por vez e os estados sobrepostos
+  // (cada begin reinicia o seu por completo)
+#if CALIB_PHASE_ARENA
+  union {
+#else
+  struct {
+#endif
+#if CALIB_WITH_IMU
+    ImuPhase_t imu;
+#endif
+#if CALIB_WITH_MAG
+    MagPhase_t mag;
+#endif
+#if CALIB_WITH_ODOM
+    OdomPhase_t odom;
+#endif
+#if CALIB_WITH_LIDAR && CALIB_LIDAR_SCAN
+    CalibrationLidarFit_t lidar_fit;
+#elif CALIB_WITH_LIDAR
+    LidarPhase_t lidar;
+#endif
+#if CALIB_WITH_CAMERA
+    CameraPhase_t camera;
+#endif
+#if CALIB_WITH_BATTERY
+    BatteryPhase_t battery;
+#endif
+    uint8_t none;  ///< SKU sem nenhuma das fases acima
+  } phase;
+#if CALIB_WITH_TEMP
+  TempPhase_t temp_phase;                      ///< Fora da arena: offsets aplicados em CALIB_COMPLETE
+#endif
+  PhaseRuntime_t phase_runtime[CALIB_PHASE_COUNT];
+};
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+//
+// Cada função abaixo é a versão por instância da função global de mesmo
+// nome sem o sufixo _ctx (ver sensor_calibration.h para a semântica).
+
+/**
+ * @brief Preparar uma instância (sem acesso ao hardware)
+ *
+ * Zera o estado e associa os drivers; chamar antes de qualquer outra
+ * função da instância, seguida de calibration_init_ctx().
+ * @param ctx Instância
+ * @param drivers Drivers (copiados)
+ */
+void calibration_context_init(CalibrationContext_t *ctx, const CalibrationDrivers_t *drivers);
+
+/**
+ * @brief Carregar a calibração da EEPROM da instância
+ * @param ctx Instância
+ */
+void calibration_init_ctx(CalibrationContext_t *ctx);
+
+void request_calibration_ctx(CalibrationContext_t *ctx);
+void request_calibration_mask_ctx(CalibrationContext_t *ctx, uint32_t sensors);
+const CalibrationSensorMeta_t *get_sensor_calibration_meta_ctx(const CalibrationContext_t *ctx,
+                                                               CalibrationSensor_t sensor);
+CalibrationState_t get_calibration_state_ctx(const CalibrationContext_t *ctx);
+const SensorCalibration_t *get_calibration_data_ctx(const CalibrationContext_t *ctx);
+const SensorCalibrationExt_t *get_calibration_ext_data_ctx(const CalibrationContext_t *ctx);
+uint32_t get_calibration_snapshot_ctx(const CalibrationContext_t *ctx, SensorCalibration_t *calib,
+                                      SensorCalibrationExt_t *ext);
+uint32_t get_calibration_generation_ctx(const CalibrationContext_t *ctx);
+#if CALIB_WIRE_SYNC
+size_t get_calibration_wire_ctx(CalibrationContext_t *ctx, uint8_t *out, size_t out_size);
+bool calibration_wire_acknowledge_ctx(CalibrationContext_t *ctx, uint32_t generation);
+void calibration_wire_request_full_ctx(CalibrationContext_t *ctx);
+#endif
+bool calibration_import_prior_ctx(CalibrationContext_t *ctx, const uint8_t *data, size_t len);
+void calibration_clear_prior_ctx(CalibrationContext_t *ctx);
+const CalibrationMetrics_t *get_calibration_metrics_ctx(const CalibrationContext_t *ctx);
+void reset_calibration_metrics_ctx(CalibrationContext_t *ctx);
+bool is_calibration_valid_ctx(const CalibrationContext_t *ctx);
+uint32_t get_calibration_age_seconds_ctx(const CalibrationContext_t *ctx);
+void reset_calibration_to_default_ctx(CalibrationContext_t *ctx);
+void set_calibration_adaptive_ctx(CalibrationContext_t *ctx, bool enabled);
+bool is_calibration_adaptive_ctx(const CalibrationContext_t *ctx);
+void set_calibration_parallel_ctx(CalibrationContext_t *ctx, bool enabled);
+bool is_calibration_parallel_ctx(const CalibrationContext_t *ctx);
+
+/**
+ * @brief Obter os coeficientes fundidos da calibração da instância
+ * @param ctx Instância
+ * @return Kernel para calibration_apply_block()
+ */
+const CalibrationApplyKernel_t *get_calibration_apply_kernel_ctx(const CalibrationContext_t *ctx);
+
+void save_calibration_to_eeprom_ctx(CalibrationContext_t *ctx, const SensorCalibration_t *calib);
+void load_calibration_from_eeprom_ctx(CalibrationContext_t *ctx, SensorCalibration_t *calib);
+void save_calibration_ext_to_eeprom_ctx(CalibrationContext_t *ctx,
+                                        const SensorCalibrationExt_t *ext);
+void load_calibration_ext_from_eeprom_ctx(CalibrationContext_t *ctx, SensorCalibrationExt_t *ext);
+
+void calibration_update_ctx(CalibrationContext_t *ctx);
+void monitor_sensor_drift_ctx(CalibrationContext_t *ctx);
+void calibration_feed_imu_ctx(CalibrationContext_t *ctx, const IMUData_t *sample);
+void calibration_feed_imu_burst_ctx(CalibrationContext_t *ctx, const IMUData_t *samples,
+                                    size_t count);
+void calibration_notify_imu_fifo_ctx(CalibrationContext_t *ctx);
+void calibration_notify_mag_fifo_ctx(CalibrationContext_t *ctx);
+bool get_imu_bias_estimate_ctx(const CalibrationContext_t *ctx, float acc_bias[3],
+                               float gyro_bias[3]);
+void calibration_feed_odometry_ctx(CalibrationContext_t *ctx, const EncoderData_t *encoder,
+                                   const PoseData_t *pose);
+void calibration_odometry_break_ctx(CalibrationContext_t *ctx);
+bool calibration_push_encoders_ctx(CalibrationContext_t *ctx, const EncoderData_t *encoder,
+                                   uint64_t stamp_us);
+bool calibration_push_pose_ctx(CalibrationContext_t *ctx, const PoseData_t *pose,
+                               uint64_t stamp_us);
+uint64_t get_calibration_time_us_ctx(const CalibrationContext_t *ctx);
+bool get_odometry_estimate_ctx(const CalibrationContext_t *ctx, float *ppm_left,
+                               float *ppm_right, float *wheel_base);
+#if CALIB_WITH_BATTERY
+bool get_battery_state_ctx(const CalibrationContext_t *ctx, BatteryState_t *state);
+#endif
+void get_gyro_bias_for_temperature_ctx(const CalibrationContext_t *ctx, float temperature,
+                                       float bias[3]);
+bool get_temperature_channels_ctx(const CalibrationContext_t *ctx, TemperatureData_t *data);
+void set_ambient_temperature_ctx(CalibrationContext_t *ctx, float temperature);
+bool set_temperature_channel_calibration_ctx(CalibrationContext_t *ctx, uint8_t channel,
+                                             float slope, float offset);
+void set_undistort_map_storage_ctx(CalibrationContext_t *ctx, void *storage, size_t size);
+bool undistort_camera_frame_ctx(CalibrationContext_t *ctx, const CameraFrame_t *frame,
+                                uint8_t *out, uint32_t out_stride);
+
+bool calibrate_imu_ctx(CalibrationContext_t *ctx);
+bool calibrate_magnetometer_ctx(CalibrationContext_t *ctx);
+bool calibrate_odometer_ctx(CalibrationContext_t *ctx);
+bool calibrate_lidar_ctx(CalibrationContext_t *ctx);
+bool calibrate_camera_ctx(CalibrationContext_t *ctx);
+bool calibrate_battery_ctx(CalibrationContext_t *ctx);
+bool calibrate_temperature_ctx(CalibrationContext_t *ctx);
+bool validate_calibration_ctx(CalibrationContext_t *ctx, const SensorCalibration_t *calib);
+
+void calibrate_imu_begin_ctx(CalibrationContext_t *ctx);
+CalibrationStepResult_t calibrate_imu_step_ctx(CalibrationContext_t *ctx);
+void calibrate_magnetometer_begin_ctx(CalibrationContext_t *ctx);
+CalibrationStepResult_t calibrate_magnetometer_step_ctx(CalibrationContext_t *ctx);
+void calibrate_odometer_begin_ctx(CalibrationContext_t *ctx);
+CalibrationStepResult_t calibrate_odometer_step_ctx(CalibrationContext_t *ctx);
+void calibrate_lidar_begin_ctx(CalibrationContext_t *ctx);
+CalibrationStepResult_t calibrate_lidar_step_ctx(CalibrationContext_t *ctx);
+void calibrate_camera_begin_ctx(CalibrationContext_t *ctx);
+CalibrationStepResult_t calibrate_camera_step_ctx(CalibrationContext_t *ctx);
+void calibrate_battery_begin_ctx(CalibrationContext_t *ctx);
+CalibrationStepResult_t calibrate_battery_step_ctx(CalibrationContext_t *ctx);
+void calibrate_temperature_begin_ctx(CalibrationContext_t *ctx);
+CalibrationStepResult_t calibrate_temperature_step_ctx(CalibrationContext_t *ctx);
+
+#endif // CALIBRATION_CONTEXT_H
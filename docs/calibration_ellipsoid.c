@@ -0,0 +1,291 @@
+/**
+ * @file calibration_ellipsoid.c
+ * @brief Ajuste incremental de elipsoide para calibração do magnetômetro
+ * @version 1.0.0
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include "calibration_ellipsoid.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define N_UNKNOWNS 9        ///< Incógnitas (o termo constante é fixado em -1)
+#define JACOBI_SWEEPS 10    ///< Varreduras máximas de Jacobi 3x3
+
+// ============================================================================
+// ACUMULAÇÃO
+// ============================================================================
+
+/**
+ * @brief Zerar acumulador
+ */
+void ellipsoid_fit_reset(EllipsoidFit_t *fit) {
+  memset(fit, 0, sizeof(*fit));
+}
+
+/**
+ * @brief Adicionar uma amostra
+ */
+void ellipsoid_fit_push(EllipsoidFit_t *fit, float x, float y, float z) {
+  const double dx = x, dy = y, dz = z;
+  const double d[ELLIPSOID_PARAMS] = {
+    dx * dx, dy * dy, dz * dz,
+    2.0 * dy * dz, 2.0 * dx * dz, 2.0 * dx * dy,
+    2.0 * dx, 2.0 * dy, 2.0 * dz,
+    1.0
+  };
+
+  int k = 0;
+  for (int i = 0; i < ELLIPSOID_PARAMS; i++) {
+    for (int j = i; j < ELLIPSOID_PARAMS; j++) {
+      fit->ata[k++] += d[i] * d[j];
+    }
+  }
+
+  fit->count++;
+}
+
+// ============================================================================
+// ÁLGEBRA LINEAR AUXILIAR
+// ============================================================================
+
+/**
+ * @brief Índice de (i, j), i <= j, no triângulo superior empacotado
+ */
+static int packed_index(int i, int j) {
+  if (i > j) {
+    int t = i; i = j; j = t;
+  }
+  return i * ELLIPSOID_PARAMS - (i * (i - 1)) / 2 + (j - i);
+}
+
+/**
+ * @brief Decomposição de Cholesky in-place (triângulo inferior)
+ * @return false se a matriz não for definida positiva
+ */
+static bool cholesky(double a[N_UNKNOWNS][N_UNKNOWNS]) {
+  for (int j = 0; j < N_UNKNOWNS; j++) {
+    double sum = a[j][j];
+    for (int k = 0; k < j; k++) {
+      sum -= a[j][k] * a[j][k];
+    }
+    if (sum <= 0.0) {
+      return false;
+    }
+    a[j][j] = sqrt(sum);
+
+    for (int i = j + 1; i < N_UNKNOWNS; i++) {
+      double s = a[i][j];
+      for (int k = 0; k < j; k++) {
+        s -= a[i][k] * a[j][k];
+      }
+      a[i][j] = s / a[j][j];
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Resolver L·Lᵀ·x = b in-place em b
+ */
+static void cholesky_solve(double l[N_UNKNOWNS][N_UNKNOWNS], double b[N_UNKNOWNS]) {
+  for (int i = 0; i < N_UNKNOWNS; i++) {
+    for (int k = 0; k < i; k++) {
+      b[i] -= l[i][k] * b[k];
+    }
+    b[i] /= l[i][i];
+  }
+  for (int i = N_UNKNOWNS - 1; i >= 0; i--) {
+    for (int k = i + 1; k < N_UNKNOWNS; k++) {
+      b[i] -= l[k][i] * b[k];
+    }
+    b[i] /= l[i][i];
+  }
+}
+
+/**
+ * @brief Autodecomposição de matriz simétrica 3x3 (Jacobi cíclico)
+ * @param a Matriz (destruída; diagonal final contém os autovalores)
+ * @param v Autovetores em colunas
+ */
+static void jacobi_eigen3(double a[3][3], double v[3][3]) {
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      v[i][j] = (i == j) ? 1.0 : 0.0;
+    }
+  }
+
+  for (int sweep = 0; sweep < JACOBI_SWEEPS; sweep++) {
+    double off = fabs(a[0][1]) + fabs(a[0][2]) + fabs(a[1][2]);
+    if (off < 1e-15) {
+      break;
+    }
+
+    for (int p = 0; p < 2; p++) {
+      for (int q = p + 1; q < 3; q++) {
+        if (a[p][q] == 0.0) {
+          continue;
+        }
+
+        double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+        double t = (theta >= 0.0 ? 1.0 : -1.0) /
+                   (fabs(theta) + sqrt(theta * theta + 1.0));
+        double c = 1.0 / sqrt(t * t + 1.0);
+        double s = t * c;
+
+        for (int k = 0; k < 3; k++) {
+          double akp = a[k][p], akq = a[k][q];
+          a[k][p] = c * akp - s * akq;
+          a[k][q] = s * akp + c * akq;
+        }
+        for (int k = 0; k < 3; k++) {
+          double apk = a[p][k], aqk = a[q][k];
+          a[p][k] = c * apk - s * aqk;
+          a[q][k] = s * apk + c * aqk;
+        }
+        for (int k = 0; k < 3; k++) {
+          double vkp = v[k][p], vkq = v[k][q];
+          v[k][p] = c * vkp - s * vkq;
+          v[k][q] = s * vkp + c * vkq;
+        }
+      }
+    }
+  }
+}
+
+// ============================================================================
+// SOLUÇÃO
+// ============================================================================
+
+/**
+ * @brief Resolver o ajuste com as amostras acumuladas até agora
+ *
+ * 1. Equações normais N·v = r (N = Σ d₀..₈·d₀..₈ᵀ, r = Σ d₀..₈), com
+ *    equilíbrio diagonal para que o número de condição independa da
+ *    unidade do sensor.
+ * 2. Quádrica xᵀAx + 2bᵀx = 1 → centro c = -A⁻¹b, k = 1 + cᵀAc.
+ * 3. soft_iron = (A/k)^½ normalizada para det = 1.
+ */
+bool ellipsoid_fit_solve(const EllipsoidFit_t *fit, EllipsoidSolution_t *solution) {
+  double n[N_UNKNOWNS][N_UNKNOWNS];
+  double r[N_UNKNOWNS];
+  double scale[N_UNKNOWNS];
+
+  if (fit->count < N_UNKNOWNS) {
+    return false;
+  }
+
+  for (int i = 0; i < N_UNKNOWNS; i++) {
+    double diag = fit->ata[packed_index(i, i)];
+    if (diag <= 0.0) {
+      return false;
+    }
+    scale[i] = 1.0 / sqrt(diag);
+  }
+
+  for (int i = 0; i < N_UNKNOWNS; i++) {
+    for (int j = 0; j < N_UNKNOWNS; j++) {
+      n[i][j] = fit->ata[packed_index(i, j)] * scale[i] * scale[j];
+    }
+    r[i] = fit->ata[packed_index(i, ELLIPSOID_PARAMS - 1)] * scale[i];
+  }
+
+  if (!cholesky(n)) {
+    return false;
+  }
+
+  // cond(N) ≈ (max Lᵢᵢ / min Lᵢᵢ)²
+  double l_min = n[0][0], l_max = n[0][0];
+  for (int i = 1; i < N_UNKNOWNS; i++) {
+    if (n[i][i] < l_min) l_min = n[i][i];
+    if (n[i][i] > l_max) l_max = n[i][i];
+  }
+  double condition = (l_max / l_min) * (l_max / l_min);
+
+  cholesky_solve(n, r);
+  for (int i = 0; i < N_UNKNOWNS; i++) {
+    r[i] *= scale[i];
+  }
+
+  // A = [[a, h, g], [h, b, f], [g, f, c]], b = [p, q, s]
+  double a[3][3] = {
+    { r[0], r[5], r[4] },
+    { r[5], r[1], r[3] },
+    { r[4], r[3], r[2] }
+  };
+  double lin[3] = { r[6], r[7], r[8] };
+
+  // Centro: c = -A⁻¹·b (inversa por cofatores)
+  double cof[3][3];
+  cof[0][0] = a[1][1] * a[2][2] - a[1][2] * a[2][1];
+  cof[0][1] = a[0][2] * a[2][1] - a[0][1] * a[2][2];
+  cof[0][2] = a[0][1] * a[1][2] - a[0][2] * a[1][1];
+  cof[1][0] = a[1][2] * a[2][0] - a[1][0] * a[2][2];
+  cof[1][1] = a[0][0] * a[2][2] - a[0][2] * a[2][0];
+  cof[1][2] = a[0][2] * a[1][0] - a[0][0] * a[1][2];
+  cof[2][0] = a[1][0] * a[2][1] - a[1][1] * a[2][0];
+  cof[2][1] = a[0][1] * a[2][0] - a[0][0] * a[2][1];
+  cof[2][2] = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+
+  double det = a[0][0] * cof[0][0] + a[0][1] * cof[1][0] + a[0][2] * cof[2][0];
+  if (fabs(det) < 1e-30) {
+    return false;
+  }
+
+  double center[3];
+  for (int i = 0; i < 3; i++) {
+    center[i] = -(cof[i][0] * lin[0] + cof[i][1] * lin[1] + cof[i][2] * lin[2]) / det;
+  }
+
+  double k = 1.0;
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      k += center[i] * a[i][j] * center[j];
+    }
+  }
+  if (k <= 0.0) {
+    return false;
+  }
+
+  // Autodecomposição de A/k (deve ser definida positiva para um elipsoide)
+  double m[3][3], vec[3][3];
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      m[i][j] = a[i][j] / k;
+    }
+  }
+  jacobi_eigen3(m, vec);
+
+  double sqrt_lambda[3];
+  double lambda_product = 1.0;
+  for (int i = 0; i < 3; i++) {
+    if (m[i][i] <= 0.0) {
+      return false;
+    }
+    sqrt_lambda[i] = sqrt(m[i][i]);
+    lambda_product *= m[i][i];
+  }
+
+  // Raio médio = (λ₁λ₂λ₃)^(-1/6); W = V·diag(√λ)·Vᵀ·raio tem det(W) = 1
+  double radius = pow(lambda_product, -1.0 / 6.0);
+
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      double w = 0.0;
+      for (int e = 0; e < 3; e++) {
+        w += vec[i][e] * sqrt_lambda[e] * vec[j][e];
+      }
+      solution->soft_iron[i][j] = (float)(w * radius);
+    }
+    solution->hard_iron[i] = (float)center[i];
+  }
+
+  solution->field_strength = (float)radius;
+  solution->condition = (float)condition;
+  return true;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file calibration_ellipsoid.h
+ * @brief Ajuste incremental de elipsoide para calibração do magnetômetro
+ * @version 1.0.0
+ *
+ * Cada amostra (x, y, z) gera o vetor de projeto
+ *   d = [x², y², z², 2yz, 2xz, 2xy, 2x, 2y, 2z, 1]
+ * e o acumulador guarda apenas Σ d·dᵀ (matriz 10x10 simétrica, 55
+ * termos), em memória O(1). A solução de mínimos quadrados de
+ * dᵀ·v = 1 fornece a quádrica, da qual se extraem o centro (hard-iron)
+ * e a matriz de correção 3x3 completa (soft-iron).
+ */
+
+#ifndef CALIBRATION_ELLIPSOID_H
+#define CALIBRATION_ELLIPSOID_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define ELLIPSOID_PARAMS 10                                        ///< Dimensão de d
+#define ELLIPSOID_PACKED ((ELLIPSOID_PARAMS * (ELLIPSOID_PARAMS + 1)) / 2)  ///< Termos únicos
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+/**
+ * @struct EllipsoidFit_t
+ * @brief Acumulador das equações normais (triângulo superior empacotado)
+ *
+ * Acumulado em double: as equações normais elevam ao quadrado o número de
+ * condição do problema e float perde precisão com poucos milhares de amostras.
+ */
+typedef struct {
+  double ata[ELLIPSOID_PACKED];  ///< Σ d·dᵀ
+  uint32_t count;                ///< Número de amostras
+} EllipsoidFit_t;
+
+/**
+ * @struct EllipsoidSolution_t
+ * @brief Resultado do ajuste
+ *
+ * Correção: m_corr = soft_iron · (m_raw - hard_iron), com det(soft_iron) = 1,
+ * de modo que |m_corr| ≈ field_strength.
+ */
+typedef struct {
+  float hard_iron[3];       ///< Centro do elipsoide
+  float soft_iron[3][3];    ///< Matriz de correção simétrica
+  float field_strength;     ///< Raio médio (média geométrica dos semi-eixos)
+  float condition;          ///< Número de condição estimado (equações equilibradas)
+} EllipsoidSolution_t;
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Zerar acumulador
+ * @param fit Acumulador
+ */
+void ellipsoid_fit_reset(EllipsoidFit_t *fit);
+
+/**
+ * @brief Adicionar uma amostra (custo fixo: 55 multiplicações-acumulações)
+ * @param fit Acumulador
+ * @param x Campo X
+ * @param y Campo Y
+ * @param z Campo Z
+ */
+void ellipsoid_fit_push(EllipsoidFit_t *fit, float x, float y, float z);
+
+/**
+ * @brief Resolver o ajuste com as amostras acumuladas até agora
+ * @param fit Acumulador
+ * @param solution Resultado (válido apenas se retornar true)
+ * @return false se o sistema for singular ou a quádrica não for um elipsoide
+ */
+bool ellipsoid_fit_solve(const EllipsoidFit_t *fit, EllipsoidSolution_t *solution);
+
+#endif // CALIBRATION_ELLIPSOID_H
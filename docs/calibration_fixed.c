@@ -0,0 +1,119 @@
+/**
+ * @file calibration_fixed.c
+ * @brief Aritmética de ponto fixo Q16.16/Q1.31 para placas sem FPU
+ * @version 1.0.0
+ */
+
+#include <stdint.h>
+#include "calibration_fixed.h"
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Converter float para Q16.16
+ *
+ * A comparação é feita antes da conversão: float fora da faixa de int32
+ * é comportamento indefinido em C.
+ */
+calib_q16_t calib_q16_from_float(float x) {
+  float scaled = x * 65536.0f;
+
+  if (!(scaled == scaled)) {
+    return 0;
+  }
+  if (scaled >= 2147483520.0f) {
+    return INT32_MAX;
+  }
+  if (scaled <= -2147483648.0f) {
+    return INT32_MIN;
+  }
+  return (calib_q16_t)(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f);
+}
+
+/**
+ * @brief Converter Q16.16 para float
+ */
+float calib_q16_to_float(calib_q16_t x) {
+  return (float)x * CALIB_Q16_LSB;
+}
+
+/**
+ * @brief Converter float em [-1, 1) para Q1.31
+ */
+calib_q31_t calib_q31_from_float(float x) {
+  if (!(x == x)) {
+    return 0;
+  }
+  if (x >= 1.0f) {
+    return INT32_MAX;
+  }
+  if (x <= -1.0f) {
+    return INT32_MIN;
+  }
+
+  // Em float, o + 0.5 do arredondamento perderia os bits baixos
+  double scaled = (double)x * 2147483648.0;
+  int64_t q = (int64_t)(scaled >= 0.0 ? scaled + 0.5 : scaled - 0.5);
+  return (q > INT32_MAX) ? INT32_MAX : (calib_q31_t)q;
+}
+
+/**
+ * @brief Saturar um valor de 64 bits para Q16.16
+ */
+calib_q16_t calib_q16_saturate(int64_t x) {
+  if (x > INT32_MAX) {
+    return INT32_MAX;
+  }
+  if (x < INT32_MIN) {
+    return INT32_MIN;
+  }
+  return (calib_q16_t)x;
+}
+
+/**
+ * @brief Produto Q16.16 · Q16.16
+ */
+calib_q16_t calib_q16_mul(calib_q16_t a, calib_q16_t b) {
+  int64_t p = (int64_t)a * b;
+
+  return calib_q16_saturate((p + ((int64_t)1 << (CALIB_Q16_SHIFT - 1))) >> CALIB_Q16_SHIFT);
+}
+
+/**
+ * @brief Forma afim com ganho em Q1.31
+ *
+ * gain · x = x + (gain - 1) · x: o produto Q16.16 · Q1.31 é Q17.47 em 64
+ * bits, devolvido a Q16.16 com arredondamento (um único shift).
+ */
+calib_q16_t calib_q16_affine(calib_q16_t x, calib_q31_t gain_minus_one, calib_q16_t offset) {
+  int64_t p = (int64_t)x * gain_minus_one;
+  int64_t y = (int64_t)x + ((p + ((int64_t)1 << 30)) >> 31) + offset;
+
+  return calib_q16_saturate(y);
+}
+
+/**
+ * @brief Raiz quadrada inteira (piso), bit a bit
+ *
+ * 32 iterações de soma/shift, sem divisão nem multiplicação.
+ */
+uint32_t calib_isqrt64(uint64_t x) {
+  uint64_t root = 0;
+  uint64_t bit = (uint64_t)1 << 62;
+
+  while (bit > x) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (x >= root + bit) {
+      x -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t)root;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file calibration_fixed.h
+ * @brief Aritmética de ponto fixo Q16.16/Q1.31 para placas sem FPU
+ * @version 1.0.0
+ *
+ * CALIB_FIXED_POINT = 1 troca o interior dos acumuladores estatísticos
+ * (calibration_stats.h) e dos kernels de aplicação (calibration_apply.h)
+ * por inteiros, mantendo as mesmas APIs em float: as conversões ficam na
+ * borda da API, uma por amostra, e o caminho quente (acumulação, produto
+ * gain · raw + offset) não passa por soft-float. Drivers que já entregam
+ * inteiros usam as variantes _q16 e não convertem nada.
+ *
+ * Formatos:
+ * - Q16.16 (calib_q16_t): amostras e offsets; faixa ±32768, resolução
+ *   2^-16 ≈ 1.5e-5 na unidade do sensor;
+ * - Q1.31 (calib_q31_t): ganhos, guardados como gain - 1 para que ganhos
+ *   próximos de 1 mantenham 31 bits de resolução (faixa de gain: [0, 2)).
+ *
+ * Os ajustes (elipsoide, LiDAR, câmera, curva OCV) e a calibração
+ * persistida continuam em float: rodam uma vez por sequência, fora do
+ * orçamento de tempo de execução, e o layout gravado/sincronizado não
+ * depende do build.
+ *
+ * Erro garantido (verificado pelo bench com -DCALIB_FIXED_POINT=1):
+ * - aplicação: |y_q16 - y_exato| <= CALIB_FIXED_APPLY_BOUND_LSB LSB
+ *   (entrada já em Q16.16, |raw| < 2^15);
+ * - média: <= CALIB_FIXED_MEAN_BOUND_LSB LSB sobre as amostras em Q16.16;
+ * - variância: <= |média - x₀| · 2^-17 + 2^-32 (unidade²), x₀ a primeira
+ *   amostra;
+ * além da conversão para float na saída das APIs em float. As APIs em
+ * float somam a quantização da entrada (meio LSB).
+ */
+
+#ifndef CALIBRATION_FIXED_H
+#define CALIBRATION_FIXED_H
+
+#include <stdint.h>
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#ifndef CALIB_FIXED_POINT
+#define CALIB_FIXED_POINT 0            ///< 1: estatísticas e kernels em ponto fixo
+#endif
+
+#define CALIB_Q16_SHIFT 16
+#define CALIB_Q16_ONE ((calib_q16_t)1 << CALIB_Q16_SHIFT)
+#define CALIB_Q16_LSB (1.0f / 65536.0f)         ///< Resolução de Q16.16
+
+#define CALIB_FIXED_APPLY_BOUND_LSB 2  ///< Arredondamento do offset + do produto
+#define CALIB_FIXED_MEAN_BOUND_LSB 1   ///< Arredondamento da divisão final
+
+// ============================================================================
+// TIPOS
+// ============================================================================
+
+typedef int32_t calib_q16_t;   ///< Q16.16
+typedef int32_t calib_q31_t;   ///< Q1.31
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Converter float para Q16.16 (arredondado, saturado)
+ * @param x Valor
+ * @return Valor em Q16.16 (NaN vira 0)
+ */
+calib_q16_t calib_q16_from_float(float x);
+
+/**
+ * @brief Converter Q16.16 para float
+ * @param x Valor em Q16.16
+ * @return Valor
+ */
+float calib_q16_to_float(calib_q16_t x);
+
+/**
+ * @brief Converter float em [-1, 1) para Q1.31 (arredondado, saturado)
+ * @param x Valor
+ * @return Valor em Q1.31 (NaN vira 0)
+ */
+calib_q31_t calib_q31_from_float(float x);
+
+/**
+ * @brief Saturar um valor de 64 bits para Q16.16
+ * @param x Valor em Q16.16 com 64 bits
+ * @return Valor saturado
+ */
+calib_q16_t calib_q16_saturate(int64_t x);
+
+/**
+ * @brief Produto Q16.16 · Q16.16 (arredondado, saturado)
+ * @param a Fator
+ * @param b Fator
+ * @return a · b
+ */
+calib_q16_t calib_q16_mul(calib_q16_t a, calib_q16_t b);
+
+/**
+ * @brief Forma afim com ganho em Q1.31: x + x · gain_minus_one + offset
+ * @param x Amostra em Q16.16
+ * @param gain_minus_one gain - 1 em Q1.31
+ * @param offset Offset em Q16.16
+ * @return Amostra corrigida (arredondada, saturada)
+ */
+calib_q16_t calib_q16_affine(calib_q16_t x, calib_q31_t gain_minus_one, calib_q16_t offset);
+
+/**
+ * @brief Raiz quadrada inteira (piso) de um valor de 64 bits
+ * @param x Valor
+ * @return floor(√x)
+ */
+uint32_t calib_isqrt64(uint64_t x);
+
+#endif // CALIBRATION_FIXED_H
@@ -0,0 +1,149 @@
+/**
+ * @file calibration_footprint.c
+ * @brief Orçamento de memória: relatório de RAM por subsistema
+ * @version 1.0.0
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "calibration_footprint.h"
+#include "calibration_context.h"
+#include "calibration_apply.h"
+#include "calibration_log.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define CTX_SIZE(member) ((uint32_t)sizeof(((CalibrationContext_t *)0)->member))
+
+// Agrupamento dos campos de CalibrationContext_t por subsistema
+#define SIZE_DRIVERS (CTX_SIZE(drivers) + CTX_SIZE(store))
+#define SIZE_CALIBRATION \
+  (CTX_SIZE(calib) + CTX_SIZE(calib_ext) + CTX_SIZE(calib_backup) + CTX_SIZE(calib_ext_backup))
+#define SIZE_SNAPSHOT CTX_SIZE(published)
+#if CALIB_WIRE_SYNC
+#define SIZE_WIRE CTX_SIZE(wire)
+#else
+#define SIZE_WIRE 0u
+#endif
+#define SIZE_KERNEL CTX_SIZE(kernel)
+#define SIZE_PRIOR CTX_SIZE(prior)
+#define SIZE_THERMAL (CTX_SIZE(thermal) + CTX_SIZE(temp_data) + CTX_SIZE(temp_calibrated))
+#define SIZE_BIAS CTX_SIZE(bias_estimator)
+#define SIZE_ODOM CTX_SIZE(odom_estimator)
+#define SIZE_ALIGN \
+  (CTX_SIZE(encoder_ring) + CTX_SIZE(pose_ring) + CTX_SIZE(encoder_samples) + \
+   CTX_SIZE(pose_samples))
+#if CALIB_WITH_BATTERY
+#define SIZE_SOC (CTX_SIZE(battery_model) + CTX_SIZE(soc))
+// Curva nominal de referência (estática em nominal_soc(), calibration_battery.c)
+#define SIZE_SOC_NOMINAL ((uint32_t)sizeof(CalibrationBatteryModel_t))
+#else
+#define SIZE_SOC 0u
+#define SIZE_SOC_NOMINAL 0u
+#endif
+#define SIZE_METRICS CTX_SIZE(metrics)
+#define SIZE_UNDISTORT CTX_SIZE(undistort_map)
+#define SIZE_SAMPLES \
+  (CTX_SIZE(imu_data) + CTX_SIZE(mag_data) + CTX_SIZE(battery_data) + CTX_SIZE(burst) + \
+   CTX_SIZE(imu_fifo) + CTX_SIZE(mag_fifo))
+#define SIZE_PHASES CTX_SIZE(phase)
+#if CALIB_WITH_TEMP
+#define SIZE_TEMP_PHASE CTX_SIZE(temp_phase)
+#else
+#define SIZE_TEMP_PHASE 0u
+#endif
+#define SIZE_RUNTIME CTX_SIZE(phase_runtime)
+
+#define SIZE_LISTED \
+  (SIZE_DRIVERS + SIZE_CALIBRATION + SIZE_SNAPSHOT + SIZE_WIRE + SIZE_KERNEL + SIZE_PRIOR + \
+   SIZE_THERMAL + SIZE_BIAS + SIZE_ODOM + SIZE_ALIGN + SIZE_SOC + SIZE_METRICS + \
+   SIZE_UNDISTORT + SIZE_SAMPLES + SIZE_PHASES + SIZE_TEMP_PHASE + SIZE_RUNTIME)
+
+// Kernel padrão em duas cópias (KernelLatch_t de calibration_apply.c)
+#define SIZE_KERNEL_LATCH \
+  ((uint32_t)(2 * sizeof(CalibrationApplyKernel_t) + sizeof(uint32_t)))
+
+// Ring do log diferido (LogRing_t de calibration_log.c)
+#define SIZE_LOG_RING \
+  ((uint32_t)(CALIB_LOG_RING_CAPACITY * sizeof(CalibrationLogRecord_t) + 3 * sizeof(uint32_t)))
+
+#define CALIB_STATIC_ASSERT(cond, name) typedef char name[(cond) ? 1 : -1]
+
+#ifdef CALIB_RAM_BUDGET
+CALIB_STATIC_ASSERT(sizeof(CalibrationContext_t) + SIZE_KERNEL_LATCH + SIZE_SOC_NOMINAL +
+                    (CALIB_LOG_DEFERRED ? SIZE_LOG_RING : 0) <= (CALIB_RAM_BUDGET),
+                    calibration_fits_ram_budget);
+#endif
+
+// ============================================================================
+// TABELA
+// ============================================================================
+
+static const CalibrationFootprintEntry_t footprint_table[] = {
+  { "drivers + EEPROM cursors", SIZE_DRIVERS, CALIB_FOOTPRINT_INSTANCE },
+  { "calibration + backup", SIZE_CALIBRATION, CALIB_FOOTPRINT_INSTANCE },
+  { "published snapshot", SIZE_SNAPSHOT, CALIB_FOOTPRINT_INSTANCE },
+#if CALIB_WIRE_SYNC
+  { "wire sync", SIZE_WIRE, CALIB_FOOTPRINT_INSTANCE },
+#endif
+  { "apply kernel", SIZE_KERNEL, CALIB_FOOTPRINT_INSTANCE },
+  { "fleet prior", SIZE_PRIOR, CALIB_FOOTPRINT_INSTANCE },
+  { "thermal model", SIZE_THERMAL, CALIB_FOOTPRINT_INSTANCE },
+  { "imu bias (online)", SIZE_BIAS, CALIB_FOOTPRINT_INSTANCE },
+  { "odometry (online)", SIZE_ODOM, CALIB_FOOTPRINT_INSTANCE },
+  { "odometry align rings", SIZE_ALIGN, CALIB_FOOTPRINT_INSTANCE },
+#if CALIB_WITH_BATTERY
+  { "battery model + SoC", SIZE_SOC, CALIB_FOOTPRINT_INSTANCE },
+#endif
+  { "metrics", SIZE_METRICS, CALIB_FOOTPRINT_INSTANCE },
+  { "undistort map", SIZE_UNDISTORT, CALIB_FOOTPRINT_INSTANCE },
+  { "samples + fifo burst", SIZE_SAMPLES, CALIB_FOOTPRINT_INSTANCE },
+#if CALIB_PHASE_ARENA
+  { "phase arena", SIZE_PHASES, CALIB_FOOTPRINT_INSTANCE },
+#else
+  { "phase states", SIZE_PHASES, CALIB_FOOTPRINT_INSTANCE },
+#endif
+#if CALIB_WITH_TEMP
+  { "temperature phase", SIZE_TEMP_PHASE, CALIB_FOOTPRINT_INSTANCE },
+#endif
+  { "phase scheduler", SIZE_RUNTIME, CALIB_FOOTPRINT_INSTANCE },
+  { "flags, timers, padding", (uint32_t)sizeof(CalibrationContext_t) - SIZE_LISTED,
+    CALIB_FOOTPRINT_INSTANCE },
+  { "global apply kernel", SIZE_KERNEL_LATCH, CALIB_FOOTPRINT_STATIC },
+#if CALIB_WITH_BATTERY
+  { "nominal battery curve", SIZE_SOC_NOMINAL, CALIB_FOOTPRINT_STATIC },
+#endif
+#if CALIB_LOG_DEFERRED
+  { "deferred log ring", SIZE_LOG_RING, CALIB_FOOTPRINT_STATIC },
+#endif
+};
+
+#define FOOTPRINT_COUNT (sizeof(footprint_table) / sizeof(footprint_table[0]))
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief RAM por subsistema no build atual
+ */
+const CalibrationFootprintEntry_t *calibration_footprint_table(size_t *count) {
+  *count = FOOTPRINT_COUNT;
+  return footprint_table;
+}
+
+/**
+ * @brief Somar a RAM de um escopo
+ */
+uint32_t calibration_footprint_total(CalibrationFootprintScope_t scope) {
+  uint32_t total = 0;
+
+  for (size_t i = 0; i < FOOTPRINT_COUNT; i++) {
+    if (footprint_table[i].scope == scope) {
+      total += footprint_table[i].bytes;
+    }
+  }
+  return total;
+}
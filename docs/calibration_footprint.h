@@ -0,0 +1,134 @@
+/**
+ * @file calibration_footprint.h
+ * @brief Orçamento de memória: perfil compacto e relatório de RAM por subsistema
+ * @version 1.0.0
+ *
+ * Toda a memória da calibração é estática (sem malloc): cada instância é
+ * um CalibrationContext_t e os únicos globais são o kernel de
+ * apply_*_calibration_batch(), a curva nominal da bateria e o ring do
+ * log diferido (a tabela de
+ * remapeamento da câmera fica na memória do integrador, ver
+ * set_undistort_map_storage()). As capacidades
+ * que dimensionam essa memória ficam nos cabeçalhos de cada subsistema,
+ * todas sobrescrevíveis com -D:
+ *
+ * - CALIB_FIFO_BURST, CALIB_ALIGN_ENCODER_CAPACITY, CALIB_ALIGN_POSE_CAPACITY
+ *   (calibration_context.h);
+ * - CALIB_IMU_RING_CAPACITY, CALIB_MAG_RING_CAPACITY (calibration_buffer.h);
+ * - CALIB_LOG_RING_CAPACITY (calibration_log.h);
+ * - CALIB_CAMERA_MAX_FRAMES, CALIB_CAMERA_MAX_WIDTH (calibration_camera.h);
+ * - CALIB_TEMP_CHANNELS (sensor_calibration.h);
+ * - CALIB_WITH_* e CALIB_WIRE_SYNC removem subsistemas inteiros.
+ *
+ * CALIB_FOOTPRINT_SMALL = 1 troca os padrões dessas capacidades pelos de
+ * MCUs pequenos (este cabeçalho é incluído antes dos padrões de cada
+ * subsistema, e um -D explícito continua valendo), liga
+ * CALIB_PHASE_ARENA (os estados das fases passam a dividir a mesma
+ * memória, e as fases rodam sempre em sequência) e fixa CALIB_RAM_BUDGET
+ * em 20 KB. Nenhuma funcionalidade sai do firmware; a câmera, que domina
+ * a arena, fica limitada a quadros QVGA e 10 vistas, e só sai com
+ * CALIB_WITH_CAMERA=0.
+ *
+ * calibration_footprint_table() descreve a RAM de cada subsistema no
+ * build atual (o bench imprime a tabela). A flash de cada subsistema é a
+ * seção de texto do objeto correspondente (um .c por subsistema), vista
+ * com o size da toolchain.
+ */
+
+#ifndef CALIBRATION_FOOTPRINT_H
+#define CALIBRATION_FOOTPRINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#ifndef CALIB_FOOTPRINT_SMALL
+#define CALIB_FOOTPRINT_SMALL 0        ///< 1: padrões de capacidade para MCUs de ~20 KB de RAM
+#endif
+
+#if CALIB_FOOTPRINT_SMALL
+#ifndef CALIB_FIFO_BURST
+#define CALIB_FIFO_BURST 8
+#endif
+#ifndef CALIB_ALIGN_ENCODER_CAPACITY
+#define CALIB_ALIGN_ENCODER_CAPACITY 16   // 150 ms de encoders a 100 Hz
+#endif
+#ifndef CALIB_ALIGN_POSE_CAPACITY
+#define CALIB_ALIGN_POSE_CAPACITY 4
+#endif
+#ifndef CALIB_IMU_RING_CAPACITY
+#define CALIB_IMU_RING_CAPACITY 64
+#endif
+#ifndef CALIB_MAG_RING_CAPACITY
+#define CALIB_MAG_RING_CAPACITY 16
+#endif
+#ifndef CALIB_LOG_RING_CAPACITY
+#define CALIB_LOG_RING_CAPACITY 16
+#endif
+#ifndef CALIB_CAMERA_MAX_FRAMES
+#define CALIB_CAMERA_MAX_FRAMES 10
+#endif
+#ifndef CALIB_CAMERA_MAX_WIDTH
+#define CALIB_CAMERA_MAX_WIDTH 320        // QVGA
+#endif
+#ifndef CALIB_RAM_BUDGET
+#define CALIB_RAM_BUDGET 20480
+#endif
+#endif
+
+#ifndef CALIB_PHASE_ARENA
+#define CALIB_PHASE_ARENA CALIB_FOOTPRINT_SMALL  ///< 1: estados das fases sobrepostos
+#endif
+
+// CALIB_RAM_BUDGET (bytes, opcional; 20480 no perfil compacto): o build
+// falha se uma instância mais os globais passarem do orçamento
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+/**
+ * @enum CalibrationFootprintScope_t
+ * @brief Onde a memória de uma entrada é alocada
+ */
+typedef enum {
+  CALIB_FOOTPRINT_INSTANCE = 0,  ///< Dentro de cada CalibrationContext_t
+  CALIB_FOOTPRINT_STATIC = 1     ///< Global, uma vez por firmware
+} CalibrationFootprintScope_t;
+
+/**
+ * @struct CalibrationFootprintEntry_t
+ * @brief RAM de um subsistema
+ */
+typedef struct {
+  const char *name;   ///< Subsistema
+  uint32_t bytes;     ///< sizeof do estado
+  uint8_t scope;      ///< CalibrationFootprintScope_t
+} CalibrationFootprintEntry_t;
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief RAM por subsistema no build atual
+ *
+ * As entradas de instância somam sizeof(CalibrationContext_t) (a última
+ * cobre flags, temporizadores e alinhamento); a instância padrão da API
+ * global é uma delas.
+ * @param count Número de entradas
+ * @return Tabela constante
+ */
+const CalibrationFootprintEntry_t *calibration_footprint_table(size_t *count);
+
+/**
+ * @brief Somar a RAM de um escopo
+ * @param scope CalibrationFootprintScope_t
+ * @return Bytes
+ */
+uint32_t calibration_footprint_total(CalibrationFootprintScope_t scope);
+
+#endif // CALIBRATION_FOOTPRINT_H
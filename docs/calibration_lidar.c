@@ -0,0 +1,150 @@
+/**
+ * @file calibration_lidar.c
+ * @brief Ajuste de varreduras do LiDAR a paredes conhecidas
+ * @version 1.0.0
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include "calibration_lidar.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define LIDAR_PI 3.14159265f
+#define LIDAR_TWO_PI (2.0f * LIDAR_PI)
+#define LIDAR_MIN_FIT_POINTS 3
+#define LIDAR_SINGULAR_EPS 1e-6f  // det relativo mínimo (suu·svv)
+
+// ============================================================================
+// UTILITÁRIOS INTERNOS
+// ============================================================================
+
+/**
+ * @brief Levar um ângulo para [-π, π) (entrada dentro de ±3π)
+ */
+static float wrap_angle(float angle) {
+  if (angle >= LIDAR_PI) {
+    angle -= LIDAR_TWO_PI;
+  } else if (angle < -LIDAR_PI) {
+    angle += LIDAR_TWO_PI;
+  }
+  return angle;
+}
+
+/**
+ * @brief Parede cuja janela contém o ângulo (NULL se nenhuma)
+ * @param angle Ângulo corrigido do ponto
+ * @param rel Ângulo relativo à normal da parede escolhida
+ */
+static const CalibrationLidarWall_t *match_wall(const CalibrationLidarWall_t *walls,
+                                                size_t wall_count, float angle, float *rel) {
+  for (size_t w = 0; w < wall_count; w++) {
+    float r = wrap_angle(angle - walls[w].normal_angle);
+    if (fabsf(r) < CALIB_LIDAR_WALL_HALF_ANGLE) {
+      *rel = r;
+      return &walls[w];
+    }
+  }
+  return NULL;
+}
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Zerar o ajuste
+ */
+void calibration_lidar_fit_reset(CalibrationLidarFit_t *fit,
+                                 float prior_distance, float prior_angle) {
+  memset(fit, 0, sizeof(*fit));
+  fit->prior_distance = prior_distance;
+  fit->prior_angle = prior_angle;
+}
+
+/**
+ * @brief Acumular uma varredura
+ *
+ * Para cada ponto corrigido pela estimativa anterior (r', θ'):
+ * y = r'·cos θ' - D ≈ -cos θ'·Δd + r'·sin θ'·Δa. Pontos fora da janela das
+ * paredes ou com |y| acima de CALIB_LIDAR_GATE (objetos, reflexos) são
+ * descartados.
+ */
+uint32_t calibration_lidar_fit_scan(CalibrationLidarFit_t *fit,
+                                    const LiDARData_t *points, size_t count,
+                                    const CalibrationLidarWall_t *walls, size_t wall_count) {
+  uint32_t accepted = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    const LiDARData_t *p = &points[i];
+    float rel;
+
+    if (!(p->distance > CALIB_LIDAR_MIN_RANGE)) {  // Também rejeita NaN
+      fit->rejected++;
+      continue;
+    }
+
+    const CalibrationLidarWall_t *wall =
+        match_wall(walls, wall_count, wrap_angle(p->angle + fit->prior_angle), &rel);
+    if (wall == NULL) {
+      fit->rejected++;
+      continue;
+    }
+
+    float range = p->distance + fit->prior_distance;
+    float c = cosf(rel);
+    float s = sinf(rel);
+    float y = range * c - wall->distance;
+
+    if (fabsf(y) > CALIB_LIDAR_GATE) {
+      fit->rejected++;
+      continue;
+    }
+
+    float u = -c;
+    float v = range * s;
+    fit->suu += u * u;
+    fit->suv += u * v;
+    fit->svv += v * v;
+    fit->suy += u * y;
+    fit->svy += v * y;
+    fit->syy += y * y;
+    accepted++;
+  }
+
+  fit->points += accepted;
+  fit->scans++;
+  return accepted;
+}
+
+/**
+ * @brief Resolver os offsets (sistema normal 2x2)
+ */
+bool calibration_lidar_fit_solve(const CalibrationLidarFit_t *fit,
+                                 float *distance_offset, float *angle_offset, float *rms) {
+  if (fit->points < LIDAR_MIN_FIT_POINTS) {
+    return false;
+  }
+
+  float det = fit->suu * fit->svv - fit->suv * fit->suv;
+  if (!(det > LIDAR_SINGULAR_EPS * fit->suu * fit->svv)) {
+    return false;  // Sem abertura angular: ângulo não observável
+  }
+
+  float dd = (fit->svv * fit->suy - fit->suv * fit->svy) / det;
+  float da = (fit->suu * fit->svy - fit->suv * fit->suy) / det;
+
+  *distance_offset = fit->prior_distance + dd;
+  *angle_offset = fit->prior_angle + da;
+
+  if (rms != NULL) {
+    float sse = fit->syy - dd * fit->suy - da * fit->svy;
+    *rms = sqrtf((sse > 0.0f ? sse : 0.0f) / (float)fit->points);
+  }
+  return true;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file calibration_lidar.h
+ * @brief Ajuste de varreduras do LiDAR a paredes conhecidas
+ * @version 1.0.0
+ *
+ * Modelo: distância real = r + d e ângulo real = θ + a. Um ponto sobre
+ * uma parede de normal β e distância D satisfaz (r + d)·cos(θ + a - β) = D.
+ * Linearizando em torno da estimativa anterior (d0, a0), cada ponto dá uma
+ * equação linear em (Δd, Δa); o ajuste acumula apenas as somas das equações
+ * normais 2x2, então a varredura é lida uma única vez, direto do buffer do
+ * driver, sem cópia nem memória proporcional ao número de pontos.
+ *
+ * Uma parede fixa distância e ângulo; um canto (duas paredes a 90°)
+ * também é aceito, basta passar as duas paredes.
+ */
+
+#ifndef CALIBRATION_LIDAR_H
+#define CALIBRATION_LIDAR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sensor_calibration.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#ifndef CALIB_LIDAR_WALL_HALF_ANGLE
+#define CALIB_LIDAR_WALL_HALF_ANGLE 0.5f  ///< Meia abertura em torno da normal (rad)
+#endif
+
+#ifndef CALIB_LIDAR_GATE
+#define CALIB_LIDAR_GATE 0.15f            ///< Resíduo máximo de um ponto aceito (m)
+#endif
+
+#ifndef CALIB_LIDAR_MIN_RANGE
+#define CALIB_LIDAR_MIN_RANGE 0.05f       ///< Distâncias menores são inválidas (m)
+#endif
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+/**
+ * @struct CalibrationLidarWall_t
+ * @brief Parede do alvo de calibração, no referencial do robô
+ */
+typedef struct {
+  float normal_angle;  ///< Direção da normal da parede (rad)
+  float distance;      ///< Distância do centro do LiDAR à parede (m)
+} CalibrationLidarWall_t;
+
+/**
+ * @struct CalibrationLidarFit_t
+ * @brief Somas do ajuste linearizado (u = -cos θ', v = r·sin θ', y = resíduo)
+ */
+typedef struct {
+  float prior_distance;  ///< d0: offset de distância da linearização (m)
+  float prior_angle;     ///< a0: offset de ângulo da linearização (rad)
+  float suu, suv, svv;
+  float suy, svy, syy;
+  uint32_t points;       ///< Pontos aceitos
+  uint32_t rejected;     ///< Pontos descartados (fora de parede ou do limiar)
+  uint32_t scans;        ///< Varreduras acumuladas
+} CalibrationLidarFit_t;
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Zerar o ajuste
+ * @param fit Ajuste
+ * @param prior_distance Offset de distância atual (ponto de linearização)
+ * @param prior_angle Offset de ângulo atual (ponto de linearização)
+ */
+void calibration_lidar_fit_reset(CalibrationLidarFit_t *fit,
+                                 float prior_distance, float prior_angle);
+
+/**
+ * @brief Acumular uma varredura (uma passada, sem cópia)
+ * @param fit Ajuste
+ * @param points Pontos da varredura (buffer do driver, apenas leitura)
+ * @param count Número de pontos
+ * @param walls Paredes do alvo
+ * @param wall_count Número de paredes
+ * @return Pontos aceitos desta varredura
+ */
+uint32_t calibration_lidar_fit_scan(CalibrationLidarFit_t *fit,
+                                    const LiDARData_t *points, size_t count,
+                                    const CalibrationLidarWall_t *walls, size_t wall_count);
+
+/**
+ * @brief Resolver os offsets
+ * @param fit Ajuste
+ * @param distance_offset Offset de distância (m)
+ * @param angle_offset Offset de ângulo (rad)
+ * @param rms Resíduo RMS dos pontos aceitos (m), pode ser NULL
+ * @return false se houver poucos pontos ou o sistema for singular
+ */
+bool calibration_lidar_fit_solve(const CalibrationLidarFit_t *fit,
+                                 float *distance_offset, float *angle_offset, float *rms);
+
+#endif // CALIBRATION_LIDAR_H
@@ -0,0 +1,295 @@
+/**
+ * @file calibration_log.c
+ * @brief Log diferido e binário para os caminhos críticos da calibração
+ * @version 1.0.0
+ */
+
+#define CALIB_LOG_NO_REDIRECT
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "calibration_log.h"
+#include "sensor_calibration.h"
+#include "logger.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define CALIB_STATIC_ASSERT(cond, name) typedef char name[(cond) ? 1 : -1]
+
+CALIB_STATIC_ASSERT((CALIB_LOG_RING_CAPACITY & (CALIB_LOG_RING_CAPACITY - 1)) == 0,
+                    log_ring_capacity_is_power_of_two);
+
+#define LOG_RING_MASK (CALIB_LOG_RING_CAPACITY - 1)
+#define LOG_LINE_SIZE 128
+#define LOG_SPEC_SIZE 16
+
+// Ordena a escrita do registro antes da publicação do índice
+#if defined(__GNUC__)
+#define LOG_BARRIER() __sync_synchronize()
+#else
+#define LOG_BARRIER()
+#endif
+
+/**
+ * @brief Ring SPSC com índices livres (head: produtor, tail: consumidor)
+ */
+typedef struct {
+  CalibrationLogRecord_t records[CALIB_LOG_RING_CAPACITY];
+  volatile uint32_t head;
+  volatile uint32_t tail;
+  volatile uint32_t dropped;
+} LogRing_t;
+
+static LogRing_t log_ring;
+
+// ============================================================================
+// FORMATO
+// ============================================================================
+
+/**
+ * @brief Avançar sobre uma especificação de conversão
+ * @param p Ponteiro logo após '%'
+ * @param length Modificador de tamanho ('l', 'z', 'h' ou 0)
+ * @return Ponteiro para o caractere de conversão
+ */
+static const char *parse_spec(const char *p, char *length) {
+  *length = 0;
+  while (*p != '\0' && strchr("-+ #0123456789.", *p) != NULL) {
+    p++;
+  }
+  while (*p != '\0' && strchr("hlLzjt", *p) != NULL) {
+    if (*length == 0 || *p == 'l') {
+      *length = *p;
+    }
+    p++;
+  }
+  return p;
+}
+
+// ============================================================================
+// PRODUTOR
+// ============================================================================
+
+/**
+ * @brief Empilhar um registro
+ *
+ * O formato é percorrido apenas para extrair os argumentos com o tipo
+ * correto; nenhuma conversão numérica é feita aqui.
+ */
+bool calibration_log_push(CalibrationLogLevel_t level, const char *fmt, ...) {
+  uint32_t head = log_ring.head;
+
+  if (head - log_ring.tail >= CALIB_LOG_RING_CAPACITY) {
+    log_ring.dropped++;
+    return false;
+  }
+
+  CalibrationLogRecord_t *rec = &log_ring.records[head & LOG_RING_MASK];
+  va_list ap;
+  uint8_t n = 0;
+
+  rec->fmt = fmt;
+  rec->timestamp = get_time_ms();
+  rec->level = (uint8_t)level;
+
+  va_start(ap, fmt);
+  for (const char *p = fmt; *p != '\0' && n < CALIB_LOG_MAX_ARGS; p++) {
+    char length;
+
+    if (*p != '%') {
+      continue;
+    }
+    p = parse_spec(p + 1, &length);
+
+    switch (*p) {
+      case 'd':
+      case 'i':
+        rec->args[n++].l = (length == 'l') ? va_arg(ap, long) : (long)va_arg(ap, int);
+        break;
+      case 'u':
+      case 'x':
+      case 'X':
+      case 'o':
+      case 'c':
+        if (length == 'l') {
+          rec->args[n++].ul = va_arg(ap, unsigned long);
+        } else if (length == 'z') {
+          rec->args[n++].ul = (unsigned long)va_arg(ap, size_t);
+        } else {
+          rec->args[n++].ul = va_arg(ap, unsigned int);
+        }
+        break;
+      case 'f':
+      case 'F':
+      case 'e':
+      case 'E':
+      case 'g':
+      case 'G':
+        rec->args[n++].f = (float)va_arg(ap, double);
+        break;
+      case 's':
+      case 'p':
+        rec->args[n++].p = va_arg(ap, const void *);
+        break;
+      case '\0':
+        p--;  // Formato truncado: parar no terminador
+        break;
+      default:  // '%%'
+        break;
+    }
+  }
+  va_end(ap);
+
+  rec->arg_count = n;
+
+  LOG_BARRIER();
+  log_ring.head = head + 1;
+  return true;
+}
+
+// ============================================================================
+// CONSUMIDOR
+// ============================================================================
+
+/**
+ * @brief Retirar o registro mais antigo
+ */
+bool calibration_log_pop(CalibrationLogRecord_t *record) {
+  uint32_t tail = log_ring.tail;
+
+  if (tail == log_ring.head) {
+    return false;
+  }
+
+  LOG_BARRIER();
+  *record = log_ring.records[tail & LOG_RING_MASK];
+  LOG_BARRIER();
+  log_ring.tail = tail + 1;
+  return true;
+}
+
+/**
+ * @brief Formatar um registro em texto
+ *
+ * Cada especificação é formatada isoladamente com seu argumento tipado.
+ */
+size_t calibration_log_format(const CalibrationLogRecord_t *record, char *buf, size_t size) {
+  size_t len = 0;
+  uint8_t n = 0;
+  const char *p = record->fmt;
+
+  if (size == 0) {
+    return 0;
+  }
+
+  while (*p != '\0' && len + 1 < size) {
+    if (*p != '%') {
+      buf[len++] = *p++;
+      continue;
+    }
+
+    char spec[LOG_SPEC_SIZE];
+    char length;
+    const char *start = p;
+    const char *conv = parse_spec(p + 1, &length);
+    size_t spec_len = (size_t)(conv - start) + 1;
+    int written = 0;
+
+    if (*conv == '\0' || spec_len >= LOG_SPEC_SIZE) {
+      break;
+    }
+    memcpy(spec, start, spec_len);
+    spec[spec_len] = '\0';
+    p = conv + 1;
+
+    if (*conv == '%') {
+      buf[len++] = '%';
+      continue;
+    }
+    if (n >= record->arg_count) {
+      break;
+    }
+
+    const CalibrationLogArg_t *arg = &record->args[n++];
+    switch (*conv) {
+      case 'd':
+      case 'i':
+        written = (length == 'l') ? snprintf(buf + len, size - len, spec, arg->l)
+                                  : snprintf(buf + len, size - len, spec, (int)arg->l);
+        break;
+      case 'u':
+      case 'x':
+      case 'X':
+      case 'o':
+      case 'c':
+        if (length == 'l') {
+          written = snprintf(buf + len, size - len, spec, arg->ul);
+        } else if (length == 'z') {
+          written = snprintf(buf + len, size - len, spec, (size_t)arg->ul);
+        } else {
+          written = snprintf(buf + len, size - len, spec, (unsigned int)arg->ul);
+        }
+        break;
+      case 's':
+        written = snprintf(buf + len, size - len, spec, (const char *)arg->p);
+        break;
+      case 'p':
+        written = snprintf(buf + len, size - len, spec, arg->p);
+        break;
+      default:
+        written = snprintf(buf + len, size - len, spec, (double)arg->f);
+        break;
+    }
+
+    if (written < 0) {
+      break;
+    }
+    len += (size_t)written;
+    if (len >= size) {
+      len = size - 1;
+    }
+  }
+
+  buf[len] = '\0';
+  return len;
+}
+
+/**
+ * @brief Formatar e repassar registros pendentes ao logger
+ */
+size_t calibration_log_flush(size_t max_records) {
+  CalibrationLogRecord_t record;
+  char line[LOG_LINE_SIZE];
+  size_t count = 0;
+
+  while (count < max_records && calibration_log_pop(&record)) {
+    calibration_log_format(&record, line, sizeof(line));
+
+    switch (record.level) {
+      case CALIB_LOG_ERROR:
+        log_error("%s", line);
+        break;
+      case CALIB_LOG_WARNING:
+        log_warning("%s", line);
+        break;
+      default:
+        log_info("%s", line);
+        break;
+    }
+    count++;
+  }
+
+  return count;
+}
+
+/**
+ * @brief Obter o número de registros descartados
+ */
+uint32_t calibration_log_dropped(void) {
+  return log_ring.dropped;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file calibration_log.h
+ * @brief Log diferido e binário para os caminhos críticos da calibração
+ * @version 1.0.0
+ *
+ * Com CALIB_LOG_DEFERRED=1, log_info/log_warning/log_error passam a
+ * empilhar um registro binário (ponteiro do formato + argumentos brutos)
+ * em um ring SPSC, sem formatar nada no contexto de controle. Uma tarefa
+ * de baixa prioridade chama calibration_log_flush() para formatar e
+ * repassar os registros ao logger real, ou transmite os registros crus
+ * (calibration_log_pop()) para formatação no host.
+ *
+ * Restrições do modo diferido:
+ * - um único produtor (incompatível com CALIB_PARALLEL_THREADS);
+ * - argumentos %s devem apontar para strings estáticas;
+ * - no máximo CALIB_LOG_MAX_ARGS argumentos por chamada.
+ *
+ * Com o ring cheio, o registro é descartado e contado em
+ * calibration_log_dropped(); o produtor nunca bloqueia.
+ */
+
+#ifndef CALIBRATION_LOG_H
+#define CALIBRATION_LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "calibration_footprint.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#ifndef CALIB_LOG_DEFERRED
+#define CALIB_LOG_DEFERRED 0           ///< 1: log_* viram registros binários diferidos
+#endif
+
+#ifndef CALIB_LOG_RING_CAPACITY
+#define CALIB_LOG_RING_CAPACITY 32     ///< Registros no ring (potência de 2)
+#endif
+
+#define CALIB_LOG_MAX_ARGS 6           ///< Argumentos por registro
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+/**
+ * @enum CalibrationLogLevel_t
+ * @brief Nível do registro
+ */
+typedef enum {
+  CALIB_LOG_INFO = 0,
+  CALIB_LOG_WARNING = 1,
+  CALIB_LOG_ERROR = 2
+} CalibrationLogLevel_t;
+
+/**
+ * @brief Argumento bruto (tipo definido pela conversão no formato)
+ */
+typedef union {
+  long l;              ///< %d, %i, %ld
+  unsigned long ul;    ///< %u, %x, %c, %lu, %zu
+  float f;             ///< %f, %e, %g (armazenado como float)
+  const void *p;       ///< %s, %p
+} CalibrationLogArg_t;
+
+/**
+ * @struct CalibrationLogRecord_t
+ * @brief Registro binário de log
+ *
+ * fmt identifica a mensagem: no host, o endereço pode ser mapeado de
+ * volta para a string usando a tabela de símbolos do firmware.
+ */
+typedef struct {
+  const char *fmt;                             ///< Formato (string estática)
+  uint32_t timestamp;                          ///< get_time_ms() no envio
+  uint8_t level;                               ///< CalibrationLogLevel_t
+  uint8_t arg_count;                           ///< Argumentos válidos
+  CalibrationLogArg_t args[CALIB_LOG_MAX_ARGS];
+} CalibrationLogRecord_t;
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Empilhar um registro (produtor; não formata, não bloqueia)
+ * @param level Nível
+ * @param fmt Formato printf (string estática)
+ * @return false se o ring estiver cheio (registro descartado)
+ */
+bool calibration_log_push(CalibrationLogLevel_t level, const char *fmt, ...);
+
+/**
+ * @brief Retirar o registro mais antigo (consumidor)
+ * @param record Destino
+ * @return false se o ring estiver vazio
+ */
+bool calibration_log_pop(CalibrationLogRecord_t *record);
+
+/**
+ * @brief Formatar um registro em texto
+ * @param record Registro
+ * @param buf Destino
+ * @param size Tamanho de buf
+ * @return Número de caracteres escritos (sem o terminador)
+ */
+size_t calibration_log_format(const CalibrationLogRecord_t *record, char *buf, size_t size);
+
+/**
+ * @brief Formatar e repassar registros pendentes ao logger (tarefa ociosa)
+ * @param max_records Máximo de registros processados nesta chamada
+ * @return Número de registros processados
+ */
+size_t calibration_log_flush(size_t max_records);
+
+/**
+ * @brief Obter o número de registros descartados por ring cheio
+ * @return Contador de descartes
+ */
+uint32_t calibration_log_dropped(void);
+
+// ============================================================================
+// FRONT-END
+// ============================================================================
+
+#if CALIB_LOG_DEFERRED && !defined(CALIB_LOG_NO_REDIRECT)
+#define log_info(...) ((void)calibration_log_push(CALIB_LOG_INFO, __VA_ARGS__))
+#define log_warning(...) ((void)calibration_log_push(CALIB_LOG_WARNING, __VA_ARGS__))
+#define log_error(...) ((void)calibration_log_push(CALIB_LOG_ERROR, __VA_ARGS__))
+#endif
+
+#endif // CALIBRATION_LOG_H
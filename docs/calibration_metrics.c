@@ -0,0 +1,97 @@
+/**
+ * @file calibration_metrics.c
+ * @brief Contadores de desempenho da calibração (tempo por estado, falhas, EEPROM)
+ * @version 1.0.0
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "calibration_metrics.h"
+
+#if defined(CALIB_METRICS_CYCLE_COUNTER)
+// Fonte fornecida pelo projeto
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+#define CALIB_METRICS_DWT 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CALIB_METRICS_CYCLE_COUNTER() ((uint32_t)__rdtsc())
+#elif defined(__aarch64__)
+#define CALIB_METRICS_CNTVCT 1
+#else
+#define CALIB_METRICS_CYCLE_COUNTER() get_time_ms()
+#endif
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#if defined(CALIB_METRICS_DWT)
+// Registradores do Cortex-M (ARMv7-M/ARMv8-M Mainline)
+#define DEMCR (*(volatile uint32_t *)0xE000EDFCu)
+#define DEMCR_TRCENA (1u << 24)
+#define DWT_CTRL (*(volatile uint32_t *)0xE0001000u)
+#define DWT_CTRL_CYCCNTENA 1u
+#define DWT_CYCCNT (*(volatile uint32_t *)0xE0001004u)
+#define CALIB_METRICS_CYCLE_COUNTER() DWT_CYCCNT
+#elif defined(CALIB_METRICS_CNTVCT)
+static inline uint32_t read_cntvct(void) {
+  uint64_t value;
+  __asm__ volatile("mrs %0, cntvct_el0" : "=r"(value));
+  return (uint32_t)value;
+}
+#define CALIB_METRICS_CYCLE_COUNTER() read_cntvct()
+#endif
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Zerar os contadores e habilitar o contador de ciclos
+ */
+void calibration_metrics_init(CalibrationMetrics_t *metrics) {
+  memset(metrics, 0, sizeof(*metrics));
+  for (int i = 0; i < CALIB_STATE_COUNT; i++) {
+    metrics->state[i].min = UINT32_MAX;
+  }
+  metrics->eeprom_write.min = UINT32_MAX;
+
+#if defined(CALIB_METRICS_DWT)
+  // O DWT fica desligado até o firmware (ou o depurador) habilitá-lo
+  DEMCR |= DEMCR_TRCENA;
+  DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+#endif
+}
+
+/**
+ * @brief Ler o contador de ciclos
+ */
+uint32_t calibration_metrics_cycles(void) {
+  return CALIB_METRICS_CYCLE_COUNTER();
+}
+
+/**
+ * @brief Registrar uma duração
+ *
+ * A média é iniciada com a primeira amostra e acompanha em passos de
+ * 1/2^CALIB_METRICS_EMA_SHIFT, em inteiros (sem FPU no caminho quente).
+ */
+void calibration_metrics_record(CalibrationTiming_t *timing, uint32_t cycles) {
+  if (cycles < timing->min) {
+    timing->min = cycles;
+  }
+  if (cycles > timing->max) {
+    timing->max = cycles;
+  }
+
+  if (timing->count == 0) {
+    timing->ema = cycles;
+  } else {
+    int64_t delta = (int64_t)cycles - (int64_t)timing->ema;
+    timing->ema = (uint32_t)((int64_t)timing->ema + delta / (1 << CALIB_METRICS_EMA_SHIFT));
+  }
+
+  if (timing->count < UINT32_MAX) {
+    timing->count++;
+  }
+}
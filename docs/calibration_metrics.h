@@ -0,0 +1,52 @@
+/**
+ * @file calibration_metrics.h
+ * @brief Contadores de desempenho da calibração (tempo por estado, falhas, EEPROM)
+ * @version 1.0.0
+ *
+ * Tempos em ciclos do contador da CPU: DWT_CYCCNT no Cortex-M3/M4/M7/M33,
+ * TSC no x86, CNTVCT no AArch64; sem contador conhecido, milissegundos de
+ * get_time_ms(). CALIB_METRICS_CYCLE_COUNTER() substitui a fonte.
+ *
+ * Os contadores são uint32_t simples, escritos só pelo laço de calibração
+ * e sem trava: cada campo lido isoladamente (ISR, tarefa de telemetria) é
+ * consistente, mas campos diferentes podem ser de ticks diferentes.
+ */
+
+#ifndef CALIBRATION_METRICS_H
+#define CALIBRATION_METRICS_H
+
+#include <stdint.h>
+#include "sensor_calibration.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#ifndef CALIB_METRICS_EMA_SHIFT
+#define CALIB_METRICS_EMA_SHIFT 4        ///< Média exponencial com α = 1/16
+#endif
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Zerar os contadores e habilitar o contador de ciclos
+ * @param metrics Contadores
+ */
+void calibration_metrics_init(CalibrationMetrics_t *metrics);
+
+/**
+ * @brief Ler o contador de ciclos
+ * @return Ciclos (com volta em 32 bits; usar diferenças)
+ */
+uint32_t calibration_metrics_cycles(void);
+
+/**
+ * @brief Registrar uma duração (mínimo, máximo e média exponencial)
+ * @param timing Estatística de tempo
+ * @param cycles Duração medida
+ */
+void calibration_metrics_record(CalibrationTiming_t *timing, uint32_t cycles);
+
+#endif // CALIBRATION_METRICS_H
@@ -0,0 +1,252 @@
+/**
+ * @file calibration_odometry.c
+ * @brief Calibração contínua do odômetro por mínimos quadrados recursivos
+ * @version 1.0.0
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include "calibration_odometry.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define ODOM_PI 3.14159265f
+#define ODOM_TWO_PI (2.0f * ODOM_PI)
+
+// Ruído esperado por trecho da localização: normaliza as equações para
+// que P seja a covariância dos parâmetros
+#define ODOM_NOISE_DISTANCE 0.01f   // m
+#define ODOM_NOISE_ANGLE 0.01f      // rad
+
+// Incerteza relativa inicial (e teto contra saturação por falta de excitação)
+#define ODOM_PRIOR_HEADING_STD 0.10f  // hL, hR: 10%
+#define ODOM_PRIOR_BASE_STD 0.10f     // B: 10%
+
+// ============================================================================
+// UTILITÁRIOS INTERNOS
+// ============================================================================
+
+/**
+ * @brief Levar um ângulo para [-π, π)
+ */
+static float wrap_angle(float angle) {
+  while (angle >= ODOM_PI) {
+    angle -= ODOM_TWO_PI;
+  }
+  while (angle < -ODOM_PI) {
+    angle += ODOM_TWO_PI;
+  }
+  return angle;
+}
+
+/**
+ * @brief Inicializar um RLS 2x2 com covariância diagonal
+ */
+static void rls2_reset(CalibrationRls2_t *rls, float theta0, float theta1, float variance) {
+  rls->theta[0] = theta0;
+  rls->theta[1] = theta1;
+  rls->p[0] = variance;
+  rls->p[1] = 0.0f;
+  rls->p[2] = variance;
+}
+
+/**
+ * @brief Inovação y - φᵀθ
+ */
+static float rls2_innovation(const CalibrationRls2_t *rls, const float phi[2], float y) {
+  return y - (phi[0] * rls->theta[0] + phi[1] * rls->theta[1]);
+}
+
+/**
+ * @brief Atualização RLS com esquecimento λ
+ *
+ * k = Pφ / (λ + φᵀPφ), θ += k·e, P = (P - kφᵀP) / λ. A diagonal de P é
+ * limitada a max_variance: sem excitação numa direção, o esquecimento
+ * faria P crescer sem limite.
+ */
+static void rls2_update(CalibrationRls2_t *rls, const float phi[2], float y,
+                        float lambda, float max_variance) {
+  float e = rls2_innovation(rls, phi, y);
+  float pphi0 = rls->p[0] * phi[0] + rls->p[1] * phi[1];
+  float pphi1 = rls->p[1] * phi[0] + rls->p[2] * phi[1];
+  float denom = lambda + phi[0] * pphi0 + phi[1] * pphi1;
+  float k0 = pphi0 / denom;
+  float k1 = pphi1 / denom;
+  float inv_lambda = 1.0f / lambda;
+
+  rls->theta[0] += k0 * e;
+  rls->theta[1] += k1 * e;
+
+  rls->p[0] = (rls->p[0] - k0 * pphi0) * inv_lambda;
+  rls->p[1] = (rls->p[1] - k0 * pphi1) * inv_lambda;
+  rls->p[2] = (rls->p[2] - k1 * pphi1) * inv_lambda;
+
+  float scale = 1.0f;
+  if (rls->p[0] > max_variance) {
+    scale = max_variance / rls->p[0];
+  }
+  if (rls->p[2] * scale > max_variance) {
+    scale = max_variance / rls->p[2];
+  }
+  if (scale < 1.0f) {
+    rls->p[0] *= scale;
+    rls->p[1] *= scale;
+    rls->p[2] *= scale;
+  }
+}
+
+/**
+ * @brief Atualização RLS escalar: y = φ·θ
+ */
+static void rls1_update(float *theta, float *variance, float phi, float y,
+                        float lambda, float max_variance) {
+  float pphi = *variance * phi;
+  float k = pphi / (lambda + phi * pphi);
+
+  *theta += k * (y - phi * *theta);
+  *variance = (*variance - k * pphi) / lambda;
+  if (*variance > max_variance) {
+    *variance = max_variance;
+  }
+}
+
+static void open_segment(CalibrationOdomEstimator_t *est,
+                         const EncoderData_t *encoder, const PoseData_t *pose) {
+  est->segment_encoder = *encoder;
+  est->segment_pose = *pose;
+  est->segment_open = true;
+}
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Reiniciar o calibrador em torno de uma calibração de referência
+ */
+void calibration_odom_reset(CalibrationOdomEstimator_t *est,
+                            float ppm_left, float ppm_right, float wheel_base) {
+  float inv_base = 1.0f / wheel_base;
+  float heading_std = ODOM_PRIOR_HEADING_STD * inv_base;
+  float base_std = ODOM_PRIOR_BASE_STD * wheel_base;
+
+  memset(est, 0, sizeof(*est));
+  est->ppm_left = ppm_left;
+  est->ppm_right = ppm_right;
+  est->wheel_base = wheel_base;
+  rls2_reset(&est->heading, inv_base, inv_base, heading_std * heading_std);
+  est->base = wheel_base;
+  est->base_variance = base_std * base_std;
+}
+
+/**
+ * @brief Incorporar um par encoders/pose
+ *
+ * Δs é a corda projetada no rumo médio, corrigida para o comprimento do
+ * arco (fator (Δθ/2)/sin(Δθ/2)); vale também em marcha à ré.
+ */
+bool calibration_odom_update(CalibrationOdomEstimator_t *est,
+                             const EncoderData_t *encoder, const PoseData_t *pose) {
+  if (!est->segment_open) {
+    open_segment(est, encoder, pose);
+    return false;
+  }
+
+  const PoseData_t *start = &est->segment_pose;
+  float dx = pose->x - start->x;
+  float dy = pose->y - start->y;
+  float dtheta = wrap_angle(pose->theta - start->theta);
+  float chord2 = dx * dx + dy * dy;
+
+  if (chord2 < CALIB_ODOM_SEGMENT_DISTANCE * CALIB_ODOM_SEGMENT_DISTANCE &&
+      fabsf(dtheta) < CALIB_ODOM_SEGMENT_ANGLE) {
+    // Parado ou quase: recomeçar o trecho para não acumular deriva da pose
+    if ((pose->timestamp - start->timestamp) > CALIB_ODOM_SEGMENT_MAX_MS) {
+      open_segment(est, encoder, pose);
+    }
+    return false;
+  }
+
+  // Diferenças modulares: corretas mesmo com a volta do contador uint32
+  int32_t pulses_left = (int32_t)(encoder->left_count - est->segment_encoder.left_count);
+  int32_t pulses_right = (int32_t)(encoder->right_count - est->segment_encoder.right_count);
+  bool too_long = (pose->timestamp - start->timestamp) > CALIB_ODOM_SEGMENT_MAX_MS;
+
+  float half = 0.5f * dtheta;
+  float mid = start->theta + half;
+  float ds = dx * cosf(mid) + dy * sinf(mid);
+  if (fabsf(half) > 1e-4f) {
+    ds *= half / sinf(half);
+  }
+
+  open_segment(est, encoder, pose);
+
+  if (too_long) {
+    est->rejected++;
+    return false;
+  }
+
+  float dl = (float)pulses_left / est->ppm_left;
+  float dr = (float)pulses_right / est->ppm_right;
+
+  // Equações normalizadas pelo ruído da localização
+  const float phi_t[2] = { -dl / ODOM_NOISE_ANGLE, dr / ODOM_NOISE_ANGLE };
+  float y_t = dtheta / ODOM_NOISE_ANGLE;
+  float phi_s = 0.5f * (dl * est->heading.theta[0] + dr * est->heading.theta[1]) /
+                ODOM_NOISE_DISTANCE;
+  float y_s = ds / ODOM_NOISE_DISTANCE;
+
+  if (est->updates >= CALIB_ODOM_MIN_UPDATES &&
+      (fabsf(y_s - phi_s * est->base) * ODOM_NOISE_DISTANCE > CALIB_ODOM_GATE_DISTANCE ||
+       fabsf(rls2_innovation(&est->heading, phi_t, y_t)) * ODOM_NOISE_ANGLE >
+           CALIB_ODOM_GATE_ANGLE)) {
+    est->rejected++;
+    return false;
+  }
+
+  float heading_std = ODOM_PRIOR_HEADING_STD / est->wheel_base;
+  float base_std = ODOM_PRIOR_BASE_STD * est->wheel_base;
+  rls2_update(&est->heading, phi_t, y_t, CALIB_ODOM_FORGETTING, heading_std * heading_std);
+  rls1_update(&est->base, &est->base_variance, phi_s, y_s, CALIB_ODOM_FORGETTING,
+              base_std * base_std);
+  est->updates++;
+  return true;
+}
+
+/**
+ * @brief Descartar o trecho aberto
+ */
+void calibration_odom_break_segment(CalibrationOdomEstimator_t *est) {
+  est->segment_open = false;
+}
+
+/**
+ * @brief Obter a estimativa atual
+ */
+void calibration_odom_get(const CalibrationOdomEstimator_t *est,
+                          float *ppm_left, float *ppm_right, float *wheel_base) {
+  // cL = gL / ppmL0 (m/pulso) => ppmL = ppmL0 / (B·hL)
+  *ppm_left = est->ppm_left / (est->base * est->heading.theta[0]);
+  *ppm_right = est->ppm_right / (est->base * est->heading.theta[1]);
+  *wheel_base = est->base;
+}
+
+/**
+ * @brief Verificar se a estimativa convergiu
+ *
+ * Exige incerteza relativa baixa em hL, hR e B: só trechos em linha reta
+ * não determinam hL + hR, só giros no lugar não determinam B.
+ */
+bool calibration_odom_converged(const CalibrationOdomEstimator_t *est) {
+  const float limit = CALIB_ODOM_CONVERGED_STD * CALIB_ODOM_CONVERGED_STD;
+  float base2 = est->wheel_base * est->wheel_base;
+
+  return est->updates >= CALIB_ODOM_MIN_UPDATES &&
+         est->heading.p[0] * base2 < limit &&
+         est->heading.p[2] * base2 < limit &&
+         est->base_variance < limit * base2;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file calibration_odometry.h
+ * @brief Calibração contínua do odômetro por mínimos quadrados recursivos
+ * @version 1.0.0
+ *
+ * Usa a operação normal do robô: os pulsos dos encoders de cada trecho
+ * são comparados ao deslocamento medido pela localização (SLAM/LiDAR).
+ * Com dL0 = nL/ppmL0 e dR0 = nR/ppmR0 (distâncias pela calibração de
+ * referência) e os ganhos de correção gL, gR:
+ *
+ *   Δs = ½·dL0·gL + ½·dR0·gR         (distância percorrida)
+ *   Δθ = (dR0·gR - dL0·gL) / B        (variação de rumo)
+ *
+ * Em duas etapas, ambas RLS com fator de esquecimento: o rumo é linear
+ * em (hL, hR) = (gL/B, gR/B), estimados por um RLS 2x2; com eles, a
+ * distância fica Δs = ½·B·(dL0·hL + dR0·hR), linear só em B (RLS
+ * escalar). Estimar (gL, gR) direto pela distância não funciona: em
+ * linha reta ela só observa gL + gR, e a diferença viria apenas das
+ * curvas. Ao final gL = B·hL e gR = B·hR.
+ *
+ * Os contadores são uint32 e podem dar a volta: as diferenças são
+ * calculadas em aritmética modular ((int32_t)(atual - anterior)), válidas
+ * para até 2^31 pulsos por trecho em qualquer sentido.
+ */
+
+#ifndef CALIBRATION_ODOMETRY_H
+#define CALIBRATION_ODOMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sensor_calibration.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#ifndef CALIB_ODOM_SEGMENT_DISTANCE
+#define CALIB_ODOM_SEGMENT_DISTANCE 0.25f  ///< Deslocamento que fecha um trecho (m)
+#endif
+
+#ifndef CALIB_ODOM_SEGMENT_ANGLE
+#define CALIB_ODOM_SEGMENT_ANGLE 0.25f     ///< Giro que fecha um trecho (rad)
+#endif
+
+#ifndef CALIB_ODOM_SEGMENT_MAX_MS
+#define CALIB_ODOM_SEGMENT_MAX_MS 5000     ///< Trecho mais longo que isso é descartado
+#endif
+
+#ifndef CALIB_ODOM_FORGETTING
+#define CALIB_ODOM_FORGETTING 0.995f       ///< Fator de esquecimento por trecho
+#endif
+
+#ifndef CALIB_ODOM_GATE_DISTANCE
+#define CALIB_ODOM_GATE_DISTANCE 0.05f     ///< Inovação máxima de Δs (deslizamento, m)
+#endif
+
+#ifndef CALIB_ODOM_GATE_ANGLE
+#define CALIB_ODOM_GATE_ANGLE 0.05f        ///< Inovação máxima de Δθ (rad)
+#endif
+
+#ifndef CALIB_ODOM_MIN_UPDATES
+#define CALIB_ODOM_MIN_UPDATES 20          ///< Trechos antes de confiar na estimativa
+#endif
+
+#ifndef CALIB_ODOM_CONVERGED_STD
+#define CALIB_ODOM_CONVERGED_STD 0.005f    ///< Desvio padrão relativo máximo de hL, hR e B
+#endif
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+/**
+ * @struct CalibrationRls2_t
+ * @brief Mínimos quadrados recursivos com dois parâmetros
+ */
+typedef struct {
+  float theta[2];  ///< Parâmetros estimados
+  float p[3];      ///< Covariância simétrica: P00, P01, P11
+} CalibrationRls2_t;
+
+/**
+ * @struct CalibrationOdomEstimator_t
+ * @brief Estado do calibrador de odometria
+ */
+typedef struct {
+  float ppm_left;                 ///< ppmL0: referência dos ganhos (pulsos/m)
+  float ppm_right;                ///< ppmR0
+  float wheel_base;               ///< B0: bitola de referência (m)
+  CalibrationRls2_t heading;      ///< (hL, hR) = (gL/B, gR/B) (1/m)
+  float base;                     ///< B estimada (m)
+  float base_variance;            ///< Variância de B (m²)
+  EncoderData_t segment_encoder;  ///< Encoders no início do trecho
+  PoseData_t segment_pose;        ///< Pose no início do trecho
+  bool segment_open;
+  uint32_t updates;               ///< Trechos incorporados
+  uint32_t rejected;              ///< Trechos descartados (inovação ou duração)
+} CalibrationOdomEstimator_t;
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Reiniciar o calibrador em torno de uma calibração de referência
+ * @param est Calibrador
+ * @param ppm_left Pulsos/metro da roda esquerda
+ * @param ppm_right Pulsos/metro da roda direita
+ * @param wheel_base Distância entre as rodas (m)
+ */
+void calibration_odom_reset(CalibrationOdomEstimator_t *est,
+                            float ppm_left, float ppm_right, float wheel_base);
+
+/**
+ * @brief Incorporar um par encoders/pose amostrado no mesmo instante
+ *
+ * Custo fixo; fecha um trecho quando o deslocamento ou o giro medido
+ * pela pose passa dos limiares e descarta trechos com deslizamento
+ * (inovação acima de CALIB_ODOM_GATE_*) depois de CALIB_ODOM_MIN_UPDATES.
+ * @param est Calibrador
+ * @param encoder Contagens brutas dos encoders
+ * @param pose Pose da localização (referencial do mapa)
+ * @return true se um trecho foi incorporado
+ */
+bool calibration_odom_update(CalibrationOdomEstimator_t *est,
+                             const EncoderData_t *encoder, const PoseData_t *pose);
+
+/**
+ * @brief Descartar o trecho aberto (pose reinicializada, robô levantado...)
+ * @param est Calibrador
+ */
+void calibration_odom_break_segment(CalibrationOdomEstimator_t *est);
+
+/**
+ * @brief Obter a estimativa atual
+ * @param est Calibrador
+ * @param ppm_left Pulsos/metro da roda esquerda
+ * @param ppm_right Pulsos/metro da roda direita
+ * @param wheel_base Distância entre as rodas (m)
+ */
+void calibration_odom_get(const CalibrationOdomEstimator_t *est,
+                          float *ppm_left, float *ppm_right, float *wheel_base);
+
+/**
+ * @brief Verificar se a estimativa convergiu
+ * @param est Calibrador
+ * @return true após CALIB_ODOM_MIN_UPDATES trechos com incerteza baixa
+ */
+bool calibration_odom_converged(const CalibrationOdomEstimator_t *est);
+
+#endif // CALIBRATION_ODOMETRY_H
@@ -0,0 +1,184 @@
+/**
+ * @file calibration_prior.c
+ * @brief Prior de frota: mediana e dispersão por modelo de robô
+ * @version 1.0.0
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include "calibration_prior.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define CALIB_STATIC_ASSERT(cond, name) typedef char name[(cond) ? 1 : -1]
+
+// Campos cobertos: os floats consecutivos de imu_bias_x a temp_offset
+#define PRIOR_FIRST_OFFSET offsetof(SensorCalibration_t, imu_bias_x)
+
+CALIB_STATIC_ASSERT(offsetof(SensorCalibration_t, temp_offset) - PRIOR_FIRST_OFFSET ==
+                    (CALIB_PRIOR_FIELD_COUNT - 1) * sizeof(float),
+                    prior_fields_are_contiguous_floats);
+
+/**
+ * @brief Nome e sensor de cada campo coberto, na ordem do layout
+ */
+typedef struct {
+  const char *name;
+  CalibrationSensor_t sensor;
+} PriorField_t;
+
+static const PriorField_t prior_fields[CALIB_PRIOR_FIELD_COUNT] = {
+  { "imu_bias_x", CALIB_SENSOR_IMU },
+  { "imu_bias_y", CALIB_SENSOR_IMU },
+  { "imu_bias_z", CALIB_SENSOR_IMU },
+  { "imu_scale_x", CALIB_SENSOR_IMU },
+  { "imu_scale_y", CALIB_SENSOR_IMU },
+  { "imu_scale_z", CALIB_SENSOR_IMU },
+  { "mag_offset_x", CALIB_SENSOR_MAG },
+  { "mag_offset_y", CALIB_SENSOR_MAG },
+  { "mag_offset_z", CALIB_SENSOR_MAG },
+  { "mag_scale_x", CALIB_SENSOR_MAG },
+  { "mag_scale_y", CALIB_SENSOR_MAG },
+  { "mag_scale_z", CALIB_SENSOR_MAG },
+  { "pulses_per_meter_left", CALIB_SENSOR_ODOM },
+  { "pulses_per_meter_right", CALIB_SENSOR_ODOM },
+  { "lidar_offset_distance", CALIB_SENSOR_LIDAR },
+  { "lidar_angle_offset", CALIB_SENSOR_LIDAR },
+  { "camera_focal_length", CALIB_SENSOR_CAMERA },
+  { "camera_principal_point_x", CALIB_SENSOR_CAMERA },
+  { "camera_principal_point_y", CALIB_SENSOR_CAMERA },
+  { "camera_distortion_k1", CALIB_SENSOR_CAMERA },
+  { "camera_distortion_k2", CALIB_SENSOR_CAMERA },
+  { "battery_voltage_offset", CALIB_SENSOR_BATTERY },
+  { "battery_voltage_scale", CALIB_SENSOR_BATTERY },
+  { "temp_offset", CALIB_SENSOR_TEMP },
+};
+
+// ============================================================================
+// UTILITÁRIOS INTERNOS
+// ============================================================================
+
+/**
+ * @brief i-ésimo campo coberto de uma calibração
+ */
+static float field_value(const SensorCalibration_t *calib, size_t i) {
+  float value;
+
+  memcpy(&value, (const uint8_t *)calib + PRIOR_FIRST_OFFSET + i * sizeof(float), sizeof(value));
+  return value;
+}
+
+/**
+ * @brief Gravar o i-ésimo campo coberto
+ */
+static void field_store(SensorCalibration_t *calib, size_t i, float value) {
+  memcpy((uint8_t *)calib + PRIOR_FIRST_OFFSET + i * sizeof(float), &value, sizeof(value));
+}
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Descartar o prior
+ */
+void calibration_prior_reset(CalibrationPrior_t *prior) {
+  memset(prior, 0, sizeof(*prior));
+}
+
+/**
+ * @brief Consultar o prior de um campo
+ */
+bool calibration_prior_lookup(const CalibrationPrior_t *prior, size_t offset,
+                              float *median, float *sigma) {
+  if (!prior->valid || offset < PRIOR_FIRST_OFFSET) {
+    return false;
+  }
+
+  size_t i = (offset - PRIOR_FIRST_OFFSET) / sizeof(float);
+  if (i >= CALIB_PRIOR_FIELD_COUNT) {
+    return false;
+  }
+
+  *median = field_value(&prior->median, i);
+  *sigma = field_value(&prior->sigma, i);
+  return *sigma > 0.0f;
+}
+
+/**
+ * @brief Combinar uma média amostral com o prior
+ *
+ * Produto de duas gaussianas: precisões somadas, média ponderada pelas
+ * precisões. Com sample_sem = 0 (uma amostra, ou variância nula) a amostra
+ * prevalece.
+ */
+bool calibration_prior_fuse(float prior_mean, float prior_sigma, float sample_mean,
+                            float sample_sem, float *estimate, float *sigma) {
+  float prior_var = prior_sigma * prior_sigma;
+  float sample_var = sample_sem * sample_sem;
+  float distance = fabsf(sample_mean - prior_mean);
+
+  if (distance > CALIB_PRIOR_CONSISTENCY * sqrtf(prior_var + sample_var)) {
+    *estimate = sample_mean;
+    *sigma = sample_sem;
+    return false;
+  }
+
+  float total = prior_var + sample_var;
+  *estimate = (sample_mean * prior_var + prior_mean * sample_var) / total;
+  *sigma = sqrtf(prior_var * sample_var / total);
+  return true;
+}
+
+/**
+ * @brief Verificar campos calibrados contra o prior
+ */
+bool calibration_prior_check(const CalibrationPrior_t *prior, const SensorCalibration_t *calib,
+                             uint32_t sensors, size_t *field) {
+  if (!prior->valid) {
+    return true;
+  }
+
+  for (size_t i = 0; i < CALIB_PRIOR_FIELD_COUNT; i++) {
+    float sigma = field_value(&prior->sigma, i);
+
+    if (sigma <= 0.0f || !(sensors & CALIB_SENSOR_BIT(prior_fields[i].sensor))) {
+      continue;
+    }
+    if (fabsf(field_value(calib, i) - field_value(&prior->median, i)) > CALIB_PRIOR_GATE * sigma) {
+      if (field != NULL) {
+        *field = i;
+      }
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Aplicar as medianas sobre uma calibração
+ */
+void calibration_prior_seed(const CalibrationPrior_t *prior, SensorCalibration_t *calib) {
+  if (!prior->valid) {
+    return;
+  }
+
+  for (size_t i = 0; i < CALIB_PRIOR_FIELD_COUNT; i++) {
+    if (field_value(&prior->sigma, i) > 0.0f) {
+      field_store(calib, i, field_value(&prior->median, i));
+    }
+  }
+}
+
+/**
+ * @brief Nome de um campo coberto
+ */
+const char *calibration_prior_field_name(size_t field) {
+  return (field < CALIB_PRIOR_FIELD_COUNT) ? prior_fields[field].name : "?";
+}
@@ -0,0 +1,131 @@
+/**
+ * @file calibration_prior.h
+ * @brief Prior de frota: mediana e dispersão por modelo de robô
+ * @version 1.0.0
+ *
+ * Robôs do mesmo modelo têm calibrações parecidas. O prior guarda, para
+ * cada campo de SensorCalibration_t, a mediana da frota e o desvio padrão
+ * robusto em torno dela (covariância diagonal: os campos são tratados como
+ * independentes). Ele é usado de três formas:
+ *
+ * - ponto de partida: um robô sem calibração válida aplica as medianas
+ *   em vez dos padrões genéricos;
+ * - partida a quente: a média de uma fase é combinada com o prior
+ *   (precisões somadas), e a amostragem adaptativa para quando o erro
+ *   padrão combinado atinge o alvo, com muito menos amostras;
+ * - validação: cada campo calibrado precisa ficar a CALIB_PRIOR_GATE
+ *   desvios da mediana, além das faixas genéricas.
+ *
+ * Uma medição incompatível com o prior (ex.: sensor trocado por outro
+ * fabricante) descarta o prior naquela fase em vez de puxar a estimativa.
+ * O prior chega no formato de calibration_wire.h (CALIB_WIRE_FLAG_PRIOR)
+ * e fica só em RAM: o app o publica retido no broker e o robô o recebe
+ * a cada conexão.
+ */
+
+#ifndef CALIBRATION_PRIOR_H
+#define CALIBRATION_PRIOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "sensor_calibration.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#ifndef CALIB_PRIOR_GATE
+#define CALIB_PRIOR_GATE 4.0f        ///< Desvios aceitos na validação
+#endif
+
+#ifndef CALIB_PRIOR_CONSISTENCY
+#define CALIB_PRIOR_CONSISTENCY 3.0f ///< Desvios combinados antes de descartar o prior
+#endif
+
+#ifndef CALIB_PRIOR_MIN_SAMPLES
+#define CALIB_PRIOR_MIN_SAMPLES 5    ///< Amostras mínimas da partida a quente
+#endif
+
+/// Campos de SensorCalibration_t cobertos (floats de imu_bias_x a temp_offset)
+#define CALIB_PRIOR_FIELD_COUNT 24
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+/**
+ * @struct CalibrationPrior_t
+ * @brief Prior de um modelo de robô
+ *
+ * sigma usa o layout de SensorCalibration_t: sigma.imu_bias_x é o desvio
+ * da frota para imu_bias_x. Desvio <= 0 significa campo sem prior.
+ */
+typedef struct {
+  SensorCalibration_t median;   ///< Mediana da frota
+  SensorCalibration_t sigma;    ///< Desvio padrão robusto
+  uint32_t model_id;            ///< Modelo do robô
+  uint32_t robots;              ///< Robôs agregados
+  bool valid;
+} CalibrationPrior_t;
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Descartar o prior
+ * @param prior Prior
+ */
+void calibration_prior_reset(CalibrationPrior_t *prior);
+
+/**
+ * @brief Consultar o prior de um campo
+ * @param prior Prior (pode ser inválido)
+ * @param offset offsetof(SensorCalibration_t, campo) de um campo float
+ * @param median Mediana
+ * @param sigma Desvio
+ * @return false se não houver prior para o campo
+ */
+bool calibration_prior_lookup(const CalibrationPrior_t *prior, size_t offset,
+                              float *median, float *sigma);
+
+/**
+ * @brief Combinar uma média amostral com o prior
+ * @param prior_mean Média do prior (no domínio da medição)
+ * @param prior_sigma Desvio do prior
+ * @param sample_mean Média amostral
+ * @param sample_sem Erro padrão da média amostral
+ * @param estimate Estimativa combinada (sample_mean se incompatível)
+ * @param sigma Desvio da estimativa (sample_sem se incompatível)
+ * @return false se a amostra for incompatível com o prior (prior descartado)
+ */
+bool calibration_prior_fuse(float prior_mean, float prior_sigma, float sample_mean,
+                            float sample_sem, float *estimate, float *sigma);
+
+/**
+ * @brief Verificar campos calibrados contra o prior
+ * @param prior Prior
+ * @param calib Calibração
+ * @param sensors Sensores verificados (CALIB_SENSOR_BIT)
+ * @param field Primeiro campo fora (índice para calibration_prior_field_name()), pode ser NULL
+ * @return true se todos os campos com prior estiverem a CALIB_PRIOR_GATE desvios
+ */
+bool calibration_prior_check(const CalibrationPrior_t *prior, const SensorCalibration_t *calib,
+                             uint32_t sensors, size_t *field);
+
+/**
+ * @brief Aplicar as medianas sobre uma calibração (campos com prior)
+ * @param prior Prior
+ * @param calib Calibração
+ */
+void calibration_prior_seed(const CalibrationPrior_t *prior, SensorCalibration_t *calib);
+
+/**
+ * @brief Nome de um campo coberto
+ * @param field Índice (0..CALIB_PRIOR_FIELD_COUNT-1)
+ * @return Nome do campo em SensorCalibration_t
+ */
+const char *calibration_prior_field_name(size_t field);
+
+#endif // CALIBRATION_PRIOR_H
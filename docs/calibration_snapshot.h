@@ -0,0 +1,92 @@
+/**
+ * @file calibration_snapshot.h
+ * @brief Publicação da calibração para leitores concorrentes (seqlock em latch)
+ * @version 1.0.0
+ *
+ * A máquina de estados altera a calibração campo a campo; leitores de
+ * outras threads ou ISRs (fusão de sensores a 1 kHz) nunca devem ver um
+ * par bias/escala pela metade. O escritor mantém duas cópias e um
+ * contador de sequência:
+ *
+ *   seq++ (ímpar)  -> leitores passam a usar copy[1]; grava copy[0]
+ *   seq++ (par)    -> leitores passam a usar copy[0]; grava copy[1]
+ *
+ * O leitor lê seq, copia copy[seq & 1] e relê seq; a cópia que ele usa
+ * nunca é a que está sendo gravada, e só repete a leitura se uma
+ * publicação inteira aconteceu no meio da cópia. Não há trava: o
+ * escritor nunca espera por leitores, e o leitor custa uma cópia.
+ *
+ * Um único escritor por snapshot (a thread de calibration_update()).
+ * A geração (seq / 2) conta as publicações e permite ao leitor saber se
+ * a calibração mudou sem copiá-la.
+ */
+
+#ifndef CALIBRATION_SNAPSHOT_H
+#define CALIBRATION_SNAPSHOT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sensor_calibration.h"
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+/**
+ * @struct CalibrationSnapshotCopy_t
+ * @brief Uma cópia publicada
+ */
+typedef struct {
+  SensorCalibration_t calib;
+  SensorCalibrationExt_t ext;
+} CalibrationSnapshotCopy_t;
+
+/**
+ * @struct CalibrationSnapshot_t
+ * @brief Calibração publicada em duas cópias
+ */
+typedef struct {
+  volatile uint32_t sequence;         ///< 2 x geração (+1 durante a publicação)
+  CalibrationSnapshotCopy_t copy[2];
+} CalibrationSnapshot_t;
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Inicializar com a primeira calibração (geração 0)
+ * @param snap Snapshot
+ * @param calib Calibração
+ * @param ext Extensões
+ */
+void calibration_snapshot_init(CalibrationSnapshot_t *snap, const SensorCalibration_t *calib,
+                               const SensorCalibrationExt_t *ext);
+
+/**
+ * @brief Publicar uma nova calibração (só o escritor)
+ * @param snap Snapshot
+ * @param calib Calibração
+ * @param ext Extensões
+ */
+void calibration_snapshot_publish(CalibrationSnapshot_t *snap, const SensorCalibration_t *calib,
+                                  const SensorCalibrationExt_t *ext);
+
+/**
+ * @brief Copiar a calibração publicada (qualquer thread ou ISR)
+ * @param snap Snapshot
+ * @param calib Destino da calibração (NULL para ignorar)
+ * @param ext Destino das extensões (NULL para ignorar)
+ * @return Geração da cópia lida
+ */
+uint32_t calibration_snapshot_read(const CalibrationSnapshot_t *snap, SensorCalibration_t *calib,
+                                   SensorCalibrationExt_t *ext);
+
+/**
+ * @brief Obter a geração publicada
+ * @param snap Snapshot
+ * @return Número de publicações desde a inicialização
+ */
+uint32_t calibration_snapshot_generation(const CalibrationSnapshot_t *snap);
+
+#endif // CALIBRATION_SNAPSHOT_H
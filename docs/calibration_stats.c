@@ -0,0 +1,325 @@
+/**
+ * @file calibration_stats.c
+ * @brief Estatísticas incrementais (Welford) para as fases de calibração
+ * @version 1.0.0
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+#include "calibration_stats.h"
+
+#if CALIB_FIXED_POINT
+
+// ============================================================================
+// PONTO FIXO
+// ============================================================================
+
+/**
+ * @brief Divisão inteira arredondada (n > 0)
+ */
+static int64_t div_round(int64_t a, int64_t n) {
+  return (a >= 0) ? (a + n / 2) / n : -((-a + n / 2) / n);
+}
+
+/**
+ * @brief Desvio médio à origem, Q16.16
+ */
+static int64_t mean_deviation(const CalibrationStats_t *stats) {
+  return div_round(stats->sum, (int64_t)stats->count);
+}
+
+/**
+ * @brief Soma dos quadrados dos desvios à média, Q32.32
+ *
+ * M2 = Σd² - d̄·Σd. O termo subtraído tem o sinal de d̄² (d̄ arredondado
+ * tem o sinal de Σd) e não passa de Σd² pela desigualdade de Cauchy-Schwarz,
+ * salvo o arredondamento de d̄: daí o clamp em 0.
+ */
+static uint64_t stats_m2(const CalibrationStats_t *stats) {
+  int64_t c = mean_deviation(stats) * stats->sum;
+
+  return (stats->sum2 > (uint64_t)c) ? stats->sum2 - (uint64_t)c : 0;
+}
+
+/**
+ * @brief Acumular Σd² com saturação
+ */
+static void sum2_add(CalibrationStats_t *stats, uint64_t value) {
+  stats->sum2 = (value > UINT64_MAX - stats->sum2) ? UINT64_MAX : stats->sum2 + value;
+}
+
+/**
+ * @brief Zerar acumulador
+ */
+void calibration_stats_reset(CalibrationStats_t *stats) {
+  stats->count = 0;
+  stats->origin = 0;
+  stats->sum = 0;
+  stats->sum2 = 0;
+  stats->min = INT32_MAX;
+  stats->max = INT32_MIN;
+}
+
+/**
+ * @brief Adicionar uma amostra em Q16.16
+ *
+ * Os desvios são medidos a partir da primeira amostra, o que evita o
+ * cancelamento de E[x²] - E[x]² para médias grandes (ex.: az ≈ 9.81) sem
+ * a divisão por amostra de Welford. |d| < 2^32, então d² cabe em 64 bits.
+ */
+void calibration_stats_push_q16(CalibrationStats_t *stats, calib_q16_t x) {
+  if (stats->count == 0) {
+    stats->origin = x;
+  }
+  stats->count++;
+
+  int64_t d = (int64_t)x - stats->origin;
+  uint64_t magnitude = (uint64_t)(d >= 0 ? d : -d);
+  stats->sum += d;
+  sum2_add(stats, magnitude * magnitude);
+
+  if (x < stats->min) stats->min = x;
+  if (x > stats->max) stats->max = x;
+}
+
+/**
+ * @brief Adicionar uma amostra
+ */
+void calibration_stats_push(CalibrationStats_t *stats, float x) {
+  calibration_stats_push_q16(stats, calib_q16_from_float(x));
+}
+
+/**
+ * @brief Adicionar um array contíguo de amostras
+ */
+void calibration_stats_push_array(CalibrationStats_t *stats, const float *x,
+                                  size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    calibration_stats_push_q16(stats, calib_q16_from_float(x[i]));
+  }
+}
+
+/**
+ * @brief Combinar src em dst
+ *
+ * Os desvios de src são trazidos para a origem de dst (Δ = origem de src
+ * - origem de dst): Σ(d + Δ) = Σd + nΔ e Σ(d + Δ)² = Σd² + 2ΔΣd + nΔ².
+ */
+void calibration_stats_merge(CalibrationStats_t *dst,
+                             const CalibrationStats_t *src) {
+  if (src->count == 0) {
+    return;
+  }
+  if (dst->count == 0) {
+    *dst = *src;
+    return;
+  }
+
+  int64_t delta = (int64_t)src->origin - dst->origin;
+  int64_t n = (int64_t)src->count;
+  int64_t cross = 2 * delta * src->sum + n * delta * delta;
+
+  dst->sum += src->sum + n * delta;
+  if (cross >= 0) {
+    sum2_add(dst, src->sum2);
+    sum2_add(dst, (uint64_t)cross);
+  } else {
+    uint64_t total = dst->sum2 + src->sum2;
+    dst->sum2 = (total > (uint64_t)-cross) ? total - (uint64_t)-cross : 0;
+  }
+  dst->count += src->count;
+
+  if (src->min < dst->min) dst->min = src->min;
+  if (src->max > dst->max) dst->max = src->max;
+}
+
+/**
+ * @brief Média
+ */
+float calibration_stats_mean(const CalibrationStats_t *stats) {
+  if (stats->count == 0) {
+    return 0.0f;
+  }
+  return calib_q16_to_float(calib_q16_saturate(stats->origin + mean_deviation(stats)));
+}
+
+/**
+ * @brief Menor amostra
+ */
+float calibration_stats_min(const CalibrationStats_t *stats) {
+  return (stats->count == 0) ? INFINITY : calib_q16_to_float(stats->min);
+}
+
+/**
+ * @brief Maior amostra
+ */
+float calibration_stats_max(const CalibrationStats_t *stats) {
+  return (stats->count == 0) ? -INFINITY : calib_q16_to_float(stats->max);
+}
+
+/**
+ * @brief Variância populacional (M2 / n)
+ */
+float calibration_stats_variance(const CalibrationStats_t *stats) {
+  if (stats->count == 0) {
+    return 0.0f;
+  }
+  return (float)(stats_m2(stats) / stats->count) * (CALIB_Q16_LSB * CALIB_Q16_LSB);
+}
+
+/**
+ * @brief Desvio padrão populacional
+ */
+float calibration_stats_stddev(const CalibrationStats_t *stats) {
+  return sqrtf(calibration_stats_variance(stats));
+}
+
+/**
+ * @brief Erro padrão da média
+ *
+ * Variância amostral (M2 / (n - 1)), como no build em float. A divisão
+ * final fica em float: o erro padrão de um giroscópio parado fica abaixo
+ * da resolução de Q16.16.
+ */
+float calibration_stats_std_error(const CalibrationStats_t *stats) {
+  if (stats->count < 2) {
+    return INFINITY;
+  }
+  float var = (float)(stats_m2(stats) / (stats->count - 1u)) * (CALIB_Q16_LSB * CALIB_Q16_LSB);
+  return sqrtf(var / (float)stats->count);
+}
+
+#else
+
+// ============================================================================
+// PONTO FLUTUANTE
+// ============================================================================
+
+/**
+ * @brief Zerar acumulador
+ */
+void calibration_stats_reset(CalibrationStats_t *stats) {
+  stats->count = 0;
+  stats->mean = 0.0f;
+  stats->m2 = 0.0f;
+  stats->min = INFINITY;
+  stats->max = -INFINITY;
+}
+
+/**
+ * @brief Adicionar uma amostra
+ *
+ * Atualização de Welford: evita E[x²] - E[x]², que cancela
+ * catastroficamente para médias grandes (ex.: az ≈ 9.81).
+ */
+void calibration_stats_push(CalibrationStats_t *stats, float x) {
+  stats->count++;
+
+  float delta = x - stats->mean;
+  stats->mean += delta / (float)stats->count;
+  stats->m2 += delta * (x - stats->mean);
+
+  if (x < stats->min) stats->min = x;
+  if (x > stats->max) stats->max = x;
+}
+
+/**
+ * @brief Adicionar uma amostra em Q16.16
+ */
+void calibration_stats_push_q16(CalibrationStats_t *stats, calib_q16_t x) {
+  calibration_stats_push(stats, calib_q16_to_float(x));
+}
+
+/**
+ * @brief Adicionar um array contíguo de amostras
+ */
+void calibration_stats_push_array(CalibrationStats_t *stats, const float *x,
+                                  size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    calibration_stats_push(stats, x[i]);
+  }
+}
+
+/**
+ * @brief Combinar src em dst (algoritmo paralelo de Chan)
+ */
+void calibration_stats_merge(CalibrationStats_t *dst,
+                             const CalibrationStats_t *src) {
+  if (src->count == 0) {
+    return;
+  }
+  if (dst->count == 0) {
+    *dst = *src;
+    return;
+  }
+
+  float n_a = (float)dst->count;
+  float n_b = (float)src->count;
+  float n = n_a + n_b;
+  float delta = src->mean - dst->mean;
+
+  dst->mean += delta * (n_b / n);
+  dst->m2 += src->m2 + delta * delta * (n_a * n_b / n);
+  dst->count += src->count;
+
+  if (src->min < dst->min) dst->min = src->min;
+  if (src->max > dst->max) dst->max = src->max;
+}
+
+/**
+ * @brief Média
+ */
+float calibration_stats_mean(const CalibrationStats_t *stats) {
+  return stats->mean;
+}
+
+/**
+ * @brief Menor amostra
+ */
+float calibration_stats_min(const CalibrationStats_t *stats) {
+  return stats->min;
+}
+
+/**
+ * @brief Maior amostra
+ */
+float calibration_stats_max(const CalibrationStats_t *stats) {
+  return stats->max;
+}
+
+/**
+ * @brief Variância populacional (M2 / n)
+ */
+float calibration_stats_variance(const CalibrationStats_t *stats) {
+  if (stats->count == 0) {
+    return 0.0f;
+  }
+  // M2 é não-negativo por construção; o clamp só protege contra -0.0
+  float var = stats->m2 / (float)stats->count;
+  return var > 0.0f ? var : 0.0f;
+}
+
+/**
+ * @brief Desvio padrão populacional
+ */
+float calibration_stats_stddev(const CalibrationStats_t *stats) {
+  return sqrtf(calibration_stats_variance(stats));
+}
+
+/**
+ * @brief Erro padrão da média
+ *
+ * Usa a variância amostral (M2 / (n - 1)) para não subestimar o erro
+ * com poucas amostras.
+ */
+float calibration_stats_std_error(const CalibrationStats_t *stats) {
+  if (stats->count < 2) {
+    return INFINITY;
+  }
+  float n = (float)stats->count;
+  float var = stats->m2 / (n - 1.0f);
+  return sqrtf((var > 0.0f ? var : 0.0f) / n);
+}
+
+#endif // CALIB_FIXED_POINT
@@ -0,0 +1,136 @@
+/**
+ * @file calibration_stats.h
+ * @brief Estatísticas incrementais (Welford) para as fases de calibração
+ * @version 1.0.0
+ *
+ * Acumulador de média/variância numericamente estável, sem armazenar
+ * amostras. Dois acumuladores podem ser combinados (merge), o que permite
+ * dividir a coleta entre buffers, threads ou fases.
+ *
+ * Com CALIB_FIXED_POINT (calibration_fixed.h) os acumuladores são inteiros:
+ * somas dos desvios à primeira amostra em Q16.16 (64 bits) e dos seus
+ * quadrados em Q32.32, sem divisão por amostra. A API é a mesma; as
+ * leituras convertem para float na saída. O limite é Σ(x - x₀)² < 2^31
+ * (na unidade do sensor ao quadrado), ex.: 2^17 amostras com desvio de
+ * até 128 unidades.
+ */
+
+#ifndef CALIBRATION_STATS_H
+#define CALIBRATION_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "calibration_fixed.h"
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+/**
+ * @struct CalibrationStats_t
+ * @brief Acumulador incremental de uma grandeza escalar
+ */
+#if CALIB_FIXED_POINT
+typedef struct {
+  uint32_t count;      ///< Número de amostras
+  calib_q16_t origin;  ///< Primeira amostra (origem dos desvios)
+  int64_t sum;         ///< Σ(x - origin), Q16.16
+  uint64_t sum2;       ///< Σ(x - origin)², Q32.32
+  calib_q16_t min;     ///< Menor amostra
+  calib_q16_t max;     ///< Maior amostra
+} CalibrationStats_t;
+#else
+typedef struct {
+  uint32_t count;  ///< Número de amostras
+  float mean;      ///< Média corrente
+  float m2;        ///< Soma dos quadrados dos desvios à média
+  float min;       ///< Menor amostra
+  float max;       ///< Maior amostra
+} CalibrationStats_t;
+#endif
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Zerar acumulador
+ * @param stats Acumulador
+ */
+void calibration_stats_reset(CalibrationStats_t *stats);
+
+/**
+ * @brief Adicionar uma amostra
+ * @param stats Acumulador
+ * @param x Amostra
+ */
+void calibration_stats_push(CalibrationStats_t *stats, float x);
+
+/**
+ * @brief Adicionar uma amostra em Q16.16 (driver inteiro, sem conversão
+ * no build em ponto fixo)
+ * @param stats Acumulador
+ * @param x Amostra em Q16.16
+ */
+void calibration_stats_push_q16(CalibrationStats_t *stats, calib_q16_t x);
+
+/**
+ * @brief Adicionar um array contíguo de amostras (ex.: eixo de um buffer SoA)
+ * @param stats Acumulador
+ * @param x Amostras
+ * @param n Número de amostras
+ */
+void calibration_stats_push_array(CalibrationStats_t *stats, const float *x,
+                                  size_t n);
+
+/**
+ * @brief Combinar src em dst (algoritmo paralelo de Chan)
+ * @param dst Acumulador de destino
+ * @param src Acumulador de origem
+ */
+void calibration_stats_merge(CalibrationStats_t *dst,
+                             const CalibrationStats_t *src);
+
+/**
+ * @brief Média
+ * @param stats Acumulador
+ * @return Média, ou 0 se vazio
+ */
+float calibration_stats_mean(const CalibrationStats_t *stats);
+
+/**
+ * @brief Menor amostra
+ * @param stats Acumulador
+ * @return Menor amostra, ou INFINITY se vazio
+ */
+float calibration_stats_min(const CalibrationStats_t *stats);
+
+/**
+ * @brief Maior amostra
+ * @param stats Acumulador
+ * @return Maior amostra, ou -INFINITY se vazio
+ */
+float calibration_stats_max(const CalibrationStats_t *stats);
+
+/**
+ * @brief Variância populacional (M2 / n)
+ * @param stats Acumulador
+ * @return Variância, ou 0 se vazio
+ */
+float calibration_stats_variance(const CalibrationStats_t *stats);
+
+/**
+ * @brief Desvio padrão populacional
+ * @param stats Acumulador
+ * @return Desvio padrão, ou 0 se vazio
+ */
+float calibration_stats_stddev(const CalibrationStats_t *stats);
+
+/**
+ * @brief Erro padrão da média (desvio padrão / √n)
+ * @param stats Acumulador
+ * @return Erro padrão, ou INFINITY com menos de 2 amostras
+ */
+float calibration_stats_std_error(const CalibrationStats_t *stats);
+
+#endif // CALIBRATION_STATS_H
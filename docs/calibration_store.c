@@ -0,0 +1,237 @@
+/**
+ * @file calibration_store.c
+ * @brief Armazenamento journaled da calibração em EEPROM
+ * @version 1.0.0
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "calibration_store.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define CALIB_STATIC_ASSERT(cond, name) typedef char name[(cond) ? 1 : -1]
+
+#define STORE_MAGIC 0x324C474A  // "JGL2"
+
+/**
+ * @brief Cabeçalho de um slot (primeira página do slot)
+ */
+typedef struct {
+  uint32_t magic;
+  uint32_t sequence;      ///< Incrementado a cada gravação do registro
+  uint32_t layout_id;     ///< CALIB_STORE_LAYOUT_ID do payload
+  uint8_t record_id;      ///< CalibrationRecordId_t
+  uint8_t flags;          ///< CALIB_STORE_FLAG_*
+  uint16_t length;        ///< Tamanho do payload
+  uint32_t payload_crc;   ///< CRC32 do payload
+  uint32_t header_crc;    ///< CRC32 dos campos acima
+} StoreHeader_t;
+
+CALIB_STATIC_ASSERT(sizeof(StoreHeader_t) == 24, store_header_is_packed);
+CALIB_STATIC_ASSERT(sizeof(StoreHeader_t) <= CALIB_EEPROM_PAGE_SIZE,
+                    store_header_fits_page);
+CALIB_STATIC_ASSERT(CALIB_STORE_SLOT_SIZE % CALIB_EEPROM_PAGE_SIZE == 0,
+                    store_slot_is_page_aligned);
+
+// ============================================================================
+// CRC32
+// ============================================================================
+
+/**
+ * @brief Calcular CRC32 (tabela de 16 entradas, um nibble por passo)
+ */
+uint32_t calibration_crc32(uint32_t crc, const void *data, size_t len) {
+  static const uint32_t table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+    0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+  };
+  const uint8_t *p = (const uint8_t *)data;
+
+  crc = ~crc;
+  for (size_t i = 0; i < len; i++) {
+    crc = table[(crc ^ p[i]) & 0x0F] ^ (crc >> 4);
+    crc = table[(crc ^ (p[i] >> 4)) & 0x0F] ^ (crc >> 4);
+  }
+  return ~crc;
+}
+
+// ============================================================================
+// UTILITÁRIOS INTERNOS
+// ============================================================================
+
+/**
+ * @brief Endereço de um slot
+ */
+static uint32_t slot_addr(CalibrationRecordId_t id, uint8_t slot) {
+  return CALIB_STORE_ADDR +
+         ((uint32_t)id * CALIB_STORE_SLOTS + slot) * CALIB_STORE_SLOT_SIZE;
+}
+
+/**
+ * @brief Ler bytes da EEPROM do armazenamento
+ */
+static void store_read(const CalibrationStore_t *store, uint32_t addr, void *data, size_t len) {
+  store->read(store->user, addr, (uint8_t *)data, len);
+}
+
+/**
+ * @brief Ler e validar os cabeçalhos de todos os slots de um registro
+ *
+ * Atualiza o cursor de gravação com o cabeçalho válido mais recente,
+ * independentemente do layout, para que a próxima gravação sempre receba
+ * uma sequência maior.
+ */
+static void scan_headers(CalibrationStore_t *store, CalibrationRecordId_t id,
+                         StoreHeader_t headers[CALIB_STORE_SLOTS],
+                         bool header_ok[CALIB_STORE_SLOTS]) {
+  CalibrationStoreCursor_t *cursor = &store->cursors[id];
+  bool any = false;
+
+  cursor->slot = CALIB_STORE_SLOTS - 1;  // Primeira gravação vai para o slot 0
+  cursor->sequence = 0;
+
+  for (uint8_t s = 0; s < CALIB_STORE_SLOTS; s++) {
+    StoreHeader_t *h = &headers[s];
+
+    store_read(store, slot_addr(id, s), h, sizeof(*h));
+    header_ok[s] = h->magic == STORE_MAGIC &&
+                   h->record_id == (uint8_t)id &&
+                   h->length <= CALIB_STORE_MAX_PAYLOAD &&
+                   h->header_crc == calibration_crc32(0, h, offsetof(StoreHeader_t, header_crc));
+
+    if (header_ok[s] && (!any || (int32_t)(h->sequence - cursor->sequence) > 0)) {
+      cursor->slot = s;
+      cursor->sequence = h->sequence;
+      any = true;
+    }
+  }
+
+  cursor->scanned = true;
+}
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Associar o armazenamento a uma EEPROM
+ */
+void calibration_store_init(CalibrationStore_t *store, CalibrationEepromRead_t read,
+                            CalibrationEepromWrite_t write, void *user) {
+  memset(store, 0, sizeof(*store));
+  store->read = read;
+  store->write = write;
+  store->user = user;
+}
+
+/**
+ * @brief Carregar a versão mais recente de um registro
+ *
+ * Custo limitado: CALIB_STORE_SLOTS leituras de cabeçalho e, do mais novo
+ * para o mais antigo, uma leitura de payload por candidato com o layout
+ * esperado, parando no primeiro com CRC válido.
+ */
+bool calibration_store_load(CalibrationStore_t *store, CalibrationRecordId_t id,
+                            void *data, size_t size, uint32_t layout_id, uint8_t *flags) {
+  StoreHeader_t headers[CALIB_STORE_SLOTS];
+  bool candidate[CALIB_STORE_SLOTS];
+
+  if (id >= CALIB_RECORD_COUNT || size > CALIB_STORE_MAX_PAYLOAD) {
+    return false;
+  }
+
+  scan_headers(store, id, headers, candidate);
+  for (uint8_t s = 0; s < CALIB_STORE_SLOTS; s++) {
+    candidate[s] = candidate[s] &&
+                   headers[s].layout_id == layout_id &&
+                   headers[s].length == size;
+  }
+
+  for (uint8_t tries = 0; tries < CALIB_STORE_SLOTS; tries++) {
+    int best = -1;
+    for (uint8_t s = 0; s < CALIB_STORE_SLOTS; s++) {
+      if (candidate[s] &&
+          (best < 0 || (int32_t)(headers[s].sequence - headers[best].sequence) > 0)) {
+        best = s;
+      }
+    }
+    if (best < 0) {
+      break;
+    }
+
+    store_read(store, slot_addr(id, (uint8_t)best) + CALIB_EEPROM_PAGE_SIZE, data, size);
+    if (calibration_crc32(0, data, size) == headers[best].payload_crc) {
+      if (flags != NULL) {
+        *flags = headers[best].flags;
+      }
+      return true;
+    }
+
+    // Payload corrompido (gravação interrompida): tentar o anterior
+    candidate[best] = false;
+  }
+
+  return false;
+}
+
+/**
+ * @brief Gravar uma nova versão de um registro no próximo slot
+ *
+ * Apenas as páginas que diferem do conteúdo atual do slot de destino são
+ * escritas; o cabeçalho (commit) é sempre a última escrita.
+ */
+size_t calibration_store_save(CalibrationStore_t *store, CalibrationRecordId_t id,
+                              const void *data, size_t size, uint32_t layout_id, uint8_t flags) {
+  CalibrationStoreCursor_t *cursor;
+  StoreHeader_t header;
+  uint8_t page[CALIB_EEPROM_PAGE_SIZE];
+  const uint8_t *src = (const uint8_t *)data;
+  size_t written = 0;
+
+  if (id >= CALIB_RECORD_COUNT || size > CALIB_STORE_MAX_PAYLOAD) {
+    return 0;
+  }
+
+  cursor = &store->cursors[id];
+  if (!cursor->scanned) {
+    StoreHeader_t headers[CALIB_STORE_SLOTS];
+    bool header_ok[CALIB_STORE_SLOTS];
+    scan_headers(store, id, headers, header_ok);
+  }
+
+  uint8_t slot = (uint8_t)((cursor->slot + 1) % CALIB_STORE_SLOTS);
+  uint32_t payload_addr = slot_addr(id, slot) + CALIB_EEPROM_PAGE_SIZE;
+
+  for (size_t off = 0; off < size; off += CALIB_EEPROM_PAGE_SIZE) {
+    size_t chunk = size - off;
+    if (chunk > CALIB_EEPROM_PAGE_SIZE) {
+      chunk = CALIB_EEPROM_PAGE_SIZE;
+    }
+    store_read(store, payload_addr + off, page, chunk);
+    if (memcmp(page, src + off, chunk) != 0) {
+      store->write(store->user, payload_addr + off, src + off, chunk);
+      written += chunk;
+    }
+  }
+
+  header.magic = STORE_MAGIC;
+  header.sequence = cursor->sequence + 1;
+  header.layout_id = layout_id;
+  header.record_id = (uint8_t)id;
+  header.flags = flags;
+  header.length = (uint16_t)size;
+  header.payload_crc = calibration_crc32(0, data, size);
+  header.header_crc = calibration_crc32(0, &header, offsetof(StoreHeader_t, header_crc));
+  store->write(store->user, slot_addr(id, slot), (const uint8_t *)&header, sizeof(header));
+  written += sizeof(header);
+
+  cursor->slot = slot;
+  cursor->sequence = header.sequence;
+  return written;
+}
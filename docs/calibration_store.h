@@ -0,0 +1,158 @@
+/**
+ * @file calibration_store.h
+ * @brief Armazenamento journaled da calibração em EEPROM
+ * @version 1.0.0
+ *
+ * Cada registro (calibração base, extensões) ocupa CALIB_STORE_SLOTS
+ * slots em rodízio. Um slot contém um cabeçalho com número de sequência
+ * e CRC32 do payload, seguido do payload. Cada gravação vai para o slot
+ * seguinte ao mais recente e escreve apenas as páginas cujo conteúdo
+ * mudou; o cabeçalho é gravado por último, de modo que uma gravação
+ * interrompida deixa o slot com CRC inválido e o slot anterior continua
+ * sendo o mais recente. Na inicialização, os cabeçalhos dos slots são
+ * varridos (sempre CALIB_STORE_SLOTS leituras) e vence o de maior
+ * sequência com CRC válido.
+ *
+ * O cabeçalho também guarda um identificador de layout (versão + tamanho
+ * da estrutura), verificado junto com o CRC na mesma leitura, e a flag
+ * CALIB_STORE_FLAG_VALIDATED, que indica que o payload já passou pela
+ * validação completa antes de ser gravado.
+ *
+ * O acesso à EEPROM é feito pelas funções de leitura/escrita do
+ * CalibrationStore_t, de modo que cada instância de calibração (ex.: um
+ * robô simulado) tenha sua própria memória e seus próprios cursores.
+ */
+
+#ifndef CALIBRATION_STORE_H
+#define CALIBRATION_STORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#ifndef CALIB_STORE_ADDR
+#define CALIB_STORE_ADDR 0x1400        ///< Início da área journaled
+#endif
+
+#ifndef CALIB_STORE_SLOTS
+#define CALIB_STORE_SLOTS 4            ///< Slots em rodízio por registro
+#endif
+
+#ifndef CALIB_EEPROM_PAGE_SIZE
+#define CALIB_EEPROM_PAGE_SIZE 32      ///< Página de escrita da EEPROM (bytes)
+#endif
+
+#define CALIB_STORE_SLOT_SIZE 256      ///< Bytes por slot (cabeçalho + payload)
+#define CALIB_STORE_MAX_PAYLOAD (CALIB_STORE_SLOT_SIZE - CALIB_EEPROM_PAGE_SIZE)
+
+#define CALIB_STORE_FLAG_VALIDATED 0x01  ///< Payload validado antes da gravação
+
+/// Identificador de layout: versão nos 16 bits altos, tamanho nos baixos
+#define CALIB_STORE_LAYOUT_ID(version, type) \
+  (((uint32_t)(version) << 16) | (uint32_t)(sizeof(type) & 0xFFFF))
+
+// ============================================================================
+// ENUMERAÇÕES
+// ============================================================================
+
+/**
+ * @enum CalibrationRecordId_t
+ * @brief Registros mantidos no armazenamento
+ */
+typedef enum {
+  CALIB_RECORD_BASE = 0,      ///< SensorCalibration_t
+  CALIB_RECORD_EXT = 1,       ///< SensorCalibrationExt_t
+  CALIB_RECORD_BATTERY = 2,   ///< CalibrationBatteryModel_t
+  CALIB_RECORD_THERMAL = 3,   ///< CalibrationThermal_t
+  CALIB_RECORD_COUNT = 4
+} CalibrationRecordId_t;
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+/// Ler len bytes da EEPROM a partir de addr
+typedef void (*CalibrationEepromRead_t)(void *user, uint32_t addr, uint8_t *data, size_t len);
+
+/// Escrever len bytes na EEPROM a partir de addr
+typedef void (*CalibrationEepromWrite_t)(void *user, uint32_t addr, const uint8_t *data,
+                                         size_t len);
+
+/**
+ * @struct CalibrationStoreCursor_t
+ * @brief Estado em RAM de um registro (slot mais recente)
+ */
+typedef struct {
+  bool scanned;
+  uint8_t slot;        ///< Slot com o cabeçalho válido mais recente
+  uint32_t sequence;   ///< Sequência desse cabeçalho
+} CalibrationStoreCursor_t;
+
+/**
+ * @struct CalibrationStore_t
+ * @brief Armazenamento de uma EEPROM
+ */
+typedef struct {
+  CalibrationEepromRead_t read;
+  CalibrationEepromWrite_t write;
+  void *user;                                          ///< Primeiro argumento de read/write
+  CalibrationStoreCursor_t cursors[CALIB_RECORD_COUNT];
+} CalibrationStore_t;
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Calcular CRC32 (IEEE 802.3, refletido)
+ * @param crc Valor anterior (0 para iniciar)
+ * @param data Dados
+ * @param len Tamanho em bytes
+ * @return CRC acumulado
+ */
+uint32_t calibration_crc32(uint32_t crc, const void *data, size_t len);
+
+/**
+ * @brief Associar o armazenamento a uma EEPROM (cursores ainda não varridos)
+ * @param store Armazenamento
+ * @param read Leitura da EEPROM
+ * @param write Escrita da EEPROM
+ * @param user Primeiro argumento de read/write
+ */
+void calibration_store_init(CalibrationStore_t *store, CalibrationEepromRead_t read,
+                            CalibrationEepromWrite_t write, void *user);
+
+/**
+ * @brief Carregar a versão mais recente de um registro
+ *
+ * O payload é lido uma única vez, direto para data, com o CRC calculado
+ * sobre o mesmo buffer.
+ * @param store Armazenamento
+ * @param id Registro
+ * @param data Destino
+ * @param size Tamanho esperado do registro
+ * @param layout_id Layout esperado (CALIB_STORE_LAYOUT_ID)
+ * @param flags Flags do slot carregado (pode ser NULL)
+ * @return false se nenhum slot válido com esse layout for encontrado
+ */
+bool calibration_store_load(CalibrationStore_t *store, CalibrationRecordId_t id,
+                            void *data, size_t size, uint32_t layout_id, uint8_t *flags);
+
+/**
+ * @brief Gravar uma nova versão de um registro no próximo slot
+ * @param store Armazenamento
+ * @param id Registro
+ * @param data Dados
+ * @param size Tamanho do registro (até CALIB_STORE_MAX_PAYLOAD)
+ * @param layout_id Layout do registro (CALIB_STORE_LAYOUT_ID)
+ * @param flags CALIB_STORE_FLAG_*
+ * @return Número de bytes efetivamente gravados na EEPROM
+ */
+size_t calibration_store_save(CalibrationStore_t *store, CalibrationRecordId_t id,
+                              const void *data, size_t size, uint32_t layout_id, uint8_t flags);
+
+#endif // CALIBRATION_STORE_H
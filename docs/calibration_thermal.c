@@ -0,0 +1,217 @@
+/**
+ * @file calibration_thermal.c
+ * @brief Compensação térmica: canais de temperatura, bias do giroscópio e LiDAR
+ * @version 1.0.0
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include "calibration_thermal.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define CALIB_THERMAL_MAGIC 0xCAFE7E01    // Incrementar a cada mudança de layout
+#define THERMAL_OFFSET_MAX 50.0f          // Offset de canal plausível (°C)
+
+// ============================================================================
+// UTILITÁRIOS INTERNOS
+// ============================================================================
+
+/**
+ * @brief Posição contínua da temperatura na tabela (0 = primeiro ponto)
+ */
+static float lut_position(float temperature) {
+  return (temperature - CALIB_GYRO_TEMP_MIN) / CALIB_GYRO_TEMP_STEP;
+}
+
+/**
+ * @brief Converter bias para a unidade da tabela (com saturação)
+ */
+static int16_t bias_to_lsb(float bias) {
+  float lsb = bias / CALIB_GYRO_LUT_LSB;
+
+  if (lsb > 32767.0f) {
+    return 32767;
+  }
+  if (lsb < -32768.0f) {
+    return -32768;
+  }
+  return (int16_t)lrintf(lsb);
+}
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Preencher o modelo térmico com a identidade
+ */
+void thermal_model_default(CalibrationThermal_t *model) {
+  memset(model, 0, sizeof(*model));
+  model->magic = CALIB_THERMAL_MAGIC;
+  for (int i = 0; i < CALIB_TEMP_CHANNELS; i++) {
+    model->slope[i] = 1.0f;
+  }
+  model->channel_count = 1;
+}
+
+/**
+ * @brief Verificar a consistência de um modelo carregado
+ */
+bool thermal_model_valid(const CalibrationThermal_t *model) {
+  if (model->magic != CALIB_THERMAL_MAGIC ||
+      !(fabsf(model->lidar_drift) <= CALIB_LIDAR_DRIFT_MAX)) {
+    return false;
+  }
+
+  for (int i = 0; i < CALIB_TEMP_CHANNELS; i++) {
+    if (!(model->slope[i] >= 0.5f && model->slope[i] <= 2.0f) ||
+        !(fabsf(model->offset[i]) < THERMAL_OFFSET_MAX)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Número de canais de uma leitura
+ */
+uint8_t thermal_channel_count(const TemperatureData_t *data) {
+  if (data->channel_count <= 1) {
+    return 1;
+  }
+  return (data->channel_count < CALIB_TEMP_CHANNELS) ? (uint8_t)data->channel_count
+                                                      : CALIB_TEMP_CHANNELS;
+}
+
+/**
+ * @brief Temperatura de um canal
+ */
+float thermal_channel(const TemperatureData_t *data, uint8_t channel) {
+  if (channel == 0 || channel >= thermal_channel_count(data)) {
+    return data->temperature;
+  }
+  return data->channel[channel - 1];
+}
+
+/**
+ * @brief Incorporar uma nova calibração do LiDAR à estimativa de deriva
+ *
+ * A deriva só é observável entre calibrações a temperaturas diferentes;
+ * pares mais próximos que CALIB_LIDAR_DRIFT_SPAN apenas movem a
+ * referência. Uma razão implausível (ex.: o LiDAR foi remontado) é
+ * descartada.
+ */
+bool thermal_lidar_learn(CalibrationThermal_t *model, float previous_offset, float offset,
+                         float temperature) {
+  bool changed = false;
+
+  if (model->lidar_referenced) {
+    float span = temperature - model->lidar_temperature;
+
+    if (fabsf(span) >= CALIB_LIDAR_DRIFT_SPAN) {
+      float drift = (offset - previous_offset) / span;
+
+      if (fabsf(drift) <= CALIB_LIDAR_DRIFT_MAX) {
+        if (model->lidar_drift_updates < CALIB_LIDAR_DRIFT_MAX_WEIGHT) {
+          model->lidar_drift_updates++;
+        }
+        model->lidar_drift += (drift - model->lidar_drift) / (float)model->lidar_drift_updates;
+        changed = true;
+      }
+    }
+  }
+
+  model->lidar_temperature = temperature;
+  model->lidar_referenced = true;
+  return changed;
+}
+
+/**
+ * @brief Offset de distância do LiDAR compensado em temperatura
+ */
+float thermal_lidar_offset(const CalibrationThermal_t *model, float offset, float temperature) {
+  if (!model->lidar_referenced) {
+    return offset;
+  }
+  return offset + model->lidar_drift * (temperature - model->lidar_temperature);
+}
+
+/**
+ * @brief Esvaziar a tabela
+ */
+void gyro_temp_lut_reset(GyroTempBin_t lut[CALIB_GYRO_TEMP_BINS]) {
+  memset(lut, 0, sizeof(GyroTempBin_t) * CALIB_GYRO_TEMP_BINS);
+}
+
+/**
+ * @brief Incorporar uma medida de bias ao ponto mais próximo
+ */
+bool gyro_temp_lut_update(GyroTempBin_t lut[CALIB_GYRO_TEMP_BINS],
+                          float temperature, const float bias[3]) {
+  float pos = lut_position(temperature);
+
+  if (!(pos >= -0.5f && pos < CALIB_GYRO_TEMP_BINS - 0.5f)) {
+    return false;
+  }
+
+  GyroTempBin_t *bin = &lut[(int)(pos + 0.5f)];
+  if (bin->count < CALIB_GYRO_LUT_MAX_WEIGHT) {
+    bin->count++;
+  }
+
+  float weight = 1.0f / (float)bin->count;
+  for (int i = 0; i < 3; i++) {
+    float current = bin->bias[i] * CALIB_GYRO_LUT_LSB;
+    bin->bias[i] = bias_to_lsb(current + weight * (bias[i] - current));
+  }
+
+  return true;
+}
+
+/**
+ * @brief Interpolar o bias para uma temperatura
+ *
+ * Entre dois pontos preenchidos: interpolação linear. Fora deles (ou com
+ * um único ponto): valor do ponto preenchido mais próximo.
+ */
+bool gyro_temp_lut_interpolate(const GyroTempBin_t lut[CALIB_GYRO_TEMP_BINS],
+                               float temperature, float bias[3]) {
+  float pos = lut_position(temperature);
+  int lower = -1;
+  int upper = -1;
+
+  for (int i = 0; i < CALIB_GYRO_TEMP_BINS; i++) {
+    if (lut[i].count == 0) {
+      continue;
+    }
+    if ((float)i <= pos) {
+      lower = i;
+    } else if (upper < 0) {
+      upper = i;
+    }
+  }
+
+  if (lower < 0 && upper < 0) {
+    return false;
+  }
+  if (lower < 0 || upper < 0) {
+    const GyroTempBin_t *bin = &lut[lower >= 0 ? lower : upper];
+    for (int i = 0; i < 3; i++) {
+      bias[i] = bin->bias[i] * CALIB_GYRO_LUT_LSB;
+    }
+    return true;
+  }
+
+  float t = (pos - (float)lower) / (float)(upper - lower);
+  for (int i = 0; i < 3; i++) {
+    float lo = lut[lower].bias[i] * CALIB_GYRO_LUT_LSB;
+    float hi = lut[upper].bias[i] * CALIB_GYRO_LUT_LSB;
+    bias[i] = lo + t * (hi - lo);
+  }
+  return true;
+}
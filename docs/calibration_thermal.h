@@ -0,0 +1,165 @@
+/**
+ * @file calibration_thermal.h
+ * @brief Compensação térmica: canais de temperatura, bias do giroscópio e LiDAR
+ * @version 1.0.0
+ *
+ * Canais: cada canal de TemperatureData_t tem sua correção
+ * T = slope · bruto + offset (CalibrationThermal_t), aplicada em lote
+ * pelo kernel de calibration_apply.h. O slope vem de fábrica (dois
+ * pontos em câmara); a fase de temperatura recalcula só os offsets,
+ * levando todos os canais à temperatura ambiente informada (o robô deve
+ * estar em equilíbrio térmico, motores parados há algum tempo).
+ *
+ * Giroscópio: CALIB_GYRO_TEMP_BINS pontos espaçados de
+ * CALIB_GYRO_TEMP_STEP a partir de CALIB_GYRO_TEMP_MIN, indexados pelo
+ * canal CALIB_TEMP_CHANNEL_IMU. Cada ponto guarda a média corrente do
+ * bias observado perto da sua temperatura; a consulta interpola
+ * linearmente entre os pontos preenchidos mais próximos.
+ *
+ * LiDAR: o offset de distância deriva linearmente com o canal
+ * CALIB_TEMP_CHANNEL_LIDAR. A deriva (m/°C) é estimada entre duas
+ * calibrações do LiDAR a temperaturas diferentes e aplicada em relação à
+ * temperatura da última delas.
+ */
+
+#ifndef CALIBRATION_THERMAL_H
+#define CALIBRATION_THERMAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sensor_calibration.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#ifndef CALIB_GYRO_LUT_MAX_WEIGHT
+#define CALIB_GYRO_LUT_MAX_WEIGHT 64     ///< Peso máximo da média (vira média exponencial)
+#endif
+
+#ifndef CALIB_TEMP_AMBIENT
+#define CALIB_TEMP_AMBIENT 25.0f         ///< Ambiente assumido na fase de temperatura (°C)
+#endif
+
+#ifndef CALIB_TEMP_CHANNEL_IMU
+#define CALIB_TEMP_CHANNEL_IMU 0         ///< Canal junto ao IMU
+#endif
+
+#ifndef CALIB_TEMP_CHANNEL_LIDAR
+#define CALIB_TEMP_CHANNEL_LIDAR 0       ///< Canal junto ao LiDAR
+#endif
+
+#ifndef CALIB_TEMP_EQUILIBRIUM
+#define CALIB_TEMP_EQUILIBRIUM 3.0f      ///< Offset de canal que sugere robô fora do equilíbrio (°C)
+#endif
+
+#ifndef CALIB_LIDAR_DRIFT_SPAN
+#define CALIB_LIDAR_DRIFT_SPAN 5.0f      ///< Diferença mínima entre calibrações para medir a deriva (°C)
+#endif
+
+#ifndef CALIB_LIDAR_DRIFT_MAX
+#define CALIB_LIDAR_DRIFT_MAX 0.002f     ///< Deriva plausível do offset do LiDAR (m/°C)
+#endif
+
+#ifndef CALIB_LIDAR_DRIFT_MAX_WEIGHT
+#define CALIB_LIDAR_DRIFT_MAX_WEIGHT 4   ///< Peso máximo da média da deriva
+#endif
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+/**
+ * @struct CalibrationThermal_t
+ * @brief Modelo térmico (persistido)
+ */
+typedef struct {
+  uint32_t magic;
+  float slope[CALIB_TEMP_CHANNELS];    ///< Ganho por canal
+  float offset[CALIB_TEMP_CHANNELS];   ///< Offset por canal (°C)
+  float lidar_temperature;             ///< Canal do LiDAR na última calibração do LiDAR (°C)
+  float lidar_drift;                   ///< Deriva do offset de distância (m/°C)
+  uint16_t lidar_drift_updates;        ///< Pares incorporados (até CALIB_LIDAR_DRIFT_MAX_WEIGHT)
+  uint8_t channel_count;               ///< Canais calibrados na última fase de temperatura
+  bool lidar_referenced;               ///< lidar_temperature válida
+} CalibrationThermal_t;
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Preencher o modelo térmico com a identidade
+ * @param model Modelo
+ */
+void thermal_model_default(CalibrationThermal_t *model);
+
+/**
+ * @brief Verificar a consistência de um modelo carregado
+ * @param model Modelo
+ * @return false se algum coeficiente for implausível
+ */
+bool thermal_model_valid(const CalibrationThermal_t *model);
+
+/**
+ * @brief Número de canais de uma leitura
+ * @param data Leitura
+ * @return 1..CALIB_TEMP_CHANNELS
+ */
+uint8_t thermal_channel_count(const TemperatureData_t *data);
+
+/**
+ * @brief Temperatura de um canal
+ * @param data Leitura (bruta ou corrigida)
+ * @param channel Canal
+ * @return Temperatura do canal, ou do canal 0 se ele não estiver na leitura (°C)
+ */
+float thermal_channel(const TemperatureData_t *data, uint8_t channel);
+
+/**
+ * @brief Incorporar uma nova calibração do LiDAR à estimativa de deriva
+ * @param model Modelo
+ * @param previous_offset Offset de distância da calibração anterior (m)
+ * @param offset Offset de distância recém-calibrado (m)
+ * @param temperature Canal do LiDAR durante a calibração (°C)
+ * @return true se a deriva mudou
+ */
+bool thermal_lidar_learn(CalibrationThermal_t *model, float previous_offset, float offset,
+                         float temperature);
+
+/**
+ * @brief Offset de distância do LiDAR compensado em temperatura
+ * @param model Modelo
+ * @param offset Offset calibrado (m)
+ * @param temperature Canal do LiDAR (°C)
+ * @return Offset na temperatura atual (m)
+ */
+float thermal_lidar_offset(const CalibrationThermal_t *model, float offset, float temperature);
+
+/**
+ * @brief Esvaziar a tabela
+ * @param lut Tabela
+ */
+void gyro_temp_lut_reset(GyroTempBin_t lut[CALIB_GYRO_TEMP_BINS]);
+
+/**
+ * @brief Incorporar uma medida de bias ao ponto mais próximo
+ * @param lut Tabela
+ * @param temperature Temperatura da medida (°C)
+ * @param bias Bias X, Y, Z (rad/s)
+ * @return false se a temperatura estiver fora da faixa da tabela
+ */
+bool gyro_temp_lut_update(GyroTempBin_t lut[CALIB_GYRO_TEMP_BINS],
+                          float temperature, const float bias[3]);
+
+/**
+ * @brief Interpolar o bias para uma temperatura
+ * @param lut Tabela
+ * @param temperature Temperatura (°C)
+ * @param bias Bias X, Y, Z (rad/s)
+ * @return false se a tabela estiver vazia (bias não alterado)
+ */
+bool gyro_temp_lut_interpolate(const GyroTempBin_t lut[CALIB_GYRO_TEMP_BINS],
+                               float temperature, float bias[3]);
+
+#endif // CALIBRATION_THERMAL_H
@@ -0,0 +1,261 @@
+/**
+ * @file calibration_undistort.c
+ * @brief Tabela de remapeamento para correção da distorção da câmera
+ * @version 1.0.0
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include "calibration_undistort.h"
+
+#if !defined(CALIB_UNDISTORT_FORCE_SCALAR) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define CALIB_UNDISTORT_NEON 1
+#elif !defined(CALIB_UNDISTORT_FORCE_SCALAR) && (defined(__SSE2__) || defined(_M_X64))
+#include <emmintrin.h>
+#define CALIB_UNDISTORT_SSE 1
+#endif
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define CALIB_STATIC_ASSERT(cond, name) typedef char name[(cond) ? 1 : -1]
+
+CALIB_STATIC_ASSERT(sizeof(CalibrationUndistortEntry_t) == 6, undistort_entry_is_6_bytes);
+
+#define REMAP_LANES 8
+#define WEIGHT_ONE 256
+
+// ============================================================================
+// UTILITÁRIOS INTERNOS
+// ============================================================================
+
+/**
+ * @brief Peso fracionário em 1/256 (saturado em 255)
+ */
+static uint8_t fraction_weight(float frac) {
+  long w = lrintf(frac * WEIGHT_ONE);
+  return (uint8_t)(w < 0 ? 0 : (w > 255 ? 255 : w));
+}
+
+/**
+ * @brief Interpolação bilinear de uma entrada (referência escalar)
+ */
+static uint8_t remap_pixel(const CalibrationUndistortEntry_t *e, const uint8_t *src,
+                           uint32_t stride) {
+  if (e->x == CALIB_UNDISTORT_INVALID) {
+    return 0;
+  }
+  const uint8_t *p = src + (size_t)e->y * stride + e->x;
+  uint32_t top = (p[0] * (WEIGHT_ONE - e->wx) + p[1] * e->wx + 128) >> 8;
+  uint32_t bottom = (p[stride] * (WEIGHT_ONE - e->wx) + p[stride + 1] * e->wx + 128) >> 8;
+  return (uint8_t)((top * (WEIGHT_ONE - e->wy) + bottom * e->wy + 128) >> 8);
+}
+
+#if defined(CALIB_UNDISTORT_SSE) || defined(CALIB_UNDISTORT_NEON)
+/**
+ * @brief Coletar a vizinhança 2x2 e os pesos de REMAP_LANES entradas
+ *
+ * SSE2/NEON não têm gather: cada lane faz três leituras de 16 bits
+ * (par de pixels de cima, par de baixo, wx|wy) e a interpolação, que
+ * domina o custo aritmético, é feita em lanes de 16 bits. Entradas
+ * inválidas leem zeros.
+ */
+static void gather_lanes(const CalibrationUndistortEntry_t *e, const uint8_t *src, uint32_t stride,
+                         uint16_t top[REMAP_LANES], uint16_t bottom[REMAP_LANES],
+                         uint16_t weights[REMAP_LANES]) {
+  static const uint8_t zeros[2] = { 0, 0 };
+
+  for (int k = 0; k < REMAP_LANES; k++) {
+    const uint8_t *p = zeros;
+    const uint8_t *q = zeros;
+    if (e[k].x != CALIB_UNDISTORT_INVALID) {
+      p = src + (size_t)e[k].y * stride + e[k].x;
+      q = p + stride;
+    }
+    memcpy(&top[k], p, sizeof(uint16_t));
+    memcpy(&bottom[k], q, sizeof(uint16_t));
+    memcpy(&weights[k], &e[k].wx, sizeof(uint16_t));
+  }
+}
+#endif
+
+/**
+ * @brief Remapear uma linha de saída
+ *
+ * Cada produto cabe em 16 bits sem sinal: 255·256 + 128 < 65536.
+ */
+static void remap_row(const CalibrationUndistortEntry_t *entries, const uint8_t *src,
+                      uint32_t stride, uint8_t *out, int width) {
+  int x = 0;
+
+#if defined(CALIB_UNDISTORT_SSE)
+  const __m128i one = _mm_set1_epi16(WEIGHT_ONE);
+  const __m128i half = _mm_set1_epi16(128);
+  const __m128i low = _mm_set1_epi16(0x00FF);
+  for (; x + REMAP_LANES <= width; x += REMAP_LANES) {
+    uint16_t t[REMAP_LANES], b[REMAP_LANES], w[REMAP_LANES];
+
+    gather_lanes(entries + x, src, stride, t, b, w);
+
+    // Pares little-endian: byte baixo = pixel da esquerda (wx no byte baixo)
+    __m128i vt = _mm_loadu_si128((const __m128i *)t);
+    __m128i vb = _mm_loadu_si128((const __m128i *)b);
+    __m128i vw = _mm_loadu_si128((const __m128i *)w);
+    __m128i fx = _mm_and_si128(vw, low);
+    __m128i fy = _mm_srli_epi16(vw, 8);
+    __m128i gx = _mm_sub_epi16(one, fx);
+
+    __m128i top = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(vt, low), gx),
+                                _mm_mullo_epi16(_mm_srli_epi16(vt, 8), fx));
+    __m128i bottom = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(vb, low), gx),
+                                   _mm_mullo_epi16(_mm_srli_epi16(vb, 8), fx));
+    top = _mm_srli_epi16(_mm_add_epi16(top, half), 8);
+    bottom = _mm_srli_epi16(_mm_add_epi16(bottom, half), 8);
+
+    __m128i y = _mm_add_epi16(_mm_mullo_epi16(top, _mm_sub_epi16(one, fy)),
+                              _mm_mullo_epi16(bottom, fy));
+    y = _mm_srli_epi16(_mm_add_epi16(y, half), 8);
+    _mm_storel_epi64((__m128i *)(out + x), _mm_packus_epi16(y, y));
+  }
+#elif defined(CALIB_UNDISTORT_NEON)
+  const uint16x8_t one = vdupq_n_u16(WEIGHT_ONE);
+  const uint16x8_t low = vdupq_n_u16(0x00FF);
+  for (; x + REMAP_LANES <= width; x += REMAP_LANES) {
+    uint16_t t[REMAP_LANES], b[REMAP_LANES], w[REMAP_LANES];
+
+    gather_lanes(entries + x, src, stride, t, b, w);
+
+    uint16x8_t vt = vld1q_u16(t);
+    uint16x8_t vb = vld1q_u16(b);
+    uint16x8_t vw = vld1q_u16(w);
+    uint16x8_t fx = vandq_u16(vw, low);
+    uint16x8_t fy = vshrq_n_u16(vw, 8);
+    uint16x8_t gx = vsubq_u16(one, fx);
+
+    uint16x8_t top = vmlaq_u16(vmulq_u16(vandq_u16(vt, low), gx), vshrq_n_u16(vt, 8), fx);
+    uint16x8_t bottom = vmlaq_u16(vmulq_u16(vandq_u16(vb, low), gx), vshrq_n_u16(vb, 8), fx);
+    top = vrshrq_n_u16(top, 8);
+    bottom = vrshrq_n_u16(bottom, 8);
+
+    uint16x8_t y = vmlaq_u16(vmulq_u16(top, vsubq_u16(one, fy)), bottom, fy);
+    vst1_u8(out + x, vmovn_u16(vrshrq_n_u16(y, 8)));
+  }
+#endif
+
+  for (; x < width; x++) {
+    out[x] = remap_pixel(&entries[x], src, stride);
+  }
+}
+
+/**
+ * @brief Gerar a tabela (avalia o polinômio uma vez por pixel de saída)
+ */
+static void build_map(CalibrationUndistortMap_t *map, const SensorCalibration_t *calib,
+                      uint16_t width, uint16_t height) {
+  const float f = calib->camera_focal_length;
+  const float cx = calib->camera_principal_point_x;
+  const float cy = calib->camera_principal_point_y;
+  const float k1 = calib->camera_distortion_k1;
+  const float k2 = calib->camera_distortion_k2;
+  const float inv_f = 1.0f / f;
+  const float max_x = (float)(width - 1);
+  const float max_y = (float)(height - 1);
+
+  for (uint16_t v = 0; v < height; v++) {
+    CalibrationUndistortEntry_t *row = map->entries + (size_t)v * width;
+    float y = ((float)v - cy) * inv_f;
+    float y2 = y * y;
+
+    for (uint16_t u = 0; u < width; u++) {
+      float x = ((float)u - cx) * inv_f;
+      float r2 = x * x + y2;
+      float d = 1.0f + k1 * r2 + k2 * r2 * r2;
+      float us = f * x * d + cx;
+      float vs = f * y * d + cy;
+      CalibrationUndistortEntry_t *e = &row[u];
+
+      if (!(us >= 0.0f && vs >= 0.0f && us <= max_x && vs <= max_y)) {
+        e->x = CALIB_UNDISTORT_INVALID;
+        e->y = 0;
+        e->wx = e->wy = 0;
+        continue;
+      }
+
+      // Vizinhança 2x2 sempre dentro do quadro: a última coluna/linha usa peso 1
+      int x0 = (int)us;
+      int y0 = (int)vs;
+      if (x0 > width - 2) {
+        x0 = width - 2;
+      }
+      if (y0 > height - 2) {
+        y0 = height - 2;
+      }
+      e->x = (uint16_t)x0;
+      e->y = (uint16_t)y0;
+      e->wx = fraction_weight(us - (float)x0);
+      e->wy = fraction_weight(vs - (float)y0);
+    }
+  }
+
+  map->width = width;
+  map->height = height;
+  map->focal_length = f;
+  map->cx = cx;
+  map->cy = cy;
+  map->k1 = k1;
+  map->k2 = k2;
+  map->valid = true;
+}
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Associar memória à tabela
+ */
+void calibration_undistort_init(CalibrationUndistortMap_t *map, void *storage, size_t size) {
+  memset(map, 0, sizeof(*map));
+  map->entries = (CalibrationUndistortEntry_t *)storage;
+  map->capacity = (storage != NULL) ? size / sizeof(CalibrationUndistortEntry_t) : 0;
+}
+
+/**
+ * @brief Garantir a tabela para a calibração e geometria dadas
+ */
+bool calibration_undistort_prepare(CalibrationUndistortMap_t *map,
+                                   const SensorCalibration_t *calib,
+                                   uint16_t width, uint16_t height) {
+  if (width < 2 || height < 2 || width >= CALIB_UNDISTORT_INVALID ||
+      (size_t)width * height > map->capacity || !(calib->camera_focal_length > 0.0f)) {
+    return false;
+  }
+
+  if (map->valid && map->width == width && map->height == height &&
+      map->focal_length == calib->camera_focal_length &&
+      map->cx == calib->camera_principal_point_x &&
+      map->cy == calib->camera_principal_point_y &&
+      map->k1 == calib->camera_distortion_k1 &&
+      map->k2 == calib->camera_distortion_k2) {
+    return true;
+  }
+
+  build_map(map, calib, width, height);
+  return true;
+}
+
+/**
+ * @brief Remapear um quadro com a tabela gerada
+ */
+void calibration_undistort_remap(const CalibrationUndistortMap_t *map,
+                                 const CameraFrame_t *frame, uint8_t *out, uint32_t out_stride) {
+  for (uint16_t v = 0; v < map->height; v++) {
+    remap_row(map->entries + (size_t)v * map->width, frame->pixels, frame->stride,
+              out + (size_t)v * out_stride, map->width);
+  }
+}
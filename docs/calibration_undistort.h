@@ -0,0 +1,98 @@
+/**
+ * @file calibration_undistort.h
+ * @brief Tabela de remapeamento para correção da distorção da câmera
+ * @version 1.0.0
+ *
+ * Para cada pixel de saída (u, v), a tabela guarda a posição de origem
+ * no quadro distorcido, já com o polinômio radial avaliado:
+ * x = (u - cx)/f, y = (v - cy)/f, d = 1 + k1·r² + k2·r⁴,
+ * origem = (f·x·d + cx, f·y·d + cy). A posição é guardada em ponto fixo
+ * (uint16 inteiro + fração de 8 bits por eixo) e a correção de um quadro
+ * vira uma coleta bilinear limitada pela banda de memória.
+ *
+ * A saída usa a mesma matriz de câmera (f, cx, cy) da entrada.
+ */
+
+#ifndef CALIBRATION_UNDISTORT_H
+#define CALIBRATION_UNDISTORT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sensor_calibration.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define CALIB_UNDISTORT_INVALID 0xFFFF   ///< x de origem fora do quadro (saída = 0)
+
+/**
+ * @brief Memória necessária para a tabela de um quadro width x height
+ */
+#define CALIB_UNDISTORT_MAP_BYTES(width, height) \
+  ((size_t)(width) * (size_t)(height) * sizeof(CalibrationUndistortEntry_t))
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+/**
+ * @struct CalibrationUndistortEntry_t
+ * @brief Origem de um pixel de saída
+ */
+typedef struct {
+  uint16_t x, y;    ///< Pixel superior esquerdo da vizinhança 2x2
+  uint8_t wx, wy;   ///< Fração em x e y (1/256)
+} CalibrationUndistortEntry_t;
+
+/**
+ * @struct CalibrationUndistortMap_t
+ * @brief Tabela e os parâmetros com que foi gerada
+ */
+typedef struct {
+  CalibrationUndistortEntry_t *entries;  ///< Memória fornecida pelo chamador
+  size_t capacity;                       ///< Entradas disponíveis
+  uint16_t width, height;                ///< Geometria da tabela gerada
+  float focal_length, cx, cy, k1, k2;    ///< Intrínsecos da tabela gerada
+  bool valid;                            ///< Tabela gerada
+} CalibrationUndistortMap_t;
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Associar memória à tabela (descarta a tabela atual)
+ * @param map Tabela
+ * @param storage Memória (alinhada a 2 bytes)
+ * @param size Tamanho em bytes; ver CALIB_UNDISTORT_MAP_BYTES()
+ */
+void calibration_undistort_init(CalibrationUndistortMap_t *map, void *storage, size_t size);
+
+/**
+ * @brief Garantir a tabela para a calibração e geometria dadas
+ *
+ * Só recalcula se os intrínsecos ou a geometria mudaram desde a última
+ * geração.
+ * @param map Tabela
+ * @param calib Calibração com os intrínsecos da câmera
+ * @param width Largura do quadro
+ * @param height Altura do quadro
+ * @return false se a memória for insuficiente
+ */
+bool calibration_undistort_prepare(CalibrationUndistortMap_t *map,
+                                   const SensorCalibration_t *calib,
+                                   uint16_t width, uint16_t height);
+
+/**
+ * @brief Remapear um quadro com a tabela gerada (interpolação bilinear)
+ * @param map Tabela (já preparada para a geometria do quadro)
+ * @param frame Quadro distorcido
+ * @param out Saída width x height
+ * @param out_stride Bytes entre linhas da saída
+ */
+void calibration_undistort_remap(const CalibrationUndistortMap_t *map,
+                                 const CameraFrame_t *frame, uint8_t *out, uint32_t out_stride);
+
+#endif // CALIBRATION_UNDISTORT_H
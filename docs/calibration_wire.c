@@ -0,0 +1,362 @@
+/**
+ * @file calibration_wire.c
+ * @brief Formato binário compacto da calibração para sincronização (MQTT)
+ * @version 1.0.0
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "calibration_wire.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define CALIB_STATIC_ASSERT(cond, name) typedef char name[(cond) ? 1 : -1]
+
+#define WIRE_RECORD_BASE 0
+#define WIRE_RECORD_EXT 1
+
+/**
+ * @brief Campo do formato: count palavras de width bytes a partir de offset
+ *
+ * Sequências de membros consecutivos do mesmo tipo (imu_bias_x..z) formam
+ * um campo só; membros de mesmo tamanho não têm padding entre si.
+ */
+typedef struct {
+  uint8_t record;    ///< WIRE_RECORD_*
+  uint8_t width;     ///< Bytes por palavra (1, 2 ou 4)
+  uint8_t count;     ///< Palavras
+  uint16_t offset;   ///< offsetof() no registro
+} WireField_t;
+
+#define WIRE_BASE(member, n) \
+  { WIRE_RECORD_BASE, sizeof(((SensorCalibration_t *)0)->member), (n), \
+    offsetof(SensorCalibration_t, member) }
+#define WIRE_EXT(member, n) \
+  { WIRE_RECORD_EXT, sizeof(((SensorCalibrationExt_t *)0)->member), (n), \
+    offsetof(SensorCalibrationExt_t, member) }
+
+#define WIRE_META(i) \
+  WIRE_EXT(sensor_meta[i].timestamp, 1), \
+  WIRE_EXT(sensor_meta[i].calibration_count, 1), \
+  WIRE_EXT(sensor_meta[i].status, 1)
+
+// bias[3] e count do ponto são quatro palavras de 16 bits consecutivas
+#define WIRE_GYRO_BIN(i) WIRE_EXT(gyro_temp_lut[i].bias[0], 4)
+
+// Versão 1. Só acrescentar no final (ver calibration_wire.h).
+static const WireField_t wire_fields[] = {
+  WIRE_BASE(imu_bias_x, 3),
+  WIRE_BASE(imu_scale_x, 3),
+  WIRE_BASE(mag_offset_x, 3),
+  WIRE_BASE(mag_scale_x, 3),
+  WIRE_BASE(pulses_per_meter_left, 2),
+  WIRE_BASE(lidar_offset_distance, 2),
+  WIRE_BASE(camera_focal_length, 1),
+  WIRE_BASE(camera_principal_point_x, 2),
+  WIRE_BASE(camera_distortion_k1, 2),
+  WIRE_BASE(battery_voltage_offset, 2),
+  WIRE_BASE(temp_offset, 1),
+  WIRE_BASE(timestamp, 1),
+  WIRE_BASE(calibration_count, 1),
+  WIRE_BASE(status, 1),
+  WIRE_EXT(mag_hard_iron[0], 3),
+  WIRE_EXT(mag_soft_iron[0][0], 9),
+  WIRE_EXT(mag_field_strength, 2),
+  WIRE_EXT(mag_model, 1),
+  WIRE_META(0), WIRE_META(1), WIRE_META(2), WIRE_META(3),
+  WIRE_META(4), WIRE_META(5), WIRE_META(6),
+  WIRE_EXT(gyro_bias[0], 3),
+  WIRE_EXT(gyro_bias_temp, 1),
+  WIRE_GYRO_BIN(0), WIRE_GYRO_BIN(1), WIRE_GYRO_BIN(2), WIRE_GYRO_BIN(3),
+  WIRE_GYRO_BIN(4), WIRE_GYRO_BIN(5), WIRE_GYRO_BIN(6), WIRE_GYRO_BIN(7),
+  WIRE_EXT(wheel_base, 1),
+};
+
+#define WIRE_FIELD_COUNT (sizeof(wire_fields) / sizeof(wire_fields[0]))
+#define WIRE_MAP_SIZE ((WIRE_FIELD_COUNT + 7) / 8)
+
+CALIB_STATIC_ASSERT(CALIB_SENSOR_COUNT == 7, wire_meta_covers_all_sensors);
+CALIB_STATIC_ASSERT(CALIB_GYRO_TEMP_BINS == 8, wire_lut_covers_all_bins);
+CALIB_STATIC_ASSERT(sizeof(GyroTempBin_t) == 8, wire_gyro_bin_is_4_halfwords);
+CALIB_STATIC_ASSERT(WIRE_FIELD_COUNT <= 255, wire_field_count_fits_header);
+
+// ============================================================================
+// UTILITÁRIOS INTERNOS
+// ============================================================================
+
+/**
+ * @brief Endereço do campo em uma cópia
+ */
+static const uint8_t *field_ptr(const CalibrationSnapshotCopy_t *copy, const WireField_t *f) {
+  const uint8_t *record = (f->record == WIRE_RECORD_BASE) ? (const uint8_t *)&copy->calib
+                                                           : (const uint8_t *)&copy->ext;
+  return record + f->offset;
+}
+
+/**
+ * @brief Bytes do campo na mensagem
+ */
+static size_t field_size(const WireField_t *f) {
+  return (size_t)f->width * f->count;
+}
+
+/**
+ * @brief Gravar um inteiro little-endian
+ */
+static void put_le(uint8_t *out, uint32_t value, size_t width) {
+  for (size_t i = 0; i < width; i++) {
+    out[i] = (uint8_t)(value >> (8 * i));
+  }
+}
+
+/**
+ * @brief Ler um inteiro little-endian
+ */
+static uint32_t get_le(const uint8_t *in, size_t width) {
+  uint32_t value = 0;
+
+  for (size_t i = 0; i < width; i++) {
+    value |= (uint32_t)in[i] << (8 * i);
+  }
+  return value;
+}
+
+/**
+ * @brief Serializar as palavras de um campo
+ */
+static void field_encode(uint8_t *out, const uint8_t *src, const WireField_t *f) {
+  for (size_t i = 0; i < f->count; i++, src += f->width, out += f->width) {
+    uint32_t value;
+
+    if (f->width == 4) {
+      uint32_t w;
+      memcpy(&w, src, 4);
+      value = w;
+    } else if (f->width == 2) {
+      uint16_t w;
+      memcpy(&w, src, 2);
+      value = w;
+    } else {
+      value = *src;
+    }
+    put_le(out, value, f->width);
+  }
+}
+
+/**
+ * @brief Desserializar as palavras de um campo
+ */
+static void field_decode(uint8_t *dst, const uint8_t *in, const WireField_t *f) {
+  for (size_t i = 0; i < f->count; i++, dst += f->width, in += f->width) {
+    uint32_t value = get_le(in, f->width);
+
+    if (f->width == 4) {
+      memcpy(dst, &value, 4);
+    } else if (f->width == 2) {
+      uint16_t w = (uint16_t)value;
+      memcpy(dst, &w, 2);
+    } else {
+      *dst = (uint8_t)value;
+    }
+  }
+}
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Codificar uma calibração
+ *
+ * O delta compara os bytes em memória: qualquer mudança de bits (inclusive
+ * -0/+0) é enviada.
+ */
+size_t calibration_wire_encode(uint8_t *out, size_t out_size,
+                               const CalibrationSnapshotCopy_t *copy, uint32_t generation,
+                               const CalibrationSnapshotCopy_t *base, uint32_t base_generation) {
+  size_t pos = CALIB_WIRE_HEADER_SIZE + WIRE_MAP_SIZE;
+
+  if (out_size < pos) {
+    return 0;
+  }
+
+  out[0] = CALIB_WIRE_MAGIC;
+  out[1] = CALIB_WIRE_VERSION;
+  out[2] = (base != NULL) ? CALIB_WIRE_FLAG_DELTA : 0;
+  out[3] = (uint8_t)WIRE_FIELD_COUNT;
+  put_le(&out[4], generation, 4);
+  put_le(&out[8], (base != NULL) ? base_generation : 0, 4);
+  memset(&out[CALIB_WIRE_HEADER_SIZE], 0, WIRE_MAP_SIZE);
+
+  for (size_t i = 0; i < WIRE_FIELD_COUNT; i++) {
+    const WireField_t *f = &wire_fields[i];
+    const uint8_t *src = field_ptr(copy, f);
+    size_t size = field_size(f);
+
+    if (base != NULL && memcmp(src, field_ptr(base, f), size) == 0) {
+      continue;
+    }
+    if (out_size - pos < size) {
+      return 0;
+    }
+    out[CALIB_WIRE_HEADER_SIZE + i / 8] |= (uint8_t)(1u << (i % 8));
+    field_encode(&out[pos], src, f);
+    pos += size;
+  }
+
+  return pos;
+}
+
+/**
+ * @brief Decodificar uma mensagem sobre a calibração do receptor
+ *
+ * Primeira passada valida o tamanho; a segunda aplica os campos.
+ */
+CalibrationWireResult_t calibration_wire_decode(const uint8_t *data, size_t len,
+                                                CalibrationSnapshotCopy_t *copy,
+                                                uint32_t *generation) {
+  if (len < CALIB_WIRE_HEADER_SIZE) {
+    return CALIB_WIRE_TRUNCATED;
+  }
+  if (data[0] != CALIB_WIRE_MAGIC || data[1] != CALIB_WIRE_VERSION ||
+      (data[2] & CALIB_WIRE_FLAG_PRIOR)) {
+    return CALIB_WIRE_BAD_HEADER;
+  }
+
+  size_t sent_fields = data[3];
+  size_t map_size = (sent_fields + 7) / 8;
+  size_t known = (sent_fields < WIRE_FIELD_COUNT) ? sent_fields : WIRE_FIELD_COUNT;
+  const uint8_t *map = &data[CALIB_WIRE_HEADER_SIZE];
+  size_t pos = CALIB_WIRE_HEADER_SIZE + map_size;
+
+  // Delta repetido da geração que o receptor já tem (confirmação perdida)
+  // é idempotente; sobre qualquer outra base, faltariam campos
+  uint32_t message_generation = get_le(&data[4], 4);
+  if ((data[2] & CALIB_WIRE_FLAG_DELTA) && get_le(&data[8], 4) != *generation &&
+      message_generation != *generation) {
+    return CALIB_WIRE_BASE_MISMATCH;
+  }
+  if (len < pos) {
+    return CALIB_WIRE_TRUNCATED;
+  }
+
+  // Campos desconhecidos ficam no final e não precisam ser lidos
+  size_t needed = pos;
+  for (size_t i = 0; i < known; i++) {
+    if (map[i / 8] & (1u << (i % 8))) {
+      needed += field_size(&wire_fields[i]);
+    }
+  }
+  if (len < needed) {
+    return CALIB_WIRE_TRUNCATED;
+  }
+
+  for (size_t i = 0; i < known; i++) {
+    const WireField_t *f = &wire_fields[i];
+
+    if (!(map[i / 8] & (1u << (i % 8)))) {
+      continue;
+    }
+    field_decode((uint8_t *)field_ptr(copy, f), &data[pos], f);
+    pos += field_size(f);
+  }
+
+  *generation = message_generation;
+  return CALIB_WIRE_OK;
+}
+
+/**
+ * @brief Decodificar um prior de frota
+ *
+ * Cada campo presente ocupa o dobro (mediana, depois desvio); campos das
+ * extensões são pulados.
+ */
+CalibrationWireResult_t calibration_wire_decode_prior(const uint8_t *data, size_t len,
+                                                      CalibrationPrior_t *prior) {
+  if (len < CALIB_WIRE_HEADER_SIZE) {
+    return CALIB_WIRE_TRUNCATED;
+  }
+  if (data[0] != CALIB_WIRE_MAGIC || data[1] != CALIB_WIRE_VERSION ||
+      !(data[2] & CALIB_WIRE_FLAG_PRIOR)) {
+    return CALIB_WIRE_BAD_HEADER;
+  }
+
+  size_t sent_fields = data[3];
+  size_t known = (sent_fields < WIRE_FIELD_COUNT) ? sent_fields : WIRE_FIELD_COUNT;
+  const uint8_t *map = &data[CALIB_WIRE_HEADER_SIZE];
+  size_t pos = CALIB_WIRE_HEADER_SIZE + (sent_fields + 7) / 8;
+
+  if (len < pos) {
+    return CALIB_WIRE_TRUNCATED;
+  }
+
+  size_t needed = pos;
+  for (size_t i = 0; i < known; i++) {
+    if (map[i / 8] & (1u << (i % 8))) {
+      needed += 2 * field_size(&wire_fields[i]);
+    }
+  }
+  if (len < needed) {
+    return CALIB_WIRE_TRUNCATED;
+  }
+
+  calibration_prior_reset(prior);
+  for (size_t i = 0; i < known; i++) {
+    const WireField_t *f = &wire_fields[i];
+    size_t size = field_size(f);
+
+    if (!(map[i / 8] & (1u << (i % 8)))) {
+      continue;
+    }
+    if (f->record == WIRE_RECORD_BASE) {
+      field_decode((uint8_t *)&prior->median + f->offset, &data[pos], f);
+      field_decode((uint8_t *)&prior->sigma + f->offset, &data[pos + size], f);
+    }
+    pos += 2 * size;
+  }
+
+  prior->model_id = get_le(&data[4], 4);
+  prior->robots = get_le(&data[8], 4);
+  prior->valid = true;
+  return CALIB_WIRE_OK;
+}
+
+/**
+ * @brief Esquecer o estado do receptor
+ */
+void calibration_wire_sync_reset(CalibrationWireSync_t *sync) {
+  sync->has_sent = false;
+  sync->has_acked = false;
+  sync->sent_generation = 0;
+  sync->acked_generation = 0;
+}
+
+/**
+ * @brief Codificar a calibração publicada: delta sobre a última confirmada
+ */
+size_t calibration_wire_sync_encode(CalibrationWireSync_t *sync, const CalibrationSnapshot_t *snap,
+                                    uint8_t *out, size_t out_size) {
+  sync->sent_generation = calibration_snapshot_read(snap, &sync->sent.calib, &sync->sent.ext);
+  sync->has_sent = true;
+
+  return calibration_wire_encode(out, out_size, &sync->sent, sync->sent_generation,
+                                 sync->has_acked ? &sync->acked : NULL, sync->acked_generation);
+}
+
+/**
+ * @brief Registrar a confirmação do receptor
+ */
+bool calibration_wire_sync_acknowledge(CalibrationWireSync_t *sync, uint32_t generation) {
+  if (!sync->has_sent || generation != sync->sent_generation) {
+    return false;
+  }
+
+  sync->acked = sync->sent;
+  sync->acked_generation = generation;
+  sync->has_acked = true;
+  return true;
+}
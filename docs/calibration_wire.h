@@ -0,0 +1,169 @@
+/**
+ * @file calibration_wire.h
+ * @brief Formato binário compacto da calibração para sincronização (MQTT)
+ * @version 1.0.0
+ *
+ * SensorCalibration_t e SensorCalibrationExt_t têm layout implícito
+ * (padding, endianness da CPU) e não servem como formato de rede. Aqui a
+ * calibração é descrita por uma tabela de campos; cada campo é uma
+ * sequência de palavras de 1, 2 ou 4 bytes (floats pelo padrão de bits
+ * IEEE 754), gravadas em little-endian, sem padding:
+ *
+ *   +0  u8   CALIB_WIRE_MAGIC
+ *   +1  u8   versão do formato (CALIB_WIRE_VERSION)
+ *   +2  u8   flags (CALIB_WIRE_FLAG_DELTA)
+ *   +3  u8   número de campos no mapa de presença
+ *   +4  u32  geração desta calibração
+ *   +8  u32  geração base (delta) ou 0
+ *   +12 mapa de presença: 1 bit por campo, LSB primeiro
+ *   ... valores dos campos presentes, na ordem da tabela
+ *
+ * Uma mensagem completa traz todos os campos; um delta traz só os campos
+ * que diferem da geração base, aquela que o receptor confirmou por último.
+ * O receptor só aplica um delta sobre a própria base (ou o repetido da
+ * geração que já tem); caso contrário pede uma mensagem completa.
+ * A tabela só cresce no final: um receptor ignora campos além dos que
+ * conhece, e campos que um emissor antigo não envia ficam ausentes.
+ * Mudanças incompatíveis incrementam CALIB_WIRE_VERSION.
+ *
+ * Tamanhos (versão 1): mensagem completa ~310 bytes; a atualização de um
+ * sensor cabe em algumas dezenas; sem mudança, 19 bytes.
+ *
+ * Um prior de frota (CALIB_WIRE_FLAG_PRIOR) usa o mesmo cabeçalho com o
+ * modelo do robô no lugar da geração e o número de robôs no lugar da
+ * base; cada campo presente traz as palavras da mediana seguidas das do
+ * desvio. Só os campos de SensorCalibration_t são aplicados.
+ */
+
+#ifndef CALIBRATION_WIRE_H
+#define CALIBRATION_WIRE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "sensor_calibration.h"
+#include "calibration_snapshot.h"
+#include "calibration_prior.h"
+
+// ============================================================================
+// DEFINIÇÕES
+// ============================================================================
+
+#define CALIB_WIRE_MAGIC 0xCA          ///< Primeiro byte de toda mensagem
+#define CALIB_WIRE_VERSION 1           ///< Versão do formato
+#define CALIB_WIRE_FLAG_DELTA 0x01     ///< Mensagem relativa à geração base
+#define CALIB_WIRE_FLAG_PRIOR 0x02     ///< Prior de frota (calibration_prior.h)
+
+#define CALIB_WIRE_HEADER_SIZE 12      ///< Bytes antes do mapa de presença
+#define CALIB_WIRE_MAX_SIZE 320        ///< Maior mensagem (completa, versão 1)
+
+// ============================================================================
+// ENUMERAÇÕES
+// ============================================================================
+
+/**
+ * @enum CalibrationWireResult_t
+ * @brief Resultado da decodificação
+ */
+typedef enum {
+  CALIB_WIRE_OK = 0,
+  CALIB_WIRE_TRUNCATED = 1,      ///< Mensagem menor que o mapa/valores indicam
+  CALIB_WIRE_BAD_HEADER = 2,     ///< Magic, versão ou tipo de mensagem inesperados
+  CALIB_WIRE_BASE_MISMATCH = 3   ///< Delta sobre outra geração: pedir mensagem completa
+} CalibrationWireResult_t;
+
+// ============================================================================
+// ESTRUTURAS DE DADOS
+// ============================================================================
+
+/**
+ * @struct CalibrationWireSync_t
+ * @brief Estado do emissor: última geração enviada e última confirmada
+ *
+ * Um único emissor (a thread de comunicação). Só a última mensagem
+ * enviada pode ser confirmada; confirmações atrasadas são ignoradas e o
+ * próximo delta continua relativo à última geração confirmada.
+ */
+typedef struct {
+  CalibrationSnapshotCopy_t sent;
+  CalibrationSnapshotCopy_t acked;
+  uint32_t sent_generation;
+  uint32_t acked_generation;
+  bool has_sent;
+  bool has_acked;
+} CalibrationWireSync_t;
+
+// ============================================================================
+// FUNÇÕES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Codificar uma calibração
+ * @param out Destino
+ * @param out_size Tamanho do destino (CALIB_WIRE_MAX_SIZE sempre basta)
+ * @param copy Calibração a enviar
+ * @param generation Geração de copy
+ * @param base Última calibração confirmada pelo receptor (NULL: mensagem completa)
+ * @param base_generation Geração de base
+ * @return Bytes gravados, 0 se out_size não bastar
+ */
+size_t calibration_wire_encode(uint8_t *out, size_t out_size,
+                               const CalibrationSnapshotCopy_t *copy, uint32_t generation,
+                               const CalibrationSnapshotCopy_t *base, uint32_t base_generation);
+
+/**
+ * @brief Decodificar uma mensagem sobre a calibração do receptor
+ *
+ * A mensagem é validada por inteiro antes de copy ser alterada. Campos
+ * ausentes (e os magic) mantêm o valor de copy; para a primeira mensagem
+ * completa, partir de init_default_calibration()/init_default_calibration_ext().
+ * @param data Mensagem
+ * @param len Tamanho da mensagem
+ * @param copy Calibração do receptor, atualizada no lugar
+ * @param generation Geração de copy na entrada; geração da mensagem na saída
+ * @return CALIB_WIRE_OK ou o motivo da rejeição (copy inalterada)
+ */
+CalibrationWireResult_t calibration_wire_decode(const uint8_t *data, size_t len,
+                                                CalibrationSnapshotCopy_t *copy,
+                                                uint32_t *generation);
+
+/**
+ * @brief Decodificar um prior de frota
+ *
+ * A mensagem é validada por inteiro antes de prior ser alterado.
+ * @param data Mensagem (CALIB_WIRE_FLAG_PRIOR)
+ * @param len Tamanho da mensagem
+ * @param prior Destino
+ * @return CALIB_WIRE_OK ou o motivo da rejeição (prior inalterado)
+ */
+CalibrationWireResult_t calibration_wire_decode_prior(const uint8_t *data, size_t len,
+                                                      CalibrationPrior_t *prior);
+
+/**
+ * @brief Esquecer o estado do receptor (próxima mensagem completa)
+ *
+ * Usado quando o receptor responde CALIB_WIRE_BASE_MISMATCH.
+ * @param sync Estado do emissor
+ */
+void calibration_wire_sync_reset(CalibrationWireSync_t *sync);
+
+/**
+ * @brief Codificar a calibração publicada: delta sobre a última confirmada
+ * @param sync Estado do emissor
+ * @param snap Calibração publicada
+ * @param out Destino
+ * @param out_size Tamanho do destino
+ * @return Bytes gravados, 0 se out_size não bastar
+ */
+size_t calibration_wire_sync_encode(CalibrationWireSync_t *sync, const CalibrationSnapshot_t *snap,
+                                    uint8_t *out, size_t out_size);
+
+/**
+ * @brief Registrar a confirmação do receptor
+ * @param sync Estado do emissor
+ * @param generation Geração confirmada
+ * @return false se não for a geração enviada por último (ignorada)
+ */
+bool calibration_wire_sync_acknowledge(CalibrationWireSync_t *sync, uint32_t generation);
+
+#endif // CALIBRATION_WIRE_H
@@ -13,13 +13,42 @@
  * - Temperatura (Múltiplos sensores)
  */
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
 #include <math.h>
 #include "sensor_calibration.h"
+#include "calibration_context.h"
+#include "calibration_apply.h"
+#include "calibration_stats.h"
+#include "calibration_ellipsoid.h"
+#include "calibration_store.h"
+#include "calibration_bias.h"
+#include "calibration_thermal.h"
+#include "calibration_lidar.h"
+#include "calibration_camera.h"
+#include "calibration_undistort.h"
+#include "calibration_odometry.h"
+#include "calibration_metrics.h"
+#include "calibration_snapshot.h"
+#include "calibration_prior.h"
+#include "calibration_battery.h"
 #include "eeprom.h"
 #include "logger.h"
+#include "calibration_log.h"  // Depois de logger.h: redireciona log_* no modo diferido
+
+#ifndef CALIB_DEFAULT_INSTANCE
+#define CALIB_DEFAULT_INSTANCE 1   // 0: só a API por instância (sem drivers globais)
+#endif
+
+#if CALIB_PARALLEL_THREADS
+#define CALIB_WORKER_POLL_MS 1
+#endif
+
+#if CALIB_LOG_DEFERRED && CALIB_PARALLEL_THREADS
+#error "CALIB_LOG_DEFERRED requires a single producer; disable CALIB_PARALLEL_THREADS"
+#endif
 
 // ============================================================================
 // DEFINIÇÕES
@@ -28,49 +57,673 @@
 #define CALIB_EEPROM_ADDR 0x1000
 #define CALIB_EEPROM_SIZE sizeof(SensorCalibration_t)
 #define CALIB_MAGIC 0xCAFEBABE
+#define CALIB_PI 3.14159265f
+#define CALIB_EXT_EEPROM_ADDR (CALIB_EEPROM_ADDR + 0x100)
+#define CALIB_EXT_EEPROM_SIZE sizeof(SensorCalibrationExt_t)
+#define CALIB_EXT_MAGIC 0xCAFED010  // Incrementar a cada mudança de layout
+
+// Versões de layout gravadas no cabeçalho do slot (incrementar ao mudar a estrutura)
+#define CALIB_LAYOUT_VERSION 1
+#define CALIB_EXT_LAYOUT_VERSION 3
+#define CALIB_LAYOUT_ID CALIB_STORE_LAYOUT_ID(CALIB_LAYOUT_VERSION, SensorCalibration_t)
+#define CALIB_EXT_LAYOUT_ID CALIB_STORE_LAYOUT_ID(CALIB_EXT_LAYOUT_VERSION, SensorCalibrationExt_t)
+#define CALIB_BATTERY_LAYOUT_VERSION 1
+#define CALIB_BATTERY_LAYOUT_ID \
+  CALIB_STORE_LAYOUT_ID(CALIB_BATTERY_LAYOUT_VERSION, CalibrationBatteryModel_t)
+#define CALIB_THERMAL_LAYOUT_VERSION 1
+#define CALIB_THERMAL_LAYOUT_ID \
+  CALIB_STORE_LAYOUT_ID(CALIB_THERMAL_LAYOUT_VERSION, CalibrationThermal_t)
 
+#define CALIB_STATIC_ASSERT(cond, name) typedef char name[(cond) ? 1 : -1]
+
+CALIB_STATIC_ASSERT(CALIB_EEPROM_SIZE <= CALIB_STORE_MAX_PAYLOAD, calib_fits_store_slot);
+CALIB_STATIC_ASSERT(CALIB_EXT_EEPROM_SIZE <= CALIB_STORE_MAX_PAYLOAD, calib_ext_fits_store_slot);
+CALIB_STATIC_ASSERT(sizeof(CalibrationBatteryModel_t) <= CALIB_STORE_MAX_PAYLOAD,
+                    battery_model_fits_store_slot);
+CALIB_STATIC_ASSERT(sizeof(CalibrationThermal_t) <= CALIB_STORE_MAX_PAYLOAD,
+                    thermal_model_fits_store_slot);
+CALIB_STATIC_ASSERT(CALIB_TEMP_CHANNEL_IMU < CALIB_TEMP_CHANNELS &&
+                    CALIB_TEMP_CHANNEL_LIDAR < CALIB_TEMP_CHANNELS, temp_channel_roles_exist);
+CALIB_STATIC_ASSERT((CALIB_ALIGN_ENCODER_CAPACITY & (CALIB_ALIGN_ENCODER_CAPACITY - 1)) == 0 &&
+                    (CALIB_ALIGN_POSE_CAPACITY & (CALIB_ALIGN_POSE_CAPACITY - 1)) == 0,
+                    align_capacities_are_powers_of_two);
+
+// Contagens de amostras: as fases usam acumuladores de Welford, então
+// IMU_SAMPLES/LIDAR_SAMPLES podem crescer sem perda de precisão nem memória
+#ifndef IMU_SAMPLES
 #define IMU_SAMPLES 100
+#endif
 #define MAG_ROTATION_TIME_MS 30000
+#ifndef LIDAR_SAMPLES
 #define LIDAR_SAMPLES 50
+#endif
 #define ODOM_TEST_DISTANCE_MM 1000
+#define LIDAR_TARGET_DISTANCE 1.0f       // Parede/objeto de calibração (m)
+#ifndef LIDAR_TARGET_CORNER
+#define LIDAR_TARGET_CORNER 0            // 1: canto (paredes a 0 e +90°)
+#endif
+#define LIDAR_SCANS 1                    // Varreduras por calibração
+#define LIDAR_SCAN_PERIOD_MS 100         // Período nominal de varredura
+#define LIDAR_SCAN_MIN_POINTS 40         // Pontos de parede aceitos para resolver
+#define CAMERA_MIN_VIEWS 5               // Vistas antes de aceitar cobertura saturada
+#define CAMERA_SATURATION_FRAMES 90      // Quadros sem bin novo para encerrar a coleta (~3 s)
+#define CAMERA_MAX_RMS_PX 1.0f           // Erro de reprojeção máximo aceitável
+#define BATTERY_SAMPLES 10
+#define TEMP_SAMPLES 10
+
+// Intervalo mínimo entre amostras de cada fase (ms)
+#define IMU_SAMPLE_INTERVAL_MS 10
+#define MAG_SAMPLE_INTERVAL_MS 50
+#define LIDAR_SAMPLE_INTERVAL_MS 20
+#define BATTERY_SAMPLE_INTERVAL_MS 100
+#define TEMP_SAMPLE_INTERVAL_MS 100
+#define ODOM_SETTLE_TIME_MS 100
+
+// Monitoramento contínuo de desvio
+#define DRIFT_SAMPLE_INTERVAL_MS 1       // Leitura própria do IMU quando não alimentado
+#define DRIFT_CHECK_INTERVAL_MS 1000     // Avaliação da evidência acumulada
+#define DRIFT_FEED_TIMEOUT_MS 100        // Sem calibration_feed_imu() por este tempo: ler o IMU
+#define DRIFT_ACC_THRESHOLD 0.15f        // Desvio do bias do acelerômetro (m/s²)
+#define DRIFT_GYRO_THRESHOLD 0.02f       // Desvio do bias do giroscópio (rad/s)
+
+// Compensação térmica do bias do giroscópio
+#define GYRO_TEMP_INTERVAL_MS 5000       // Leitura de temperatura / atualização da tabela
+#define GYRO_LUT_SAVE_INTERVAL_MS 600000 // Persistência mínima da tabela (10 min)
+#define GYRO_DEFAULT_TEMP 25.0f          // Temperatura assumida sem sensor (°C)
+
+// Calibração contínua do odômetro
+#define ODOM_DEFAULT_WHEEL_BASE 0.30f    // Bitola padrão (m)
+#define ODOM_WHEEL_BASE_MIN 0.05f        // Faixa plausível da bitola (m)
+#define ODOM_WHEEL_BASE_MAX 2.0f
+#define ODOM_COMMIT_TOLERANCE 0.002f     // Variação relativa mínima para atualizar a calibração
+#define ODOM_SAVE_INTERVAL_MS 600000     // Persistência mínima da estimativa (10 min)
+#define ODOM_ALIGN_MAX_GAP_US 200000     // Maior intervalo entre encoders interpolados (µs)
+#define WHEELS_MOTION_HOLD_US 50000      // IMU descartado até este tempo após as rodas pararem
+
+// Palavras dos streams de odometria (calibration_align.h)
+#define ALIGN_ENCODER_CHANNELS 2         // Esquerda, direita
+#define ALIGN_ENCODER_COUNTERS 0x3
+#define ALIGN_POSE_CHANNELS 4            // x, y, θ, timestamp (ms)
+#define ALIGN_POSE_ANGLES 0x4
+#define ALIGN_POSE_HOLDS 0x8
+
+// Barreira completa do seqlock da base de tempo (compilador e CPU)
+#define TIME_BARRIER() __sync_synchronize()
+
+CALIB_STATIC_ASSERT(ALIGN_POSE_CHANNELS <= CALIB_ALIGN_CHANNELS, pose_fits_align_sample);
+
+// Estado de carga da bateria
+#define SOC_SAMPLE_INTERVAL_MS 1000      // Leitura da bateria fora das sequências
+#define SOC_SAVE_INTERVAL_MS 600000      // Persistência mínima do modelo (10 min)
+
+// Execução paralela de fases independentes
+#ifndef CALIB_PARALLEL_DEFAULT
+#define CALIB_PARALLEL_DEFAULT false
+#endif
+#if CALIB_PHASE_ARENA && CALIB_PARALLEL_DEFAULT
+#error "CALIB_PHASE_ARENA runs phases in sequence; CALIB_PARALLEL_DEFAULT must be false"
+#endif
+
+// Amostragem adaptativa: alvo de erro padrão da média e mínimo de amostras
+#ifndef CALIB_ADAPTIVE_DEFAULT
+#define CALIB_ADAPTIVE_DEFAULT false
+#endif
+#define IMU_SEM_TARGET 0.005f            // m/s²
+#define IMU_MIN_SAMPLES 20
+#define LIDAR_SEM_TARGET 0.002f          // m
+#define LIDAR_MIN_SAMPLES 10
+#define BATTERY_SEM_TARGET 0.01f         // V
+#define BATTERY_MIN_SAMPLES 3
+#define TEMP_SEM_TARGET 0.05f            // °C
+#define TEMP_MIN_SAMPLES 3
+
+#define MAG_COVERAGE_SATURATION_SAMPLES 100  // Amostras sem bin novo para saturar
+
+// Ajuste de elipsoide do magnetômetro
+#define MAG_FIT_MIN_SAMPLES 100          // Amostras antes do primeiro ajuste
+#define MAG_FIT_CHECK_SAMPLES 20         // Resolver a cada N amostras
+#define MAG_FIT_MAX_CONDITION 1000.0f    // Condição máxima aceitável
+#define MAG_FIT_COND_TOLERANCE 0.10f     // Variação relativa da condição entre ajustes
+#define MAG_FIT_CENTER_TOLERANCE 0.005f  // Deslocamento do centro / intensidade do campo
+#define MAG_FIT_STABLE_CHECKS 3          // Ajustes estáveis consecutivos para parar
+
+// Tempo máximo de cada fase, medido a partir do início da fase (ms):
+// o dobro do tempo nominal de amostragem mais uma margem fixa
+#define PHASE_TIMEOUT_MS(samples, interval_ms) ((samples) * (interval_ms) * 2 + 1000)
+#define IMU_PHASE_TIMEOUT_MS PHASE_TIMEOUT_MS(IMU_SAMPLES, IMU_SAMPLE_INTERVAL_MS)
+#define MAG_PHASE_TIMEOUT_MS (MAG_ROTATION_TIME_MS + 5000)
+#define ODOM_PHASE_TIMEOUT_MS 30000
+#define CAMERA_PHASE_TIMEOUT_MS 60000   // Inclui o operador movendo o tabuleiro
+#if CALIB_LIDAR_SCAN
+#define LIDAR_PHASE_TIMEOUT_MS PHASE_TIMEOUT_MS(LIDAR_SCANS, LIDAR_SCAN_PERIOD_MS)
+#else
+#define LIDAR_PHASE_TIMEOUT_MS PHASE_TIMEOUT_MS(LIDAR_SAMPLES, LIDAR_SAMPLE_INTERVAL_MS)
+#endif
+#define BATTERY_PHASE_TIMEOUT_MS PHASE_TIMEOUT_MS(BATTERY_SAMPLES, BATTERY_SAMPLE_INTERVAL_MS)
+#define TEMP_PHASE_TIMEOUT_MS PHASE_TIMEOUT_MS(TEMP_SAMPLES, TEMP_SAMPLE_INTERVAL_MS)
+
+// ============================================================================
+// INSTÂNCIA PADRÃO
+// ============================================================================
+//
+// A API global opera sobre default_context, cujos drivers repassam às
+// funções auxiliares de sensor_calibration.h.
+
+#if CALIB_DEFAULT_INSTANCE
+
+static bool default_read_imu_raw(void *user, IMUData_t *imu_data) {
+  (void)user;
+  return read_imu_raw(imu_data);
+}
+
+static bool default_read_magnetometer_raw(void *user, MagData_t *mag_data) {
+  (void)user;
+  return read_magnetometer_raw(mag_data);
+}
+
+#if CALIB_SENSOR_FIFO
+static bool default_read_imu_fifo(void *user, IMUData_t *buf, size_t max, size_t *got) {
+  (void)user;
+  return read_imu_fifo(buf, max, got);
+}
+
+static bool default_read_magnetometer_fifo(void *user, MagData_t *buf, size_t max, size_t *got) {
+  (void)user;
+  return read_magnetometer_fifo(buf, max, got);
+}
+#endif
+
+static bool default_read_battery_data(void *user, BatteryData_t *battery_data) {
+  (void)user;
+  return read_battery_data(battery_data);
+}
+
+static bool default_read_temperature_data(void *user, TemperatureData_t *temp_data) {
+  (void)user;
+  return read_temperature_data(temp_data);
+}
+
+#if CALIB_LIDAR_SCAN
+static bool default_read_lidar_scan(void *user, const LiDARData_t **points, size_t *count) {
+  (void)user;
+  return read_lidar_scan(points, count);
+}
+#else
+static float default_read_lidar_distance(void *user) {
+  (void)user;
+  return read_lidar_distance();
+}
+#endif
+
+static bool default_read_camera_frame(void *user, CameraFrame_t *frame) {
+  (void)user;
+  return read_camera_frame(frame);
+}
+
+static void default_release_camera_frame(void *user, const CameraFrame_t *frame) {
+  (void)user;
+  release_camera_frame(frame);
+}
+
+static bool default_move_forward_distance(void *user, uint32_t distance_mm) {
+  (void)user;
+  return move_forward_distance(distance_mm);
+}
+
+static void default_reset_encoder_counters(void *user) {
+  (void)user;
+  reset_encoder_counters();
+}
+
+static uint32_t default_get_left_encoder_count(void *user) {
+  (void)user;
+  return get_left_encoder_count();
+}
+
+static uint32_t default_get_right_encoder_count(void *user) {
+  (void)user;
+  return get_right_encoder_count();
+}
+
+static uint32_t default_get_time_ms(void *user) {
+  (void)user;
+  return get_time_ms();
+}
+
+#if CALIB_TIME_US
+static uint64_t default_get_time_us(void *user) {
+  (void)user;
+  return get_time_us();
+}
+#endif
+
+static void default_delay_ms(void *user, uint32_t ms) {
+  (void)user;
+  delay_ms(ms);
+}
+
+/**
+ * @brief Ler a EEPROM (mapeamento direto quando CALIB_EEPROM_MAPPED_BASE
+ * estiver definido, ex.: EEPROM emulada em flash)
+ */
+static void default_eeprom_read(void *user, uint32_t addr, uint8_t *data, size_t len) {
+  (void)user;
+#ifdef CALIB_EEPROM_MAPPED_BASE
+  memcpy(data, (const uint8_t *)(CALIB_EEPROM_MAPPED_BASE) + addr, len);
+#else
+  eeprom_read(addr, data, len);
+#endif
+}
+
+static void default_eeprom_write(void *user, uint32_t addr, const uint8_t *data, size_t len) {
+  (void)user;
+  eeprom_write(addr, data, len);
+}
+
+// Inicializada estaticamente: set_calibration_*() valem antes de calibration_init()
+static CalibrationContext_t default_context = {
+  .drivers = {
+    .user = NULL,
+    .read_imu_raw = default_read_imu_raw,
+    .read_magnetometer_raw = default_read_magnetometer_raw,
+#if CALIB_SENSOR_FIFO
+    .read_imu_fifo = default_read_imu_fifo,
+    .read_magnetometer_fifo = default_read_magnetometer_fifo,
+#endif
+    .read_battery_data = default_read_battery_data,
+    .read_temperature_data = default_read_temperature_data,
+#if CALIB_LIDAR_SCAN
+    .read_lidar_scan = default_read_lidar_scan,
+#else
+    .read_lidar_distance = default_read_lidar_distance,
+#endif
+    .read_camera_frame = default_read_camera_frame,
+    .release_camera_frame = default_release_camera_frame,
+    .move_forward_distance = default_move_forward_distance,
+    .reset_encoder_counters = default_reset_encoder_counters,
+    .get_left_encoder_count = default_get_left_encoder_count,
+    .get_right_encoder_count = default_get_right_encoder_count,
+    .get_time_ms = default_get_time_ms,
+#if CALIB_TIME_US
+    .get_time_us = default_get_time_us,
+#endif
+    .delay_ms = default_delay_ms,
+    .eeprom_read = default_eeprom_read,
+    .eeprom_write = default_eeprom_write,
+  },
+  .store = { .read = default_eeprom_read, .write = default_eeprom_write },
+  .calib_state = CALIB_IDLE,
+  .adaptive_sampling = CALIB_ADAPTIVE_DEFAULT,
+  .parallel_calibration = CALIB_PARALLEL_DEFAULT,
+  .calibration_mask = CALIB_SENSOR_MASK_SKU,
+  .ambient_temperature = CALIB_TEMP_AMBIENT,
+  // Mesmo estado de align_rings_init()
+  .encoder_ring = {
+    .samples = default_context.encoder_samples,
+    .mask = CALIB_ALIGN_ENCODER_CAPACITY - 1,
+    .channels = ALIGN_ENCODER_CHANNELS,
+    .counter_mask = ALIGN_ENCODER_COUNTERS,
+  },
+  .pose_ring = {
+    .samples = default_context.pose_samples,
+    .mask = CALIB_ALIGN_POSE_CAPACITY - 1,
+    .channels = ALIGN_POSE_CHANNELS,
+    .angle_mask = ALIGN_POSE_ANGLES,
+    .hold_mask = ALIGN_POSE_HOLDS,
+  },
+};
+
+#endif // CALIB_DEFAULT_INSTANCE
+
+// Persistência interna (definidas em PERSISTÊNCIA)
+static bool read_calibration_record(CalibrationContext_t *ctx, SensorCalibration_t *calib,
+                                    uint8_t *flags);
+static void write_calibration_record(CalibrationContext_t *ctx, const SensorCalibration_t *calib,
+                                     bool validated);
 
 // ============================================================================
-// VARIÁVEIS GLOBAIS
+// UTILITÁRIOS INTERNOS
 // ============================================================================
 
-static SensorCalibration_t calib;
-static CalibrationState_t calib_state = CALIB_IDLE;
-static bool calibration_requested = false;
-static uint32_t calib_start_time = 0;
+/**
+ * @brief Tempo atual pelo driver da instância
+ */
+static uint32_t time_ms(const CalibrationContext_t *ctx) {
+  return ctx->drivers.get_time_ms(ctx->drivers.user);
+}
+
+/**
+ * @brief Verificar se um instante já foi atingido (seguro contra wraparound)
+ */
+static bool time_reached(uint32_t now, uint32_t target) {
+  return (int32_t)(now - target) >= 0;
+}
+
+/**
+ * @brief Contar uma leitura de driver com falha
+ */
+static void count_read_failure(CalibrationContext_t *ctx, CalibrationSensor_t sensor) {
+#if CALIB_PARALLEL_THREADS
+  // Workers de fases diferentes contam ao mesmo tempo (ex.: temperatura)
+  __sync_fetch_and_add(&ctx->metrics.read_failures[sensor], 1u);
+#else
+  ctx->metrics.read_failures[sensor]++;
+#endif
+}
+
+#if CALIB_WITH_IMU || CALIB_WITH_MAG
+/**
+ * @brief Reiniciar o controle de leitura de uma FIFO (lê no próximo tick)
+ */
+static void fifo_reset(CalibrationFifoPoll_t *fifo, uint32_t now) {
+  fifo->seen = fifo->notified;
+  fifo->next_poll = now;
+}
+#endif
+
+/**
+ * @brief Verificar se a FIFO deve ser lida neste tick
+ *
+ * Lê quando a ISR de watermark/DMA sinalizou dados novos ou, sem
+ * sinalização, a cada CALIB_FIFO_POLL_MS.
+ */
+static bool fifo_due(const CalibrationFifoPoll_t *fifo, uint32_t now) {
+  return fifo->notified != fifo->seen || time_reached(now, fifo->next_poll);
+}
+
+/**
+ * @brief Registrar uma leitura; rajada cheia relê no próximo tick
+ */
+static void fifo_mark_read(CalibrationFifoPoll_t *fifo, uint32_t now, size_t got) {
+  fifo->seen = fifo->notified;
+  fifo->next_poll = (got >= CALIB_FIFO_BURST) ? now : now + CALIB_FIFO_POLL_MS;
+}
+
+/**
+ * @brief Gravar um registro medindo bytes e duração
+ */
+static size_t store_save_measured(CalibrationContext_t *ctx, CalibrationRecordId_t id,
+                                  const void *data, size_t size,
+                                  uint32_t layout_id, uint8_t flags) {
+  uint32_t start = calibration_metrics_cycles();
+  size_t written = calibration_store_save(&ctx->store, id, data, size, layout_id, flags);
+  
+  calibration_metrics_record(&ctx->metrics.eeprom_write, calibration_metrics_cycles() - start);
+  ctx->metrics.eeprom_writes++;
+  ctx->metrics.eeprom_bytes_written += (uint32_t)written;
+  return written;
+}
+
+/**
+ * @brief Executar uma fase incremental até o fim (modo bloqueante)
+ */
+static bool run_phase_blocking(CalibrationContext_t *ctx,
+                               void (*begin)(CalibrationContext_t *),
+                               CalibrationStepResult_t (*step)(CalibrationContext_t *)) {
+  CalibrationStepResult_t result;
+  
+  begin(ctx);
+  while ((result = step(ctx)) == CALIB_STEP_PENDING) {
+    ctx->drivers.delay_ms(ctx->drivers.user, 1);
+  }
+  
+  return result == CALIB_STEP_DONE;
+}
+
+/**
+ * @brief Relação entre a média medida por uma fase e um campo calibrado
+ *
+ * campo = reference + sign * média (ex.: offset do LiDAR = 1.0 - média).
+ */
+typedef struct {
+  size_t field;      ///< offsetof(SensorCalibration_t, campo)
+  float reference;
+  float sign;        ///< +1 ou -1
+} PhasePriorMap_t;
+
+/**
+ * @brief Prior do campo levado ao domínio da medição
+ * @return false sem prior para o campo
+ */
+static bool phase_prior(const CalibrationContext_t *ctx, const PhasePriorMap_t *map,
+                        float *mean, float *sigma) {
+  float median;
+
+  if (!calibration_prior_lookup(&ctx->prior, map->field, &median, sigma)) {
+    return false;
+  }
+  *mean = map->sign * (median - map->reference);
+  return true;
+}
+
+/**
+ * @brief Verificar se uma grandeza já atingiu o erro padrão alvo
+ *
+ * Com prior de frota compatível, vale o erro combinado (partida a quente)
+ * a partir de CALIB_PRIOR_MIN_SAMPLES amostras.
+ * @return false se a amostragem adaptativa estiver desativada
+ */
+static bool stats_converged(CalibrationContext_t *ctx, const CalibrationStats_t *stats,
+                            uint32_t min_samples, float sem_target, const PhasePriorMap_t *map) {
+  float prior_mean, prior_sigma, estimate, sigma;
+  float sem = calibration_stats_std_error(stats);
+
+  if (!ctx->adaptive_sampling) {
+    return false;
+  }
+  if (stats->count >= CALIB_PRIOR_MIN_SAMPLES && phase_prior(ctx, map, &prior_mean, &prior_sigma) &&
+      calibration_prior_fuse(prior_mean, prior_sigma, calibration_stats_mean(stats), sem,
+                             &estimate, &sigma)) {
+    return sigma <= sem_target;
+  }
+  return stats->count >= min_samples && sem <= sem_target;
+}
+
+/**
+ * @brief Média da fase combinada com o prior, já como valor do campo
+ */
+static float stats_estimate(const CalibrationContext_t *ctx, const CalibrationStats_t *stats,
+                            const PhasePriorMap_t *map) {
+  float prior_mean, prior_sigma, sigma;
+  float estimate = calibration_stats_mean(stats);
+
+  if (phase_prior(ctx, map, &prior_mean, &prior_sigma) &&
+      !calibration_prior_fuse(prior_mean, prior_sigma, calibration_stats_mean(stats),
+                              calibration_stats_std_error(stats), &estimate, &sigma)) {
+    log_warning("Fleet prior ignored: measured %.3f, fleet %.3f +/- %.3f",
+                calibration_stats_mean(stats), prior_mean, prior_sigma);
+  }
+  return map->reference + map->sign * estimate;
+}
+
+/**
+ * @brief Reiniciar o estimador de bias com a calibração atual como referência
+ */
+static void bias_estimator_rebase(CalibrationContext_t *ctx) {
+  const float acc_ref[3] = {
+    ctx->calib.imu_bias_x, ctx->calib.imu_bias_y, ctx->calib.imu_bias_z
+  };
+  
+  calibration_bias_set_reference(&ctx->bias_estimator, acc_ref, ctx->calib_ext.gyro_bias);
+}
+
+/**
+ * @brief Recentrar o calibrador de odometria na calibração atual
+ */
+static void odom_estimator_rebase(CalibrationContext_t *ctx) {
+  calibration_odom_reset(&ctx->odom_estimator, ctx->calib.pulses_per_meter_left,
+                         ctx->calib.pulses_per_meter_right, ctx->calib_ext.wheel_base);
+}
+
+/**
+ * @brief Publicar o kernel da instância padrão para apply_*_batch()
+ */
+static void kernel_publish(const CalibrationContext_t *ctx) {
+#if CALIB_DEFAULT_INSTANCE
+  if (ctx == &default_context) {
+    calibration_apply_set_kernel(&ctx->kernel);
+  }
+#else
+  (void)ctx;
+#endif
+}
+
+/**
+ * @brief Recalcular o kernel da instância após mudança da calibração
+ */
+static void kernel_refresh(CalibrationContext_t *ctx) {
+  calibration_apply_prepare(&ctx->kernel, &ctx->calib);
+  calibration_apply_prepare_ext(&ctx->kernel, &ctx->calib_ext);
+  calibration_apply_prepare_thermal(&ctx->kernel, &ctx->thermal);
+  kernel_publish(ctx);
+}
+
+/**
+ * @brief Confirmar a calibração de trabalho para os leitores
+ *
+ * ctx->calib/calib_ext são a cópia de trabalho das fases; leitores de
+ * outras threads só veem o que passa por aqui, de uma vez.
+ */
+static void calibration_commit(CalibrationContext_t *ctx) {
+  kernel_refresh(ctx);
+  calibration_snapshot_publish(&ctx->published, &ctx->calib, &ctx->calib_ext);
+}
+
+/**
+ * @brief Ler a temperatura e corrigir cada canal pelo kernel da instância
+ *
+ * As fases leem em buffers próprios: com CALIB_PARALLEL_THREADS o IMU e
+ * a temperatura leem o sensor ao mesmo tempo.
+ * @param raw Leitura do driver
+ * @param calibrated Leitura corrigida por canal
+ */
+static bool temperature_sample(CalibrationContext_t *ctx, TemperatureData_t *raw,
+                               TemperatureData_t *calibrated) {
+  if (!ctx->drivers.read_temperature_data(ctx->drivers.user, raw)) {
+    count_read_failure(ctx, CALIB_SENSOR_TEMP);
+    return false;
+  }
+  
+  calibration_apply_block(&ctx->kernel.temp, raw, calibrated, 1);
+  return true;
+}
+
+/**
+ * @brief Atualizar a última leitura de temperatura (thread de calibration_update())
+ */
+static bool temperature_read(CalibrationContext_t *ctx) {
+  if (!temperature_sample(ctx, &ctx->temp_data, &ctx->temp_calibrated)) {
+    return false;
+  }
+  
+  ctx->temp_valid = true;
+  return true;
+}
+
+/**
+ * @brief Gravar o modelo térmico
+ */
+static void thermal_save(CalibrationContext_t *ctx) {
+  store_save_measured(ctx, CALIB_RECORD_THERMAL, &ctx->thermal, sizeof(ctx->thermal),
+                      CALIB_THERMAL_LAYOUT_ID, 0);
+}
 
-// Estruturas de dados dos sensores
-static IMUData_t imu_data;
-static MagData_t mag_data;
-static EncoderData_t encoder_data;
-static LiDARData_t lidar_data;
-static BatteryData_t battery_data;
-static TemperatureData_t temp_data;
+/**
+ * @brief Preparar os streams de encoders e pose, vazios
+ */
+static void align_rings_init(CalibrationContext_t *ctx) {
+  calibration_align_init(&ctx->encoder_ring, ctx->encoder_samples, CALIB_ALIGN_ENCODER_CAPACITY,
+                         ALIGN_ENCODER_CHANNELS, 0, ALIGN_ENCODER_COUNTERS, 0);
+  calibration_align_init(&ctx->pose_ring, ctx->pose_samples, CALIB_ALIGN_POSE_CAPACITY,
+                         ALIGN_POSE_CHANNELS, ALIGN_POSE_ANGLES, 0, ALIGN_POSE_HOLDS);
+}
 
 // ============================================================================
 // INICIALIZAÇÃO
 // ============================================================================
 
+/**
+ * @brief Preparar uma instância
+ */
+void calibration_context_init(CalibrationContext_t *ctx, const CalibrationDrivers_t *drivers) {
+  memset(ctx, 0, sizeof(*ctx));
+  ctx->drivers = *drivers;
+  calibration_store_init(&ctx->store, drivers->eeprom_read, drivers->eeprom_write,
+                         drivers->user);
+  ctx->calib_state = CALIB_IDLE;
+  ctx->adaptive_sampling = CALIB_ADAPTIVE_DEFAULT;
+  ctx->parallel_calibration = CALIB_PARALLEL_DEFAULT;
+  ctx->calibration_mask = CALIB_SENSOR_MASK_SKU;
+  calibration_metrics_init(&ctx->metrics);
+  init_default_calibration(&ctx->calib);
+  init_default_calibration_ext(&ctx->calib_ext);
+  thermal_model_default(&ctx->thermal);
+  ctx->ambient_temperature = CALIB_TEMP_AMBIENT;
+  calibration_apply_prepare(&ctx->kernel, &ctx->calib);
+  calibration_apply_prepare_ext(&ctx->kernel, &ctx->calib_ext);
+  calibration_apply_prepare_thermal(&ctx->kernel, &ctx->thermal);
+  calibration_snapshot_init(&ctx->published, &ctx->calib, &ctx->calib_ext);
+  align_rings_init(ctx);
+#if CALIB_WITH_BATTERY
+  calibration_battery_model_default(&ctx->battery_model);
+  calibration_soc_reset(&ctx->soc);
+#endif
+}
+
 /**
  * @brief Inicializar sistema de calibração
  */
-void calibration_init(void) {
-  log_info("Initializing sensor calibration system");
+void calibration_init_ctx(CalibrationContext_t *ctx) {
+  uint8_t flags;
   
-  // Carregar calibração da EEPROM
-  load_calibration_from_eeprom(&calib);
+  calibration_metrics_init(&ctx->metrics);
   
-  // Se inválida, usar valores padrão
-  if (calib.status != CALIB_VALID) {
+  // Caminho rápido: uma leitura + CRC; registros já validados não são revalidados
+  if (!read_calibration_record(ctx, &ctx->calib, &flags)) {
     log_warning("Calibration data invalid, using defaults");
-    init_default_calibration(&calib);
+    init_default_calibration(&ctx->calib);
+  } else if (!(flags & CALIB_STORE_FLAG_VALIDATED)) {
+    // Registro legado ou gravado sem validação: validar uma vez e registrar
+    if (validate_calibration_ctx(ctx, &ctx->calib)) {
+      write_calibration_record(ctx, &ctx->calib, true);
+    } else {
+      log_warning("Stored calibration failed validation, using defaults");
+      init_default_calibration(&ctx->calib);
+    }
+  }
+  
+  load_calibration_ext_from_eeprom_ctx(ctx, &ctx->calib_ext);
+  
+  // Extensões ausentes: herdar metadados por sensor da calibração legada
+  if (ctx->calib_ext.sensor_meta[CALIB_SENSOR_IMU].status == CALIB_INVALID &&
+      ctx->calib.status == CALIB_VALID) {
+    for (int i = 0; i < CALIB_SENSOR_COUNT; i++) {
+      ctx->calib_ext.sensor_meta[i].timestamp = ctx->calib.timestamp;
+      ctx->calib_ext.sensor_meta[i].calibration_count = ctx->calib.calibration_count;
+      ctx->calib_ext.sensor_meta[i].status = CALIB_VALID;
+    }
+  }
+  
+  if (!calibration_store_load(&ctx->store, CALIB_RECORD_THERMAL, &ctx->thermal,
+                              sizeof(ctx->thermal), CALIB_THERMAL_LAYOUT_ID, NULL) ||
+      !thermal_model_valid(&ctx->thermal)) {
+    thermal_model_default(&ctx->thermal);
+  }
+  
+  calibration_commit(ctx);
+  bias_estimator_rebase(ctx);
+  odom_estimator_rebase(ctx);
+  
+#if CALIB_WITH_BATTERY
+  if (!calibration_store_load(&ctx->store, CALIB_RECORD_BATTERY, &ctx->battery_model,
+                              sizeof(ctx->battery_model), CALIB_BATTERY_LAYOUT_ID, NULL) ||
+      !calibration_battery_model_valid(&ctx->battery_model)) {
+    calibration_battery_model_default(&ctx->battery_model);
   }
+  calibration_soc_reset(&ctx->soc);
+#endif
   
-  calib_state = CALIB_IDLE;
+  ctx->calib_state = CALIB_IDLE;
   log_info("Calibration system ready");
 }
 
@@ -129,243 +782,710 @@ void init_default_calibration(SensorCalibration_t *calib) {
   log_info("Default calibration initialized");
 }
 
+/**
+ * @brief Inicializar extensões com valores padrão
+ */
+void init_default_calibration_ext(SensorCalibrationExt_t *ext) {
+  memset(ext, 0, sizeof(SensorCalibrationExt_t));
+  
+  ext->magic = CALIB_EXT_MAGIC;
+  
+  // Magnetômetro: identidade
+  ext->mag_soft_iron[0][0] = 1.0f;
+  ext->mag_soft_iron[1][1] = 1.0f;
+  ext->mag_soft_iron[2][2] = 1.0f;
+  ext->mag_field_strength = 0.0f;
+  ext->mag_fit_condition = 0.0f;
+  ext->mag_model = MAG_MODEL_MINMAX;
+  
+  // Giroscópio: sem bias, tabela vazia
+  ext->gyro_bias_temp = GYRO_DEFAULT_TEMP;
+  gyro_temp_lut_reset(ext->gyro_temp_lut);
+  
+  // Odômetro
+  ext->wheel_base = ODOM_DEFAULT_WHEEL_BASE;
+}
+
 // ============================================================================
 // CALIBRAÇÃO IMU
 // ============================================================================
 
+#if CALIB_WITH_IMU
+
+// Bias = média do acelerômetro; em z, descontada a gravidade
+static const PhasePriorMap_t imu_prior_map[3] = {
+  { offsetof(SensorCalibration_t, imu_bias_x), 0.0f, 1.0f },
+  { offsetof(SensorCalibration_t, imu_bias_y), 0.0f, 1.0f },
+  { offsetof(SensorCalibration_t, imu_bias_z), -9.81f, 1.0f },
+};
+
 /**
- * @brief Calibrar IMU (Acelerômetro + Giroscópio)
- * Robô deve estar imóvel em superfície plana
+ * @brief Acumular uma amostra na fase do IMU
  */
-bool calibrate_imu(void) {
+static void imu_phase_push(CalibrationContext_t *ctx, const IMUData_t *sample) {
+  calibration_stats_push(&ctx->phase.imu.acc_x, sample->ax);
+  calibration_stats_push(&ctx->phase.imu.acc_y, sample->ay);
+  calibration_stats_push(&ctx->phase.imu.acc_z, sample->az);
+  
+  calibration_stats_push(&ctx->phase.imu.gyro_x, sample->gx);
+  calibration_stats_push(&ctx->phase.imu.gyro_y, sample->gy);
+  calibration_stats_push(&ctx->phase.imu.gyro_z, sample->gz);
+}
+
+/**
+ * @brief Iniciar fase de calibração do IMU
+ */
+void calibrate_imu_begin_ctx(CalibrationContext_t *ctx) {
   log_info("Starting IMU calibration");
   
-  float acc_x_sum = 0.0f, acc_y_sum = 0.0f, acc_z_sum = 0.0f;
-  float gyro_x_sum = 0.0f, gyro_y_sum = 0.0f, gyro_z_sum = 0.0f;
-  float acc_x_sq_sum = 0.0f, acc_y_sq_sum = 0.0f, acc_z_sq_sum = 0.0f;
+  ctx->phase.imu.start_time = time_ms(ctx);
+  ctx->phase.imu.next_sample_time = ctx->phase.imu.start_time;
+  fifo_reset(&ctx->imu_fifo, ctx->phase.imu.start_time);
+  calibration_stats_reset(&ctx->phase.imu.acc_x);
+  calibration_stats_reset(&ctx->phase.imu.acc_y);
+  calibration_stats_reset(&ctx->phase.imu.acc_z);
+  calibration_stats_reset(&ctx->phase.imu.gyro_x);
+  calibration_stats_reset(&ctx->phase.imu.gyro_y);
+  calibration_stats_reset(&ctx->phase.imu.gyro_z);
+}
+
+/**
+ * @brief Executar um passo da calibração do IMU
+ * Robô deve estar imóvel em superfície plana
+ */
+CalibrationStepResult_t calibrate_imu_step_ctx(CalibrationContext_t *ctx) {
+  uint32_t now = time_ms(ctx);
   
-  // Coletar amostras
-  for (int i = 0; i < IMU_SAMPLES; i++) {
-    if (!read_imu_raw(&imu_data)) {
-      log_error("Failed to read IMU");
-      return false;
-    }
+  if (ctx->drivers.read_imu_fifo != NULL) {
+    // Rajada: uma transação por tick com dados novos
+    size_t got;
     
-    acc_x_sum += imu_data.ax;
-    acc_y_sum += imu_data.ay;
-    acc_z_sum += imu_data.az;
-    
-    acc_x_sq_sum += imu_data.ax * imu_data.ax;
-    acc_y_sq_sum += imu_data.ay * imu_data.ay;
-    acc_z_sq_sum += imu_data.az * imu_data.az;
+    if (!fifo_due(&ctx->imu_fifo, now)) {
+      return CALIB_STEP_PENDING;
+    }
+    if (!ctx->drivers.read_imu_fifo(ctx->drivers.user, ctx->burst.imu, CALIB_FIFO_BURST, &got)) {
+      count_read_failure(ctx, CALIB_SENSOR_IMU);
+      log_error("Failed to read IMU FIFO");
+      return CALIB_STEP_FAILED;
+    }
+    fifo_mark_read(&ctx->imu_fifo, now, got);
     
-    gyro_x_sum += imu_data.gx;
-    gyro_y_sum += imu_data.gy;
-    gyro_z_sum += imu_data.gz;
+    for (size_t i = 0; i < got; i++) {
+      // Amostras anteriores ao início da fase (FIFO com dados antigos)
+      if (time_reached(ctx->burst.imu[i].timestamp, ctx->phase.imu.start_time)) {
+        imu_phase_push(ctx, &ctx->burst.imu[i]);
+      }
+    }
+    if (ctx->phase.imu.acc_x.count == 0) {
+      return CALIB_STEP_PENDING;
+    }
+  } else {
+    if (!time_reached(now, ctx->phase.imu.next_sample_time)) {
+      return CALIB_STEP_PENDING;
+    }
+    ctx->phase.imu.next_sample_time = now + IMU_SAMPLE_INTERVAL_MS;
     
-    delay_ms(10);
+    // Coletar uma amostra
+    if (!ctx->drivers.read_imu_raw(ctx->drivers.user, &ctx->imu_data)) {
+      count_read_failure(ctx, CALIB_SENSOR_IMU);
+      log_error("Failed to read IMU");
+      return CALIB_STEP_FAILED;
+    }
+    imu_phase_push(ctx, &ctx->imu_data);
   }
   
-  // Calcular média (bias)
-  float acc_x_mean = acc_x_sum / IMU_SAMPLES;
-  float acc_y_mean = acc_y_sum / IMU_SAMPLES;
-  float acc_z_mean = acc_z_sum / IMU_SAMPLES;
+  bool converged =
+    stats_converged(ctx, &ctx->phase.imu.acc_x, IMU_MIN_SAMPLES, IMU_SEM_TARGET, &imu_prior_map[0]) &&
+    stats_converged(ctx, &ctx->phase.imu.acc_y, IMU_MIN_SAMPLES, IMU_SEM_TARGET, &imu_prior_map[1]) &&
+    stats_converged(ctx, &ctx->phase.imu.acc_z, IMU_MIN_SAMPLES, IMU_SEM_TARGET, &imu_prior_map[2]);
   
-  calib.imu_bias_x = acc_x_mean;
-  calib.imu_bias_y = acc_y_mean;
-  calib.imu_bias_z = acc_z_mean - 9.81f; // Remover gravidade
+  if (ctx->phase.imu.acc_x.count < IMU_SAMPLES && !converged) {
+    return CALIB_STEP_PENDING;
+  }
   
-  // Calcular desvio padrão (para validação)
-  float acc_x_var = (acc_x_sq_sum / IMU_SAMPLES) - (acc_x_mean * acc_x_mean);
-  float acc_y_var = (acc_y_sq_sum / IMU_SAMPLES) - (acc_y_mean * acc_y_mean);
-  float acc_z_var = (acc_z_sq_sum / IMU_SAMPLES) - (acc_z_mean * acc_z_mean);
+  // Média (bias), combinada com o prior de frota
+  ctx->calib.imu_bias_x = stats_estimate(ctx, &ctx->phase.imu.acc_x, &imu_prior_map[0]);
+  ctx->calib.imu_bias_y = stats_estimate(ctx, &ctx->phase.imu.acc_y, &imu_prior_map[1]);
+  ctx->calib.imu_bias_z = stats_estimate(ctx, &ctx->phase.imu.acc_z, &imu_prior_map[2]);
   
-  float acc_x_std = sqrtf(acc_x_var);
-  float acc_y_std = sqrtf(acc_y_var);
-  float acc_z_std = sqrtf(acc_z_var);
+  // Desvio padrão (para validação)
+  float acc_x_std = calibration_stats_stddev(&ctx->phase.imu.acc_x);
+  float acc_y_std = calibration_stats_stddev(&ctx->phase.imu.acc_y);
+  float acc_z_std = calibration_stats_stddev(&ctx->phase.imu.acc_z);
   
   log_info("IMU Calibration:");
   log_info("  Accel Bias: (%.3f, %.3f, %.3f) m/s²", 
-           calib.imu_bias_x, calib.imu_bias_y, calib.imu_bias_z);
+           ctx->calib.imu_bias_x, ctx->calib.imu_bias_y, ctx->calib.imu_bias_z);
   log_info("  Accel Std Dev: (%.3f, %.3f, %.3f) m/s²", 
            acc_x_std, acc_y_std, acc_z_std);
+  log_info("  Samples: %lu", (unsigned long)ctx->phase.imu.acc_x.count);
   
   // Validar (desvio padrão deve ser pequeno)
   if (acc_x_std > 0.5f || acc_y_std > 0.5f || acc_z_std > 0.5f) {
     log_error("IMU noise too high, calibration may be invalid");
-    return false;
+    return CALIB_STEP_FAILED;
+  }
+  
+  // Bias do giroscópio (robô imóvel: a média é o próprio bias)
+  ctx->calib_ext.gyro_bias[0] = calibration_stats_mean(&ctx->phase.imu.gyro_x);
+  ctx->calib_ext.gyro_bias[1] = calibration_stats_mean(&ctx->phase.imu.gyro_y);
+  ctx->calib_ext.gyro_bias[2] = calibration_stats_mean(&ctx->phase.imu.gyro_z);
+  
+  TemperatureData_t temp_raw, temp_calibrated;
+  if (temperature_sample(ctx, &temp_raw, &temp_calibrated)) {
+    ctx->calib_ext.gyro_bias_temp = thermal_channel(&temp_calibrated, CALIB_TEMP_CHANNEL_IMU);
+    gyro_temp_lut_update(ctx->calib_ext.gyro_temp_lut, ctx->calib_ext.gyro_bias_temp,
+                         ctx->calib_ext.gyro_bias);
   }
   
+  log_info("  Gyro Bias: (%.4f, %.4f, %.4f) rad/s @ %.1f °C",
+           ctx->calib_ext.gyro_bias[0], ctx->calib_ext.gyro_bias[1], ctx->calib_ext.gyro_bias[2],
+           ctx->calib_ext.gyro_bias_temp);
+  
   // Escala (assumir 1.0 por enquanto)
-  calib.imu_scale_x = 1.0f;
-  calib.imu_scale_y = 1.0f;
-  calib.imu_scale_z = 1.0f;
+  ctx->calib.imu_scale_x = 1.0f;
+  ctx->calib.imu_scale_y = 1.0f;
+  ctx->calib.imu_scale_z = 1.0f;
   
   log_info("IMU calibration complete");
-  return true;
+  return CALIB_STEP_DONE;
+}
+
+/**
+ * @brief Calibrar IMU (Acelerômetro + Giroscópio)
+ * Robô deve estar imóvel em superfície plana
+ */
+bool calibrate_imu_ctx(CalibrationContext_t *ctx) {
+  return run_phase_blocking(ctx, calibrate_imu_begin_ctx, calibrate_imu_step_ctx);
 }
 
+#endif // CALIB_WITH_IMU
+
 // ============================================================================
 // CALIBRAÇÃO MAGNETÔMETRO
 // ============================================================================
 
+#if CALIB_WITH_MAG
+
 /**
- * @brief Calibrar Magnetômetro (Bússola)
- * Robô deve rotacionar 360° lentamente
+ * @brief Verificar se o ajuste atual é estável em relação ao anterior
  */
-bool calibrate_magnetometer(void) {
-  log_info("Starting Magnetometer calibration");
-  log_info("Please rotate robot 360 degrees slowly (30 seconds)");
+static bool mag_fit_is_stable(const EllipsoidSolution_t *prev,
+                              const EllipsoidSolution_t *cur) {
+  float cond_change = fabsf(cur->condition - prev->condition) / prev->condition;
+  float dx = cur->hard_iron[0] - prev->hard_iron[0];
+  float dy = cur->hard_iron[1] - prev->hard_iron[1];
+  float dz = cur->hard_iron[2] - prev->hard_iron[2];
+  float center_change = sqrtf(dx * dx + dy * dy + dz * dz) / cur->field_strength;
+  
+  return cur->condition < MAG_FIT_MAX_CONDITION &&
+         cond_change < MAG_FIT_COND_TOLERANCE &&
+         center_change < MAG_FIT_CENTER_TOLERANCE;
+}
+
+/**
+ * @brief Resolver o ajuste periodicamente e detectar convergência
+ * @return true se o ajuste convergiu e a coleta pode terminar
+ */
+static bool mag_fit_check_convergence(CalibrationContext_t *ctx) {
+  EllipsoidSolution_t solution;
   
-  float mag_x_min = 32767.0f, mag_x_max = -32768.0f;
-  float mag_y_min = 32767.0f, mag_y_max = -32768.0f;
-  float mag_z_min = 32767.0f, mag_z_max = -32768.0f;
+  if (ctx->phase.mag.fit.count < MAG_FIT_MIN_SAMPLES ||
+      (ctx->phase.mag.fit.count % MAG_FIT_CHECK_SAMPLES) != 0) {
+    return false;
+  }
   
-  uint32_t start_time = get_time_ms();
-  int sample_count = 0;
+  if (!ellipsoid_fit_solve(&ctx->phase.mag.fit, &solution)) {
+    ctx->phase.mag.stable_checks = 0;
+    ctx->phase.mag.has_solution = false;
+    return false;
+  }
   
-  // Coletar dados durante rotação
-  while ((get_time_ms() - start_time) < MAG_ROTATION_TIME_MS) {
-    if (!read_magnetometer_raw(&mag_data)) {
-      log_error("Failed to read magnetometer");
-      return false;
-    }
-    
-    // Encontrar min/max
-    if (mag_data.mx < mag_x_min) mag_x_min = mag_data.mx;
-    if (mag_data.mx > mag_x_max) mag_x_max = mag_data.mx;
-    
-    if (mag_data.my < mag_y_min) mag_y_min = mag_data.my;
-    if (mag_data.my > mag_y_max) mag_y_max = mag_data.my;
-    
-    if (mag_data.mz < mag_z_min) mag_z_min = mag_data.mz;
-    if (mag_data.mz > mag_z_max) mag_z_max = mag_data.mz;
-    
-    sample_count++;
-    delay_ms(50);
+  if (ctx->phase.mag.has_solution &&
+      mag_fit_is_stable(&ctx->phase.mag.last_solution, &solution)) {
+    ctx->phase.mag.stable_checks++;
+  } else {
+    ctx->phase.mag.stable_checks = 0;
   }
   
-  // Calcular offset (ponto médio)
-  calib.mag_offset_x = (mag_x_max + mag_x_min) / 2.0f;
-  calib.mag_offset_y = (mag_y_max + mag_y_min) / 2.0f;
-  calib.mag_offset_z = (mag_z_max + mag_z_min) / 2.0f;
+  ctx->phase.mag.last_solution = solution;
+  ctx->phase.mag.has_solution = true;
+  
+  return ctx->phase.mag.stable_checks >= MAG_FIT_STABLE_CHECKS;
+}
+
+/**
+ * @brief Ponto médio entre a menor e a maior amostra
+ */
+static float stats_midrange(const CalibrationStats_t *stats) {
+  return (calibration_stats_max(stats) + calibration_stats_min(stats)) / 2.0f;
+}
+
+/**
+ * @brief Metade da faixa de amostras
+ */
+static float stats_half_range(const CalibrationStats_t *stats) {
+  return (calibration_stats_max(stats) - calibration_stats_min(stats)) / 2.0f;
+}
+
+/**
+ * @brief Registrar a direção da amostra no mapa de cobertura
+ *
+ * A direção é medida em relação ao ponto médio min/max corrente, uma
+ * estimativa grosseira do centro que basta para contar direções visitadas.
+ */
+static void mag_coverage_update(CalibrationContext_t *ctx, const MagData_t *sample) {
+  float x = sample->mx - stats_midrange(&ctx->phase.mag.mag_x);
+  float y = sample->my - stats_midrange(&ctx->phase.mag.mag_y);
+  float z = sample->mz - stats_midrange(&ctx->phase.mag.mag_z);
+  float norm = sqrtf(x * x + y * y + z * z);
+  
+  if (norm <= 0.0f) {
+    return;
+  }
+  
+  // Azimute em [0, AZ_BINS), z normalizado em [0, EL_BINS)
+  int az = (int)((atan2f(y, x) + CALIB_PI) * (CALIB_MAG_COVERAGE_AZ_BINS / (2.0f * CALIB_PI)));
+  int el = (int)((z / norm + 1.0f) * (CALIB_MAG_COVERAGE_EL_BINS / 2.0f));
+  if (az >= CALIB_MAG_COVERAGE_AZ_BINS) az = CALIB_MAG_COVERAGE_AZ_BINS - 1;
+  if (el >= CALIB_MAG_COVERAGE_EL_BINS) el = CALIB_MAG_COVERAGE_EL_BINS - 1;
+  
+  int bin = el * CALIB_MAG_COVERAGE_AZ_BINS + az;
+  uint32_t bit = 1u << (bin % 32);
+  
+  if (!(ctx->phase.mag.coverage[bin / 32] & bit)) {
+    ctx->phase.mag.coverage[bin / 32] |= bit;
+    ctx->phase.mag.coverage_bins++;
+    ctx->phase.mag.last_new_bin_sample = ctx->phase.mag.mag_x.count;
+  }
+}
+
+/**
+ * @brief Verificar se a cobertura de direções saturou
+ */
+static bool mag_coverage_saturated(CalibrationContext_t *ctx) {
+  return ctx->adaptive_sampling &&
+         ctx->phase.mag.mag_x.count >= MAG_FIT_MIN_SAMPLES &&
+         (ctx->phase.mag.mag_x.count - ctx->phase.mag.last_new_bin_sample) >=
+             MAG_COVERAGE_SATURATION_SAMPLES;
+}
+
+/**
+ * @brief Calcular offset/escala por eixo a partir de min/max
+ */
+static void mag_finalize_minmax(CalibrationContext_t *ctx) {
+  // Calcular offset (ponto médio)
+  ctx->calib.mag_offset_x = stats_midrange(&ctx->phase.mag.mag_x);
+  ctx->calib.mag_offset_y = stats_midrange(&ctx->phase.mag.mag_y);
+  ctx->calib.mag_offset_z = stats_midrange(&ctx->phase.mag.mag_z);
   
   // Calcular escala (raio)
-  float avg_delta_x = (mag_x_max - mag_x_min) / 2.0f;
-  float avg_delta_y = (mag_y_max - mag_y_min) / 2.0f;
-  float avg_delta_z = (mag_z_max - mag_z_min) / 2.0f;
+  float avg_delta_x = stats_half_range(&ctx->phase.mag.mag_x);
+  float avg_delta_y = stats_half_range(&ctx->phase.mag.mag_y);
+  float avg_delta_z = stats_half_range(&ctx->phase.mag.mag_z);
   
   float avg_delta = (avg_delta_x + avg_delta_y + avg_delta_z) / 3.0f;
   
-  calib.mag_scale_x = avg_delta / avg_delta_x;
-  calib.mag_scale_y = avg_delta / avg_delta_y;
-  calib.mag_scale_z = avg_delta / avg_delta_z;
+  ctx->calib.mag_scale_x = avg_delta / avg_delta_x;
+  ctx->calib.mag_scale_y = avg_delta / avg_delta_y;
+  ctx->calib.mag_scale_z = avg_delta / avg_delta_z;
+  
+  // Extensão equivalente: matriz diagonal
+  memset(ctx->calib_ext.mag_soft_iron, 0, sizeof(ctx->calib_ext.mag_soft_iron));
+  ctx->calib_ext.mag_hard_iron[0] = ctx->calib.mag_offset_x;
+  ctx->calib_ext.mag_hard_iron[1] = ctx->calib.mag_offset_y;
+  ctx->calib_ext.mag_hard_iron[2] = ctx->calib.mag_offset_z;
+  ctx->calib_ext.mag_soft_iron[0][0] = ctx->calib.mag_scale_x;
+  ctx->calib_ext.mag_soft_iron[1][1] = ctx->calib.mag_scale_y;
+  ctx->calib_ext.mag_soft_iron[2][2] = ctx->calib.mag_scale_z;
+  ctx->calib_ext.mag_field_strength = avg_delta;
+  ctx->calib_ext.mag_fit_condition = 0.0f;
+  ctx->calib_ext.mag_model = MAG_MODEL_MINMAX;
+}
+
+/**
+ * @brief Copiar solução do elipsoide para a calibração
+ */
+static void mag_finalize_ellipsoid(CalibrationContext_t *ctx, const EllipsoidSolution_t *solution) {
+  memcpy(ctx->calib_ext.mag_hard_iron, solution->hard_iron, sizeof(ctx->calib_ext.mag_hard_iron));
+  memcpy(ctx->calib_ext.mag_soft_iron, solution->soft_iron, sizeof(ctx->calib_ext.mag_soft_iron));
+  ctx->calib_ext.mag_field_strength = solution->field_strength;
+  ctx->calib_ext.mag_fit_condition = solution->condition;
+  ctx->calib_ext.mag_model = MAG_MODEL_ELLIPSOID;
+  
+  // Campos legados: centro e diagonal da matriz soft-iron
+  ctx->calib.mag_offset_x = solution->hard_iron[0];
+  ctx->calib.mag_offset_y = solution->hard_iron[1];
+  ctx->calib.mag_offset_z = solution->hard_iron[2];
+  ctx->calib.mag_scale_x = solution->soft_iron[0][0];
+  ctx->calib.mag_scale_y = solution->soft_iron[1][1];
+  ctx->calib.mag_scale_z = solution->soft_iron[2][2];
+}
+
+/**
+ * @brief Acumular uma amostra na fase do Magnetômetro
+ * @param converged true se o ajuste de elipsoide convergiu
+ * @return true se a coleta pode terminar (convergência ou cobertura saturada)
+ */
+static bool mag_phase_push(CalibrationContext_t *ctx, const MagData_t *sample, bool *converged) {
+  // Acumular min/max por eixo e equações normais do elipsoide
+  calibration_stats_push(&ctx->phase.mag.mag_x, sample->mx);
+  calibration_stats_push(&ctx->phase.mag.mag_y, sample->my);
+  calibration_stats_push(&ctx->phase.mag.mag_z, sample->mz);
+  ellipsoid_fit_push(&ctx->phase.mag.fit, sample->mx, sample->my, sample->mz);
+  mag_coverage_update(ctx, sample);
+  
+  *converged = mag_fit_check_convergence(ctx);
+  return *converged || mag_coverage_saturated(ctx);
+}
+
+/**
+ * @brief Iniciar fase de calibração do Magnetômetro
+ */
+void calibrate_magnetometer_begin_ctx(CalibrationContext_t *ctx) {
+  log_info("Starting Magnetometer calibration");
+  log_info("Please rotate robot 360 degrees slowly (up to 30 seconds)");
+  
+  uint32_t now = time_ms(ctx);
+  
+  ctx->phase.mag.start_time = now;
+  ctx->phase.mag.end_time = now + MAG_ROTATION_TIME_MS;
+  ctx->phase.mag.next_sample_time = now;
+  fifo_reset(&ctx->mag_fifo, now);
+  calibration_stats_reset(&ctx->phase.mag.mag_x);
+  calibration_stats_reset(&ctx->phase.mag.mag_y);
+  calibration_stats_reset(&ctx->phase.mag.mag_z);
+  ellipsoid_fit_reset(&ctx->phase.mag.fit);
+  ctx->phase.mag.stable_checks = 0;
+  ctx->phase.mag.has_solution = false;
+  memset(ctx->phase.mag.coverage, 0, sizeof(ctx->phase.mag.coverage));
+  ctx->phase.mag.coverage_bins = 0;
+  ctx->phase.mag.last_new_bin_sample = 0;
+}
+
+/**
+ * @brief Executar um passo da calibração do Magnetômetro
+ * Robô deve rotacionar 360° lentamente; a coleta termina antes de
+ * MAG_ROTATION_TIME_MS se o ajuste de elipsoide convergir
+ */
+CalibrationStepResult_t calibrate_magnetometer_step_ctx(CalibrationContext_t *ctx) {
+  uint32_t now = time_ms(ctx);
+  bool converged = false;
+  
+  // Coletar dados durante rotação
+  if (!time_reached(now, ctx->phase.mag.end_time)) {
+    bool done = false;
+    
+    if (ctx->drivers.read_magnetometer_fifo != NULL) {
+      size_t got;
+      
+      if (!fifo_due(&ctx->mag_fifo, now)) {
+        return CALIB_STEP_PENDING;
+      }
+      if (!ctx->drivers.read_magnetometer_fifo(ctx->drivers.user, ctx->burst.mag,
+                                               CALIB_FIFO_BURST, &got)) {
+        count_read_failure(ctx, CALIB_SENSOR_MAG);
+        log_error("Failed to read magnetometer FIFO");
+        return CALIB_STEP_FAILED;
+      }
+      fifo_mark_read(&ctx->mag_fifo, now, got);
+      
+      for (size_t i = 0; i < got && !done; i++) {
+        if (time_reached(ctx->burst.mag[i].timestamp, ctx->phase.mag.start_time)) {
+          done = mag_phase_push(ctx, &ctx->burst.mag[i], &converged);
+        }
+      }
+    } else {
+      if (!time_reached(now, ctx->phase.mag.next_sample_time)) {
+        return CALIB_STEP_PENDING;
+      }
+      ctx->phase.mag.next_sample_time = now + MAG_SAMPLE_INTERVAL_MS;
+      
+      if (!ctx->drivers.read_magnetometer_raw(ctx->drivers.user, &ctx->mag_data)) {
+        count_read_failure(ctx, CALIB_SENSOR_MAG);
+        log_error("Failed to read magnetometer");
+        return CALIB_STEP_FAILED;
+      }
+      done = mag_phase_push(ctx, &ctx->mag_data, &converged);
+    }
+    
+    if (!done) {
+      return CALIB_STEP_PENDING;
+    }
+  }
+  
+  if (ctx->phase.mag.mag_x.count == 0) {
+    log_error("No magnetometer samples collected");
+    return CALIB_STEP_FAILED;
+  }
+  
+  EllipsoidSolution_t solution;
+  bool fit_ok = converged;
+  
+  if (converged) {
+    solution = ctx->phase.mag.last_solution;
+  } else {
+    fit_ok = ellipsoid_fit_solve(&ctx->phase.mag.fit, &solution) &&
+             solution.condition < MAG_FIT_MAX_CONDITION;
+  }
   
   log_info("Magnetometer Calibration:");
+  
+  if (fit_ok) {
+    mag_finalize_ellipsoid(ctx, &solution);
+    log_info("  Model: ellipsoid (condition %.1f%s)", solution.condition,
+             converged ? ", converged early" : "");
+  } else {
+    // Cobertura insuficiente (ex.: rotação apenas em yaw): usar min/max
+    mag_finalize_minmax(ctx);
+    log_warning("  Ellipsoid fit ill-conditioned, using min/max model");
+  }
+  
   log_info("  Offset: (%.1f, %.1f, %.1f)", 
-           calib.mag_offset_x, calib.mag_offset_y, calib.mag_offset_z);
+           ctx->calib.mag_offset_x, ctx->calib.mag_offset_y, ctx->calib.mag_offset_z);
   log_info("  Scale: (%.3f, %.3f, %.3f)", 
-           calib.mag_scale_x, calib.mag_scale_y, calib.mag_scale_z);
-  log_info("  Samples collected: %d", sample_count);
+           ctx->calib.mag_scale_x, ctx->calib.mag_scale_y, ctx->calib.mag_scale_z);
+  log_info("  Samples collected: %lu", (unsigned long)ctx->phase.mag.mag_x.count);
+  log_info("  Coverage: %d/%d directions", ctx->phase.mag.coverage_bins, CALIB_MAG_COVERAGE_BINS);
   
   log_info("Magnetometer calibration complete");
-  return true;
+  return CALIB_STEP_DONE;
+}
+
+/**
+ * @brief Calibrar Magnetômetro (Bússola)
+ * Robô deve rotacionar 360° lentamente
+ */
+bool calibrate_magnetometer_ctx(CalibrationContext_t *ctx) {
+  return run_phase_blocking(ctx, calibrate_magnetometer_begin_ctx,
+                            calibrate_magnetometer_step_ctx);
 }
 
+#endif // CALIB_WITH_MAG
+
 // ============================================================================
 // CALIBRAÇÃO ODÔMETRO
 // ============================================================================
 
+#if CALIB_WITH_ODOM
+
 /**
- * @brief Calibrar Odômetro (Encoders)
- * Robô deve mover 1 metro em linha reta
+ * @brief Iniciar fase de calibração do Odômetro
  */
-bool calibrate_odometer(void) {
+void calibrate_odometer_begin_ctx(CalibrationContext_t *ctx) {
   log_info("Starting Odometer calibration");
   log_info("Moving robot forward %.1f meters", ODOM_TEST_DISTANCE_MM / 1000.0f);
   
   // Reset contadores
-  reset_encoder_counters();
-  delay_ms(100);
+  ctx->drivers.reset_encoder_counters(ctx->drivers.user);
+  ctx->phase.odom.settle_time = time_ms(ctx) + ODOM_SETTLE_TIME_MS;
+}
+
+/**
+ * @brief Executar um passo da calibração do Odômetro
+ * Robô deve mover 1 metro em linha reta
+ */
+CalibrationStepResult_t calibrate_odometer_step_ctx(CalibrationContext_t *ctx) {
+  // Aguardar encoders estabilizarem sem bloquear o loop
+  if (!time_reached(time_ms(ctx), ctx->phase.odom.settle_time)) {
+    return CALIB_STEP_PENDING;
+  }
   
   // Mover distância conhecida
-  if (!move_forward_distance(ODOM_TEST_DISTANCE_MM)) {
+  ctx->phase.odom.start_left = ctx->drivers.get_left_encoder_count(ctx->drivers.user);
+  ctx->phase.odom.start_right = ctx->drivers.get_right_encoder_count(ctx->drivers.user);
+  if (!ctx->drivers.move_forward_distance(ctx->drivers.user, ODOM_TEST_DISTANCE_MM)) {
+    count_read_failure(ctx, CALIB_SENSOR_ODOM);
     log_error("Failed to move robot");
-    return false;
+    return CALIB_STEP_FAILED;
   }
   
-  // Ler contadores
-  uint32_t pulses_left = get_left_encoder_count();
-  uint32_t pulses_right = get_right_encoder_count();
+  // Diferenças modulares: não dependem do reset nem da volta do contador
+  uint32_t left = ctx->drivers.get_left_encoder_count(ctx->drivers.user);
+  uint32_t right = ctx->drivers.get_right_encoder_count(ctx->drivers.user);
+  int32_t pulses_left = (int32_t)(left - ctx->phase.odom.start_left);
+  int32_t pulses_right = (int32_t)(right - ctx->phase.odom.start_right);
+  if (pulses_left <= 0 || pulses_right <= 0) {
+    log_error("Odometer moved backwards or encoders not counting");
+    return CALIB_STEP_FAILED;
+  }
   
   // Calcular pulsos por metro
   float distance_m = ODOM_TEST_DISTANCE_MM / 1000.0f;
-  calib.pulses_per_meter_left = pulses_left / distance_m;
-  calib.pulses_per_meter_right = pulses_right / distance_m;
+  ctx->calib.pulses_per_meter_left = pulses_left / distance_m;
+  ctx->calib.pulses_per_meter_right = pulses_right / distance_m;
   
   // Validar (deve ser similar)
-  float error = fabs(pulses_left - pulses_right) / ((pulses_left + pulses_right) / 2.0f);
+  float error = fabsf((float)(pulses_left - pulses_right)) /
+                ((pulses_left + pulses_right) / 2.0f);
   
   log_info("Odometer Calibration:");
-  log_info("  Left pulses: %lu", pulses_left);
-  log_info("  Right pulses: %lu", pulses_right);
+  log_info("  Left pulses: %ld", (long)pulses_left);
+  log_info("  Right pulses: %ld", (long)pulses_right);
   log_info("  Pulses/meter: Left=%.1f, Right=%.1f", 
-           calib.pulses_per_meter_left, calib.pulses_per_meter_right);
+           ctx->calib.pulses_per_meter_left, ctx->calib.pulses_per_meter_right);
   log_info("  Encoder error: %.2f%%", error * 100.0f);
   
   if (error > 0.15f) { // 15% de erro
     log_error("Odometer calibration error too high: %.2f%%", error * 100.0f);
-    return false;
+    return CALIB_STEP_FAILED;
   }
   
   log_info("Odometer calibration complete");
-  return true;
+  return CALIB_STEP_DONE;
+}
+
+/**
+ * @brief Calibrar Odômetro (Encoders)
+ * Robô deve mover 1 metro em linha reta
+ */
+bool calibrate_odometer_ctx(CalibrationContext_t *ctx) {
+  return run_phase_blocking(ctx, calibrate_odometer_begin_ctx, calibrate_odometer_step_ctx);
 }
 
+#endif // CALIB_WITH_ODOM
+
 // ============================================================================
 // CALIBRAÇÃO LIDAR
 // ============================================================================
 
+#if CALIB_WITH_LIDAR
+
+#if CALIB_LIDAR_SCAN
+
+// Alvo no referencial do robô: parede à frente (e à esquerda, no canto)
+static const CalibrationLidarWall_t lidar_target[] = {
+  { 0.0f, LIDAR_TARGET_DISTANCE },
+#if LIDAR_TARGET_CORNER
+  { CALIB_PI / 2.0f, LIDAR_TARGET_DISTANCE },
+#endif
+};
+
 /**
- * @brief Calibrar LiDAR
- * Colocar objeto a 1 metro de distância
+ * @brief Iniciar fase de calibração do LiDAR
  */
-bool calibrate_lidar(void) {
+void calibrate_lidar_begin_ctx(CalibrationContext_t *ctx) {
+  log_info("Starting LiDAR calibration");
+  log_info("Place robot facing a flat wall at exactly 1.0 meter distance");
+
+  // Linearizar em torno da calibração atual: recalibrações partem do ótimo
+  calibration_lidar_fit_reset(&ctx->phase.lidar_fit, ctx->calib.lidar_offset_distance,
+                              ctx->calib.lidar_angle_offset);
+}
+
+/**
+ * @brief Executar um passo da calibração do LiDAR
+ * Consome varreduras inteiras direto do buffer do driver
+ */
+CalibrationStepResult_t calibrate_lidar_step_ctx(CalibrationContext_t *ctx) {
+  const LiDARData_t *points;
+  size_t count;
+
+  if (!ctx->drivers.read_lidar_scan(ctx->drivers.user, &points, &count)) {
+    return CALIB_STEP_PENDING;  // Varredura em andamento (o timeout cobre falhas)
+  }
+
+  uint32_t accepted = calibration_lidar_fit_scan(&ctx->phase.lidar_fit, points, count, lidar_target,
+                                                 sizeof(lidar_target) / sizeof(lidar_target[0]));
+  if (accepted == 0) {
+    log_warning("LiDAR scan has no wall points (%lu points)", (unsigned long)count);
+  }
+
+  if (ctx->phase.lidar_fit.scans < LIDAR_SCANS || ctx->phase.lidar_fit.points < LIDAR_SCAN_MIN_POINTS) {
+    return CALIB_STEP_PENDING;
+  }
+
+  float distance_offset, angle_offset, rms;
+  if (!calibration_lidar_fit_solve(&ctx->phase.lidar_fit, &distance_offset, &angle_offset, &rms)) {
+    log_error("LiDAR wall fit failed");
+    return CALIB_STEP_FAILED;
+  }
+
+  ctx->calib.lidar_offset_distance = distance_offset;
+  ctx->calib.lidar_angle_offset = angle_offset;
+
+  log_info("LiDAR Calibration:");
+  log_info("  Offset: %.3f m", ctx->calib.lidar_offset_distance);
+  log_info("  Angle offset: %.4f rad", ctx->calib.lidar_angle_offset);
+  log_info("  Residual RMS: %.3f m", rms);
+  log_info("  Points: %lu (%lu rejected, %lu scans)", (unsigned long)ctx->phase.lidar_fit.points,
+           (unsigned long)ctx->phase.lidar_fit.rejected, (unsigned long)ctx->phase.lidar_fit.scans);
+
+  // Validar (offset deve ser < 100mm)
+  if (fabsf(ctx->calib.lidar_offset_distance) > 0.1f) {
+    log_warning("LiDAR offset large: %.3f m", ctx->calib.lidar_offset_distance);
+  }
+
+  // Validar (resíduo da parede deve ser pequeno)
+  if (rms > 0.05f) {
+    log_warning("LiDAR noise high: %.3f m", rms);
+  }
+
+  log_info("LiDAR calibration complete");
+  return CALIB_STEP_DONE;
+}
+
+#else
+
+// Offset = distância do alvo (1.0 m) - média medida
+static const PhasePriorMap_t lidar_prior_map = {
+  offsetof(SensorCalibration_t, lidar_offset_distance), 1.0f, -1.0f
+};
+
+/**
+ * @brief Iniciar fase de calibração do LiDAR
+ */
+void calibrate_lidar_begin_ctx(CalibrationContext_t *ctx) {
   log_info("Starting LiDAR calibration");
   log_info("Place object at exactly 1.0 meter distance");
   
-  float distance_sum = 0.0f;
-  float distance_sq_sum = 0.0f;
+  ctx->phase.lidar.next_sample_time = time_ms(ctx);
+  calibration_stats_reset(&ctx->phase.lidar.distance);
+}
+
+/**
+ * @brief Executar um passo da calibração do LiDAR
+ * Colocar objeto a 1 metro de distância
+ */
+CalibrationStepResult_t calibrate_lidar_step_ctx(CalibrationContext_t *ctx) {
+  uint32_t now = time_ms(ctx);
   
-  for (int i = 0; i < LIDAR_SAMPLES; i++) {
-    float distance = read_lidar_distance();
-    
-    if (distance < 0.0f) {
-      log_error("Failed to read LiDAR");
-      return false;
-    }
-    
-    distance_sum += distance;
-    distance_sq_sum += distance * distance;
-    
-    delay_ms(20);
+  if (!time_reached(now, ctx->phase.lidar.next_sample_time)) {
+    return CALIB_STEP_PENDING;
   }
+  ctx->phase.lidar.next_sample_time = now + LIDAR_SAMPLE_INTERVAL_MS;
   
-  float avg_distance = distance_sum / LIDAR_SAMPLES;
-  float distance_var = (distance_sq_sum / LIDAR_SAMPLES) - (avg_distance * avg_distance);
-  float distance_std = sqrtf(distance_var);
+  float distance = ctx->drivers.read_lidar_distance(ctx->drivers.user);
+  
+  if (distance < 0.0f) {
+    count_read_failure(ctx, CALIB_SENSOR_LIDAR);
+    log_error("Failed to read LiDAR");
+    return CALIB_STEP_FAILED;
+  }
+  
+  calibration_stats_push(&ctx->phase.lidar.distance, distance);
+  
+  if (ctx->phase.lidar.distance.count < LIDAR_SAMPLES &&
+      !stats_converged(ctx, &ctx->phase.lidar.distance, LIDAR_MIN_SAMPLES, LIDAR_SEM_TARGET,
+                       &lidar_prior_map)) {
+    return CALIB_STEP_PENDING;
+  }
+  
+  float avg_distance = calibration_stats_mean(&ctx->phase.lidar.distance);
+  float distance_std = calibration_stats_stddev(&ctx->phase.lidar.distance);
   
   // Calcular offset (esperado 1.0m)
-  calib.lidar_offset_distance = 1.0f - avg_distance;
+  ctx->calib.lidar_offset_distance = stats_estimate(ctx, &ctx->phase.lidar.distance, &lidar_prior_map);
   
   log_info("LiDAR Calibration:");
   log_info("  Average distance: %.3f m", avg_distance);
   log_info("  Std deviation: %.3f m", distance_std);
-  log_info("  Offset: %.3f m", calib.lidar_offset_distance);
+  log_info("  Offset: %.3f m", ctx->calib.lidar_offset_distance);
+  log_info("  Samples: %lu", (unsigned long)ctx->phase.lidar.distance.count);
   
   // Validar (offset deve ser < 100mm)
-  if (fabs(calib.lidar_offset_distance) > 0.1f) {
-    log_warning("LiDAR offset large: %.3f m", calib.lidar_offset_distance);
+  if (fabsf(ctx->calib.lidar_offset_distance) > 0.1f) {
+    log_warning("LiDAR offset large: %.3f m", ctx->calib.lidar_offset_distance);
   }
   
   // Validar (desvio padrão deve ser pequeno)
@@ -374,124 +1494,287 @@ bool calibrate_lidar(void) {
   }
   
   log_info("LiDAR calibration complete");
-  return true;
+  return CALIB_STEP_DONE;
+}
+
+#endif // CALIB_LIDAR_SCAN
+
+/**
+ * @brief Calibrar LiDAR
+ * Colocar objeto a 1 metro de distância
+ */
+bool calibrate_lidar_ctx(CalibrationContext_t *ctx) {
+  return run_phase_blocking(ctx, calibrate_lidar_begin_ctx, calibrate_lidar_step_ctx);
 }
 
+#endif // CALIB_WITH_LIDAR
+
 // ============================================================================
 // CALIBRAÇÃO CÂMERA
 // ============================================================================
 
+#if CALIB_WITH_CAMERA
+
 /**
- * @brief Calibrar Câmera
- * Usar padrão de calibração (checkerboard)
+ * @brief Iniciar fase de calibração da Câmera
  */
-bool calibrate_camera(void) {
+void calibrate_camera_begin_ctx(CalibrationContext_t *ctx) {
   log_info("Starting Camera calibration");
-  
-  // Nota: Implementação simplificada
-  // Em produção, usar OpenCV ou biblioteca similar
-  
-  // Parâmetros típicos para câmera VGA (640x480)
-  calib.camera_focal_length = 500.0f; // pixels
-  calib.camera_principal_point_x = 320.0f; // centro X
-  calib.camera_principal_point_y = 240.0f; // centro Y
-  
-  // Distorção (coeficientes radiais)
-  calib.camera_distortion_k1 = 0.0f;
-  calib.camera_distortion_k2 = 0.0f;
-  
+  log_info("Move a %dx%d checkerboard across the field of view, tilting it",
+           CALIB_CAMERA_BOARD_COLS + 1, CALIB_CAMERA_BOARD_ROWS + 1);
+
+  ctx->phase.camera.stage = CAMERA_STAGE_COLLECT;
+  calibration_camera_reset(&ctx->phase.camera.calibrator);
+}
+
+/**
+ * @brief Executar um passo da calibração da Câmera
+ * Um quadro por passo na coleta; uma iteração do ajuste por passo depois
+ */
+CalibrationStepResult_t calibrate_camera_step_ctx(CalibrationContext_t *ctx) {
+  CameraCalibrator_t *cal = &ctx->phase.camera.calibrator;
+
+  if (ctx->phase.camera.stage == CAMERA_STAGE_COLLECT) {
+    CameraFrame_t frame;
+
+    if (!ctx->drivers.read_camera_frame(ctx->drivers.user, &frame)) {
+      return CALIB_STEP_PENDING;
+    }
+    uint8_t views = cal->view_count;
+    calibration_camera_add_frame(cal, &frame);
+    ctx->drivers.release_camera_frame(ctx->drivers.user, &frame);
+
+    if (cal->view_count != views) {
+      log_info("  Board view %u/%u", cal->view_count, CALIB_CAMERA_MAX_FRAMES);
+    }
+    if (cal->view_count < CALIB_CAMERA_MAX_FRAMES &&
+        !(cal->view_count >= CAMERA_MIN_VIEWS &&
+          cal->frames_since_new >= CAMERA_SATURATION_FRAMES)) {
+      return CALIB_STEP_PENDING;
+    }
+
+    const CameraIntrinsics_t prior = {
+      ctx->calib.camera_focal_length, ctx->calib.camera_principal_point_x,
+      ctx->calib.camera_principal_point_y,
+      ctx->calib.camera_distortion_k1, ctx->calib.camera_distortion_k2
+    };
+    if (!calibration_camera_solve_begin(cal, &prior)) {
+      log_error("Camera initialization failed (%u views)", cal->view_count);
+      return CALIB_STEP_FAILED;
+    }
+    ctx->phase.camera.stage = CAMERA_STAGE_SOLVE;
+    return CALIB_STEP_PENDING;
+  }
+
+  CalibrationStepResult_t result = calibration_camera_solve_step(cal);
+  if (result == CALIB_STEP_PENDING) {
+    return result;
+  }
+
+  float rms = calibration_camera_rms(cal);
+  if (result == CALIB_STEP_FAILED || rms > CAMERA_MAX_RMS_PX) {
+    log_error("Camera fit failed: reprojection RMS %.2f px", rms);
+    return CALIB_STEP_FAILED;
+  }
+
+  ctx->calib.camera_focal_length = cal->intrinsics.focal_length;
+  ctx->calib.camera_principal_point_x = cal->intrinsics.cx;
+  ctx->calib.camera_principal_point_y = cal->intrinsics.cy;
+  ctx->calib.camera_distortion_k1 = cal->intrinsics.k1;
+  ctx->calib.camera_distortion_k2 = cal->intrinsics.k2;
+
   log_info("Camera Calibration:");
-  log_info("  Focal length: %.1f pixels", calib.camera_focal_length);
-  log_info("  Principal point: (%.1f, %.1f)", 
-           calib.camera_principal_point_x, calib.camera_principal_point_y);
-  log_info("  Distortion: k1=%.3f, k2=%.3f", 
-           calib.camera_distortion_k1, calib.camera_distortion_k2);
-  
+  log_info("  Focal length: %.1f pixels", ctx->calib.camera_focal_length);
+  log_info("  Principal point: (%.1f, %.1f)",
+           ctx->calib.camera_principal_point_x, ctx->calib.camera_principal_point_y);
+  log_info("  Distortion: k1=%.3f, k2=%.3f",
+           ctx->calib.camera_distortion_k1, ctx->calib.camera_distortion_k2);
+  log_info("  Reprojection RMS: %.3f px (%u views, %lu frames, %u iterations)", rms,
+           cal->view_count, (unsigned long)cal->frames_seen, cal->iterations);
+
   log_info("Camera calibration complete");
-  return true;
+  return CALIB_STEP_DONE;
+}
+
+/**
+ * @brief Calibrar Câmera
+ * Usar padrão de calibração (checkerboard)
+ */
+bool calibrate_camera_ctx(CalibrationContext_t *ctx) {
+  return run_phase_blocking(ctx, calibrate_camera_begin_ctx, calibrate_camera_step_ctx);
 }
 
+#endif // CALIB_WITH_CAMERA
+
 // ============================================================================
 // CALIBRAÇÃO BATERIA
 // ============================================================================
 
+#if CALIB_WITH_BATTERY
+
+// Offset = voltagem nominal (12 V) - média medida
+static const PhasePriorMap_t battery_prior_map = {
+  offsetof(SensorCalibration_t, battery_voltage_offset), 12.0f, -1.0f
+};
+
 /**
- * @brief Calibrar Sensor de Bateria
+ * @brief Iniciar fase de calibração da Bateria
  */
-bool calibrate_battery(void) {
+void calibrate_battery_begin_ctx(CalibrationContext_t *ctx) {
   log_info("Starting Battery calibration");
   
-  float voltage_sum = 0.0f;
+  ctx->phase.battery.next_sample_time = time_ms(ctx);
+  calibration_stats_reset(&ctx->phase.battery.voltage);
+}
+
+/**
+ * @brief Executar um passo da calibração da Bateria
+ */
+CalibrationStepResult_t calibrate_battery_step_ctx(CalibrationContext_t *ctx) {
+  uint32_t now = time_ms(ctx);
   
-  for (int i = 0; i < 10; i++) {
-    if (!read_battery_data(&battery_data)) {
-      log_error("Failed to read battery");
-      return false;
-    }
-    
-    voltage_sum += battery_data.voltage;
-    delay_ms(100);
+  if (!time_reached(now, ctx->phase.battery.next_sample_time)) {
+    return CALIB_STEP_PENDING;
   }
+  ctx->phase.battery.next_sample_time = now + BATTERY_SAMPLE_INTERVAL_MS;
   
-  float avg_voltage = voltage_sum / 10.0f;
+  if (!ctx->drivers.read_battery_data(ctx->drivers.user, &ctx->battery_data)) {
+    count_read_failure(ctx, CALIB_SENSOR_BATTERY);
+    log_error("Failed to read battery");
+    return CALIB_STEP_FAILED;
+  }
+  
+  calibration_stats_push(&ctx->phase.battery.voltage, ctx->battery_data.voltage);
+  
+  if (ctx->phase.battery.voltage.count < BATTERY_SAMPLES &&
+      !stats_converged(ctx, &ctx->phase.battery.voltage, BATTERY_MIN_SAMPLES, BATTERY_SEM_TARGET,
+                       &battery_prior_map)) {
+    return CALIB_STEP_PENDING;
+  }
   
-  // Assumir voltagem nominal conhecida (ex: 12V)
-  float nominal_voltage = 12.0f;
-  calib.battery_voltage_offset = nominal_voltage - avg_voltage;
-  calib.battery_voltage_scale = 1.0f;
+  float avg_voltage = calibration_stats_mean(&ctx->phase.battery.voltage);
+  
+  // Voltagem nominal conhecida (battery_prior_map)
+  ctx->calib.battery_voltage_offset = stats_estimate(ctx, &ctx->phase.battery.voltage,
+                                                     &battery_prior_map);
+  ctx->calib.battery_voltage_scale = 1.0f;
   
   log_info("Battery Calibration:");
   log_info("  Average voltage: %.2f V", avg_voltage);
-  log_info("  Offset: %.2f V", calib.battery_voltage_offset);
+  log_info("  Offset: %.2f V", ctx->calib.battery_voltage_offset);
   
   log_info("Battery calibration complete");
-  return true;
+  return CALIB_STEP_DONE;
+}
+
+/**
+ * @brief Calibrar Sensor de Bateria
+ */
+bool calibrate_battery_ctx(CalibrationContext_t *ctx) {
+  return run_phase_blocking(ctx, calibrate_battery_begin_ctx, calibrate_battery_step_ctx);
 }
 
+#endif // CALIB_WITH_BATTERY
+
 // ============================================================================
 // CALIBRAÇÃO TEMPERATURA
 // ============================================================================
 
+#if CALIB_WITH_TEMP
+
 /**
- * @brief Calibrar Sensores de Temperatura
+ * @brief Iniciar fase de calibração de Temperatura
  */
-bool calibrate_temperature(void) {
-  log_info("Starting Temperature calibration");
+void calibrate_temperature_begin_ctx(CalibrationContext_t *ctx) {
+  log_info("Starting Temperature calibration (ambient %.1f °C)", ctx->ambient_temperature);
+  
+  ctx->temp_phase.next_sample_time = time_ms(ctx);
+  ctx->temp_phase.channel_count = CALIB_TEMP_CHANNELS;
+  for (int i = 0; i < CALIB_TEMP_CHANNELS; i++) {
+    calibration_stats_reset(&ctx->temp_phase.channel[i]);
+  }
+}
+
+/**
+ * @brief Executar um passo da calibração de Temperatura
+ */
+CalibrationStepResult_t calibrate_temperature_step_ctx(CalibrationContext_t *ctx) {
+  uint32_t now = time_ms(ctx);
   
-  float temp_sum = 0.0f;
+  if (!time_reached(now, ctx->temp_phase.next_sample_time)) {
+    return CALIB_STEP_PENDING;
+  }
+  ctx->temp_phase.next_sample_time = now + TEMP_SAMPLE_INTERVAL_MS;
   
-  for (int i = 0; i < 10; i++) {
-    if (!read_temperature_data(&temp_data)) {
-      log_error("Failed to read temperature");
-      return false;
-    }
-    
-    temp_sum += temp_data.temperature;
-    delay_ms(100);
+  TemperatureData_t temp_raw, temp_calibrated;
+  if (!temperature_sample(ctx, &temp_raw, &temp_calibrated)) {
+    log_error("Failed to read temperature");
+    return CALIB_STEP_FAILED;
+  }
+  
+  uint8_t channels = thermal_channel_count(&temp_raw);
+  if (channels < ctx->temp_phase.channel_count) {
+    ctx->temp_phase.channel_count = channels;
+  }
+  for (uint8_t i = 0; i < channels; i++) {
+    calibration_stats_push(&ctx->temp_phase.channel[i], thermal_channel(&temp_raw, i));
   }
   
-  float avg_temp = temp_sum / 10.0f;
+  // Offset do canal 0 = temperatura ambiente - média medida
+  const PhasePriorMap_t temp_prior_map = {
+    offsetof(SensorCalibration_t, temp_offset), ctx->ambient_temperature, -1.0f
+  };
+  const CalibrationStats_t *reference = &ctx->temp_phase.channel[0];
   
-  // Assumir temperatura ambiente conhecida (ex: 25°C)
-  float ambient_temp = 25.0f;
-  calib.temp_offset = ambient_temp - avg_temp;
+  if (reference->count < TEMP_SAMPLES &&
+      !stats_converged(ctx, reference, TEMP_MIN_SAMPLES, TEMP_SEM_TARGET, &temp_prior_map)) {
+    return CALIB_STEP_PENDING;
+  }
+  
+  ctx->calib.temp_offset = stats_estimate(ctx, reference, &temp_prior_map);
   
   log_info("Temperature Calibration:");
-  log_info("  Average temperature: %.1f °C", avg_temp);
-  log_info("  Offset: %.1f °C", calib.temp_offset);
+  log_info("  Average temperature: %.1f °C", calibration_stats_mean(reference));
+  log_info("  Offset: %.1f °C", ctx->calib.temp_offset);
+  
+  // Em equilíbrio, todos os canais leem o ambiente; o slope é de fábrica
+  float reference_mean = ctx->ambient_temperature - ctx->calib.temp_offset;
+  for (uint8_t i = 0; i < ctx->temp_phase.channel_count; i++) {
+    float mean = (i == 0) ? reference_mean : calibration_stats_mean(&ctx->temp_phase.channel[i]);
+    float offset = ctx->ambient_temperature - ctx->thermal.slope[i] * mean;
+    
+    ctx->temp_phase.offset[i] = offset;
+    if (i > 0) {
+      log_info("  Channel %u: %.1f °C, offset %.1f °C", (unsigned)i, mean, offset);
+    }
+    if (fabsf(offset - ctx->thermal.offset[i]) > CALIB_TEMP_EQUILIBRIUM) {
+      log_warning("Temperature channel %u moved %.1f °C: robot may not be at thermal equilibrium",
+                  (unsigned)i, offset - ctx->thermal.offset[i]);
+    }
+  }
   
   log_info("Temperature calibration complete");
-  return true;
+  return CALIB_STEP_DONE;
+}
+
+/**
+ * @brief Calibrar Sensores de Temperatura
+ */
+bool calibrate_temperature_ctx(CalibrationContext_t *ctx) {
+  return run_phase_blocking(ctx, calibrate_temperature_begin_ctx,
+                            calibrate_temperature_step_ctx);
 }
 
+#endif // CALIB_WITH_TEMP
+
 // ============================================================================
 // VALIDAÇÃO
 // ============================================================================
 
 /**
- * @brief Validar calibração
+ * @brief Verificar as faixas de cada campo da calibração
  */
-bool validate_calibration(const SensorCalibration_t *calib) {
+static bool check_calibration_ranges(const SensorCalibration_t *calib) {
   log_info("Validating calibration data");
   
   // Magic number
@@ -501,9 +1784,9 @@ bool validate_calibration(const SensorCalibration_t *calib) {
   }
   
   // IMU
-  if (fabs(calib->imu_bias_x) > 5.0f ||
-      fabs(calib->imu_bias_y) > 5.0f ||
-      fabs(calib->imu_bias_z) > 5.0f) {
+  if (fabsf(calib->imu_bias_x) > 5.0f ||
+      fabsf(calib->imu_bias_y) > 5.0f ||
+      fabsf(calib->imu_bias_z) > 5.0f) {
     log_error("IMU bias out of range");
     return false;
   }
@@ -537,9 +1820,13 @@ bool validate_calibration(const SensorCalibration_t *calib) {
   }
   
   // LiDAR
-  if (fabs(calib->lidar_offset_distance) > 0.2f) {
+  if (fabsf(calib->lidar_offset_distance) > 0.2f) {
     log_warning("LiDAR offset large: %.3f m", calib->lidar_offset_distance);
   }
+
+  if (fabsf(calib->lidar_angle_offset) > 0.1f) {
+    log_warning("LiDAR angle offset large: %.3f rad", calib->lidar_angle_offset);
+  }
   
   // Câmera
   if (calib->camera_focal_length < 100.0f ||
@@ -552,151 +1839,529 @@ bool validate_calibration(const SensorCalibration_t *calib) {
   return true;
 }
 
-// ============================================================================
-// MÁQUINA DE ESTADOS
-// ============================================================================
+/**
+ * @brief Validar calibração
+ */
+bool validate_calibration_ctx(CalibrationContext_t *ctx, const SensorCalibration_t *calib) {
+  bool valid = check_calibration_ranges(calib);
+  
+  // Com prior de frota, só os sensores recalibrados na sequência são comparados
+  uint32_t sensors = (ctx->calib_state == CALIB_VALIDATE) ? ctx->calibration_mask
+                                                          : CALIB_SENSOR_MASK_SKU;
+  size_t field;
+  if (valid && !calibration_prior_check(&ctx->prior, calib, sensors, &field)) {
+    log_error("%s outside fleet prior for model %lu", calibration_prior_field_name(field),
+              (unsigned long)ctx->prior.model_id);
+    valid = false;
+  }
+  
+  ctx->metrics.validations++;
+  if (!valid) {
+    ctx->metrics.validation_failures++;
+  }
+  return valid;
+}
+
+// ============================================================================
+// MÁQUINA DE ESTADOS
+// ============================================================================
 
 /**
- * @brief Máquina de estados de calibração
+ * @brief Recursos exigidos por uma fase (compatibilidade de execução)
  */
-void calibration_state_machine(void) {
-  static uint32_t phase_start_time = 0;
+#define PHASE_NEEDS_STILL  0x01  ///< Robô deve estar imóvel
+#define PHASE_MOVES_ROBOT  0x02  ///< Fase move o robô (execução exclusiva)
+
+/**
+ * @brief Descritor estático de uma fase de calibração
+ *
+ * begin/step rodam durante a sequência; finalize (opcional) roda em
+ * CALIB_COMPLETE, após a calibração ser publicada. depends lista os
+ * sensores (CALIB_SENSOR_BIT) cuja fase precisa terminar antes desta
+ * iniciar, quando também selecionados na sequência; o finalize() delas
+ * também roda antes.
+ */
+typedef struct {
+  const char *name;
+  CalibrationSensor_t sensor;
+  CalibrationState_t running_state;
+  void (*begin)(CalibrationContext_t *ctx);
+  CalibrationStepResult_t (*step)(CalibrationContext_t *ctx);
+  void (*finalize)(CalibrationContext_t *ctx);
+  uint32_t timeout_ms;
+  uint32_t depends;
+  uint8_t flags;
+} CalibrationPhase_t;
+
+#if CALIB_WITH_IMU
+/**
+ * @brief Rebasear a estimativa de drift do giroscópio no novo bias
+ */
+static void imu_phase_finalize(CalibrationContext_t *ctx) {
+  bias_estimator_rebase(ctx);
+}
+#endif
+
+#if CALIB_WITH_ODOM
+/**
+ * @brief Rebasear o estimador de odometria na nova calibração
+ */
+static void odom_phase_finalize(CalibrationContext_t *ctx) {
+  odom_estimator_rebase(ctx);
+}
+#endif
+
+#if CALIB_WITH_LIDAR
+/**
+ * @brief Incorporar a nova calibração do LiDAR à deriva térmica
+ *
+ * calib_backup guarda o offset da calibração anterior, feita em
+ * thermal.lidar_temperature.
+ */
+static void lidar_phase_finalize(CalibrationContext_t *ctx) {
+  if (!temperature_read(ctx)) {
+    return;
+  }
   
-  switch (calib_state) {
-    case CALIB_IDLE:
-      if (calibration_requested) {
-        calib_state = CALIB_IMU_INIT;
-        phase_start_time = get_time_ms();
-        log_info("Starting calibration sequence");
-      }
-      break;
-    
-    case CALIB_IMU_INIT:
-      log_info("Initializing IMU calibration");
-      calib_state = CALIB_IMU_RUNNING;
-      phase_start_time = get_time_ms();
-      break;
-    
-    case CALIB_IMU_RUNNING:
-      if (calibrate_imu()) {
-        calib_state = CALIB_MAG_INIT;
-      } else {
-        calib_state = CALIB_ERROR;
-      }
-      break;
-    
-    case CALIB_MAG_INIT:
-      log_info("Initializing Magnetometer calibration");
-      calib_state = CALIB_MAG_RUNNING;
-      phase_start_time = get_time_ms();
-      break;
-    
-    case CALIB_MAG_RUNNING:
-      if (calibrate_magnetometer()) {
-        calib_state = CALIB_ODOM_INIT;
-      } else {
-        calib_state = CALIB_ERROR;
-      }
-      break;
-    
-    case CALIB_ODOM_INIT:
-      log_info("Initializing Odometer calibration");
-      calib_state = CALIB_ODOM_RUNNING;
-      phase_start_time = get_time_ms();
-      break;
-    
-    case CALIB_ODOM_RUNNING:
-      if (calibrate_odometer()) {
-        calib_state = CALIB_LIDAR_INIT;
-      } else {
-        calib_state = CALIB_ERROR;
-      }
-      break;
-    
-    case CALIB_LIDAR_INIT:
-      log_info("Initializing LiDAR calibration");
-      calib_state = CALIB_LIDAR_RUNNING;
-      phase_start_time = get_time_ms();
-      break;
-    
-    case CALIB_LIDAR_RUNNING:
-      if (calibrate_lidar()) {
-        calib_state = CALIB_CAMERA_INIT;
-      } else {
-        calib_state = CALIB_ERROR;
-      }
-      break;
-    
-    case CALIB_CAMERA_INIT:
-      log_info("Initializing Camera calibration");
-      calib_state = CALIB_CAMERA_RUNNING;
-      phase_start_time = get_time_ms();
+  if (thermal_lidar_learn(&ctx->thermal, ctx->calib_backup.lidar_offset_distance,
+                          ctx->calib.lidar_offset_distance,
+                          thermal_channel(&ctx->temp_calibrated, CALIB_TEMP_CHANNEL_LIDAR))) {
+    log_info("LiDAR thermal drift: %.2f mm/°C", ctx->thermal.lidar_drift * 1000.0f);
+  }
+  thermal_save(ctx);
+}
+#endif
+
+#if CALIB_WITH_TEMP
+/**
+ * @brief Aplicar os offsets dos canais de temperatura
+ */
+static void temp_phase_finalize(CalibrationContext_t *ctx) {
+  memcpy(ctx->thermal.offset, ctx->temp_phase.offset,
+         ctx->temp_phase.channel_count * sizeof(ctx->thermal.offset[0]));
+  ctx->thermal.channel_count = ctx->temp_phase.channel_count;
+  thermal_save(ctx);
+  kernel_refresh(ctx);
+}
+#endif
+
+// Ordem da tabela = ordem sequencial original, exceto onde depends adia
+// uma fase; o SKU define as linhas. O odômetro espera o bias do giroscópio
+// (a bitola online é ajustada contra o rumo da localização, que integra o
+// giroscópio) e o LiDAR espera os offsets de temperatura (o aprendizado da
+// deriva térmica lê a temperatura calibrada)
+static const CalibrationPhase_t phase_table[] = {
+#if CALIB_WITH_IMU
+  { .name = "IMU", .sensor = CALIB_SENSOR_IMU, .running_state = CALIB_IMU_RUNNING,
+    .begin = calibrate_imu_begin_ctx, .step = calibrate_imu_step_ctx,
+    .finalize = imu_phase_finalize, .timeout_ms = IMU_PHASE_TIMEOUT_MS,
+    .depends = 0, .flags = PHASE_NEEDS_STILL },
+#endif
+#if CALIB_WITH_MAG
+  { .name = "Magnetometer", .sensor = CALIB_SENSOR_MAG, .running_state = CALIB_MAG_RUNNING,
+    .begin = calibrate_magnetometer_begin_ctx, .step = calibrate_magnetometer_step_ctx,
+    .finalize = NULL, .timeout_ms = MAG_PHASE_TIMEOUT_MS,
+    .depends = 0, .flags = PHASE_MOVES_ROBOT },
+#endif
+#if CALIB_WITH_ODOM
+  { .name = "Odometer", .sensor = CALIB_SENSOR_ODOM, .running_state = CALIB_ODOM_RUNNING,
+    .begin = calibrate_odometer_begin_ctx, .step = calibrate_odometer_step_ctx,
+    .finalize = odom_phase_finalize, .timeout_ms = ODOM_PHASE_TIMEOUT_MS,
+    .depends = CALIB_SENSOR_BIT(CALIB_SENSOR_IMU), .flags = PHASE_MOVES_ROBOT },
+#endif
+#if CALIB_WITH_LIDAR
+  { .name = "LiDAR", .sensor = CALIB_SENSOR_LIDAR, .running_state = CALIB_LIDAR_RUNNING,
+    .begin = calibrate_lidar_begin_ctx, .step = calibrate_lidar_step_ctx,
+    .finalize = lidar_phase_finalize, .timeout_ms = LIDAR_PHASE_TIMEOUT_MS,
+    .depends = CALIB_SENSOR_BIT(CALIB_SENSOR_TEMP), .flags = PHASE_NEEDS_STILL },
+#endif
+#if CALIB_WITH_CAMERA
+  { .name = "Camera", .sensor = CALIB_SENSOR_CAMERA, .running_state = CALIB_CAMERA_RUNNING,
+    .begin = calibrate_camera_begin_ctx, .step = calibrate_camera_step_ctx,
+    .finalize = NULL, .timeout_ms = CAMERA_PHASE_TIMEOUT_MS,
+    .depends = 0, .flags = PHASE_NEEDS_STILL },
+#endif
+#if CALIB_WITH_BATTERY
+  { .name = "Battery", .sensor = CALIB_SENSOR_BATTERY, .running_state = CALIB_BATTERY_RUNNING,
+    .begin = calibrate_battery_begin_ctx, .step = calibrate_battery_step_ctx,
+    .finalize = NULL, .timeout_ms = BATTERY_PHASE_TIMEOUT_MS,
+    .depends = 0, .flags = 0 },
+#endif
+#if CALIB_WITH_TEMP
+  { .name = "Temperature", .sensor = CALIB_SENSOR_TEMP, .running_state = CALIB_TEMP_RUNNING,
+    .begin = calibrate_temperature_begin_ctx, .step = calibrate_temperature_step_ctx,
+    .finalize = temp_phase_finalize, .timeout_ms = TEMP_PHASE_TIMEOUT_MS,
+    .depends = 0, .flags = 0 },
+#endif
+};
+
+#define PHASE_COUNT (sizeof(phase_table) / sizeof(phase_table[0]))
+
+CALIB_STATIC_ASSERT(CALIB_PHASE_COUNT > 0, sku_has_a_calibrated_sensor);
+CALIB_STATIC_ASSERT(PHASE_COUNT == CALIB_PHASE_COUNT, phase_table_matches_context);
+
+#if CALIB_PARALLEL_THREADS
+/**
+ * @brief Ler o resultado publicado pelo worker
+ */
+static CalibrationStepResult_t runtime_result(PhaseRuntime_t *rt) {
+  pthread_mutex_lock(&rt->lock);
+  CalibrationStepResult_t result = (CalibrationStepResult_t)rt->result;
+  pthread_mutex_unlock(&rt->lock);
+  return result;
+}
+
+/**
+ * @brief Publicar o resultado do worker
+ */
+static void runtime_set_result(PhaseRuntime_t *rt, CalibrationStepResult_t result) {
+  pthread_mutex_lock(&rt->lock);
+  rt->result = result;
+  pthread_mutex_unlock(&rt->lock);
+}
+
+/**
+ * @brief Verificar se o worker foi cancelado
+ */
+static bool runtime_cancelled(PhaseRuntime_t *rt) {
+  pthread_mutex_lock(&rt->lock);
+  bool cancel = rt->cancel;
+  pthread_mutex_unlock(&rt->lock);
+  return cancel;
+}
+
+/**
+ * @brief Cancelar o worker e esperar que termine
+ */
+static void runtime_join(PhaseRuntime_t *rt) {
+  pthread_mutex_lock(&rt->lock);
+  rt->cancel = true;
+  pthread_mutex_unlock(&rt->lock);
+  pthread_join(rt->thread, NULL);
+  pthread_cond_destroy(&rt->begun_cond);
+  pthread_mutex_destroy(&rt->lock);
+}
+
+/**
+ * @brief Worker de uma fase: executa step() até concluir ou ser cancelado
+ *
+ * phase_start() espera o fim de begin(), como no caminho sequencial.
+ */
+static void *phase_worker(void *arg) {
+  PhaseRuntime_t *rt = (PhaseRuntime_t *)arg;
+  CalibrationContext_t *ctx = rt->ctx;
+  size_t i = (size_t)(rt - ctx->phase_runtime);
+  CalibrationStepResult_t result;
+  
+  phase_table[i].begin(ctx);
+  pthread_mutex_lock(&rt->lock);
+  rt->begun = true;
+  pthread_cond_signal(&rt->begun_cond);
+  pthread_mutex_unlock(&rt->lock);
+  
+  while ((result = phase_table[i].step(ctx)) == CALIB_STEP_PENDING) {
+    if (runtime_cancelled(rt)) {
       break;
-    
-    case CALIB_CAMERA_RUNNING:
-      if (calibrate_camera()) {
-        calib_state = CALIB_BATTERY_INIT;
-      } else {
-        calib_state = CALIB_ERROR;
+    }
+    ctx->drivers.delay_ms(ctx->drivers.user, CALIB_WORKER_POLL_MS);
+  }
+  
+  runtime_set_result(rt, result);
+  return NULL;
+}
+#endif
+
+/**
+ * @brief Verificar se uma fase pode iniciar junto às fases em execução
+ *
+ * Fases que movem o robô rodam sozinhas; fases que exigem robô imóvel
+ * podem rodar juntas; fases sem restrição só não convivem com movimento.
+ * Sem execução paralela, apenas uma fase roda por vez. Uma dependência
+ * selecionada ainda não concluída adia a fase.
+ */
+static bool phase_can_start(CalibrationContext_t *ctx, size_t index) {
+  uint8_t flags = phase_table[index].flags;
+  uint32_t depends = phase_table[index].depends;
+  
+  for (size_t i = 0; i < PHASE_COUNT; i++) {
+    if ((depends & CALIB_SENSOR_BIT(phase_table[i].sensor)) &&
+        ctx->phase_runtime[i].status != PHASE_DONE) {
+      return false;
+    }
+    if (ctx->phase_runtime[i].status != PHASE_RUNNING) {
+      continue;
+    }
+    if (!ctx->parallel_calibration || CALIB_PHASE_ARENA) {
+      return false;
+    }
+    if ((flags | phase_table[i].flags) & PHASE_MOVES_ROBOT) {
+      return false;
+    }
+  }
+  
+  return true;
+}
+
+/**
+ * @brief Iniciar uma fase (no tick atual ou em thread própria)
+ * @return false se a fase não pôde ser iniciada
+ */
+static bool phase_start(CalibrationContext_t *ctx, size_t index) {
+  PhaseRuntime_t *rt = &ctx->phase_runtime[index];
+  
+  rt->status = PHASE_RUNNING;
+  rt->start_time = time_ms(ctx);
+  ctx->metrics.phase_start_ms[phase_table[index].sensor] = rt->start_time;
+  
+#if CALIB_PARALLEL_THREADS
+  rt->result = CALIB_STEP_PENDING;
+  rt->cancel = false;
+  rt->begun = false;
+  rt->ctx = ctx;
+  pthread_mutex_init(&rt->lock, NULL);
+  pthread_cond_init(&rt->begun_cond, NULL);
+  if (pthread_create(&rt->thread, NULL, phase_worker, rt) != 0) {
+    pthread_cond_destroy(&rt->begun_cond);
+    pthread_mutex_destroy(&rt->lock);
+    log_error("Failed to start %s calibration thread", phase_table[index].name);
+    rt->status = PHASE_DONE;
+    ctx->failed_sensors |= CALIB_SENSOR_BIT(phase_table[index].sensor);
+    return false;
+  }
+  pthread_mutex_lock(&rt->lock);
+  while (!rt->begun) {
+    pthread_cond_wait(&rt->begun_cond, &rt->lock);
+  }
+  pthread_mutex_unlock(&rt->lock);
+#else
+  phase_table[index].begin(ctx);
+#endif
+  return true;
+}
+
+/**
+ * @brief Avançar uma fase em execução
+ */
+static CalibrationStepResult_t phase_poll(CalibrationContext_t *ctx, size_t index) {
+  PhaseRuntime_t *rt = &ctx->phase_runtime[index];
+  CalibrationStepResult_t result;
+  
+#if CALIB_PARALLEL_THREADS
+  result = runtime_result(rt);
+#else
+  result = phase_table[index].step(ctx);
+#endif
+  
+  if (result == CALIB_STEP_PENDING &&
+      (time_ms(ctx) - rt->start_time) > phase_table[index].timeout_ms) {
+    log_error("%s calibration timed out", phase_table[index].name);
+    result = CALIB_STEP_FAILED;
+  }
+  
+#if CALIB_PARALLEL_THREADS
+  if (result != CALIB_STEP_PENDING) {
+    runtime_join(rt);
+  }
+#endif
+  
+  if (result != CALIB_STEP_PENDING) {
+    rt->status = PHASE_DONE;
+    ctx->metrics.phase_end_ms[phase_table[index].sensor] = time_ms(ctx);
+  }
+  if (result == CALIB_STEP_FAILED) {
+    ctx->failed_sensors |= CALIB_SENSOR_BIT(phase_table[index].sensor);
+  }
+  return result;
+}
+
+/**
+ * @brief Cancelar fases em execução (após erro)
+ */
+static void phases_abort(CalibrationContext_t *ctx) {
+  for (size_t i = 0; i < PHASE_COUNT; i++) {
+#if CALIB_PARALLEL_THREADS
+    if (ctx->phase_runtime[i].status == PHASE_RUNNING) {
+      runtime_join(&ctx->phase_runtime[i]);
+    }
+#endif
+    ctx->phase_runtime[i].status = PHASE_DONE;
+  }
+}
+
+/**
+ * @brief Preparar as fases selecionadas para uma nova sequência
+ * @param mask Sensores a calibrar (CALIB_SENSOR_BIT)
+ */
+static void phases_reset(CalibrationContext_t *ctx, uint32_t mask) {
+  for (size_t i = 0; i < PHASE_COUNT; i++) {
+    bool selected = (mask & CALIB_SENSOR_BIT(phase_table[i].sensor)) != 0;
+    ctx->phase_runtime[i].status = selected ? PHASE_PENDING : PHASE_DONE;
+  }
+  ctx->failed_sensors = 0;
+}
+
+/**
+ * @brief Executar os finalize() das fases selecionadas, dependências primeiro
+ *
+ * Em ordem de tabela entre fases independentes; cada passada executa as
+ * fases cujas dependências selecionadas já foram finalizadas (a tabela não
+ * tem ciclos, então PHASE_COUNT passadas bastam).
+ * @param mask Sensores calibrados (CALIB_SENSOR_BIT)
+ */
+static void phases_finalize(CalibrationContext_t *ctx, uint32_t mask) {
+  uint32_t finalized = 0;
+  
+  for (size_t pass = 0; pass < PHASE_COUNT && (mask & ~finalized) != 0; pass++) {
+    for (size_t i = 0; i < PHASE_COUNT; i++) {
+      uint32_t bit = CALIB_SENSOR_BIT(phase_table[i].sensor);
+      if (!(mask & bit) || (finalized & bit) ||
+          (phase_table[i].depends & mask & ~finalized) != 0) {
+        continue;
       }
-      break;
-    
-    case CALIB_BATTERY_INIT:
-      log_info("Initializing Battery calibration");
-      calib_state = CALIB_BATTERY_RUNNING;
-      phase_start_time = get_time_ms();
-      break;
-    
-    case CALIB_BATTERY_RUNNING:
-      if (calibrate_battery()) {
-        calib_state = CALIB_TEMP_INIT;
-      } else {
-        calib_state = CALIB_ERROR;
+      if (phase_table[i].finalize != NULL) {
+        phase_table[i].finalize(ctx);
       }
-      break;
+      finalized |= bit;
+    }
+  }
+}
+
+/**
+ * @brief Registrar metadados dos sensores recalibrados e consolidar o status
+ *
+ * A calibração global só passa a válida quando todos os sensores do SKU
+ * têm calibração válida; uma recalibração parcial sobre um conjunto
+ * inválido mantém o status anterior.
+ */
+static void update_sensor_meta(CalibrationContext_t *ctx, uint32_t mask, uint32_t now) {
+  bool all_valid = true;
+  
+  for (int i = 0; i < CALIB_SENSOR_COUNT; i++) {
+    CalibrationSensorMeta_t *meta = &ctx->calib_ext.sensor_meta[i];
     
-    case CALIB_TEMP_INIT:
-      log_info("Initializing Temperature calibration");
-      calib_state = CALIB_TEMP_RUNNING;
-      phase_start_time = get_time_ms();
+    if (mask & CALIB_SENSOR_BIT(i)) {
+      meta->timestamp = now;
+      meta->calibration_count++;
+      meta->status = CALIB_VALID;
+    }
+    if ((CALIB_SENSOR_MASK_SKU & CALIB_SENSOR_BIT(i)) && meta->status != CALIB_VALID) {
+      all_valid = false;
+    }
+  }
+  
+  if (all_valid) {
+    ctx->calib.status = CALIB_VALID;
+  }
+}
+
+/**
+ * @brief Um tick do escalonador de fases
+ * @return Próximo estado: RUNNING da primeira fase ativa, VALIDATE ou ERROR
+ */
+static CalibrationState_t phases_tick(CalibrationContext_t *ctx) {
+  CalibrationState_t reported = CALIB_VALIDATE;
+  
+  // Iniciar fases compatíveis, em ordem de tabela
+  for (size_t i = 0; i < PHASE_COUNT; i++) {
+    if (ctx->phase_runtime[i].status == PHASE_PENDING && phase_can_start(ctx, i) &&
+        !phase_start(ctx, i)) {
+      phases_abort(ctx);
+      return CALIB_ERROR;
+    }
+  }
+  
+  // Avançar fases em execução
+  for (size_t i = 0; i < PHASE_COUNT; i++) {
+    if (ctx->phase_runtime[i].status != PHASE_RUNNING) {
+      continue;
+    }
+    if (phase_poll(ctx, i) == CALIB_STEP_FAILED) {
+      phases_abort(ctx);
+      return CALIB_ERROR;
+    }
+  }
+  
+  // Estado reportado: primeira fase em execução; sem nenhuma (iniciando no
+  // próximo tick), a primeira ainda não concluída
+  for (size_t i = 0; i < PHASE_COUNT; i++) {
+    if (ctx->phase_runtime[i].status == PHASE_RUNNING) {
+      reported = phase_table[i].running_state;
       break;
-    
-    case CALIB_TEMP_RUNNING:
-      if (calibrate_temperature()) {
-        calib_state = CALIB_VALIDATE;
-      } else {
-        calib_state = CALIB_ERROR;
+    }
+    if (ctx->phase_runtime[i].status == PHASE_PENDING && reported == CALIB_VALIDATE) {
+      reported = phase_table[i].running_state;
+    }
+  }
+  
+  return reported;
+}
+
+/**
+ * @brief Máquina de estados de calibração
+ * Cada chamada executa no máximo um passo de cada fase ativa e retorna
+ */
+void calibration_state_machine_ctx(CalibrationContext_t *ctx) {
+  switch (ctx->calib_state) {
+    case CALIB_IDLE:
+      if (ctx->calibration_requested) {
+        phases_reset(ctx, ctx->calibration_mask);
+        ctx->calib_backup = ctx->calib;
+        ctx->calib_ext_backup = ctx->calib_ext;
+        ctx->calib_state = CALIB_IMU_INIT;
+        log_info("Starting calibration sequence (sensors 0x%02lx%s)",
+                 (unsigned long)ctx->calibration_mask,
+                 ctx->parallel_calibration ? ", parallel" : "");
       }
       break;
     
     case CALIB_VALIDATE:
-      if (validate_calibration(&calib)) {
-        calib_state = CALIB_COMPLETE;
+      if (validate_calibration_ctx(ctx, &ctx->calib)) {
+        ctx->calib_state = CALIB_COMPLETE;
       } else {
-        calib_state = CALIB_ERROR;
+        ctx->calib_state = CALIB_ERROR;
       }
       break;
     
     case CALIB_COMPLETE:
       log_info("Calibration complete!");
-      calib.status = CALIB_VALID;
-      calib.timestamp = get_time_ms();
-      calib.calibration_count++;
-      save_calibration_to_eeprom(&calib);
-      calib_state = CALIB_IDLE;
-      calibration_requested = false;
+      ctx->calib.timestamp = time_ms(ctx);
+      ctx->calib.calibration_count++;
+      update_sensor_meta(ctx, ctx->calibration_mask, ctx->calib.timestamp);
+      write_calibration_record(ctx, &ctx->calib, true);  // Validada em CALIB_VALIDATE
+      save_calibration_ext_to_eeprom_ctx(ctx, &ctx->calib_ext);
+      calibration_commit(ctx);
+      phases_finalize(ctx, ctx->calibration_mask);
+      ctx->calib_state = CALIB_IDLE;
+      ctx->calibration_requested = false;
       break;
     
     case CALIB_ERROR:
       log_error("Calibration error!");
-      calib.status = CALIB_INVALID;
-      calib_state = CALIB_IDLE;
-      calibration_requested = false;
+      // Descartar os resultados da sequência: a cópia de trabalho tem uma
+      // mistura de valores novos e antigos, que não pode ser publicada
+      ctx->calib = ctx->calib_backup;
+      ctx->calib_ext = ctx->calib_ext_backup;
+      if (ctx->calibration_mask == CALIB_SENSOR_MASK_SKU) {
+        ctx->calib.status = CALIB_INVALID;
+      }
+      for (int i = 0; i < CALIB_SENSOR_COUNT; i++) {
+        if (ctx->failed_sensors & CALIB_SENSOR_BIT(i)) {
+          ctx->calib_ext.sensor_meta[i].status = CALIB_INVALID;
+        }
+      }
+      calibration_commit(ctx);
+      ctx->calib_state = CALIB_IDLE;
+      ctx->calibration_requested = false;
       break;
     
     default:
-      log_error("Unknown calibration state: %d", calib_state);
-      calib_state = CALIB_IDLE;
+      // CALIB_*_INIT/RUNNING: o escalonador da tabela conduz todas as fases
+      if (ctx->calib_state > CALIB_IDLE && ctx->calib_state < CALIB_VALIDATE) {
+        ctx->calib_state = phases_tick(ctx);
+        break;
+      }
+      log_error("Unknown calibration state: %d", ctx->calib_state);
+      ctx->calib_state = CALIB_IDLE;
       break;
   }
 }
@@ -705,30 +2370,84 @@ void calibration_state_machine(void) {
 // PERSISTÊNCIA
 // ============================================================================
 
+/**
+ * @brief Gravar calibração no armazenamento journaled
+ * @param validated true se o registro já passou por validate_calibration()
+ */
+static void write_calibration_record(CalibrationContext_t *ctx, const SensorCalibration_t *calib,
+                                     bool validated) {
+  size_t written = store_save_measured(ctx, CALIB_RECORD_BASE, calib, CALIB_EEPROM_SIZE,
+                                       CALIB_LAYOUT_ID,
+                                       validated ? CALIB_STORE_FLAG_VALIDATED : 0);
+  log_info("Calibration saved to EEPROM (%d bytes written)", (int)written);
+}
+
+/**
+ * @brief Ler calibração sem logs
+ * Slot journaled mais recente; sem journal, registro legado em CALIB_EEPROM_ADDR
+ * @param flags Flags do slot (0 para o registro legado)
+ * @return true se o registro lido for válido
+ */
+static bool read_calibration_record(CalibrationContext_t *ctx, SensorCalibration_t *calib,
+                                    uint8_t *flags) {
+  if (!calibration_store_load(&ctx->store, CALIB_RECORD_BASE, calib, CALIB_EEPROM_SIZE,
+                              CALIB_LAYOUT_ID, flags)) {
+    *flags = 0;
+    ctx->drivers.eeprom_read(ctx->drivers.user, CALIB_EEPROM_ADDR, (uint8_t *)calib,
+                             CALIB_EEPROM_SIZE);
+  }
+  
+  return calib->status == CALIB_VALID && calib->magic == CALIB_MAGIC;
+}
+
 /**
  * @brief Salvar calibração em EEPROM
  */
-void save_calibration_to_eeprom(const SensorCalibration_t *calib) {
-  eeprom_write(CALIB_EEPROM_ADDR, (const uint8_t *)calib, CALIB_EEPROM_SIZE);
-  log_info("Calibration saved to EEPROM");
+void save_calibration_to_eeprom_ctx(CalibrationContext_t *ctx, const SensorCalibration_t *calib) {
+  write_calibration_record(ctx, calib, false);
 }
 
 /**
  * @brief Carregar calibração da EEPROM
  */
-void load_calibration_from_eeprom(SensorCalibration_t *calib) {
-  eeprom_read(CALIB_EEPROM_ADDR, (uint8_t *)calib, CALIB_EEPROM_SIZE);
+void load_calibration_from_eeprom_ctx(CalibrationContext_t *ctx, SensorCalibration_t *calib) {
+  uint8_t flags;
   
-  if (calib->status == CALIB_VALID && calib->magic == CALIB_MAGIC) {
+  if (read_calibration_record(ctx, calib, &flags)) {
     log_info("Calibration loaded from EEPROM (count: %d, age: %d seconds)",
              calib->calibration_count, 
-             (get_time_ms() - calib->timestamp) / 1000);
+             (time_ms(ctx) - calib->timestamp) / 1000);
   } else {
     log_warning("Calibration data invalid, using defaults");
     init_default_calibration(calib);
   }
 }
 
+/**
+ * @brief Salvar extensões de calibração em EEPROM
+ */
+void save_calibration_ext_to_eeprom_ctx(CalibrationContext_t *ctx,
+                                        const SensorCalibrationExt_t *ext) {
+  store_save_measured(ctx, CALIB_RECORD_EXT, ext, CALIB_EXT_EEPROM_SIZE,
+                      CALIB_EXT_LAYOUT_ID, 0);
+}
+
+/**
+ * @brief Carregar extensões de calibração da EEPROM
+ */
+void load_calibration_ext_from_eeprom_ctx(CalibrationContext_t *ctx, SensorCalibrationExt_t *ext) {
+  if (!calibration_store_load(&ctx->store, CALIB_RECORD_EXT, ext, CALIB_EXT_EEPROM_SIZE,
+                              CALIB_EXT_LAYOUT_ID, NULL)) {
+    ctx->drivers.eeprom_read(ctx->drivers.user, CALIB_EXT_EEPROM_ADDR, (uint8_t *)ext,
+                             CALIB_EXT_EEPROM_SIZE);
+  }
+  
+  if (ext->magic != CALIB_EXT_MAGIC) {
+    log_warning("Calibration extension data invalid, using defaults");
+    init_default_calibration_ext(ext);
+  }
+}
+
 // ============================================================================
 // INTERFACE PÚBLICA
 // ============================================================================
@@ -736,101 +2455,1118 @@ void load_calibration_from_eeprom(SensorCalibration_t *calib) {
 /**
  * @brief Solicitar calibração
  */
-void request_calibration(void) {
-  if (calib_state != CALIB_IDLE) {
+void request_calibration_ctx(CalibrationContext_t *ctx) {
+  request_calibration_mask_ctx(ctx, CALIB_SENSOR_MASK_SKU);
+}
+
+/**
+ * @brief Solicitar calibração apenas dos sensores selecionados
+ */
+void request_calibration_mask_ctx(CalibrationContext_t *ctx, uint32_t sensors) {
+  if (ctx->calib_state != CALIB_IDLE) {
     log_warning("Calibration already in progress");
     return;
   }
   
-  calibration_requested = true;
-  log_info("Calibration requested");
+  sensors &= CALIB_SENSOR_MASK_SKU;
+  if (sensors == 0) {
+    log_warning("Calibration requested with no sensor present in this build");
+    return;
+  }
+  
+  ctx->calibration_mask = sensors;
+  ctx->calibration_requested = true;
+  log_info("Calibration requested (sensors 0x%02lx)", (unsigned long)sensors);
 }
 
 /**
- * @brief Obter estado atual da calibração
+ * @brief Obter metadados de calibração de um sensor
  */
-CalibrationState_t get_calibration_state(void) {
-  return calib_state;
+const CalibrationSensorMeta_t *get_sensor_calibration_meta_ctx(const CalibrationContext_t *ctx,
+                                                               CalibrationSensor_t sensor) {
+  if ((int)sensor < 0 || sensor >= CALIB_SENSOR_COUNT) {
+    return NULL;
+  }
+  return &ctx->calib_ext.sensor_meta[sensor];
 }
 
 /**
- * @brief Obter dados de calibração
+ * @brief Ativar/desativar amostragem adaptativa
  */
-const SensorCalibration_t *get_calibration_data(void) {
-  return &calib;
+void set_calibration_adaptive_ctx(CalibrationContext_t *ctx, bool enabled) {
+  ctx->adaptive_sampling = enabled;
+  log_info("Adaptive sampling %s", enabled ? "enabled" : "disabled");
 }
 
 /**
- * @brief Verificar se calibração é válida
+ * @brief Verificar se a amostragem adaptativa está ativa
  */
-bool is_calibration_valid(void) {
-  return calib.status == CALIB_VALID;
+bool is_calibration_adaptive_ctx(const CalibrationContext_t *ctx) {
+  return ctx->adaptive_sampling;
 }
 
 /**
- * @brief Obter tempo desde última calibração (segundos)
+ * @brief Ativar/desativar execução paralela de fases independentes
  */
-uint32_t get_calibration_age_seconds(void) {
-  return (get_time_ms() - calib.timestamp) / 1000;
+void set_calibration_parallel_ctx(CalibrationContext_t *ctx, bool enabled) {
+  if (ctx->calib_state != CALIB_IDLE) {
+    log_warning("Cannot change parallel mode during calibration");
+    return;
+  }
+#if CALIB_PHASE_ARENA
+  if (enabled) {
+    log_warning("Parallel calibration unavailable: phases share one arena");
+    return;
+  }
+#endif
+  ctx->parallel_calibration = enabled;
+  log_info("Parallel calibration %s", enabled ? "enabled" : "disabled");
 }
 
 /**
- * @brief Resetar calibração para padrão
+ * @brief Verificar se a execução paralela está ativa
  */
-void reset_calibration_to_default(void) {
-  init_default_calibration(&calib);
-  save_calibration_to_eeprom(&calib);
-  log_info("Calibration reset to default");
+bool is_calibration_parallel_ctx(const CalibrationContext_t *ctx) {
+  return ctx->parallel_calibration;
 }
 
-// ============================================================================
-// MONITORAMENTO CONTÍNUO
-// ============================================================================
+/**
+ * @brief Obter estado atual da calibração
+ */
+CalibrationState_t get_calibration_state_ctx(const CalibrationContext_t *ctx) {
+  return ctx->calib_state;
+}
 
 /**
- * @brief Monitorar desvio de sensores
- * Executar periodicamente (a cada 1 hora)
+ * @brief Obter dados de calibração
  */
-void monitor_sensor_drift(void) {
-  static uint32_t last_check = 0;
-  uint32_t now = get_time_ms();
-  
-  // Verificar a cada 1 hora
-  if ((now - last_check) < 3600000) {
-    return;
-  }
-  
-  last_check = now;
-  
-  log_info("Monitoring sensor drift");
-  
-  // Ler sensores
-  if (!read_imu_raw(&imu_data)) {
-    return;
-  }
-  
-  // Comparar com calibração
-  float imu_drift_x = fabs(imu_data.ax - calib.imu_bias_x);
-  float imu_drift_y = fabs(imu_data.ay - calib.imu_bias_y);
-  float imu_drift_z = fabs(imu_data.az - calib.imu_bias_z);
-  
-  log_info("IMU drift: (%.3f, %.3f, %.3f) m/s²", 
-           imu_drift_x, imu_drift_y, imu_drift_z);
-  
-  // Se desvio > 2.0, marcar para recalibração
-  if (imu_drift_x > 2.0f || imu_drift_y > 2.0f || imu_drift_z > 2.0f) {
-    log_warning("IMU drift detected, recalibration recommended");
-    calib.status = CALIB_NEEDS_RECALIBRATION;
-  }
+const SensorCalibration_t *get_calibration_data_ctx(const CalibrationContext_t *ctx) {
+  return &ctx->calib;
 }
 
 /**
- * @brief Atualizar máquina de estados (chamar periodicamente)
+ * @brief Obter extensões de calibração
  */
-void calibration_update(void) {
-  calibration_state_machine();
-  monitor_sensor_drift();
+const SensorCalibrationExt_t *get_calibration_ext_data_ctx(const CalibrationContext_t *ctx) {
+  return &ctx->calib_ext;
+}
+
+/**
+ * @brief Copiar a última calibração confirmada
+ */
+uint32_t get_calibration_snapshot_ctx(const CalibrationContext_t *ctx, SensorCalibration_t *calib,
+                                      SensorCalibrationExt_t *ext) {
+  return calibration_snapshot_read(&ctx->published, calib, ext);
+}
+
+/**
+ * @brief Obter a geração da calibração confirmada
+ */
+uint32_t get_calibration_generation_ctx(const CalibrationContext_t *ctx) {
+  return calibration_snapshot_generation(&ctx->published);
+}
+
+#if CALIB_WIRE_SYNC
+/**
+ * @brief Codificar a calibração confirmada para o app (delta sobre a última confirmada)
+ */
+size_t get_calibration_wire_ctx(CalibrationContext_t *ctx, uint8_t *out, size_t out_size) {
+  return calibration_wire_sync_encode(&ctx->wire, &ctx->published, out, out_size);
+}
+
+/**
+ * @brief Registrar a geração confirmada pelo app
+ */
+bool calibration_wire_acknowledge_ctx(CalibrationContext_t *ctx, uint32_t generation) {
+  return calibration_wire_sync_acknowledge(&ctx->wire, generation);
+}
+
+/**
+ * @brief Enviar a calibração completa na próxima mensagem
+ */
+void calibration_wire_request_full_ctx(CalibrationContext_t *ctx) {
+  calibration_wire_sync_reset(&ctx->wire);
+}
+#endif
+
+/**
+ * @brief Obter a instrumentação da calibração
+ */
+const CalibrationMetrics_t *get_calibration_metrics_ctx(const CalibrationContext_t *ctx) {
+  return &ctx->metrics;
+}
+
+/**
+ * @brief Obter os coeficientes fundidos da calibração
+ */
+const CalibrationApplyKernel_t *get_calibration_apply_kernel_ctx(const CalibrationContext_t *ctx) {
+  return &ctx->kernel;
+}
+
+/**
+ * @brief Zerar a instrumentação
+ */
+void reset_calibration_metrics_ctx(CalibrationContext_t *ctx) {
+  calibration_metrics_init(&ctx->metrics);
+}
+
+/**
+ * @brief Verificar se calibração é válida
+ */
+bool is_calibration_valid_ctx(const CalibrationContext_t *ctx) {
+  return ctx->calib.status == CALIB_VALID;
+}
+
+/**
+ * @brief Obter tempo desde última calibração (segundos)
+ */
+uint32_t get_calibration_age_seconds_ctx(const CalibrationContext_t *ctx) {
+  return (time_ms(ctx) - ctx->calib.timestamp) / 1000;
+}
+
+/**
+ * @brief Resetar calibração para padrão
+ */
+void reset_calibration_to_default_ctx(CalibrationContext_t *ctx) {
+  init_default_calibration(&ctx->calib);
+  init_default_calibration_ext(&ctx->calib_ext);
+  save_calibration_to_eeprom_ctx(ctx, &ctx->calib);
+  save_calibration_ext_to_eeprom_ctx(ctx, &ctx->calib_ext);
+  ctx->thermal.lidar_referenced = false;  // Offset do LiDAR de volta ao padrão
+  thermal_save(ctx);
+  calibration_commit(ctx);
+  bias_estimator_rebase(ctx);
+  odom_estimator_rebase(ctx);
+  log_info("Calibration reset to default");
+}
+
+/**
+ * @brief Importar o prior de frota do modelo do robô
+ *
+ * Um robô ainda sem calibração válida passa a usar as medianas da frota.
+ */
+bool calibration_import_prior_ctx(CalibrationContext_t *ctx, const uint8_t *data, size_t len) {
+  CalibrationPrior_t prior;
+  CalibrationWireResult_t result = calibration_wire_decode_prior(data, len, &prior);
+
+  if (result != CALIB_WIRE_OK) {
+    log_error("Fleet prior rejected (wire error %d)", (int)result);
+    return false;
+  }
+  if (CALIB_ROBOT_MODEL_ID != 0 && prior.model_id != CALIB_ROBOT_MODEL_ID) {
+    log_error("Fleet prior for model %lu ignored (robot model %lu)",
+              (unsigned long)prior.model_id, (unsigned long)CALIB_ROBOT_MODEL_ID);
+    return false;
+  }
+
+  ctx->prior = prior;
+  log_info("Fleet prior loaded: model %lu, %lu robots",
+           (unsigned long)prior.model_id, (unsigned long)prior.robots);
+
+  if (ctx->calib.status != CALIB_VALID) {
+    calibration_prior_seed(&ctx->prior, &ctx->calib);
+    calibration_commit(ctx);
+    bias_estimator_rebase(ctx);
+    odom_estimator_rebase(ctx);
+    log_info("Uncalibrated robot seeded from fleet prior");
+  }
+  return true;
+}
+
+/**
+ * @brief Descartar o prior de frota
+ */
+void calibration_clear_prior_ctx(CalibrationContext_t *ctx) {
+  calibration_prior_reset(&ctx->prior);
+}
+
+// ============================================================================
+// MONITORAMENTO CONTÍNUO
+// ============================================================================
+
+/**
+ * @brief Instante de uma amostra em ms na base de tempo em µs da instância
+ *
+ * A base em µs pode vir de drivers.get_time_us, que não é múltiplo de
+ * get_time_ms(): a amostra é posicionada pela idade em relação a agora.
+ */
+static uint64_t sample_time_us(const CalibrationContext_t *ctx, uint32_t stamp_ms) {
+  uint32_t age_ms = time_ms(ctx) - stamp_ms;
+
+  if ((int32_t)age_ms < 0) {
+    age_ms = 0;  // Timestamp à frente do relógio: tratar como agora
+  }
+  return get_calibration_time_us_ctx(ctx) - (uint64_t)age_ms * 1000u;
+}
+
+/**
+ * @brief Passar uma amostra ao estimador de bias
+ *
+ * Com o stream de encoders ativo, amostras até WHEELS_MOTION_HOLD_US
+ * depois da última mudança de contagem contam como movimento: em
+ * velocidade constante o IMU parece parado. A comparação é feita na base
+ * de tempo dos streams (get_calibration_time_us()).
+ */
+static void bias_estimator_feed(CalibrationContext_t *ctx, const IMUData_t *sample) {
+  if (ctx->wheels_streamed &&
+      sample_time_us(ctx, sample->timestamp) - ctx->wheels_motion_us < WHEELS_MOTION_HOLD_US) {
+    calibration_bias_reject(&ctx->bias_estimator);
+    return;
+  }
+  calibration_bias_update(&ctx->bias_estimator, sample);
+}
+
+/**
+ * @brief Alimentar o estimador de bias com uma amostra bruta do IMU
+ * Chamar no caminho de aquisição (custo fixo por amostra)
+ */
+void calibration_feed_imu_ctx(CalibrationContext_t *ctx, const IMUData_t *sample) {
+  // Durante a calibração a referência ainda vai mudar
+  if (ctx->calib_state == CALIB_IDLE) {
+    bias_estimator_feed(ctx, sample);
+  }
+  ctx->last_imu_feed_time = time_ms(ctx);
+  ctx->imu_fed_externally = true;
+}
+
+/**
+ * @brief Alimentar o monitoramento com uma rajada de amostras do IMU
+ */
+void calibration_feed_imu_burst_ctx(CalibrationContext_t *ctx, const IMUData_t *samples,
+                                    size_t count) {
+  if (ctx->calib_state == CALIB_IDLE) {
+    for (size_t i = 0; i < count; i++) {
+      bias_estimator_feed(ctx, &samples[i]);
+    }
+  }
+  ctx->last_imu_feed_time = time_ms(ctx);
+  ctx->imu_fed_externally = true;
+}
+
+/**
+ * @brief Sinalizar dados novos na FIFO do IMU
+ */
+void calibration_notify_imu_fifo_ctx(CalibrationContext_t *ctx) {
+  ctx->imu_fifo.notified++;
+}
+
+/**
+ * @brief Sinalizar dados novos na FIFO do Magnetômetro
+ */
+void calibration_notify_mag_fifo_ctx(CalibrationContext_t *ctx) {
+  ctx->mag_fifo.notified++;
+}
+
+/**
+ * @brief Obter o bias estimado online
+ */
+bool get_imu_bias_estimate_ctx(const CalibrationContext_t *ctx, float acc_bias[3],
+                               float gyro_bias[3]) {
+  memcpy(acc_bias, ctx->bias_estimator.acc_bias, sizeof(ctx->bias_estimator.acc_bias));
+  memcpy(gyro_bias, ctx->bias_estimator.gyro_bias, sizeof(ctx->bias_estimator.gyro_bias));
+  return calibration_bias_has_evidence(&ctx->bias_estimator);
+}
+
+/**
+ * @brief Obter o bias do giroscópio compensado em temperatura
+ */
+void get_gyro_bias_for_temperature_ctx(const CalibrationContext_t *ctx, float temperature,
+                                       float bias[3]) {
+  if (!gyro_temp_lut_interpolate(ctx->calib_ext.gyro_temp_lut, temperature, bias)) {
+    memcpy(bias, ctx->calib_ext.gyro_bias, sizeof(ctx->calib_ext.gyro_bias));
+  }
+}
+
+/**
+ * @brief Obter a última leitura de temperatura corrigida por canal
+ */
+bool get_temperature_channels_ctx(const CalibrationContext_t *ctx, TemperatureData_t *data) {
+  if (!ctx->temp_valid) {
+    return false;
+  }
+  
+  *data = ctx->temp_calibrated;
+  return true;
+}
+
+/**
+ * @brief Informar a temperatura ambiente para a próxima fase de temperatura
+ */
+void set_ambient_temperature_ctx(CalibrationContext_t *ctx, float temperature) {
+  ctx->ambient_temperature = temperature;
+}
+
+/**
+ * @brief Gravar a correção de fábrica de um canal de temperatura
+ */
+bool set_temperature_channel_calibration_ctx(CalibrationContext_t *ctx, uint8_t channel,
+                                             float slope, float offset) {
+  CalibrationThermal_t thermal = ctx->thermal;
+  
+  if (channel >= CALIB_TEMP_CHANNELS) {
+    return false;
+  }
+  
+  thermal.slope[channel] = slope;
+  thermal.offset[channel] = offset;
+  if (!thermal_model_valid(&thermal)) {
+    log_error("Temperature channel %u calibration out of range", (unsigned)channel);
+    return false;
+  }
+  
+  ctx->thermal = thermal;
+  thermal_save(ctx);
+  kernel_refresh(ctx);
+  return true;
+}
+
+/**
+ * @brief Compensação térmica do giroscópio e do LiDAR
+ *
+ * A cada GYRO_TEMP_INTERVAL_MS: com o robô em repouso, incorpora o bias
+ * estimado online ao ponto da temperatura do IMU; em seguida aplica ao
+ * kernel o bias interpolado (também referência do detector de desvio) e
+ * o offset do LiDAR na temperatura do LiDAR. A tabela é persistida no
+ * máximo a cada GYRO_LUT_SAVE_INTERVAL_MS.
+ */
+static void thermal_update(CalibrationContext_t *ctx, uint32_t now) {
+  float bias[3];
+  
+  if (!time_reached(now, ctx->gyro_next_update)) {
+    return;
+  }
+  ctx->gyro_next_update = now + GYRO_TEMP_INTERVAL_MS;
+  
+  if (!temperature_read(ctx)) {
+    return;
+  }
+  
+  float imu_temp = thermal_channel(&ctx->temp_calibrated, CALIB_TEMP_CHANNEL_IMU);
+  if (calibration_bias_is_still(&ctx->bias_estimator) &&
+      calibration_bias_has_evidence(&ctx->bias_estimator) &&
+      gyro_temp_lut_update(ctx->calib_ext.gyro_temp_lut, imu_temp,
+                           ctx->bias_estimator.gyro_bias)) {
+    ctx->gyro_lut_dirty = true;
+    calibration_snapshot_publish(&ctx->published, &ctx->calib, &ctx->calib_ext);
+  }
+  
+  get_gyro_bias_for_temperature_ctx(ctx, imu_temp, bias);
+  calibration_apply_prepare_gyro_bias(&ctx->kernel, bias);
+  calibration_apply_prepare_lidar_offset(
+      &ctx->kernel,
+      thermal_lidar_offset(&ctx->thermal, ctx->calib.lidar_offset_distance,
+                           thermal_channel(&ctx->temp_calibrated, CALIB_TEMP_CHANNEL_LIDAR)));
+  kernel_publish(ctx);
+  calibration_bias_set_gyro_reference(&ctx->bias_estimator, bias);
+  
+  if (ctx->gyro_lut_dirty && (now - ctx->gyro_lut_saved_time) >= GYRO_LUT_SAVE_INTERVAL_MS) {
+    save_calibration_ext_to_eeprom_ctx(ctx, &ctx->calib_ext);
+    ctx->gyro_lut_saved_time = now;
+    ctx->gyro_lut_dirty = false;
+  }
+}
+
+/**
+ * @brief Alimentar o calibrador de odometria
+ *
+ * A cada trecho incorporado, se a estimativa convergiu e difere da
+ * calibração em mais de ODOM_COMMIT_TOLERANCE, ela passa a valer
+ * imediatamente; a gravação fica para odometry_persist(ctx).
+ */
+void calibration_feed_odometry_ctx(CalibrationContext_t *ctx, const EncoderData_t *encoder,
+                                   const PoseData_t *pose) {
+  float ppm_left, ppm_right, wheel_base;
+  
+  // A fase dedicada move o robô e reescreve a referência
+  if (ctx->calib_state != CALIB_IDLE) {
+    calibration_odom_break_segment(&ctx->odom_estimator);
+    return;
+  }
+  
+  if (!calibration_odom_update(&ctx->odom_estimator, encoder, pose) ||
+      !calibration_odom_converged(&ctx->odom_estimator)) {
+    return;
+  }
+  
+  calibration_odom_get(&ctx->odom_estimator, &ppm_left, &ppm_right, &wheel_base);
+  if (ppm_left < 500.0f || ppm_left > 2000.0f ||
+      ppm_right < 500.0f || ppm_right > 2000.0f ||
+      wheel_base < ODOM_WHEEL_BASE_MIN || wheel_base > ODOM_WHEEL_BASE_MAX) {
+    return;  // Mesma faixa de validate_calibration()
+  }
+  
+  if (fabsf(ppm_left - ctx->calib.pulses_per_meter_left) >
+          ODOM_COMMIT_TOLERANCE * ctx->calib.pulses_per_meter_left ||
+      fabsf(ppm_right - ctx->calib.pulses_per_meter_right) >
+          ODOM_COMMIT_TOLERANCE * ctx->calib.pulses_per_meter_right ||
+      fabsf(wheel_base - ctx->calib_ext.wheel_base) >
+          ODOM_COMMIT_TOLERANCE * ctx->calib_ext.wheel_base) {
+    ctx->calib.pulses_per_meter_left = ppm_left;
+    ctx->calib.pulses_per_meter_right = ppm_right;
+    ctx->calib_ext.wheel_base = wheel_base;
+    ctx->odom_dirty = true;
+    calibration_snapshot_publish(&ctx->published, &ctx->calib, &ctx->calib_ext);
+  }
+}
+
+/**
+ * @brief Descartar o trecho de odometria em andamento
+ */
+void calibration_odometry_break_ctx(CalibrationContext_t *ctx) {
+  calibration_odom_break_segment(&ctx->odom_estimator);
+}
+
+/**
+ * @brief Obter a estimativa online do odômetro
+ */
+bool get_odometry_estimate_ctx(const CalibrationContext_t *ctx, float *ppm_left, float *ppm_right,
+                               float *wheel_base) {
+  calibration_odom_get(&ctx->odom_estimator, ppm_left, ppm_right, wheel_base);
+  return calibration_odom_converged(&ctx->odom_estimator);
+}
+
+/**
+ * @brief Registrar uma leitura dos encoders no stream de odometria
+ */
+bool calibration_push_encoders_ctx(CalibrationContext_t *ctx, const EncoderData_t *encoder,
+                                   uint64_t stamp_us) {
+  const uint32_t words[ALIGN_ENCODER_CHANNELS] = { encoder->left_count, encoder->right_count };
+
+  return calibration_align_push(&ctx->encoder_ring, stamp_us, words);
+}
+
+/**
+ * @brief Registrar uma pose no stream de odometria
+ */
+bool calibration_push_pose_ctx(CalibrationContext_t *ctx, const PoseData_t *pose,
+                               uint64_t stamp_us) {
+  const uint32_t words[ALIGN_POSE_CHANNELS] = {
+    calibration_align_word(pose->x),
+    calibration_align_word(pose->y),
+    calibration_align_word(pose->theta),
+    pose->timestamp,
+  };
+
+  return calibration_align_push(&ctx->pose_ring, stamp_us, words);
+}
+
+/**
+ * @brief Obter a base de tempo da calibração em µs
+ *
+ * Pode ser chamada de outra thread: lê a volta e o último instante de
+ * time_us_track() sob o seqlock e repete se o par mudou durante a leitura.
+ * O relógio é lido dentro do laço, então nunca é anterior ao time_last_ms
+ * visto (uma volta já contada não é somada de novo).
+ */
+uint64_t get_calibration_time_us_ctx(const CalibrationContext_t *ctx) {
+  if (ctx->drivers.get_time_us != NULL) {
+    return ctx->drivers.get_time_us(ctx->drivers.user);
+  }
+
+  uint32_t seq;
+  uint32_t now;
+  uint64_t base;
+
+  do {
+    seq = ctx->time_sequence;
+    TIME_BARRIER();
+    now = time_ms(ctx);
+    base = ctx->time_us_base;
+    if (now < ctx->time_last_ms) {
+      base += (uint64_t)1000u << 32;  // Volta ainda não vista por time_us_track()
+    }
+    TIME_BARRIER();
+  } while ((seq & 1u) != 0u || ctx->time_sequence != seq);
+
+  return base + (uint64_t)now * 1000u;
+}
+
+/**
+ * @brief Acompanhar a volta de 32 bits de get_time_ms()
+ *
+ * Único escritor do par time_us_base/time_last_ms (thread de
+ * calibration_update()); a sequência fica ímpar durante a gravação.
+ */
+static void time_us_track(CalibrationContext_t *ctx) {
+  uint32_t now = time_ms(ctx);
+  uint32_t seq = ctx->time_sequence;
+
+  ctx->time_sequence = seq + 1;
+  TIME_BARRIER();
+  if (now < ctx->time_last_ms) {
+    ctx->time_us_base += (uint64_t)1000u << 32;
+  }
+  ctx->time_last_ms = now;
+  TIME_BARRIER();
+  ctx->time_sequence = seq + 2;
+}
+
+/**
+ * @brief Registrar o último instante com as rodas girando
+ *
+ * Percorre só as leituras de encoder chegadas desde a chamada anterior.
+ */
+static void wheels_scan(CalibrationContext_t *ctx) {
+  CalibrationAlignSample_t sample;
+
+  while (calibration_align_get(&ctx->encoder_ring, ctx->encoder_scanned, &sample)) {
+    if (!ctx->wheels_streamed) {
+      ctx->wheels_motion_us = sample.t_us - WHEELS_MOTION_HOLD_US;
+      ctx->wheels_streamed = true;
+    } else if (sample.word[0] != ctx->wheels_last[0] || sample.word[1] != ctx->wheels_last[1]) {
+      ctx->wheels_motion_us = sample.t_us;
+    }
+    ctx->wheels_last[0] = sample.word[0];
+    ctx->wheels_last[1] = sample.word[1];
+    ctx->encoder_scanned++;
+  }
+}
+
+/**
+ * @brief Descartar as leituras de encoder anteriores a t_us
+ */
+static void encoders_release(CalibrationContext_t *ctx, uint64_t t_us) {
+  uint32_t released = calibration_align_release(&ctx->encoder_ring, t_us);
+
+  ctx->encoder_scanned = (released < ctx->encoder_scanned) ? ctx->encoder_scanned - released : 0;
+}
+
+/**
+ * @brief Parear as poses pendentes com os encoders no mesmo instante
+ *
+ * As contagens são interpoladas no instante de cada pose; uma pose sem
+ * leituras de encoder depois dela espera até CALIB_ALIGN_LATENCY_US.
+ * Poses sem par (encoders ausentes ou espaçados demais) encerram o
+ * trecho de odometria, como calibration_odometry_break().
+ */
+static void odometry_align_drain(CalibrationContext_t *ctx) {
+  CalibrationAlignSample_t pose;
+  uint32_t counts[ALIGN_ENCODER_CHANNELS];
+  uint64_t now_us = get_calibration_time_us_ctx(ctx);
+
+  wheels_scan(ctx);
+
+  while (calibration_align_get(&ctx->pose_ring, 0, &pose)) {
+    CalibrationAlignResult_t result = calibration_align_at(&ctx->encoder_ring, pose.t_us,
+                                                           ODOM_ALIGN_MAX_GAP_US, counts);
+    if (result == CALIB_ALIGN_PENDING) {
+      if (now_us < pose.t_us + CALIB_ALIGN_LATENCY_US) {
+        break;
+      }
+      result = CALIB_ALIGN_MISSED;
+    }
+
+    if (result == CALIB_ALIGN_OK) {
+      const EncoderData_t encoder = { counts[0], counts[1], pose.word[3] };
+      const PoseData_t aligned = {
+        calibration_align_float(pose.word[0]),
+        calibration_align_float(pose.word[1]),
+        calibration_align_float(pose.word[2]),
+        pose.word[3],
+      };
+      calibration_feed_odometry_ctx(ctx, &encoder, &aligned);
+    } else {
+      calibration_odom_break_segment(&ctx->odom_estimator);
+    }
+    calibration_align_pop(&ctx->pose_ring);
+    encoders_release(ctx, pose.t_us);
+  }
+
+  // Leituras mais antigas que a latência não servem a nenhuma pose futura
+  if (now_us > CALIB_ALIGN_LATENCY_US) {
+    encoders_release(ctx, now_us - CALIB_ALIGN_LATENCY_US);
+  }
+}
+
+/**
+ * @brief Persistir o odômetro refinado online
+ *
+ * No máximo a cada ODOM_SAVE_INTERVAL_MS, fora do caminho de
+ * calibration_feed_odometry() (a gravação na EEPROM é lenta).
+ */
+static void odometry_persist(CalibrationContext_t *ctx, uint32_t now) {
+  if (!ctx->odom_dirty || (now - ctx->odom_saved_time) < ODOM_SAVE_INTERVAL_MS) {
+    return;
+  }
+  
+  log_info("Odometer refined online: Left=%.1f, Right=%.1f pulses/m, base=%.3f m",
+           ctx->calib.pulses_per_meter_left, ctx->calib.pulses_per_meter_right,
+           ctx->calib_ext.wheel_base);
+  write_calibration_record(ctx, &ctx->calib, ctx->calib.status == CALIB_VALID);
+  save_calibration_ext_to_eeprom_ctx(ctx, &ctx->calib_ext);
+  ctx->odom_saved_time = now;
+  ctx->odom_dirty = false;
+}
+
+#if CALIB_WITH_BATTERY
+/**
+ * @brief Amostrar a bateria para o estado de carga
+ *
+ * A tensão passa pela calibração (offset/escala) antes do modelo; o
+ * modelo aprendido é persistido no máximo a cada SOC_SAVE_INTERVAL_MS.
+ */
+static void battery_soc_poll(CalibrationContext_t *ctx, uint32_t now) {
+  if (!time_reached(now, ctx->soc_next_sample)) {
+    return;
+  }
+  ctx->soc_next_sample = now + SOC_SAMPLE_INTERVAL_MS;
+  
+  if (!ctx->drivers.read_battery_data(ctx->drivers.user, &ctx->battery_data)) {
+    count_read_failure(ctx, CALIB_SENSOR_BATTERY);
+    return;
+  }
+  
+  float voltage = ctx->battery_data.voltage * ctx->calib.battery_voltage_scale +
+                  ctx->calib.battery_voltage_offset;
+  if (calibration_soc_update(&ctx->soc, &ctx->battery_model, voltage,
+                             ctx->battery_data.current, now)) {
+    ctx->battery_model_dirty = true;
+  }
+  
+  if (ctx->battery_model_dirty &&
+      (now - ctx->battery_model_saved_time) >= SOC_SAVE_INTERVAL_MS) {
+    store_save_measured(ctx, CALIB_RECORD_BATTERY, &ctx->battery_model,
+                        sizeof(ctx->battery_model), CALIB_BATTERY_LAYOUT_ID, 0);
+    ctx->battery_model_saved_time = now;
+    ctx->battery_model_dirty = false;
+  }
+}
+
+/**
+ * @brief Obter o estado de carga da bateria
+ */
+bool get_battery_state_ctx(const CalibrationContext_t *ctx, BatteryState_t *state) {
+  if (!ctx->soc.initialized) {
+    return false;
+  }
+  
+  state->soc = ctx->soc.soc * 100.0f;
+  state->remaining_ah = ctx->soc.soc * ctx->battery_model.capacity_ah;
+  state->runtime_s = calibration_soc_runtime(&ctx->soc, &ctx->battery_model);
+  state->ocv = ctx->soc.ocv;
+  state->resistance = ctx->battery_model.resistance;
+  state->capacity_ah = ctx->battery_model.capacity_ah;
+  state->anchored = ctx->soc.anchored;
+  return true;
+}
+#endif
+
+/**
+ * @brief Monitorar desvio de sensores
+ *
+ * Sem calibration_feed_imu(), lê o IMU a cada DRIFT_SAMPLE_INTERVAL_MS.
+ * A cada DRIFT_CHECK_INTERVAL_MS compara o bias estimado em repouso com
+ * a calibração atual e marca recalibração quando o desvio é sustentado.
+ */
+void monitor_sensor_drift_ctx(CalibrationContext_t *ctx) {
+  uint32_t now = time_ms(ctx);
+  
+  if (ctx->calib_state != CALIB_IDLE) {
+    return;
+  }
+  
+  if (ctx->imu_fed_externally && (now - ctx->last_imu_feed_time) > DRIFT_FEED_TIMEOUT_MS) {
+    ctx->imu_fed_externally = false;
+  }
+  
+  if (!ctx->imu_fed_externally && ctx->drivers.read_imu_fifo != NULL) {
+    size_t got;
+    
+    if (fifo_due(&ctx->imu_fifo, now)) {
+      if (ctx->drivers.read_imu_fifo(ctx->drivers.user, ctx->burst.imu, CALIB_FIFO_BURST,
+                                     &got)) {
+        fifo_mark_read(&ctx->imu_fifo, now, got);
+        for (size_t i = 0; i < got; i++) {
+          bias_estimator_feed(ctx, &ctx->burst.imu[i]);
+        }
+      } else {
+        fifo_mark_read(&ctx->imu_fifo, now, 0);
+        count_read_failure(ctx, CALIB_SENSOR_IMU);
+      }
+    }
+  } else if (!ctx->imu_fed_externally && time_reached(now, ctx->drift_next_sample)) {
+    ctx->drift_next_sample = now + DRIFT_SAMPLE_INTERVAL_MS;
+    if (ctx->drivers.read_imu_raw(ctx->drivers.user, &ctx->imu_data)) {
+      bias_estimator_feed(ctx, &ctx->imu_data);
+    } else {
+      count_read_failure(ctx, CALIB_SENSOR_IMU);
+    }
+  }
+  
+#if CALIB_WITH_BATTERY
+  battery_soc_poll(ctx, now);
+#endif
+  
+  if (!time_reached(now, ctx->drift_next_check)) {
+    return;
+  }
+  ctx->drift_next_check = now + DRIFT_CHECK_INTERVAL_MS;
+  
+  thermal_update(ctx, now);
+  odometry_persist(ctx, now);
+  
+  if (!calibration_bias_has_evidence(&ctx->bias_estimator) ||
+      ctx->calib.status != CALIB_VALID) {
+    return;
+  }
+  
+  float acc_drift = calibration_bias_acc_drift(&ctx->bias_estimator);
+  float gyro_drift = calibration_bias_gyro_drift(&ctx->bias_estimator);
+  
+  if (acc_drift > DRIFT_ACC_THRESHOLD || gyro_drift > DRIFT_GYRO_THRESHOLD) {
+    log_warning("IMU drift detected (accel %.3f m/s², gyro %.4f rad/s), "
+                "recalibration recommended", acc_drift, gyro_drift);
+    ctx->calib.status = CALIB_NEEDS_RECALIBRATION;
+    ctx->calib_ext.sensor_meta[CALIB_SENSOR_IMU].status = CALIB_NEEDS_RECALIBRATION;
+    calibration_snapshot_publish(&ctx->published, &ctx->calib, &ctx->calib_ext);
+  }
+}
+
+// ============================================================================
+// CORREÇÃO DE DISTORÇÃO DA CÂMERA
+// ============================================================================
+
+/**
+ * @brief Fornecer memória para a tabela de remapeamento
+ */
+void set_undistort_map_storage_ctx(CalibrationContext_t *ctx, void *storage, size_t size) {
+  calibration_undistort_init(&ctx->undistort_map, storage, size);
+}
+
+/**
+ * @brief Corrigir a distorção de um quadro da câmera
+ *
+ * A tabela é gerada na primeira chamada após uma mudança de calibração
+ * (ou de geometria do quadro) e reutilizada nos quadros seguintes.
+ */
+bool undistort_camera_frame_ctx(CalibrationContext_t *ctx, const CameraFrame_t *frame, uint8_t *out,
+                                uint32_t out_stride) {
+  if (!calibration_undistort_prepare(&ctx->undistort_map, &ctx->calib,
+                                     frame->width, frame->height)) {
+    return false;
+  }
+  calibration_undistort_remap(&ctx->undistort_map, frame, out, out_stride);
+  return true;
+}
+
+/**
+ * @brief Atualizar máquina de estados (chamar periodicamente)
+ */
+void calibration_update_ctx(CalibrationContext_t *ctx) {
+  CalibrationState_t state = ctx->calib_state;
+  uint32_t start = calibration_metrics_cycles();
+  
+  time_us_track(ctx);
+  odometry_align_drain(ctx);
+  calibration_state_machine_ctx(ctx);
+  monitor_sensor_drift_ctx(ctx);
+  
+  calibration_metrics_record(&ctx->metrics.state[state], calibration_metrics_cycles() - start);
+}
+
+#if CALIB_DEFAULT_INSTANCE
+// ============================================================================
+// API GLOBAL (INSTÂNCIA PADRÃO)
+// ============================================================================
+
+void calibration_init(void) {
+  calibration_init_ctx(&default_context);
+}
+
+void request_calibration(void) {
+  request_calibration_ctx(&default_context);
+}
+
+void request_calibration_mask(uint32_t sensors) {
+  request_calibration_mask_ctx(&default_context, sensors);
+}
+
+const CalibrationSensorMeta_t *get_sensor_calibration_meta(CalibrationSensor_t sensor) {
+  return get_sensor_calibration_meta_ctx(&default_context, sensor);
+}
+
+CalibrationState_t get_calibration_state(void) {
+  return get_calibration_state_ctx(&default_context);
+}
+
+const SensorCalibration_t *get_calibration_data(void) {
+  return get_calibration_data_ctx(&default_context);
+}
+
+const SensorCalibrationExt_t *get_calibration_ext_data(void) {
+  return get_calibration_ext_data_ctx(&default_context);
+}
+
+uint32_t get_calibration_snapshot(SensorCalibration_t *calib, SensorCalibrationExt_t *ext) {
+  return get_calibration_snapshot_ctx(&default_context, calib, ext);
+}
+
+uint32_t get_calibration_generation(void) {
+  return get_calibration_generation_ctx(&default_context);
+}
+
+bool calibration_import_prior(const uint8_t *data, size_t len) {
+  return calibration_import_prior_ctx(&default_context, data, len);
+}
+
+void calibration_clear_prior(void) {
+  calibration_clear_prior_ctx(&default_context);
+}
+
+#if CALIB_WIRE_SYNC
+size_t get_calibration_wire(uint8_t *out, size_t out_size) {
+  return get_calibration_wire_ctx(&default_context, out, out_size);
+}
+
+bool calibration_wire_acknowledge(uint32_t generation) {
+  return calibration_wire_acknowledge_ctx(&default_context, generation);
+}
+
+void calibration_wire_request_full(void) {
+  calibration_wire_request_full_ctx(&default_context);
+}
+#endif
+
+const CalibrationMetrics_t *get_calibration_metrics(void) {
+  return get_calibration_metrics_ctx(&default_context);
+}
+
+void reset_calibration_metrics(void) {
+  reset_calibration_metrics_ctx(&default_context);
+}
+
+bool is_calibration_valid(void) {
+  return is_calibration_valid_ctx(&default_context);
+}
+
+uint32_t get_calibration_age_seconds(void) {
+  return get_calibration_age_seconds_ctx(&default_context);
+}
+
+void reset_calibration_to_default(void) {
+  reset_calibration_to_default_ctx(&default_context);
+}
+
+void set_calibration_adaptive(bool enabled) {
+  set_calibration_adaptive_ctx(&default_context, enabled);
+}
+
+bool is_calibration_adaptive(void) {
+  return is_calibration_adaptive_ctx(&default_context);
+}
+
+void set_calibration_parallel(bool enabled) {
+  set_calibration_parallel_ctx(&default_context, enabled);
+}
+
+bool is_calibration_parallel(void) {
+  return is_calibration_parallel_ctx(&default_context);
+}
+
+void save_calibration_to_eeprom(const SensorCalibration_t *calib) {
+  save_calibration_to_eeprom_ctx(&default_context, calib);
+}
+
+void load_calibration_from_eeprom(SensorCalibration_t *calib) {
+  load_calibration_from_eeprom_ctx(&default_context, calib);
+}
+
+void save_calibration_ext_to_eeprom(const SensorCalibrationExt_t *ext) {
+  save_calibration_ext_to_eeprom_ctx(&default_context, ext);
+}
+
+void load_calibration_ext_from_eeprom(SensorCalibrationExt_t *ext) {
+  load_calibration_ext_from_eeprom_ctx(&default_context, ext);
+}
+
+void calibration_update(void) {
+  calibration_update_ctx(&default_context);
+}
+
+void monitor_sensor_drift(void) {
+  monitor_sensor_drift_ctx(&default_context);
+}
+
+void calibration_state_machine(void) {
+  calibration_state_machine_ctx(&default_context);
+}
+
+void calibration_feed_imu(const IMUData_t *sample) {
+  calibration_feed_imu_ctx(&default_context, sample);
+}
+
+void calibration_feed_imu_burst(const IMUData_t *samples, size_t count) {
+  calibration_feed_imu_burst_ctx(&default_context, samples, count);
+}
+
+void calibration_notify_imu_fifo(void) {
+  calibration_notify_imu_fifo_ctx(&default_context);
+}
+
+void calibration_notify_mag_fifo(void) {
+  calibration_notify_mag_fifo_ctx(&default_context);
+}
+
+bool get_imu_bias_estimate(float acc_bias[3], float gyro_bias[3]) {
+  return get_imu_bias_estimate_ctx(&default_context, acc_bias, gyro_bias);
+}
+
+void calibration_feed_odometry(const EncoderData_t *encoder, const PoseData_t *pose) {
+  calibration_feed_odometry_ctx(&default_context, encoder, pose);
+}
+
+bool calibration_push_encoders(const EncoderData_t *encoder, uint64_t stamp_us) {
+  return calibration_push_encoders_ctx(&default_context, encoder, stamp_us);
+}
+
+bool calibration_push_pose(const PoseData_t *pose, uint64_t stamp_us) {
+  return calibration_push_pose_ctx(&default_context, pose, stamp_us);
+}
+
+uint64_t get_calibration_time_us(void) {
+  return get_calibration_time_us_ctx(&default_context);
+}
+
+void calibration_odometry_break(void) {
+  calibration_odometry_break_ctx(&default_context);
+}
+
+bool get_odometry_estimate(float *ppm_left, float *ppm_right, float *wheel_base) {
+  return get_odometry_estimate_ctx(&default_context, ppm_left, ppm_right, wheel_base);
+}
+
+#if CALIB_WITH_BATTERY
+bool get_battery_state(BatteryState_t *state) {
+  return get_battery_state_ctx(&default_context, state);
+}
+#endif
+
+void get_gyro_bias_for_temperature(float temperature, float bias[3]) {
+  get_gyro_bias_for_temperature_ctx(&default_context, temperature, bias);
+}
+
+bool get_temperature_channels(TemperatureData_t *data) {
+  return get_temperature_channels_ctx(&default_context, data);
+}
+
+void set_ambient_temperature(float temperature) {
+  set_ambient_temperature_ctx(&default_context, temperature);
+}
+
+bool set_temperature_channel_calibration(uint8_t channel, float slope, float offset) {
+  return set_temperature_channel_calibration_ctx(&default_context, channel, slope, offset);
+}
+
+void set_undistort_map_storage(void *storage, size_t size) {
+  set_undistort_map_storage_ctx(&default_context, storage, size);
+}
+
+bool undistort_camera_frame(const CameraFrame_t *frame, uint8_t *out, uint32_t out_stride) {
+  return undistort_camera_frame_ctx(&default_context, frame, out, out_stride);
+}
+
+bool validate_calibration(const SensorCalibration_t *calib) {
+  return validate_calibration_ctx(&default_context, calib);
+}
+
+#if CALIB_WITH_IMU
+bool calibrate_imu(void) {
+  return calibrate_imu_ctx(&default_context);
+}
+
+void calibrate_imu_begin(void) {
+  calibrate_imu_begin_ctx(&default_context);
+}
+
+CalibrationStepResult_t calibrate_imu_step(void) {
+  return calibrate_imu_step_ctx(&default_context);
+}
+#endif
+
+#if CALIB_WITH_MAG
+bool calibrate_magnetometer(void) {
+  return calibrate_magnetometer_ctx(&default_context);
+}
+
+void calibrate_magnetometer_begin(void) {
+  calibrate_magnetometer_begin_ctx(&default_context);
+}
+
+CalibrationStepResult_t calibrate_magnetometer_step(void) {
+  return calibrate_magnetometer_step_ctx(&default_context);
+}
+#endif
+
+#if CALIB_WITH_ODOM
+bool calibrate_odometer(void) {
+  return calibrate_odometer_ctx(&default_context);
+}
+
+void calibrate_odometer_begin(void) {
+  calibrate_odometer_begin_ctx(&default_context);
+}
+
+CalibrationStepResult_t calibrate_odometer_step(void) {
+  return calibrate_odometer_step_ctx(&default_context);
+}
+#endif
+
+#if CALIB_WITH_LIDAR
+bool calibrate_lidar(void) {
+  return calibrate_lidar_ctx(&default_context);
+}
+
+void calibrate_lidar_begin(void) {
+  calibrate_lidar_begin_ctx(&default_context);
+}
+
+CalibrationStepResult_t calibrate_lidar_step(void) {
+  return calibrate_lidar_step_ctx(&default_context);
+}
+#endif
+
+#if CALIB_WITH_CAMERA
+bool calibrate_camera(void) {
+  return calibrate_camera_ctx(&default_context);
+}
+
+void calibrate_camera_begin(void) {
+  calibrate_camera_begin_ctx(&default_context);
+}
+
+CalibrationStepResult_t calibrate_camera_step(void) {
+  return calibrate_camera_step_ctx(&default_context);
+}
+#endif
+
+#if CALIB_WITH_BATTERY
+bool calibrate_battery(void) {
+  return calibrate_battery_ctx(&default_context);
+}
+
+void calibrate_battery_begin(void) {
+  calibrate_battery_begin_ctx(&default_context);
+}
+
+CalibrationStepResult_t calibrate_battery_step(void) {
+  return calibrate_battery_step_ctx(&default_context);
+}
+#endif
+
+#if CALIB_WITH_TEMP
+bool calibrate_temperature(void) {
+  return calibrate_temperature_ctx(&default_context);
+}
+
+void calibrate_temperature_begin(void) {
+  calibrate_temperature_begin_ctx(&default_context);
+}
+
+CalibrationStepResult_t calibrate_temperature_step(void) {
+  return calibrate_temperature_step_ctx(&default_context);
 }
+#endif
+#endif // CALIB_DEFAULT_INSTANCE
 
 // ============================================================================
 // FIM DO ARQUIVO
@@ -9,6 +9,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 // ============================================================================
 // ENUMERAÇÕES
@@ -49,6 +50,56 @@ typedef enum {
   CALIB_ERROR = 17
 } CalibrationState_t;
 
+#define CALIB_STATE_COUNT (CALIB_ERROR + 1)
+
+/**
+ * @enum CalibrationStepResult_t
+ * @brief Resultado de um passo incremental de calibração
+ */
+typedef enum {
+  CALIB_STEP_PENDING = 0,  ///< Fase em andamento, chamar novamente no próximo tick
+  CALIB_STEP_DONE = 1,     ///< Fase concluída com sucesso
+  CALIB_STEP_FAILED = 2    ///< Fase falhou
+} CalibrationStepResult_t;
+
+/**
+ * @enum CalibrationSensor_t
+ * @brief Sensores calibráveis (índice em sensor_meta; bit em máscaras)
+ */
+typedef enum {
+  CALIB_SENSOR_IMU = 0,
+  CALIB_SENSOR_MAG = 1,
+  CALIB_SENSOR_ODOM = 2,
+  CALIB_SENSOR_LIDAR = 3,
+  CALIB_SENSOR_CAMERA = 4,
+  CALIB_SENSOR_BATTERY = 5,
+  CALIB_SENSOR_TEMP = 6,
+  CALIB_SENSOR_COUNT = 7
+} CalibrationSensor_t;
+
+#define CALIB_SENSOR_BIT(sensor) (1UL << (sensor))                 ///< Bit do sensor na máscara
+#define CALIB_SENSOR_MASK_ALL ((1UL << CALIB_SENSOR_COUNT) - 1)      ///< Todos os sensores
+
+// Tabela bias do giroscópio x temperatura
+#define CALIB_GYRO_TEMP_BINS 8           ///< Pontos da tabela
+#define CALIB_GYRO_TEMP_MIN (-10.0f)     ///< Temperatura do primeiro ponto (°C)
+#define CALIB_GYRO_TEMP_STEP 10.0f       ///< Espaçamento entre pontos (°C)
+#define CALIB_GYRO_LUT_LSB 1.0e-5f       ///< rad/s por unidade de GyroTempBin_t.bias
+
+// Canais de temperatura (capacidade fixa de TemperatureData_t)
+#ifndef CALIB_TEMP_CHANNELS
+#define CALIB_TEMP_CHANNELS 6            ///< Canais, incluindo o canal 0 (temperature)
+#endif
+
+/**
+ * @enum MagCalibrationModel_t
+ * @brief Modelo de correção do magnetômetro
+ */
+typedef enum {
+  MAG_MODEL_MINMAX = 0,     ///< Offset/escala por eixo (min/max)
+  MAG_MODEL_ELLIPSOID = 1   ///< Hard-iron + matriz soft-iron 3x3 (ajuste de elipsoide)
+} MagCalibrationModel_t;
+
 // ============================================================================
 // ESTRUTURAS DE DADOS
 // ============================================================================
@@ -92,6 +143,28 @@ typedef struct {
   uint32_t timestamp; ///< Timestamp (ms)
 } LiDARData_t;
 
+/**
+ * @struct PoseData_t
+ * @brief Pose da localização (SLAM/LiDAR) no referencial do mapa
+ */
+typedef struct {
+  float x, y;         ///< Posição (m)
+  float theta;        ///< Rumo (rad)
+  uint32_t timestamp; ///< Timestamp (ms)
+} PoseData_t;
+
+/**
+ * @struct CameraFrame_t
+ * @brief Quadro da câmera em escala de cinza (plano Y), emprestado do driver
+ */
+typedef struct {
+  const uint8_t *pixels;  ///< Primeiro pixel (buffer do driver, apenas leitura)
+  uint16_t width;         ///< Largura (pixels)
+  uint16_t height;        ///< Altura (pixels)
+  uint32_t stride;        ///< Bytes entre linhas
+  uint32_t timestamp;     ///< Timestamp (ms)
+} CameraFrame_t;
+
 /**
  * @struct BatteryData_t
  * @brief Dados da Bateria
@@ -103,13 +176,33 @@ typedef struct {
   uint32_t timestamp; ///< Timestamp (ms)
 } BatteryData_t;
 
+/**
+ * @struct BatteryState_t
+ * @brief Estado de carga estimado (calibration_battery.h)
+ */
+typedef struct {
+  float soc;            ///< Estado de carga (%)
+  float remaining_ah;   ///< Carga restante (Ah)
+  uint32_t runtime_s;   ///< Autonomia na descarga média recente (s)
+  float ocv;            ///< Tensão de circuito aberto estimada (V)
+  float resistance;     ///< Resistência interna (ohm)
+  float capacity_ah;    ///< Capacidade útil aprendida (Ah)
+  bool anchored;        ///< Carga completa desde o boot (contagem de coulombs referenciada)
+} BatteryState_t;
+
 /**
  * @struct TemperatureData_t
  * @brief Dados de Temperatura
+ *
+ * Drivers de um canal preenchem só temperature e timestamp; os demais
+ * (ex.: placa dos motores, IMU, LiDAR) vão em channel, até
+ * CALIB_TEMP_CHANNELS no total.
  */
 typedef struct {
-  float temperature;  ///< Temperatura (°C)
+  float temperature;  ///< Canal 0: temperatura ambiente/placa principal (°C)
   uint32_t timestamp; ///< Timestamp (ms)
+  float channel[CALIB_TEMP_CHANNELS - 1];  ///< Canais 1..CALIB_TEMP_CHANNELS-1 (°C)
+  uint32_t channel_count;                  ///< Canais preenchidos (0 = só temperature)
 } TemperatureData_t;
 
 /**
@@ -165,9 +258,101 @@ typedef struct {
   
 } SensorCalibration_t;
 
+/**
+ * @struct CalibrationSensorMeta_t
+ * @brief Metadados de calibração de um sensor
+ */
+typedef struct {
+  uint32_t timestamp;            ///< Timestamp da última calibração do sensor (ms)
+  uint16_t calibration_count;    ///< Número de calibrações do sensor
+  uint8_t status;                ///< Status do sensor (CalibrationStatus_t)
+} CalibrationSensorMeta_t;
+
+/**
+ * @struct GyroTempBin_t
+ * @brief Ponto da tabela bias do giroscópio x temperatura
+ *
+ * Bias em CALIB_GYRO_LUT_LSB (±0,33 rad/s) para manter a tabela compacta.
+ */
+typedef struct {
+  int16_t bias[3];     ///< Bias X, Y, Z (CALIB_GYRO_LUT_LSB)
+  uint16_t count;      ///< Amostras acumuladas (0 = ponto vazio)
+} GyroTempBin_t;
+
+/**
+ * @struct SensorCalibrationExt_t
+ * @brief Extensões de calibração (campos além de SensorCalibration_t)
+ *
+ * Mantida separada de SensorCalibration_t para não alterar o layout já
+ * gravado em campo. Os campos legados (mag_offset_*, mag_scale_*) continuam
+ * preenchidos com a melhor aproximação por eixo.
+ */
+typedef struct {
+  // Magic number para validação
+  uint32_t magic;
+  
+  // ========== Magnetometer Ellipsoid Fit ==========
+  float mag_hard_iron[3];      ///< Centro do elipsoide (Gauss)
+  float mag_soft_iron[3][3];   ///< Matriz de correção soft-iron (det = 1)
+  float mag_field_strength;    ///< Intensidade média do campo (Gauss)
+  float mag_fit_condition;     ///< Número de condição do ajuste
+  uint8_t mag_model;           ///< Modelo ativo (MagCalibrationModel_t)
+  
+  // ========== Per-Sensor Metadata ==========
+  CalibrationSensorMeta_t sensor_meta[CALIB_SENSOR_COUNT];  ///< Indexado por CalibrationSensor_t
+  
+  // ========== Gyroscope Bias ==========
+  float gyro_bias[3];          ///< Bias do giroscópio na calibração (rad/s)
+  float gyro_bias_temp;        ///< Temperatura durante a calibração (°C)
+  GyroTempBin_t gyro_temp_lut[CALIB_GYRO_TEMP_BINS];  ///< Bias x temperatura
+  
+  // ========== Odometry ==========
+  float wheel_base;            ///< Distância entre as rodas (m)
+  
+} SensorCalibrationExt_t;
+
+/**
+ * @struct CalibrationTiming_t
+ * @brief Duração de um trecho em ciclos do contador da CPU
+ */
+typedef struct {
+  uint32_t min;    ///< Menor duração (UINT32_MAX antes da primeira amostra)
+  uint32_t max;    ///< Maior duração
+  uint32_t ema;    ///< Média exponencial (α = 1/16)
+  uint32_t count;  ///< Amostras (saturado)
+} CalibrationTiming_t;
+
+/**
+ * @struct CalibrationMetrics_t
+ * @brief Instrumentação do caminho de calibração
+ *
+ * Campos uint32_t escritos sem trava por calibration_update() e pelas
+ * funções de alimentação; podem ser lidos de uma ISR ou tarefa de
+ * telemetria sem perturbar o tempo do laço.
+ */
+typedef struct {
+  CalibrationTiming_t state[CALIB_STATE_COUNT];  ///< calibration_update(), pelo estado de entrada
+  uint32_t read_failures[CALIB_SENSOR_COUNT];    ///< Leituras de driver com falha
+  uint32_t validations;                          ///< Chamadas de validate_calibration()
+  uint32_t validation_failures;                  ///< Rejeições de validate_calibration()
+  uint32_t eeprom_writes;                        ///< Registros gravados
+  uint32_t eeprom_bytes_written;                 ///< Bytes efetivamente escritos
+  CalibrationTiming_t eeprom_write;              ///< Duração de cada gravação
+  uint32_t phase_start_ms[CALIB_SENSOR_COUNT];   ///< Início da fase na última sequência (get_time_ms())
+  uint32_t phase_end_ms[CALIB_SENSOR_COUNT];     ///< Fim da fase na última sequência
+} CalibrationMetrics_t;
+
+/**
+ * @brief Instância do sistema de calibração (ver calibration_context.h)
+ */
+typedef struct CalibrationContext CalibrationContext_t;
+
 // ============================================================================
 // FUNÇÕES PÚBLICAS
 // ============================================================================
+//
+// Operam sobre a instância padrão; cada função tem uma variante _ctx()
+// em calibration_context.h que recebe a instância explicitamente.
 
 /**
  * @brief Inicializar sistema de calibração
@@ -185,6 +370,24 @@ void init_default_calibration(SensorCalibration_t *calib);
  */
 void request_calibration(void);
 
+/**
+ * @brief Solicitar calibração apenas dos sensores selecionados
+ *
+ * Somente as fases selecionadas são executadas; os resultados são
+ * mesclados na calibração atual e os demais campos permanecem
+ * inalterados. Em caso de falha, a calibração anterior é restaurada.
+ * Ex.: request_calibration_mask(CALIB_SENSOR_BIT(CALIB_SENSOR_IMU))
+ * @param sensors Máscara de sensores (CALIB_SENSOR_BIT)
+ */
+void request_calibration_mask(uint32_t sensors);
+
+/**
+ * @brief Obter metadados de calibração de um sensor
+ * @param sensor Sensor
+ * @return Ponteiro para os metadados ou NULL se o sensor for inválido
+ */
+const CalibrationSensorMeta_t *get_sensor_calibration_meta(CalibrationSensor_t sensor);
+
 /**
  * @brief Obter estado atual da calibração
  * @return Estado da calibração
@@ -193,10 +396,99 @@ CalibrationState_t get_calibration_state(void);
 
 /**
  * @brief Obter dados de calibração
+ *
+ * Cópia de trabalho: durante uma sequência contém resultados parciais, e
+ * é alterada campo a campo. Só para a thread que chama
+ * calibration_update(); outras threads usam get_calibration_snapshot().
  * @return Ponteiro para dados de calibração
  */
 const SensorCalibration_t *get_calibration_data(void);
 
+/**
+ * @brief Obter extensões de calibração
+ *
+ * Cópia de trabalho, como get_calibration_data().
+ * @return Ponteiro para extensões de calibração
+ */
+const SensorCalibrationExt_t *get_calibration_ext_data(void);
+
+/**
+ * @brief Copiar a última calibração confirmada, sem trava
+ *
+ * Consistente mesmo lida de outra thread ou de uma ISR. A calibração só
+ * é confirmada ao concluir (ou abortar) uma sequência, e nas mudanças do
+ * monitoramento contínuo (desvio, tabela térmica, odometria online).
+ * @param calib Destino da calibração (NULL para ignorar)
+ * @param ext Destino das extensões (NULL para ignorar)
+ * @return Geração da cópia
+ */
+uint32_t get_calibration_snapshot(SensorCalibration_t *calib, SensorCalibrationExt_t *ext);
+
+/**
+ * @brief Obter a geração da calibração confirmada
+ *
+ * Muda a cada confirmação: um leitor pode comparar com a geração da sua
+ * última cópia em vez de copiar a cada ciclo.
+ * @return Geração atual
+ */
+uint32_t get_calibration_generation(void);
+
+/**
+ * @brief Codificar a calibração confirmada no formato binário (calibration_wire.h)
+ *
+ * Delta sobre a última geração confirmada pelo app, ou mensagem completa
+ * se não houver. Chamar sempre da mesma thread (comunicação).
+ * @param out Destino (CALIB_WIRE_MAX_SIZE bytes sempre bastam)
+ * @param out_size Tamanho do destino
+ * @return Bytes gravados, 0 se out_size não bastar
+ */
+size_t get_calibration_wire(uint8_t *out, size_t out_size);
+
+/**
+ * @brief Registrar a geração que o app confirmou ter aplicado
+ * @param generation Geração confirmada
+ * @return false se não for a última enviada (ignorada)
+ */
+bool calibration_wire_acknowledge(uint32_t generation);
+
+/**
+ * @brief Enviar a calibração completa na próxima mensagem (app sem a base do delta)
+ */
+void calibration_wire_request_full(void);
+
+/**
+ * @brief Importar o prior de frota do modelo (calibration_prior.h)
+ *
+ * Chamar da thread de controle, fora de uma sequência. Sem calibração
+ * válida, as medianas da frota passam a valer de imediato.
+ * @param data Mensagem no formato binário com CALIB_WIRE_FLAG_PRIOR
+ * @param len Tamanho da mensagem
+ * @return false se a mensagem for inválida ou de outro modelo (prior anterior mantido)
+ */
+bool calibration_import_prior(const uint8_t *data, size_t len);
+
+/**
+ * @brief Descartar o prior de frota (fases e validação voltam ao genérico)
+ */
+void calibration_clear_prior(void);
+
+/**
+ * @brief Obter a instrumentação da calibração
+ * @return Ponteiro para os contadores (atualizados no lugar)
+ */
+const CalibrationMetrics_t *get_calibration_metrics(void);
+
+/**
+ * @brief Zerar a instrumentação
+ */
+void reset_calibration_metrics(void);
+
+/**
+ * @brief Inicializar extensões com valores padrão (matriz identidade)
+ * @param ext Ponteiro para extensões de calibração
+ */
+void init_default_calibration_ext(SensorCalibrationExt_t *ext);
+
 /**
  * @brief Verificar se calibração é válida
  * @return true se válida, false caso contrário
@@ -214,6 +506,41 @@ uint32_t get_calibration_age_seconds(void);
  */
 void reset_calibration_to_default(void);
 
+/**
+ * @brief Ativar/desativar amostragem adaptativa
+ *
+ * Com amostragem adaptativa, cada fase termina assim que o erro padrão da
+ * média fica abaixo do alvo do sensor (ou, no magnetômetro, quando a
+ * cobertura de direções satura). As contagens fixas continuam como teto.
+ * @param enabled true para ativar
+ */
+void set_calibration_adaptive(bool enabled);
+
+/**
+ * @brief Verificar se a amostragem adaptativa está ativa
+ * @return true se ativa
+ */
+bool is_calibration_adaptive(void);
+
+/**
+ * @brief Ativar/desativar execução paralela de fases independentes
+ *
+ * IMU, LiDAR, câmera (robô imóvel), bateria e temperatura rodam
+ * intercaladas no mesmo tick; magnetômetro e odômetro (movem o robô)
+ * continuam exclusivos. Uma fase ainda espera as de que depende (odômetro
+ * após o IMU, LiDAR após a temperatura). Com CALIB_PARALLEL_THREADS=1 (host Linux), cada
+ * fase ativa roda em uma thread própria e os drivers devem ser thread-safe.
+ * Só pode ser alterado com a calibração ociosa.
+ * @param enabled true para ativar
+ */
+void set_calibration_parallel(bool enabled);
+
+/**
+ * @brief Verificar se a execução paralela está ativa
+ * @return true se ativa
+ */
+bool is_calibration_parallel(void);
+
 /**
  * @brief Salvar calibração em EEPROM
  * @param calib Ponteiro para estrutura de calibração
@@ -226,6 +553,18 @@ void save_calibration_to_eeprom(const SensorCalibration_t *calib);
  */
 void load_calibration_from_eeprom(SensorCalibration_t *calib);
 
+/**
+ * @brief Salvar extensões de calibração em EEPROM
+ * @param ext Ponteiro para extensões de calibração
+ */
+void save_calibration_ext_to_eeprom(const SensorCalibrationExt_t *ext);
+
+/**
+ * @brief Carregar extensões de calibração da EEPROM
+ * @param ext Ponteiro para extensões de calibração
+ */
+void load_calibration_ext_from_eeprom(SensorCalibrationExt_t *ext);
+
 /**
  * @brief Atualizar máquina de estados (chamar periodicamente)
  */
@@ -236,9 +575,198 @@ void calibration_update(void);
  */
 void monitor_sensor_drift(void);
 
+/**
+ * @brief Alimentar o estimador de bias online com uma amostra bruta do IMU
+ *
+ * Custo fixo por amostra; pode ser chamada no caminho de 1 kHz. Enquanto
+ * houver amostras externas, monitor_sensor_drift() não lê o IMU.
+ * @param sample Amostra bruta (sem calibração aplicada)
+ */
+void calibration_feed_imu(const IMUData_t *sample);
+
+/**
+ * @brief Alimentar o estimador de bias online com uma rajada do IMU
+ *
+ * Para quem já drena a FIFO do IMU (fusão de sensores): equivale a
+ * calibration_feed_imu() em cada amostra, com uma chamada por rajada.
+ * @param samples Amostras brutas, em ordem de aquisição
+ * @param count Número de amostras
+ */
+void calibration_feed_imu_burst(const IMUData_t *samples, size_t count);
+
+/**
+ * @brief Sinalizar dados novos na FIFO do IMU
+ *
+ * Chamar da ISR de watermark da FIFO ou do callback de conclusão do DMA
+ * (só incrementa um contador). A próxima chamada de calibration_update()
+ * lê a rajada com read_imu_fifo(); sem sinalização, a FIFO é lida a cada
+ * CALIB_FIFO_POLL_MS.
+ */
+void calibration_notify_imu_fifo(void);
+
+/**
+ * @brief Sinalizar dados novos na FIFO do Magnetômetro
+ *
+ * Como calibration_notify_imu_fifo(), para read_magnetometer_fifo().
+ */
+void calibration_notify_mag_fifo(void);
+
+/**
+ * @brief Obter o bias do IMU estimado online
+ * @param acc_bias Bias do acelerômetro (m/s², mesmo modelo de imu_bias_*)
+ * @param gyro_bias Bias do giroscópio (rad/s)
+ * @return true se há repouso suficiente para a estimativa ser confiável
+ */
+bool get_imu_bias_estimate(float acc_bias[3], float gyro_bias[3]);
+
+/**
+ * @brief Alimentar o calibrador de odometria com encoders e pose simultâneos
+ *
+ * Para uso durante a operação normal (entregas); custo fixo por chamada.
+ * Quando a estimativa converge, pulses_per_meter_* e wheel_base são
+ * atualizados sem interromper o robô. Quando encoders e pose chegam em
+ * instantes diferentes, usar calibration_push_encoders() e
+ * calibration_push_pose(), que fazem o pareamento.
+ * @param encoder Contagens brutas dos encoders
+ * @param pose Pose da localização no mesmo instante
+ */
+void calibration_feed_odometry(const EncoderData_t *encoder, const PoseData_t *pose);
+
+/**
+ * @brief Registrar uma leitura dos encoders no stream de odometria
+ *
+ * Chamável da ISR do timer dos encoders (sem lock, custo fixo). A cada
+ * calibration_update(), cada pose pendente recebe as contagens
+ * interpoladas no seu instante e segue para o calibrador de odometria;
+ * enquanto as contagens mudam, o estimador de bias descarta as amostras
+ * do IMU (robô em velocidade constante não aparece no IMU).
+ * @param encoder Contagens brutas (timestamp ignorado)
+ * @param stamp_us Instante da leitura na base de get_calibration_time_us()
+ * @return false se o stream estiver cheio ou a leitura fora de ordem
+ */
+bool calibration_push_encoders(const EncoderData_t *encoder, uint64_t stamp_us);
+
+/**
+ * @brief Registrar uma pose da localização no stream de odometria
+ *
+ * A pose espera até CALIB_ALIGN_LATENCY_US pelos encoders posteriores ao
+ * seu instante; depois disso, ou se os encoders em volta estiverem
+ * distantes demais, o trecho de odometria é descartado.
+ * @param pose Pose (timestamp repassado ao calibrador)
+ * @param stamp_us Instante a que a pose se refere, na base de stamp_us dos encoders
+ * @return false se o stream estiver cheio ou a pose fora de ordem
+ */
+bool calibration_push_pose(const PoseData_t *pose, uint64_t stamp_us);
+
+/**
+ * @brief Obter a base de tempo da calibração em µs
+ *
+ * get_time_us() com CALIB_TIME_US=1; senão get_time_ms() estendida a 64
+ * bits (a volta de 49 dias é acompanhada por calibration_update()). É a
+ * base de stamp_us de calibration_push_*(). Segura de qualquer thread ou
+ * ISR (seqlock com calibration_update()).
+ * @return Tempo monotônico (µs)
+ */
+uint64_t get_calibration_time_us(void);
+
+/**
+ * @brief Descartar o trecho de odometria em andamento
+ *
+ * Chamar quando a pose saltar (relocalização) ou as rodas perderem o
+ * contato com o chão.
+ */
+void calibration_odometry_break(void);
+
+/**
+ * @brief Obter a estimativa online do odômetro
+ * @param ppm_left Pulsos/metro da roda esquerda
+ * @param ppm_right Pulsos/metro da roda direita
+ * @param wheel_base Distância entre as rodas (m)
+ * @return true se a estimativa convergiu
+ */
+bool get_odometry_estimate(float *ppm_left, float *ppm_right, float *wheel_base);
+
+/**
+ * @brief Obter o bias do giroscópio compensado em temperatura
+ *
+ * Interpola a tabela bias x temperatura entre os pontos preenchidos; sem
+ * pontos, retorna o bias da última calibração.
+ * @param temperature Temperatura (°C)
+ * @param bias Bias X, Y, Z (rad/s)
+ */
+void get_gyro_bias_for_temperature(float temperature, float bias[3]);
+
+/**
+ * @brief Obter a última leitura de temperatura corrigida por canal
+ *
+ * Atualizada pelo monitoramento contínuo (a cada poucos segundos) e ao
+ * final da fase do LiDAR; o mesmo valor alimenta a compensação térmica do
+ * giroscópio e do LiDAR. As fases de IMU e temperatura leem em buffers
+ * próprios. Para corrigir leituras próprias em lote, ver
+ * apply_temperature_calibration_batch().
+ * @param data Leitura corrigida (channel_count como lido do driver)
+ * @return false antes da primeira leitura de temperatura
+ */
+bool get_temperature_channels(TemperatureData_t *data);
+
+/**
+ * @brief Informar a temperatura ambiente (ex.: sensor do galpão)
+ *
+ * Referência da próxima fase de temperatura, no lugar de
+ * CALIB_TEMP_AMBIENT; não é persistida.
+ * @param temperature Temperatura ambiente (°C)
+ */
+void set_ambient_temperature(float temperature);
+
+/**
+ * @brief Gravar a correção de fábrica de um canal: T = slope · bruto + offset
+ *
+ * A fase de temperatura mantém o slope e recalcula o offset.
+ * @param channel Canal (0..CALIB_TEMP_CHANNELS-1)
+ * @param slope Ganho (0,5..2)
+ * @param offset Offset (°C)
+ * @return false se o canal ou os coeficientes forem inválidos
+ */
+bool set_temperature_channel_calibration(uint8_t channel, float slope, float offset);
+
+/**
+ * @brief Obter o estado de carga da bateria
+ *
+ * Substitui BatteryData_t.percentage (cru do driver): contagem de
+ * coulombs, queda na resistência interna compensada e curva OCV x SoC
+ * aprendida online. Amostrado a cada segundo fora das sequências de
+ * calibração; custo fixo. Só existe com CALIB_WITH_BATTERY.
+ * @param state Estado de carga
+ * @return false antes da primeira leitura da bateria
+ */
+bool get_battery_state(BatteryState_t *state);
+
+/**
+ * @brief Fornecer memória para a tabela de correção de distorção
+ * @param storage Memória (alinhada a 2 bytes), 6 bytes por pixel
+ * @param size Tamanho em bytes
+ */
+void set_undistort_map_storage(void *storage, size_t size);
+
+/**
+ * @brief Corrigir a distorção radial de um quadro da câmera
+ *
+ * Usa uma tabela de remapeamento em ponto fixo gerada sob demanda a partir
+ * dos intrínsecos atuais; após a primeira chamada, o custo por quadro é
+ * uma coleta bilinear.
+ * @param frame Quadro distorcido
+ * @param out Saída com a mesma geometria do quadro
+ * @param out_stride Bytes entre linhas da saída
+ * @return false sem memória suficiente para a tabela (ver set_undistort_map_storage())
+ */
+bool undistort_camera_frame(const CameraFrame_t *frame, uint8_t *out, uint32_t out_stride);
+
 // ============================================================================
 // FUNÇÕES DE CALIBRAÇÃO INDIVIDUAIS
 // ============================================================================
+//
+// Só existem para os sensores presentes no SKU (CALIB_WITH_* em
+// calibration_context.h).
 
 /**
  * @brief Calibrar IMU
@@ -289,6 +817,93 @@ bool calibrate_temperature(void);
  */
 bool validate_calibration(const SensorCalibration_t *calib);
 
+// ============================================================================
+// FUNÇÕES DE CALIBRAÇÃO INCREMENTAIS (NÃO-BLOQUEANTES)
+// ============================================================================
+//
+// Cada fase é dividida em begin/step. begin() zera o acumulador da fase;
+// step() coleta no máximo uma amostra por chamada e retorna imediatamente.
+// As funções calibrate_*() acima continuam disponíveis como wrappers
+// bloqueantes sobre o par begin/step.
+
+/**
+ * @brief Iniciar fase de calibração do IMU
+ */
+void calibrate_imu_begin(void);
+
+/**
+ * @brief Executar um passo da calibração do IMU
+ * @return Estado da fase após o passo
+ */
+CalibrationStepResult_t calibrate_imu_step(void);
+
+/**
+ * @brief Iniciar fase de calibração do Magnetômetro
+ */
+void calibrate_magnetometer_begin(void);
+
+/**
+ * @brief Executar um passo da calibração do Magnetômetro
+ * @return Estado da fase após o passo
+ */
+CalibrationStepResult_t calibrate_magnetometer_step(void);
+
+/**
+ * @brief Iniciar fase de calibração do Odômetro
+ */
+void calibrate_odometer_begin(void);
+
+/**
+ * @brief Executar um passo da calibração do Odômetro
+ * @note O movimento em si ainda usa move_forward_distance() (bloqueante)
+ * @return Estado da fase após o passo
+ */
+CalibrationStepResult_t calibrate_odometer_step(void);
+
+/**
+ * @brief Iniciar fase de calibração do LiDAR
+ */
+void calibrate_lidar_begin(void);
+
+/**
+ * @brief Executar um passo da calibração do LiDAR
+ * @return Estado da fase após o passo
+ */
+CalibrationStepResult_t calibrate_lidar_step(void);
+
+/**
+ * @brief Iniciar fase de calibração da Câmera
+ */
+void calibrate_camera_begin(void);
+
+/**
+ * @brief Executar um passo da calibração da Câmera
+ * @return Estado da fase após o passo
+ */
+CalibrationStepResult_t calibrate_camera_step(void);
+
+/**
+ * @brief Iniciar fase de calibração da Bateria
+ */
+void calibrate_battery_begin(void);
+
+/**
+ * @brief Executar um passo da calibração da Bateria
+ * @return Estado da fase após o passo
+ */
+CalibrationStepResult_t calibrate_battery_step(void);
+
+/**
+ * @brief Iniciar fase de calibração de Temperatura
+ */
+void calibrate_temperature_begin(void);
+
+/**
+ * @brief Executar um passo da calibração de Temperatura
+ * @return Estado da fase após o passo
+ */
+CalibrationStepResult_t calibrate_temperature_step(void);
+
 // ============================================================================
 // FUNÇÕES AUXILIARES (implementadas em outros arquivos)
 // ============================================================================
@@ -307,6 +922,33 @@ bool read_imu_raw(IMUData_t *imu_data);
  */
 bool read_magnetometer_raw(MagData_t *mag_data);
 
+/**
+ * @brief Ler em rajada as amostras acumuladas na FIFO do IMU
+ *
+ * Usada com CALIB_SENSOR_FIFO=1, no lugar de read_imu_raw(). Uma
+ * transação de barramento por chamada; com DMA, devolver o buffer da
+ * última transferência concluída e sinalizar com
+ * calibration_notify_imu_fifo(). O timestamp de cada amostra é o
+ * instante de aquisição informado pelo sensor, convertido para a base
+ * de get_time_ms().
+ * @param buf Destino, em ordem de aquisição
+ * @param max Capacidade de buf
+ * @param got Amostras lidas (0 se a FIFO estiver vazia)
+ * @return true se bem-sucedido, false caso contrário
+ */
+bool read_imu_fifo(IMUData_t *buf, size_t max, size_t *got);
+
+/**
+ * @brief Ler em rajada as amostras acumuladas na FIFO do Magnetômetro
+ *
+ * Como read_imu_fifo(), sinalizada com calibration_notify_mag_fifo().
+ * @param buf Destino, em ordem de aquisição
+ * @param max Capacidade de buf
+ * @param got Amostras lidas (0 se a FIFO estiver vazia)
+ * @return true se bem-sucedido, false caso contrário
+ */
+bool read_magnetometer_fifo(MagData_t *buf, size_t max, size_t *got);
+
 /**
  * @brief Ler dados da Bateria
  * @param battery_data Ponteiro para estrutura BatteryData_t
@@ -327,6 +969,28 @@ bool read_temperature_data(TemperatureData_t *temp_data);
  */
 float read_lidar_distance(void);
 
+/**
+ * @brief Obter a última varredura completa do LiDAR (sem cópia)
+ * @param points Recebe ponteiro para o buffer do driver; válido até a
+ *        próxima chamada
+ * @param count Recebe o número de pontos
+ * @return true se há varredura nova desde a última chamada
+ */
+bool read_lidar_scan(const LiDARData_t **points, size_t *count);
+
+/**
+ * @brief Emprestar o quadro mais recente da câmera (sem cópia)
+ * @param frame Recebe ponteiro e geometria do buffer do driver
+ * @return true se há quadro novo desde a última chamada
+ */
+bool read_camera_frame(CameraFrame_t *frame);
+
+/**
+ * @brief Devolver ao driver um quadro obtido com read_camera_frame()
+ * @param frame Quadro emprestado
+ */
+void release_camera_frame(const CameraFrame_t *frame);
+
 /**
  * @brief Mover robô para frente uma distância conhecida
  * @param distance_mm Distância em milímetros
@@ -357,6 +1021,15 @@ uint32_t get_right_encoder_count(void);
  */
 uint32_t get_time_ms(void);
 
+/**
+ * @brief Obter tempo em microssegundos (só com CALIB_TIME_US=1)
+ *
+ * Mesmo relógio de get_time_ms(), sem voltar: get_time_us() / 1000 deve
+ * coincidir com get_time_ms() módulo 2^32.
+ * @return Tempo em µs
+ */
+uint64_t get_time_us(void);
+
 /**
  * @brief Delay em milissegundos
  * @param ms Tempo em milissegundos
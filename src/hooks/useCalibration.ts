@@ -9,6 +9,36 @@ import {
   CalibrationChannel,
 } from '@/services/bluetoothCalibrationBridge';
 import { RobotCommandBridge } from '@/services/robotCommandBridge';
+import { useMQTT } from '@/hooks/useMQTT';
+import type { CalibrationWireState } from '@/shared-core/types/calibrationWire';
+
+/** Calibração recebida em binário via MQTT → formato do bridge */
+function wireToCalibrationData({ calib }: CalibrationWireState): CalibrationData {
+  return {
+    status: calib.status,
+    timestamp: calib.timestamp,
+    calibrationCount: calib.calibrationCount,
+    imu: {
+      biasX: calib.imuBiasX, biasY: calib.imuBiasY, biasZ: calib.imuBiasZ,
+      scaleX: calib.imuScaleX, scaleY: calib.imuScaleY, scaleZ: calib.imuScaleZ,
+    },
+    magnetometer: {
+      offsetX: calib.magOffsetX, offsetY: calib.magOffsetY, offsetZ: calib.magOffsetZ,
+      scaleX: calib.magScaleX, scaleY: calib.magScaleY, scaleZ: calib.magScaleZ,
+    },
+    odometer: { pulsesPerMeterLeft: calib.pulsesPerMeterLeft, pulsesPerMeterRight: calib.pulsesPerMeterRight },
+    lidar: { offsetDistance: calib.lidarOffsetDistance, angleOffset: calib.lidarAngleOffset },
+    camera: {
+      focalLength: calib.cameraFocalLength,
+      principalPointX: calib.cameraPrincipalPointX,
+      principalPointY: calib.cameraPrincipalPointY,
+      distortionK1: calib.cameraDistortionK1,
+      distortionK2: calib.cameraDistortionK2,
+    },
+    battery: { voltageOffset: calib.batteryVoltageOffset, voltageScale: calib.batteryVoltageScale },
+    temperature: { offset: calib.tempOffset },
+  };
+}
 
 export const useCalibration = () => {
   const bridgeRef = useRef<BluetoothCalibrationBridge | null>(null);
@@ -21,6 +51,7 @@ export const useCalibration = () => {
   const [logs, setLogs] = useState<string[]>([]);
   const [bleAvailable] = useState(() => BluetoothCalibrationBridge.isAvailable());
   const [activeChannel, setActiveChannel] = useState<CalibrationChannel>('none');
+  const { calibration: wireCalibration } = useMQTT();
 
   const addLog = useCallback((msg: string) => {
     setLogs(prev => [`[${new Date().toLocaleTimeString()}] ${msg}`, ...prev].slice(0, 100));
@@ -70,6 +101,11 @@ export const useCalibration = () => {
     };
   }, []);
 
+  // Robô publica a calibração em binário (completa/delta) pelo MQTT
+  useEffect(() => {
+    if (wireCalibration) setCalibData(wireToCalibrationData(wireCalibration));
+  }, [wireCalibration]);
+
   const connect = useCallback(async () => {
     try {
       setError(null);
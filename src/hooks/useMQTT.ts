@@ -9,24 +9,44 @@ import { useCallback, useEffect, useRef, useState } from 'react';
 import { RobotMQTTClient } from '@/services/RobotMQTTClient';
 import { useMQTTConfigStore } from '@/store/useMQTTConfigStore';
 import { MQTT_CONFIG } from '@/config/mqtt';
+import {
+  CalibrationWireReceiver,
+  type CalibrationWireState,
+} from '@/shared-core/types/calibrationWire';
 
 // ─── Singleton fora do React para sobreviver entre re-renders e navegação ───
 let globalClient: RobotMQTTClient | null = null;
 let globalConnected = false;
 let globalMessageCount = 0;
 let globalLastTopic = '';
+// Calibração binária por robô (robot/<sn>/calibration/wire)
+const calibrationReceivers = new Map<string, CalibrationWireReceiver>();
 const subscribers = new Set<() => void>();
 
 function notifySubscribers() {
   subscribers.forEach(fn => fn());
 }
 
+/** Aplica uma mensagem de calibração binária e responde ack (ou pede a completa) */
+function handleCalibrationWire(topic: string, payload: Uint8Array) {
+  const serial = topic.split('/')[1];
+  let receiver = calibrationReceivers.get(serial);
+  if (!receiver) {
+    receiver = new CalibrationWireReceiver();
+    calibrationReceivers.set(serial, receiver);
+  }
+  const { reply } = receiver.receive(payload);
+  if (reply) globalClient?.publish(`${topic}/ack`, reply);
+}
+
 export interface UseMQTTReturn {
   client: RobotMQTTClient | null;
   isConnected: boolean;
   brokerUrl: string;
   messageCount: number;
   lastTopic: string;
+  /** Última calibração recebida em formato binário do robô configurado */
+  calibration: CalibrationWireState | null;
   connect: (brokerUrl?: string) => Promise<void>;
   disconnect: () => void;
   publish: (topic: string, payload: string | object) => void;
@@ -82,7 +102,10 @@ export function useMQTT(): UseMQTTReturn {
         globalConnected = false;
         notifySubscribers();
       },
-      onMessage: (topic, _payload) => {
+      onMessage: (topic, payload) => {
+        if (payload instanceof Uint8Array && topic.endsWith('/calibration/wire')) {
+          handleCalibrationWire(topic, payload);
+        }
         globalMessageCount++;
         globalLastTopic = topic;
         notifySubscribers();
@@ -98,6 +121,7 @@ export function useMQTT(): UseMQTTReturn {
     globalConnected = false;
     globalMessageCount = 0;
     globalLastTopic = '';
+    calibrationReceivers.clear();
     notifySubscribers();
   }, []);
 
@@ -111,6 +135,7 @@ export function useMQTT(): UseMQTTReturn {
     brokerUrl: globalClient?.currentBroker ?? config.activeBroker,
     messageCount: globalMessageCount,
     lastTopic: globalLastTopic,
+    calibration: calibrationReceivers.get(config.robotSerial || MQTT_CONFIG.ROBOT_SERIAL)?.state ?? null,
     connect,
     disconnect,
     publish,
@@ -14,6 +14,10 @@
 
 import mqtt, { type MqttClient } from 'mqtt';
 import { MQTT_CONFIG, NETWORK_CONFIG } from '@/config/mqtt';
+import {
+  encodeCalibrationPrior,
+  type CalibrationPrior,
+} from '@/shared-core/types/calibrationWire';
 
 export interface MQTTCallbacks {
   onConnect?: () => void;
@@ -214,6 +218,13 @@ export class RobotMQTTClient {
         });
 
         this.client.on('message', (topic, message) => {
+          // Calibração binária (calibrationWire.ts): entregar os bytes sem decodificar texto
+          if (topic.endsWith('/calibration/wire')) {
+            const bytes = new Uint8Array(message);
+            this.callbacks.onMessage?.(topic, bytes);
+            window.dispatchEvent(new CustomEvent('mqtt-message', { detail: { topic, payload: bytes } }));
+            return;
+          }
           const raw = message.toString();
           let payload: string | object = raw;
           try { payload = JSON.parse(raw); } catch { /* keep as string */ }
@@ -248,14 +259,22 @@ export class RobotMQTTClient {
 
   // ─── Publish ───
 
-  publish(topic: string, message: string | object, qos: 0 | 1 | 2 = 0): void {
+  publish(topic: string, message: string | object | Uint8Array, qos: 0 | 1 | 2 = 0, retain = false): void {
     if (!this.client?.connected) {
       console.warn('⚠️ MQTT não conectado — publicação ignorada');
       return;
     }
+    if (message instanceof Uint8Array) {
+      // Binário (calibrationWire.ts): vai como está, sem JSON
+      console.log(`📤 MQTT → ${topic}: ${message.length} bytes`);
+      this.client.publish(topic, message as Buffer, { qos, retain }, (err) => {
+        if (err) console.error('❌ Erro ao publicar:', err.message);
+      });
+      return;
+    }
     const payload = typeof message === 'string' ? message : JSON.stringify(message);
     console.log(`📤 MQTT → ${topic}:`, payload.slice(0, 80));
-    this.client.publish(topic, payload, { qos }, (err) => {
+    this.client.publish(topic, payload, { qos, retain }, (err) => {
       if (err) console.error('❌ Erro ao publicar:', err.message);
     });
   }
@@ -292,6 +311,11 @@ export class RobotMQTTClient {
     this.publish(`robot/${serial}/calibration/reset`, { timestamp: Date.now() });
   }
 
+  /** Prior de frota do modelo; retido no broker, o robô recebe ao (re)conectar */
+  publishCalibrationPrior(prior: CalibrationPrior, serial = ROBOT_SERIAL): void {
+    this.publish(`robot/${serial}/calibration/prior`, encodeCalibrationPrior(prior), 1, true);
+  }
+
   move(direction: 'forward' | 'backward' | 'left' | 'right' | 'stop', speed = 0.3, duration = 1000, serial = ROBOT_SERIAL): void {
     if (direction === 'stop') {
       this.publish(`robot/${serial}/movement/stop`, { timestamp: Date.now() });
@@ -90,6 +90,35 @@ export interface CalibrationData {
   tempOffset: number;
 }
 
+// ─── Extensões de calibração (espelha SensorCalibrationExt_t) ───
+
+export interface SensorCalibrationMeta {
+  timestamp: number;
+  calibrationCount: number;
+  status: CalibrationStatus;
+}
+
+export interface GyroTempBin {
+  bias: [number, number, number]; // CALIB_GYRO_LUT_LSB
+  count: number;
+}
+
+export interface CalibrationExtData {
+  magHardIron: [number, number, number];
+  magSoftIron: number[]; // 3x3, linha a linha
+  magFieldStrength: number;
+  magFitCondition: number;
+  magModel: number; // 0 = min/max, 1 = elipsoide
+  sensorMeta: SensorCalibrationMeta[]; // Ordem de SUPPORTED_SENSORS
+  gyroBias: [number, number, number];
+  gyroBiasTemp: number;
+  gyroTempLut: GyroTempBin[];
+  wheelBase: number;
+}
+
+/** Campos de CalibrationData que o firmware persiste (sem estado da sequência) */
+export type CalibrationRecord = Omit<CalibrationData, 'state' | 'ageSeconds'>;
+
 // ─── Progresso de calibração ───
 
 export interface CalibrationProgress {
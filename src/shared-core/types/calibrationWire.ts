@@ -0,0 +1,407 @@
+/**
+ * shared-core/types/calibrationWire.ts
+ * Codec do formato binário de calibração — espelha docs/calibration_wire.c
+ *
+ * Mensagem little-endian:
+ *   +0 u8 magic (0xCA) · +1 u8 versão · +2 u8 flags (bit 0 = delta)
+ *   +3 u8 nº de campos · +4 u32 geração · +8 u32 geração base
+ *   +12 mapa de presença (1 bit por campo) · valores dos campos presentes
+ *
+ * A tabela de campos só cresce no final; a ordem é a do firmware.
+ *
+ * Prior de frota (bit 1 das flags, docs/calibration_prior.h): geração =
+ * modelo do robô, base = nº de robôs; cada campo traz mediana e desvio.
+ */
+
+import type {
+  CalibrationRecord,
+  CalibrationExtData,
+  CalibrationStatus,
+} from './calibration';
+
+// ─── Constantes (calibration_wire.h) ───
+
+export const CALIB_WIRE_MAGIC = 0xca;
+export const CALIB_WIRE_VERSION = 1;
+export const CALIB_WIRE_FLAG_DELTA = 0x01;
+export const CALIB_WIRE_FLAG_PRIOR = 0x02;
+export const CALIB_WIRE_HEADER_SIZE = 12;
+export const CALIB_WIRE_MAX_SIZE = 320;
+
+const SENSOR_COUNT = 7;
+const GYRO_TEMP_BINS = 8;
+
+// ─── Tipos ───
+
+export interface CalibrationWireState {
+  generation: number;
+  calib: CalibrationRecord;
+  ext: CalibrationExtData;
+}
+
+/** Campos de calibração com prior de frota (floats de SensorCalibration_t) */
+export type CalibrationPriorKey = Exclude<keyof CalibrationRecord, 'status' | 'timestamp' | 'calibrationCount'>;
+
+/** Mediana e desvio robusto da frota por campo; desvio 0 = campo sem prior */
+export interface CalibrationPrior {
+  modelId: number;
+  robots: number;
+  median: Record<CalibrationPriorKey, number>;
+  sigma: Record<CalibrationPriorKey, number>;
+}
+
+export type CalibrationWireResult =
+  | { ok: true; state: CalibrationWireState; delta: boolean }
+  | { ok: false; reason: 'truncated' | 'bad-header' | 'base-mismatch' };
+
+type Word = 'f32' | 'u32' | 'u16' | 'i16' | 'u8';
+
+interface WireField {
+  word: Word;
+  count: number;
+  get: (s: CalibrationWireState) => number[];
+  set: (s: CalibrationWireState, v: number[]) => void;
+}
+
+const WORD_SIZE: Record<Word, number> = { f32: 4, u32: 4, u16: 2, i16: 2, u8: 1 };
+
+// ─── Tabela de campos (versão 1) ───
+
+type CalibKey = keyof CalibrationRecord;
+
+function calibRun(word: Word, keys: CalibKey[]): WireField {
+  return {
+    word,
+    count: keys.length,
+    get: s => keys.map(k => s.calib[k]),
+    set: (s, v) => {
+      const calib = s.calib as Record<CalibKey, number>;
+      keys.forEach((k, i) => { calib[k] = v[i]; });
+    },
+  };
+}
+
+function extField(
+  word: Word,
+  count: number,
+  get: (e: CalibrationExtData) => number[],
+  set: (e: CalibrationExtData, v: number[]) => void,
+): WireField {
+  return { word, count, get: s => get(s.ext), set: (s, v) => set(s.ext, v) };
+}
+
+function metaFields(i: number): WireField[] {
+  return [
+    extField('u32', 1, e => [e.sensorMeta[i].timestamp], (e, v) => { e.sensorMeta[i].timestamp = v[0]; }),
+    extField('u16', 1, e => [e.sensorMeta[i].calibrationCount], (e, v) => { e.sensorMeta[i].calibrationCount = v[0]; }),
+    extField('u8', 1, e => [e.sensorMeta[i].status], (e, v) => { e.sensorMeta[i].status = v[0] as CalibrationStatus; }),
+  ];
+}
+
+// bias[3] (i16) e count (u16) do ponto: quatro palavras de 16 bits
+function gyroBinField(i: number): WireField {
+  return {
+    word: 'i16',
+    count: 4,
+    get: s => [...s.ext.gyroTempLut[i].bias, s.ext.gyroTempLut[i].count],
+    set: (s, v) => {
+      s.ext.gyroTempLut[i] = { bias: [v[0], v[1], v[2]], count: v[3] & 0xffff };
+    },
+  };
+}
+
+const WIRE_FIELDS: WireField[] = [
+  calibRun('f32', ['imuBiasX', 'imuBiasY', 'imuBiasZ']),
+  calibRun('f32', ['imuScaleX', 'imuScaleY', 'imuScaleZ']),
+  calibRun('f32', ['magOffsetX', 'magOffsetY', 'magOffsetZ']),
+  calibRun('f32', ['magScaleX', 'magScaleY', 'magScaleZ']),
+  calibRun('f32', ['pulsesPerMeterLeft', 'pulsesPerMeterRight']),
+  calibRun('f32', ['lidarOffsetDistance', 'lidarAngleOffset']),
+  calibRun('f32', ['cameraFocalLength']),
+  calibRun('f32', ['cameraPrincipalPointX', 'cameraPrincipalPointY']),
+  calibRun('f32', ['cameraDistortionK1', 'cameraDistortionK2']),
+  calibRun('f32', ['batteryVoltageOffset', 'batteryVoltageScale']),
+  calibRun('f32', ['tempOffset']),
+  calibRun('u32', ['timestamp']),
+  calibRun('u16', ['calibrationCount']),
+  calibRun('u8', ['status']),
+  extField('f32', 3, e => [...e.magHardIron], (e, v) => { e.magHardIron = [v[0], v[1], v[2]]; }),
+  extField('f32', 9, e => [...e.magSoftIron], (e, v) => { e.magSoftIron = [...v]; }),
+  extField('f32', 2, e => [e.magFieldStrength, e.magFitCondition], (e, v) => {
+    e.magFieldStrength = v[0];
+    e.magFitCondition = v[1];
+  }),
+  extField('u8', 1, e => [e.magModel], (e, v) => { e.magModel = v[0]; }),
+  ...Array.from({ length: SENSOR_COUNT }, (_, i) => metaFields(i)).flat(),
+  extField('f32', 3, e => [...e.gyroBias], (e, v) => { e.gyroBias = [v[0], v[1], v[2]]; }),
+  extField('f32', 1, e => [e.gyroBiasTemp], (e, v) => { e.gyroBiasTemp = v[0]; }),
+  ...Array.from({ length: GYRO_TEMP_BINS }, (_, i) => gyroBinField(i)),
+  extField('f32', 1, e => [e.wheelBase], (e, v) => { e.wheelBase = v[0]; }),
+];
+
+const MAP_SIZE = Math.ceil(WIRE_FIELDS.length / 8);
+
+// Os campos com prior são as 11 primeiras entradas (floats da calibração base)
+const PRIOR_FIELDS = 11;
+const PRIOR_MIN_ROBOTS = 3;
+const MAD_TO_SIGMA = 1.4826;
+
+// ─── Utilitários ───
+
+function fieldSize(f: WireField): number {
+  return WORD_SIZE[f.word] * f.count;
+}
+
+function readWord(view: DataView, pos: number, word: Word): number {
+  switch (word) {
+    case 'f32': return view.getFloat32(pos, true);
+    case 'u32': return view.getUint32(pos, true);
+    case 'u16': return view.getUint16(pos, true);
+    case 'i16': return view.getInt16(pos, true);
+    case 'u8': return view.getUint8(pos);
+  }
+}
+
+function writeWord(view: DataView, pos: number, word: Word, value: number): void {
+  switch (word) {
+    case 'f32': view.setFloat32(pos, value, true); break;
+    case 'u32': view.setUint32(pos, value >>> 0, true); break;
+    case 'u16': view.setUint16(pos, value & 0xffff, true); break;
+    case 'i16': view.setInt16(pos, value, true); break;
+    case 'u8': view.setUint8(pos, value & 0xff); break;
+  }
+}
+
+/** Igualdade após a conversão para a palavra do fio (f32 compara os bits) */
+function sameWords(word: Word, a: number[], b: number[]): boolean {
+  if (word !== 'f32') return a.every((x, i) => x === b[i]);
+  return a.every((x, i) => Object.is(Math.fround(x), Math.fround(b[i])));
+}
+
+/** Estado vazio: base para a primeira mensagem completa (que traz todos os campos) */
+function emptyState(): CalibrationWireState {
+  return {
+    generation: 0,
+    calib: {
+      status: 0 as CalibrationStatus,
+      timestamp: 0,
+      calibrationCount: 0,
+      imuBiasX: 0, imuBiasY: 0, imuBiasZ: 0,
+      imuScaleX: 1, imuScaleY: 1, imuScaleZ: 1,
+      magOffsetX: 0, magOffsetY: 0, magOffsetZ: 0,
+      magScaleX: 1, magScaleY: 1, magScaleZ: 1,
+      pulsesPerMeterLeft: 0, pulsesPerMeterRight: 0,
+      lidarOffsetDistance: 0, lidarAngleOffset: 0,
+      cameraFocalLength: 0, cameraPrincipalPointX: 0, cameraPrincipalPointY: 0,
+      cameraDistortionK1: 0, cameraDistortionK2: 0,
+      batteryVoltageOffset: 0, batteryVoltageScale: 1,
+      tempOffset: 0,
+    },
+    ext: {
+      magHardIron: [0, 0, 0],
+      magSoftIron: [1, 0, 0, 0, 1, 0, 0, 0, 1],
+      magFieldStrength: 0,
+      magFitCondition: 0,
+      magModel: 0,
+      sensorMeta: Array.from({ length: SENSOR_COUNT }, () => ({
+        timestamp: 0, calibrationCount: 0, status: 0 as CalibrationStatus,
+      })),
+      gyroBias: [0, 0, 0],
+      gyroBiasTemp: 0,
+      gyroTempLut: Array.from({ length: GYRO_TEMP_BINS }, () => ({
+        bias: [0, 0, 0] as [number, number, number], count: 0,
+      })),
+      wheelBase: 0,
+    },
+  };
+}
+
+function cloneState(s: CalibrationWireState): CalibrationWireState {
+  return {
+    generation: s.generation,
+    calib: { ...s.calib },
+    ext: {
+      ...s.ext,
+      magHardIron: [...s.ext.magHardIron] as [number, number, number],
+      magSoftIron: [...s.ext.magSoftIron],
+      sensorMeta: s.ext.sensorMeta.map(m => ({ ...m })),
+      gyroBias: [...s.ext.gyroBias] as [number, number, number],
+      gyroTempLut: s.ext.gyroTempLut.map(b => ({ bias: [...b.bias] as [number, number, number], count: b.count })),
+    },
+  };
+}
+
+// ─── Codec ───
+
+/**
+ * Codifica `state`; com `base`, só os campos que diferem dela (delta).
+ */
+export function encodeCalibrationWire(
+  state: CalibrationWireState,
+  base?: CalibrationWireState | null,
+): Uint8Array {
+  const present = WIRE_FIELDS.map(f => !base || !sameWords(f.word, f.get(state), f.get(base)));
+  const size = CALIB_WIRE_HEADER_SIZE + MAP_SIZE +
+    WIRE_FIELDS.reduce((n, f, i) => n + (present[i] ? fieldSize(f) : 0), 0);
+  const out = new Uint8Array(size);
+  const view = new DataView(out.buffer);
+
+  out[0] = CALIB_WIRE_MAGIC;
+  out[1] = CALIB_WIRE_VERSION;
+  out[2] = base ? CALIB_WIRE_FLAG_DELTA : 0;
+  out[3] = WIRE_FIELDS.length;
+  view.setUint32(4, state.generation >>> 0, true);
+  view.setUint32(8, base ? base.generation >>> 0 : 0, true);
+
+  let pos = CALIB_WIRE_HEADER_SIZE + MAP_SIZE;
+  WIRE_FIELDS.forEach((f, i) => {
+    if (!present[i]) return;
+    out[CALIB_WIRE_HEADER_SIZE + (i >> 3)] |= 1 << (i & 7);
+    for (const v of f.get(state)) {
+      writeWord(view, pos, f.word, v);
+      pos += WORD_SIZE[f.word];
+    }
+  });
+  return out;
+}
+
+/**
+ * Decodifica uma mensagem sobre `current` (null antes da primeira completa).
+ * Não altera `current`; devolve o novo estado.
+ */
+export function decodeCalibrationWire(
+  data: Uint8Array,
+  current: CalibrationWireState | null,
+): CalibrationWireResult {
+  if (data.length < CALIB_WIRE_HEADER_SIZE) return { ok: false, reason: 'truncated' };
+  if (data[0] !== CALIB_WIRE_MAGIC || data[1] !== CALIB_WIRE_VERSION ||
+      (data[2] & CALIB_WIRE_FLAG_PRIOR) !== 0) {
+    return { ok: false, reason: 'bad-header' };
+  }
+
+  const view = new DataView(data.buffer, data.byteOffset, data.byteLength);
+  const delta = (data[2] & CALIB_WIRE_FLAG_DELTA) !== 0;
+  const sentFields = data[3];
+  const known = Math.min(sentFields, WIRE_FIELDS.length);
+  const generation = view.getUint32(4, true);
+  const baseGeneration = view.getUint32(8, true);
+  const mapAt = CALIB_WIRE_HEADER_SIZE;
+  let pos = mapAt + Math.ceil(sentFields / 8);
+
+  // Delta repetido da geração que já temos é idempotente (confirmação perdida)
+  if (delta && (!current ||
+      (current.generation !== baseGeneration && current.generation !== generation))) {
+    return { ok: false, reason: 'base-mismatch' };
+  }
+
+  const isPresent = (i: number) => (data[mapAt + (i >> 3)] & (1 << (i & 7))) !== 0;
+  let needed = pos;
+  for (let i = 0; i < known; i++) if (isPresent(i)) needed += fieldSize(WIRE_FIELDS[i]);
+  if (data.length < needed) return { ok: false, reason: 'truncated' };
+
+  const state = current ? cloneState(current) : emptyState();
+  for (let i = 0; i < known; i++) {
+    if (!isPresent(i)) continue;
+    const f = WIRE_FIELDS[i];
+    const values: number[] = [];
+    for (let k = 0; k < f.count; k++) {
+      values.push(readWord(view, pos, f.word));
+      pos += WORD_SIZE[f.word];
+    }
+    f.set(state, values);
+  }
+  state.generation = generation;
+  return { ok: true, state, delta };
+}
+
+// ─── Prior de frota ───
+
+function median(values: number[]): number {
+  const sorted = [...values].sort((a, b) => a - b);
+  const mid = sorted.length >> 1;
+  return sorted.length % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+}
+
+/**
+ * Prior de um modelo a partir das calibrações válidas da frota:
+ * mediana e 1.4826·MAD por campo. Campos sem dispersão ficam sem prior.
+ * null com menos de 3 robôs.
+ */
+export function calibrationPriorFromFleet(
+  modelId: number,
+  records: CalibrationRecord[],
+): CalibrationPrior | null {
+  if (records.length < PRIOR_MIN_ROBOTS) return null;
+
+  const keys = Object.keys(emptyState().calib)
+    .filter(k => k !== 'status' && k !== 'timestamp' && k !== 'calibrationCount') as CalibrationPriorKey[];
+  const prior: CalibrationPrior = {
+    modelId,
+    robots: records.length,
+    median: {} as Record<CalibrationPriorKey, number>,
+    sigma: {} as Record<CalibrationPriorKey, number>,
+  };
+  for (const key of keys) {
+    const values = records.map(r => r[key]);
+    const m = median(values);
+    prior.median[key] = m;
+    prior.sigma[key] = MAD_TO_SIGMA * median(values.map(v => Math.abs(v - m)));
+  }
+  return prior;
+}
+
+/** Codifica um prior para robot/<sn>/calibration/prior */
+export function encodeCalibrationPrior(prior: CalibrationPrior): Uint8Array {
+  const medianState = emptyState();
+  const sigmaState = emptyState();
+  Object.assign(medianState.calib, prior.median);
+  Object.assign(sigmaState.calib, prior.sigma);
+
+  const fields = WIRE_FIELDS.slice(0, PRIOR_FIELDS);
+  const mapSize = Math.ceil(PRIOR_FIELDS / 8);
+  const size = CALIB_WIRE_HEADER_SIZE + mapSize + fields.reduce((n, f) => n + 2 * fieldSize(f), 0);
+  const out = new Uint8Array(size);
+  const view = new DataView(out.buffer);
+
+  out[0] = CALIB_WIRE_MAGIC;
+  out[1] = CALIB_WIRE_VERSION;
+  out[2] = CALIB_WIRE_FLAG_PRIOR;
+  out[3] = PRIOR_FIELDS;
+  view.setUint32(4, prior.modelId >>> 0, true);
+  view.setUint32(8, prior.robots >>> 0, true);
+
+  let pos = CALIB_WIRE_HEADER_SIZE + mapSize;
+  fields.forEach((f, i) => {
+    out[CALIB_WIRE_HEADER_SIZE + (i >> 3)] |= 1 << (i & 7);
+    for (const v of [...f.get(medianState), ...f.get(sigmaState)]) {
+      writeWord(view, pos, f.word, v);
+      pos += WORD_SIZE[f.word];
+    }
+  });
+  return out;
+}
+
+// ─── Receptor (app) ───
+
+/**
+ * Mantém a calibração recebida de um robô e diz o que responder:
+ * `{ generation }` aplicada (ack) ou `{ full: true }` quando falta a base do delta.
+ */
+export class CalibrationWireReceiver {
+  state: CalibrationWireState | null = null;
+
+  receive(data: Uint8Array): { reply: { generation: number } | { full: true } | null; changed: boolean } {
+    const result = decodeCalibrationWire(data, this.state);
+    if (!result.ok) {
+      return { reply: result.reason === 'base-mismatch' ? { full: true } : null, changed: false };
+    }
+    // Delta repetido da mesma geração: manter o objeto (consumidores comparam por referência)
+    const changed = this.state?.generation !== result.state.generation || !result.delta;
+    if (changed) this.state = result.state;
+    return { reply: { generation: result.state.generation }, changed };
+  }
+
+  reset(): void {
+    this.state = null;
+  }
+}
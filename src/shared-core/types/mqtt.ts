@@ -31,6 +31,9 @@ export const PUB_TOPICS = {
   calibrationStart: (sn: string) => robotTopic(sn, 'calibration/start'),
   calibrationStop: (sn: string) => robotTopic(sn, 'calibration/stop'),
   calibrationReset: (sn: string) => robotTopic(sn, 'calibration/reset'),
+  calibrationWireAck: (sn: string) => robotTopic(sn, 'calibration/wire/ack'),
+  /** Prior de frota do modelo (encodeCalibrationPrior), publicado com retain */
+  calibrationPrior: (sn: string) => robotTopic(sn, 'calibration/prior'),
   movementDir: (sn: string, dir: string) => robotTopic(sn, `movement/${dir}`),
   movementStop: (sn: string) => robotTopic(sn, 'movement/stop'),
   cmd: (sn: string) => robotTopic(sn, 'cmd'),
@@ -44,6 +47,8 @@ export const SUB_TOPICS = {
   calibrationProgress: (sn: string) => robotTopic(sn, 'calibration/progress'),
   calibrationComplete: (sn: string) => robotTopic(sn, 'calibration/complete'),
   calibrationError: (sn: string) => robotTopic(sn, 'calibration/error'),
+  /** Calibração em formato binário (calibrationWire.ts), completa ou delta */
+  calibrationWire: (sn: string) => robotTopic(sn, 'calibration/wire'),
   kitchenReady: () => 'kitchen/order/ready',
   robotWildcard: (sn: string) => `robot/${sn}/#`,
   csjbotWildcard: (sn: string) => `csjbot/${sn}/#`,
@@ -63,6 +68,9 @@ export interface MQTTPayloadMap {
   'calibration/progress': CalibrationProgress;
   'calibration/complete': CalibrationData;
   'calibration/error': { error: string; state: number };
+  'calibration/wire': Uint8Array;
+  'calibration/wire/ack': { generation: number } | { full: true };
+  'calibration/prior': Uint8Array;
   'movement/forward': { speed: number; duration: number; timestamp: number };
   'movement/backward': { speed: number; duration: number; timestamp: number };
   'movement/left': { speed: number; duration: number; timestamp: number };
@@ -0,0 +1,214 @@
+import { describe, it, expect } from "vitest";
+import {
+  CALIB_WIRE_FLAG_PRIOR,
+  CALIB_WIRE_HEADER_SIZE,
+  CalibrationWireReceiver,
+  type CalibrationWireState,
+  decodeCalibrationWire,
+  encodeCalibrationWire,
+} from "@/shared-core/types/calibrationWire";
+import { CalibrationStatus } from "@/shared-core/types/calibration";
+
+// Vetores gerados por calibration_wire_encode() (docs/calibration_wire.c)
+// sobre o mesmo estado de fixture(): completa na geração 7, delta 7 → 8 e
+// delta vazio 8 → 9.
+const C_FULL =
+  "ca0100320700000000000000ffffffffffff03cdcc4c3d0ad7a3bccdcccc3dae47813fa4707d3f0000803f" +
+  "cdcccc3dcdcc4cbecdcc4c3d643b7f3ff2d28d3f9eef673f0040834400007f440ad7a33c8fc2f53c002000" +
+  "440000a043000070438fc2f5bd8fc2f53ccdcc4c3e0000803f000080bf00f15365030001cdcccc3dcdcc4c" +
+  "becdcc4c3dcdcc8c3f0ad7233c000000000ad7233c6666663f0000000000000000000000000000803f0000" +
+  "42429a9921410100f1536501000101f1536502000102f1536503000103f1536504000104f1536505000105" +
+  "f1536506000106f153650700016f12833a6c09f9ba5f294b3b0000d04100000000640000000a00fbff6300" +
+  "03001400f6ff620006001e00f1ff610009002800ecff60000c003200e7ff5f000f003c00e2ff5e00120046" +
+  "00ddff5d0015007b14ae3e";
+const C_DELTA = "ca0101320800000007000000010000000008028fc2753d0ad7a3bccdcccc3d1400f6ff62006300d7a3b03e";
+const C_EMPTY_DELTA = "ca010132090000000800000000000000000000";
+
+function hex(bytes: Uint8Array): string {
+  return Array.from(bytes, b => b.toString(16).padStart(2, "0")).join("");
+}
+
+function unhex(text: string): Uint8Array {
+  return Uint8Array.from(text.match(/../g)!.map(b => parseInt(b, 16)));
+}
+
+function fixture(generation = 7): CalibrationWireState {
+  return {
+    generation,
+    calib: {
+      status: CalibrationStatus.VALID,
+      timestamp: 1700000000,
+      calibrationCount: 3,
+      imuBiasX: 0.05, imuBiasY: -0.02, imuBiasZ: 0.1,
+      imuScaleX: 1.01, imuScaleY: 0.99, imuScaleZ: 1.0,
+      magOffsetX: 0.1, magOffsetY: -0.2, magOffsetZ: 0.05,
+      magScaleX: 0.997, magScaleY: 1.108, magScaleZ: 0.906,
+      pulsesPerMeterLeft: 1050, pulsesPerMeterRight: 1020,
+      lidarOffsetDistance: 0.02, lidarAngleOffset: 0.03,
+      cameraFocalLength: 512.5, cameraPrincipalPointX: 320, cameraPrincipalPointY: 240,
+      cameraDistortionK1: -0.12, cameraDistortionK2: 0.03,
+      batteryVoltageOffset: 0.2, batteryVoltageScale: 1.0,
+      tempOffset: -1.0,
+    },
+    ext: {
+      magHardIron: [0.1, -0.2, 0.05],
+      magSoftIron: [1.1, 0.01, 0, 0.01, 0.9, 0, 0, 0, 1.0],
+      magFieldStrength: 48.5,
+      magFitCondition: 10.1,
+      magModel: 1,
+      sensorMeta: Array.from({ length: 7 }, (_, i) => ({
+        timestamp: 1700000000 + i,
+        calibrationCount: i + 1,
+        status: CalibrationStatus.VALID,
+      })),
+      gyroBias: [0.001, -0.0019, 0.0031],
+      gyroBiasTemp: 26,
+      gyroTempLut: Array.from({ length: 8 }, (_, i) => ({
+        bias: [i * 10, -i * 5, 100 - i] as [number, number, number],
+        count: i * 3,
+      })),
+      wheelBase: 0.34,
+    },
+  };
+}
+
+function changed(generation = 8): CalibrationWireState {
+  const state = fixture(generation);
+  state.calib.imuBiasX = 0.06;
+  state.ext.wheelBase = 0.345;
+  state.ext.gyroTempLut[2].count = 99;
+  return state;
+}
+
+describe("calibrationWire", () => {
+  describe("byte-for-byte with the firmware", () => {
+    it("encodes a full message like calibration_wire_encode", () => {
+      expect(hex(encodeCalibrationWire(fixture()))).toBe(C_FULL);
+    });
+
+    it("encodes a delta like calibration_wire_encode", () => {
+      expect(hex(encodeCalibrationWire(changed(), fixture()))).toBe(C_DELTA);
+    });
+
+    it("encodes an unchanged state as an empty delta", () => {
+      expect(hex(encodeCalibrationWire(changed(9), changed()))).toBe(C_EMPTY_DELTA);
+    });
+
+    it("decodes the firmware messages", () => {
+      const full = decodeCalibrationWire(unhex(C_FULL), null);
+      expect(full.ok).toBe(true);
+      if (!full.ok) return;
+      expect(full.delta).toBe(false);
+      expect(full.state.generation).toBe(7);
+      expect(full.state.calib.imuBiasX).toBe(Math.fround(0.05));
+      expect(full.state.ext.gyroTempLut[3].bias).toEqual([30, -15, 97]);
+
+      const delta = decodeCalibrationWire(unhex(C_DELTA), full.state);
+      expect(delta.ok).toBe(true);
+      if (!delta.ok) return;
+      expect(delta.delta).toBe(true);
+      expect(delta.state.generation).toBe(8);
+      expect(delta.state.calib.imuBiasX).toBe(Math.fround(0.06));
+      expect(delta.state.ext.wheelBase).toBe(Math.fround(0.345));
+      expect(delta.state.ext.gyroTempLut[2].count).toBe(99);
+      expect(delta.state.calib.imuBiasY).toBe(full.state.calib.imuBiasY);
+    });
+  });
+
+  describe("round trip", () => {
+    it("decodes what it encodes", () => {
+      const bytes = encodeCalibrationWire(fixture());
+      const result = decodeCalibrationWire(bytes, null);
+      expect(result.ok).toBe(true);
+      if (!result.ok) return;
+      expect(encodeCalibrationWire(result.state)).toEqual(bytes);
+      expect(result.state.calib.status).toBe(CalibrationStatus.VALID);
+      expect(result.state.ext.sensorMeta[6]).toEqual({
+        timestamp: 1700000006,
+        calibrationCount: 7,
+        status: CalibrationStatus.VALID,
+      });
+    });
+
+    it("does not modify the current state", () => {
+      const current = fixture();
+      const before = JSON.stringify(current);
+      decodeCalibrationWire(encodeCalibrationWire(changed(), current), current);
+      expect(JSON.stringify(current)).toBe(before);
+    });
+  });
+
+  // O formato não tem CRC: a
+  // mensagem é rejeitada pelo comprimento e pelo cabeçalho
+  describe("rejection", () => {
+    it("rejects messages shorter than the header", () => {
+      const bytes = unhex(C_FULL).subarray(0, CALIB_WIRE_HEADER_SIZE - 1);
+      expect(decodeCalibrationWire(bytes, null)).toEqual({ ok: false, reason: "truncated" });
+    });
+
+    it("rejects messages shorter than their presence map", () => {
+      const full = unhex(C_FULL);
+      expect(decodeCalibrationWire(full.subarray(0, full.length - 1), null))
+        .toEqual({ ok: false, reason: "truncated" });
+      const delta = unhex(C_DELTA);
+      expect(decodeCalibrationWire(delta.subarray(0, delta.length - 1), fixture()))
+        .toEqual({ ok: false, reason: "truncated" });
+    });
+
+    it("rejects a wrong magic, version or a prior message", () => {
+      for (const [at, value] of [[0, 0xcb], [1, 2], [2, CALIB_WIRE_FLAG_PRIOR]]) {
+        const bytes = unhex(C_FULL);
+        bytes[at] = value;
+        expect(decodeCalibrationWire(bytes, null)).toEqual({ ok: false, reason: "bad-header" });
+      }
+    });
+
+    it("rejects a delta over another base", () => {
+      expect(decodeCalibrationWire(unhex(C_DELTA), null))
+        .toEqual({ ok: false, reason: "base-mismatch" });
+      expect(decodeCalibrationWire(unhex(C_DELTA), fixture(6)))
+        .toEqual({ ok: false, reason: "base-mismatch" });
+    });
+
+    it("accepts a delta repeated for the current generation", () => {
+      const result = decodeCalibrationWire(unhex(C_DELTA), changed());
+      expect(result.ok).toBe(true);
+      if (result.ok) expect(result.state.generation).toBe(8);
+    });
+  });
+
+  describe("CalibrationWireReceiver", () => {
+    it("acknowledges each applied generation", () => {
+      const receiver = new CalibrationWireReceiver();
+      expect(receiver.receive(unhex(C_FULL))).toEqual({ reply: { generation: 7 }, changed: true });
+      expect(receiver.receive(unhex(C_DELTA))).toEqual({ reply: { generation: 8 }, changed: true });
+      expect(receiver.state?.ext.wheelBase).toBe(Math.fround(0.345));
+    });
+
+    it("keeps the state object when a delta is repeated (lost ack)", () => {
+      const receiver = new CalibrationWireReceiver();
+      receiver.receive(unhex(C_FULL));
+      receiver.receive(unhex(C_DELTA));
+      const state = receiver.state;
+      expect(receiver.receive(unhex(C_DELTA))).toEqual({ reply: { generation: 8 }, changed: false });
+      expect(receiver.state).toBe(state);
+    });
+
+    it("asks for a full message when the delta base is missing", () => {
+      const receiver = new CalibrationWireReceiver();
+      expect(receiver.receive(unhex(C_DELTA))).toEqual({ reply: { full: true }, changed: false });
+      receiver.receive(unhex(C_FULL));
+      receiver.reset();
+      expect(receiver.state).toBeNull();
+      expect(receiver.receive(unhex(C_EMPTY_DELTA))).toEqual({ reply: { full: true }, changed: false });
+    });
+
+    it("ignores malformed messages without replying", () => {
+      const receiver = new CalibrationWireReceiver();
+      receiver.receive(unhex(C_FULL));
+      const state = receiver.state;
+      expect(receiver.receive(unhex(C_DELTA).subarray(0, 20))).toEqual({ reply: null, changed: false });
+      expect(receiver.state).toBe(state);
+    });
+  });
+});